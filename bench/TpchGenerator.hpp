@@ -0,0 +1,170 @@
+#pragma once
+
+#include "../include/storage/Database.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace parallaxdb {
+namespace bench {
+
+// Small deterministic PRNG (splitmix64). Unlike the <random> distributions its
+// output is identical on every platform, so generated data is reproducible.
+class Random {
+public:
+    explicit Random(uint64_t seed) : state(seed) {}
+
+    uint64_t next() {
+        uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    // Uniform integer in [lo, hi]
+    int uniform(int lo, int hi) {
+        return lo + static_cast<int>(next() % static_cast<uint64_t>(hi - lo + 1));
+    }
+
+    // Uniform double in [lo, hi), rounded to cents
+    double money(double lo, double hi) {
+        double unit = static_cast<double>(next() >> 11) / static_cast<double>(1ULL << 53);
+        return static_cast<int64_t>((lo + unit * (hi - lo)) * 100) / 100.0;
+    }
+
+    template <typename T>
+    const T& pick(const std::vector<T>& items) {
+        return items[next() % items.size()];
+    }
+
+private:
+    uint64_t state;
+};
+
+// TpchGenerator: Populates a database with TPC-H-like NATION, CUSTOMER,
+// ORDERS and LINEITEM tables. Cardinalities follow the TPC-H ratios for the
+// scale factor (SF 1 = 150k customers, 1.5M orders, ~6M line items); dates
+// are stored as INT days since 1992-01-01. The same scale factor and seed
+// always produce the same data.
+class TpchGenerator {
+public:
+    static constexpr uint64_t kDefaultSeed = 0x7c9a11;
+    static constexpr int kDateRange = 2405; // 1992-01-01 .. 1998-08-02
+
+    explicit TpchGenerator(double scaleFactor, uint64_t seed = kDefaultSeed)
+        : scaleFactor(scaleFactor), seed(seed) {}
+
+    size_t customerCount() const { return scaled(150000); }
+    size_t orderCount() const { return scaled(1500000); }
+
+    static Schema nationSchema() {
+        Schema schema("nation");
+        schema.columns = {{"n_nationkey", DataType::INT}, {"n_name", DataType::STRING},
+                          {"n_regionkey", DataType::INT}};
+        return schema;
+    }
+
+    static Schema customerSchema() {
+        Schema schema("customer");
+        schema.columns = {{"c_custkey", DataType::INT}, {"c_name", DataType::STRING},
+                          {"c_nationkey", DataType::INT}, {"c_acctbal", DataType::DOUBLE},
+                          {"c_mktsegment", DataType::STRING}};
+        return schema;
+    }
+
+    static Schema ordersSchema() {
+        Schema schema("orders");
+        schema.columns = {{"o_orderkey", DataType::INT}, {"o_custkey", DataType::INT},
+                          {"o_orderstatus", DataType::STRING}, {"o_totalprice", DataType::DOUBLE},
+                          {"o_orderdate", DataType::INT}, {"o_orderpriority", DataType::STRING}};
+        return schema;
+    }
+
+    static Schema lineitemSchema() {
+        Schema schema("lineitem");
+        schema.columns = {{"l_orderkey", DataType::INT}, {"l_linenumber", DataType::INT},
+                          {"l_quantity", DataType::INT}, {"l_extendedprice", DataType::DOUBLE},
+                          {"l_discount", DataType::DOUBLE}, {"l_shipdate", DataType::INT},
+                          {"l_returnflag", DataType::STRING}, {"l_shipmode", DataType::STRING}};
+        return schema;
+    }
+
+    // Creates and fills all four tables; returns the number of rows inserted
+    size_t populate(Database& db) const {
+        db.createTable("nation", nationSchema());
+        db.createTable("customer", customerSchema());
+        db.createTable("orders", ordersSchema());
+        db.createTable("lineitem", lineitemSchema());
+
+        size_t rows = 0;
+        for (int n = 0; n < static_cast<int>(kNations.size()); ++n) {
+            db.insertInto("nation", {n, kNations[n], n % 5});
+            rows++;
+        }
+
+        Random rng(seed);
+        for (size_t c = 1; c <= customerCount(); ++c) {
+            db.insertInto("customer", customerRow(static_cast<int>(c), rng));
+            rows++;
+        }
+
+        for (size_t o = 1; o <= orderCount(); ++o) {
+            int orderKey = static_cast<int>(o);
+            int orderDate = rng.uniform(0, kDateRange - 151);
+            int lines = rng.uniform(1, 7);
+            double total = 0;
+            for (int l = 1; l <= lines; ++l) {
+                std::vector<Value> item = lineitemRow(orderKey, l, orderDate, rng);
+                total += std::get<double>(item[3]);
+                db.insertInto("lineitem", item);
+                rows++;
+            }
+            int custKey = rng.uniform(1, static_cast<int>(customerCount()));
+            db.insertInto("orders", {orderKey, custKey, rng.pick(kStatuses), total, orderDate,
+                                     rng.pick(kPriorities)});
+            rows++;
+        }
+        return rows;
+    }
+
+    // A CUSTOMER row for key `key`, drawing attributes from `rng`
+    static std::vector<Value> customerRow(int key, Random& rng) {
+        std::string name = std::to_string(key);
+        name = "Customer#" + std::string(9 - std::min<size_t>(9, name.size()), '0') + name;
+        return {key, name, rng.uniform(0, static_cast<int>(kNations.size()) - 1),
+                rng.money(-999.99, 9999.99), rng.pick(kSegments)};
+    }
+
+    static std::vector<Value> lineitemRow(int orderKey, int lineNumber, int orderDate, Random& rng) {
+        int quantity = rng.uniform(1, 50);
+        double price = quantity * rng.money(900.0, 2000.0);
+        return {orderKey, lineNumber, quantity, price, rng.uniform(0, 10) / 100.0,
+                orderDate + rng.uniform(1, 121), rng.pick(kReturnFlags), rng.pick(kShipModes)};
+    }
+
+private:
+    double scaleFactor;
+    uint64_t seed;
+
+    size_t scaled(size_t base) const {
+        size_t n = static_cast<size_t>(base * scaleFactor);
+        return n > 0 ? n : 1;
+    }
+
+    static inline const std::vector<std::string> kNations = {
+        "ALGERIA", "ARGENTINA", "BRAZIL", "CANADA", "EGYPT", "ETHIOPIA", "FRANCE", "GERMANY",
+        "INDIA", "INDONESIA", "IRAN", "IRAQ", "JAPAN", "JORDAN", "KENYA", "MOROCCO",
+        "MOZAMBIQUE", "PERU", "CHINA", "ROMANIA", "SAUDI ARABIA", "VIETNAM", "RUSSIA",
+        "UNITED KINGDOM", "UNITED STATES"};
+    static inline const std::vector<std::string> kSegments = {
+        "AUTOMOBILE", "BUILDING", "FURNITURE", "HOUSEHOLD", "MACHINERY"};
+    static inline const std::vector<std::string> kStatuses = {"F", "O", "P"};
+    static inline const std::vector<std::string> kPriorities = {
+        "1-URGENT", "2-HIGH", "3-MEDIUM", "4-NOT SPECIFIED", "5-LOW"};
+    static inline const std::vector<std::string> kReturnFlags = {"A", "N", "R"};
+    static inline const std::vector<std::string> kShipModes = {
+        "AIR", "FOB", "MAIL", "RAIL", "REG AIR", "SHIP", "TRUCK"};
+};
+
+} // namespace bench
+} // namespace parallaxdb
@@ -0,0 +1,268 @@
+#include "TpchGenerator.hpp"
+#include "../include/parser/DMLParser.hpp"
+#include "../include/parser/SQLParser.hpp"
+#include "../include/planner/QueryPlan.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace parallaxdb;
+using namespace parallaxdb::bench;
+
+namespace {
+
+struct Options {
+    double scale = 0.01;
+    int iterations = 10;
+    std::string filter;       // Run only benchmarks whose name contains this
+    std::string jsonPath;     // Write results here
+    std::string baselinePath; // Compare against a previous JSON result
+    double threshold = 10.0;  // Percent slowdown that counts as a regression
+};
+
+struct Result {
+    std::string name;
+    size_t rows = 0;          // Rows produced (or inserted / parsed) per iteration
+    std::vector<double> samples; // Milliseconds per iteration, sorted
+
+    double percentile(double p) const {
+        size_t rank = static_cast<size_t>(p / 100.0 * samples.size() + 0.5);
+        return samples[std::min(samples.size() - 1, rank > 0 ? rank - 1 : 0)];
+    }
+    double mean() const {
+        double sum = 0;
+        for (double s : samples) sum += s;
+        return sum / samples.size();
+    }
+    double rowsPerSecond() const { return rows / (percentile(50) / 1000.0); }
+};
+
+double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Runs `body` once to warm up, then `iterations` timed times. `body` returns
+// the number of rows it processed.
+Result measure(const std::string& name, int iterations, const std::function<size_t()>& body) {
+    Result result;
+    result.name = name;
+    result.rows = body();
+    for (int i = 0; i < iterations; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        result.samples.push_back(elapsedMs(start));
+    }
+    std::sort(result.samples.begin(), result.samples.end());
+    return result;
+}
+
+// Drains a plan without collecting its rows
+size_t drain(QueryPlanNode& plan) {
+    size_t rows = 0;
+    plan.open();
+    RowBatch batch;
+    while (plan.next(batch)) {
+        rows += batch.size();
+    }
+    return rows;
+}
+
+std::unique_ptr<QueryPlanNode> plan(const std::string& sql, const Database& db) {
+    auto result = SQLParser::parse(sql, db);
+    if (!result) {
+        std::cerr << "Failed to plan benchmark query: " << sql << std::endl;
+        std::exit(1);
+    }
+    return result;
+}
+
+std::vector<Result> runSuite(const Options& options, Database& db, const TpchGenerator& generator) {
+    std::vector<Result> results;
+    auto wanted = [&options](const std::string& name) {
+        return options.filter.empty() || name.find(options.filter) != std::string::npos;
+    };
+    auto query = [&](const std::string& name, const std::string& sql) {
+        if (!wanted(name)) return;
+        auto p = plan(sql, db);
+        results.push_back(measure(name, options.iterations, [&p] { return drain(*p); }));
+    };
+
+    query("scan.lineitem", "SELECT * FROM lineitem");
+    query("filter.lineitem_selective",
+          "SELECT l_orderkey, l_extendedprice FROM lineitem WHERE l_quantity < 5 AND l_shipmode = 'AIR'");
+    query("filter.lineitem_wide",
+          "SELECT l_orderkey FROM lineitem WHERE l_shipdate >= 100 AND l_discount <= 0.08");
+    query("join.orders_customer",
+          "SELECT o.o_orderkey, c.c_name FROM orders o JOIN customer c ON o.o_custkey = c.c_custkey "
+          "WHERE c.c_mktsegment = 'BUILDING'");
+    query("join.lineitem_orders_customer",
+          "SELECT l.l_extendedprice, c.c_name FROM lineitem l JOIN orders o ON l.l_orderkey = o.o_orderkey "
+          "JOIN customer c ON o.o_custkey = c.c_custkey WHERE o.o_orderstatus = 'F' AND l.l_quantity > 45");
+
+    query("aggregate.lineitem_by_flag",
+          "SELECT l_returnflag, SUM(l_extendedprice) FROM lineitem WHERE l_shipdate <= 2300 GROUP BY l_returnflag");
+
+    if (wanted("insert.customer")) {
+        const size_t count = generator.customerCount();
+        results.push_back(measure("insert.customer", options.iterations, [count] {
+            Database scratch;
+            scratch.createTable("customer", TpchGenerator::customerSchema());
+            Random rng(TpchGenerator::kDefaultSeed);
+            for (size_t c = 1; c <= count; ++c) {
+                scratch.insertInto("customer", TpchGenerator::customerRow(static_cast<int>(c), rng));
+            }
+            return count;
+        }));
+    }
+
+    // Parse latency: each iteration parses a fixed number of statements
+    const size_t kParses = 200;
+    if (wanted("parse.select_join")) {
+        const std::string sql =
+            "SELECT l.l_extendedprice, c.c_name FROM lineitem l JOIN orders o ON l.l_orderkey = o.o_orderkey "
+            "JOIN customer c ON o.o_custkey = c.c_custkey WHERE o.o_orderstatus = 'F' AND l.l_quantity > 45";
+        results.push_back(measure("parse.select_join", options.iterations, [&] {
+            for (size_t i = 0; i < kParses; ++i) plan(sql, db);
+            return kParses;
+        }));
+    }
+    if (wanted("parse.insert")) {
+        const std::string sql =
+            "INSERT INTO customer VALUES (42, 'Customer#000000042', 7, 1234.56, 'MACHINERY')";
+        results.push_back(measure("parse.insert", options.iterations, [&] {
+            for (size_t i = 0; i < kParses; ++i) DMLParser::parseInsert(sql);
+            return kParses;
+        }));
+    }
+    return results;
+}
+
+void printResults(const std::vector<Result>& results) {
+    std::cout << std::left << std::setw(32) << "benchmark" << std::right
+              << std::setw(10) << "rows" << std::setw(11) << "p50 ms" << std::setw(11) << "p90 ms"
+              << std::setw(11) << "p99 ms" << std::setw(11) << "max ms" << std::setw(15) << "rows/s" << "\n";
+    std::cout << std::fixed;
+    for (const auto& r : results) {
+        std::cout << std::left << std::setw(32) << r.name << std::right << std::setw(10) << r.rows
+                  << std::setprecision(3) << std::setw(11) << r.percentile(50) << std::setw(11) << r.percentile(90)
+                  << std::setw(11) << r.percentile(99) << std::setw(11) << r.samples.back()
+                  << std::setprecision(0) << std::setw(15) << r.rowsPerSecond() << "\n";
+    }
+}
+
+// One benchmark object per line, so baselines can be read back line by line
+void writeJson(const std::string& path, const Options& options, const std::vector<Result>& results) {
+    std::ofstream out(path);
+    out << std::setprecision(6);
+    out << "{\"scale\": " << options.scale << ", \"iterations\": " << options.iterations << ", \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        out << "  {\"name\": \"" << r.name << "\", \"rows\": " << r.rows
+            << ", \"min_ms\": " << r.samples.front() << ", \"p50_ms\": " << r.percentile(50)
+            << ", \"p90_ms\": " << r.percentile(90) << ", \"p99_ms\": " << r.percentile(99)
+            << ", \"max_ms\": " << r.samples.back() << ", \"mean_ms\": " << r.mean()
+            << ", \"rows_per_sec\": " << r.rowsPerSecond() << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "]}\n";
+}
+
+// Reads benchmark name -> p50 from a file written by writeJson()
+std::map<std::string, double> readBaseline(const std::string& path) {
+    std::map<std::string, double> baseline;
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "Cannot read baseline " << path << std::endl;
+        std::exit(1);
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t name = line.find("\"name\": \"");
+        size_t p50 = line.find("\"p50_ms\": ");
+        if (name == std::string::npos || p50 == std::string::npos) continue;
+        name += 9;
+        baseline[line.substr(name, line.find('"', name) - name)] = std::atof(line.c_str() + p50 + 10);
+    }
+    return baseline;
+}
+
+// Prints p50 deltas against the baseline; returns false if any regressed
+bool compareBaseline(const std::vector<Result>& results, const std::map<std::string, double>& baseline,
+                     double threshold) {
+    bool ok = true;
+    std::cout << "\n" << std::left << std::setw(32) << "benchmark" << std::right << std::setw(13)
+              << "baseline ms" << std::setw(11) << "p50 ms" << std::setw(10) << "change" << "\n";
+    for (const auto& r : results) {
+        auto it = baseline.find(r.name);
+        if (it == baseline.end() || it->second <= 0) continue;
+        double change = (r.percentile(50) - it->second) / it->second * 100.0;
+        bool regressed = change > threshold;
+        ok = ok && !regressed;
+        std::cout << std::left << std::setw(32) << r.name << std::right << std::fixed << std::setprecision(3)
+                  << std::setw(13) << it->second << std::setw(11) << r.percentile(50)
+                  << std::setprecision(1) << std::setw(9) << std::showpos << change << "%" << std::noshowpos
+                  << (regressed ? "  REGRESSION" : "") << "\n";
+    }
+    return ok;
+}
+
+void usage() {
+    std::cout << "Usage: ParallaxDB_bench [--scale SF] [--iterations N] [--filter NAME]\n"
+                 "                        [--json FILE] [--baseline FILE] [--threshold PCT]\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                usage();
+                std::exit(1);
+            }
+            return argv[++i];
+        };
+        if (arg == "--scale") options.scale = std::atof(value().c_str());
+        else if (arg == "--iterations") options.iterations = std::max(1, std::atoi(value().c_str()));
+        else if (arg == "--filter") options.filter = value();
+        else if (arg == "--json") options.jsonPath = value();
+        else if (arg == "--baseline") options.baselinePath = value();
+        else if (arg == "--threshold") options.threshold = std::atof(value().c_str());
+        else {
+            usage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+#ifndef NDEBUG
+    std::cout << "Warning: assertions are enabled; build with -DCMAKE_BUILD_TYPE=Release for meaningful numbers\n";
+#endif
+    Database db;
+    TpchGenerator generator(options.scale);
+    auto start = std::chrono::steady_clock::now();
+    size_t rows = generator.populate(db);
+    std::cout << "Generated " << rows << " rows at scale " << options.scale << " in "
+              << std::fixed << std::setprecision(1) << elapsedMs(start) << " ms\n";
+    for (const char* table : {"nation", "customer", "orders", "lineitem"}) {
+        db.analyzeTable(table);
+    }
+
+    std::vector<Result> results = runSuite(options, db, generator);
+    printResults(results);
+    if (!options.jsonPath.empty()) {
+        writeJson(options.jsonPath, options, results);
+    }
+    if (!options.baselinePath.empty()) {
+        return compareBaseline(results, readBaseline(options.baselinePath), options.threshold) ? 0 : 2;
+    }
+    return 0;
+}
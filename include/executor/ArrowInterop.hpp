@@ -0,0 +1,74 @@
+#pragma once
+
+#include "../planner/QueryPlan.hpp"
+#include "../storage/Database.hpp"
+#include "../types/Common.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Arrow C Data Interface (https://arrow.apache.org/docs/format/CDataInterface.html).
+// The ABI is these two structs; the guard lets the definitions coexist with
+// Arrow's own headers.
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+extern "C" {
+
+struct ArrowSchema {
+    const char* format;
+    const char* name;
+    const char* metadata;
+    int64_t flags;
+    int64_t n_children;
+    struct ArrowSchema** children;
+    struct ArrowSchema* dictionary;
+    void (*release)(struct ArrowSchema*);
+    void* private_data;
+};
+
+struct ArrowArray {
+    int64_t length;
+    int64_t null_count;
+    int64_t offset;
+    int64_t n_buffers;
+    int64_t n_children;
+    const void** buffers;
+    struct ArrowArray** children;
+    struct ArrowArray* dictionary;
+    void (*release)(struct ArrowArray*);
+    void* private_data;
+};
+
+} // extern "C"
+
+#endif // ARROW_C_DATA_INTERFACE
+
+namespace parallaxdb {
+
+// Exports rows as an Arrow struct array (the C Data Interface form of a
+// record batch) with one child per column. Column types are inferred from
+// the values: INT -> int32, DOUBLE (or INT mixed with DOUBLE) -> float64,
+// STRING -> utf8 (other values in the column are rendered as text), and an
+// all-NULL column -> null. The buffers are built once and owned by the
+// exported structs; consumers read them in place and must call release().
+void exportArrow(const std::vector<Row>& rows, const std::vector<std::string>& columns,
+                 ArrowSchema* schema, ArrowArray* array);
+
+inline void exportArrow(const RowBatch& batch, const std::vector<std::string>& columns,
+                        ArrowSchema* schema, ArrowArray* array) {
+    exportArrow(batch.rows, columns, schema, array);
+}
+
+// Creates table `tableName` from an Arrow struct array and its schema.
+// Supported child formats: int8/16/32 and in-range int64 (INT), float32/64
+// (DOUBLE), utf8 and large utf8 (STRING), bool (BOOLEAN) and null. Both
+// structs are released on return, as the C Data Interface requires of a
+// consumer. Returns the number of rows imported.
+size_t importArrowTable(Database& db, const std::string& tableName, ArrowSchema* schema, ArrowArray* array);
+
+} // namespace parallaxdb
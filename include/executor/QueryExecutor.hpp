@@ -1,6 +1,8 @@
 #pragma once
 #include "../planner/QueryPlan.hpp"
 #include "../planner/FilterNode.hpp"
+#include "ArrowInterop.hpp"
+#include "ResultSink.hpp"
 #include "../types/Common.hpp"
 #include <iostream>
 #include <variant>
@@ -10,10 +12,26 @@ namespace parallaxdb {
 
 
 
+enum class ExplainFormat { TEXT, JSON };
+
 // QueryExecutor class declaration
 class QueryExecutor {
 public:
     static std::vector<Row> execute(const QueryPlanNode& plan);
+
+    // Streams the plan's result batches into `sink`; returns the row count.
+    // Column names are shown unqualified where that is unambiguous.
+    static size_t execute(const QueryPlanNode& plan, ResultSink& sink);
+
+    // Runs the plan and exports the whole result as one Arrow struct array
+    static size_t exportArrow(const QueryPlanNode& plan, ArrowSchema* schema, ArrowArray* array);
+
+    // The plan's output column names, unqualified where that is unambiguous
+    static std::vector<std::string> displayColumns(const QueryPlanNode& plan);
+
+    // Runs the plan with profiling enabled, discarding its rows, and renders
+    // the plan with per-operator measurements (EXPLAIN ANALYZE)
+    static std::string explainAnalyze(QueryPlanNode& plan, ExplainFormat format = ExplainFormat::TEXT);
 };
 
 } // namespace parallaxdb 
\ No newline at end of file
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "ResultSink.hpp"
+#include "../storage/Database.hpp"
+#include "../types/Common.hpp"
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace parallaxdb {
+
+// A query's normalized text with its literals pulled out: keywords are
+// upper-cased, whitespace collapsed and every literal replaced by '?', so
+// "select id from t where x = 5" and "SELECT id  FROM t WHERE x=7" share a
+// shape.
+struct QueryFingerprint {
+    std::string shape;
+    std::vector<Value> literals;
+    bool cacheable = false;   // False if the query did not tokenize
+
+    // Shape plus literals: equal keys mean the same query
+    std::string key() const;
+};
+
+QueryFingerprint fingerprintQuery(const std::string& query);
+
+struct ResultCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t invalidations = 0;   // Entries dropped because a table changed
+    uint64_t evictions = 0;       // Entries dropped to stay under the cap
+    size_t entries = 0;
+    size_t bytes = 0;
+};
+
+// ResultCache: Results of SELECTs keyed by query fingerprint. Each entry
+// records the version of every table its query read (Table::getVersion());
+// a lookup only hits if none of them has changed since, so writes and DDL
+// invalidate entries without the cache being told.
+//
+// Memory is capped at `capacityBytes`. Eviction is GreedyDual-Size: an
+// entry's priority is the clock value when it was last used plus its
+// execution time per byte, so cheap-to-recompute and bulky results go
+// first, and the clock advances to each evicted priority to age the rest.
+class ResultCache {
+public:
+    static constexpr size_t kDefaultCapacityBytes = 64 << 20;
+    // Results larger than this share of the capacity are not cached
+    static constexpr double kMaxEntryShare = 0.25;
+
+    struct Entry {
+        std::vector<std::string> columns;
+        std::vector<Row> rows;
+        std::vector<std::pair<std::string, uint64_t>> tableVersions;
+        double costNanos = 0.0;   // Execution time that produced the rows
+        size_t bytes = 0;
+        double priority = 0.0;
+    };
+
+    ResultCache() : ResultCache(kDefaultCapacityBytes) {}
+    explicit ResultCache(size_t capacityBytes) : capacityBytes(capacityBytes) {}
+
+    // The cached result for `key` if every table it read is unchanged in
+    // `db`. Stale entries are dropped. The pointer is valid until the next
+    // call that modifies the cache.
+    const Entry* lookup(const std::string& key, const Database& db);
+
+    // Caches a result; skipped if it is too large
+    void insert(const std::string& key, Entry entry);
+
+    // Whether a result of `bytes` bytes would be cached
+    bool fits(size_t bytes) const { return bytes <= kMaxEntryShare * capacityBytes; }
+
+    void setCapacity(size_t bytes);
+    size_t getCapacity() const { return capacityBytes; }
+    void clear();
+    ResultCacheStats getStats() const;
+
+    // Approximate heap footprint of cached rows
+    static size_t rowBytes(const Row& row);
+
+private:
+    size_t capacityBytes;
+    size_t bytes = 0;
+    double clock = 0.0;
+    ResultCacheStats stats;
+    std::unordered_map<std::string, Entry> entries;
+    mutable std::mutex mutex;
+
+    void evictTo(size_t limit);
+    void erase(std::unordered_map<std::string, Entry>::iterator it);
+};
+
+// ResultSink that forwards to another sink while keeping a copy of the
+// rows, until they outgrow `limitBytes`
+class RecordingSink : public ResultSink {
+public:
+    RecordingSink(ResultSink& target, size_t limitBytes) : target(target), limitBytes(limitBytes) {}
+
+    void begin(const std::vector<std::string>& columns) override;
+    void consume(const RowBatch& batch) override;
+    void finish() override { target.finish(); }
+
+    // False if the result outgrew the limit and was not kept
+    bool complete() const { return !overflowed; }
+    std::vector<std::string>& getColumns() { return columns; }
+    std::vector<Row>& getRows() { return rows; }
+    size_t getBytes() const { return bytes; }
+
+private:
+    ResultSink& target;
+    size_t limitBytes;
+    std::vector<std::string> columns;
+    std::vector<Row> rows;
+    size_t bytes = 0;
+    bool overflowed = false;
+};
+
+} // namespace parallaxdb
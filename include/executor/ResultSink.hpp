@@ -0,0 +1,142 @@
+#pragma once
+
+#include "../planner/QueryPlan.hpp"
+#include "../storage/AsyncIO.hpp"
+#include "../types/Common.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace parallaxdb {
+
+// ResultSink: Receives a query's result one batch at a time. begin() is
+// called once with the output column names, consume() for every batch and
+// finish() after the last one.
+class ResultSink {
+public:
+    virtual ~ResultSink() = default;
+    virtual void begin(const std::vector<std::string>& columns) = 0;
+    virtual void consume(const RowBatch& batch) = 0;
+    virtual void finish() = 0;
+};
+
+// BufferedSink: Base for sinks that serialize into a memory buffer and hand
+// it to the file descriptor in large chunks instead of flushing per row. A
+// full chunk is written asynchronously while the next one is serialized into
+// a second buffer, so formatting overlaps with the write. What is left at
+// the end is written directly, so small results never set up an AsyncIO.
+class BufferedSink : public ResultSink {
+public:
+    static constexpr size_t kFlushBytes = 1 << 20;
+
+    explicit BufferedSink(int fd) : fd(fd) { buffer.reserve(kFlushBytes + 4096); }
+    ~BufferedSink() override;
+
+    void finish() override { flush(); }
+
+    // Total bytes written so far
+    size_t getBytesWritten() const { return bytesWritten; }
+
+protected:
+    std::string buffer;
+
+    // Starts writing the buffer out once it has grown past kFlushBytes
+    void maybeFlush() {
+        if (buffer.size() >= kFlushBytes) startWrite();
+    }
+    // Writes out everything buffered and waits until it is written
+    void flush();
+
+private:
+    int fd;
+    size_t bytesWritten = 0;
+    std::unique_ptr<AsyncIO> io;   // Created by the first full chunk
+    std::string writing;           // The chunk being written
+    size_t writeOffset = 0;        // Bytes of it written so far
+    AsyncIO::Ticket ticket = 0;    // Outstanding write, or 0
+
+    void startWrite();
+    void completeWrite();
+};
+
+// Aligned text table, like the interactive shell prints. Column widths are
+// taken from the first kWidthSampleRows rows; later rows are streamed with
+// those widths.
+class TextTableSink : public BufferedSink {
+public:
+    static constexpr size_t kWidthSampleRows = 1000;
+
+    explicit TextTableSink(int fd) : BufferedSink(fd) {}
+    void begin(const std::vector<std::string>& columns) override;
+    void consume(const RowBatch& batch) override;
+    void finish() override;
+
+private:
+    std::vector<std::string> columns;
+    std::vector<size_t> widths;
+    std::vector<std::vector<std::string>> pending; // Rows held until widths are fixed
+    bool widthsFixed = false;
+    size_t rowCount = 0;
+
+    void fixWidths();
+    void appendRow(const std::vector<std::string>& cells);
+};
+
+// RFC 4180 CSV with a header row. NULL is written as an empty field.
+class CsvSink : public BufferedSink {
+public:
+    explicit CsvSink(int fd) : BufferedSink(fd) {}
+    void begin(const std::vector<std::string>& columns) override;
+    void consume(const RowBatch& batch) override;
+};
+
+// Newline-delimited JSON: one object per row keyed by column name
+class NdjsonSink : public BufferedSink {
+public:
+    explicit NdjsonSink(int fd) : BufferedSink(fd) {}
+    void begin(const std::vector<std::string>& columns) override;
+    void consume(const RowBatch& batch) override;
+
+private:
+    std::vector<std::string> keys; // Pre-rendered "\"name\":" prefixes
+};
+
+// Compact binary columnar stream. All integers are in host byte order.
+//
+//   stream := "PXCB" u32 version u32 columnCount {u32 length, name bytes}
+//             block* u32 0
+//   block  := u32 rowCount column[columnCount]
+//   column := u8 type, validity bitmap (ceil(rows/8) bytes, bit set = not
+//             NULL), then by type:
+//               INT     int32[rows]
+//               DOUBLE  f64[rows]
+//               STRING  u32 offsets[rows + 1], bytes
+//               NULLS   nothing (every value is NULL)
+//               MIXED   per row: u8 tag (a ColumnType), then its payload
+//
+// A batch becomes one block; each column takes the type shared by all its
+// non-NULL values, or MIXED.
+class BinaryColumnarSink : public BufferedSink {
+public:
+    static constexpr uint32_t kVersion = 1;
+    enum class ColumnType : uint8_t { NULLS = 0, INT = 1, DOUBLE = 2, STRING = 3, MIXED = 4 };
+
+    explicit BinaryColumnarSink(int fd) : BufferedSink(fd) {}
+    void begin(const std::vector<std::string>& columns) override;
+    void consume(const RowBatch& batch) override;
+    void finish() override;
+
+private:
+    size_t columnCount = 0;
+};
+
+// Reads a BinaryColumnarSink stream back into rows; throws on malformed input
+std::vector<Row> decodeBinaryColumnar(const std::string& data, std::vector<std::string>* columns = nullptr);
+
+enum class ResultFormat { TABLE, CSV, NDJSON, BINARY };
+
+// Accepts "table", "csv", "ndjson"/"json" and "binary" (case-insensitive)
+ResultFormat parseResultFormat(const std::string& name);
+std::unique_ptr<ResultSink> makeResultSink(ResultFormat format, int fd);
+
+} // namespace parallaxdb
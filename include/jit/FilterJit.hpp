@@ -0,0 +1,115 @@
+#pragma once
+
+#include "../parser/Expression.hpp"
+#include "../types/CompactValue.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace parallaxdb {
+
+// FilterJit: Tiered execution of scan predicates. A predicate is reduced to
+// its shape (the comparisons, AND/OR structure and row width, without the
+// literal values) and looked up in a process-wide cache. Scans start on the
+// interpreted ConjunctFilter while a background thread compiles the shape
+// with LLVM ORC; they switch to the native function at the next block once
+// it is ready. Shapes that were compiled before start compiled, whatever
+// their literals.
+//
+// A shape is compiled once it is hot: scanned over many rows, or requested
+// kHotUses times. Comparisons against numbers, NULL and inline strings
+// (equality only) compile; any other conjunct keeps the whole predicate
+// interpreted. Compiled code evaluates the conjuncts in written order, so
+// once a scan switches tiers ConjunctFilter's adaptive order no longer
+// applies.
+class FilterJit {
+public:
+    // Narrows `selection`, `count` row positions into `cells`, in place to
+    // the rows passing the predicate and returns how many remain. `literals`
+    // holds the comparison literals in shape order.
+    using Function = size_t (*)(const CompactValue* cells, uint32_t* selection, size_t count,
+                                const CompactValue* literals);
+
+    static constexpr size_t kHotUses = 2;
+    // Most shapes compiled; later ones stay interpreted
+    static constexpr size_t kMaxEntries = 1024;
+
+    struct Node {
+        enum class Type { COMPARE, AND, OR, NEVER };   // NEVER: comparison with NULL
+        Type type;
+        int column = 0;                       // COMPARE
+        CompareOp op = CompareOp::EQ;         // COMPARE
+        CompactValue::Kind literalKind = CompactValue::Kind::NULL_VALUE;
+    };
+
+    struct Shape {
+        std::vector<Node> nodes;              // Prefix order; literal i belongs to the i-th COMPARE
+        size_t width = 0;                     // Cells per row
+        std::string key;
+        std::vector<CompactValue> literals;   // This predicate's; not part of the shape
+    };
+
+    class Entry {
+    public:
+        // The compiled function; null until compiled, or if compiling failed
+        Function get() const { return function.load(std::memory_order_acquire); }
+        double getCompileNanos() const { return compileNanos.load(std::memory_order_acquire); }
+
+    private:
+        friend class FilterJit;
+        std::vector<Node> nodes;
+        size_t width = 0;
+        std::atomic<Function> function{nullptr};
+        std::atomic<double> compileNanos{0.0};
+        size_t uses = 0;
+        bool queued = false;
+        bool compiled = false;                // Guarded by FilterJit::mutex
+    };
+
+    struct Lookup {
+        std::shared_ptr<const Entry> entry;   // Null when tiering is disabled or the cache is full
+        bool compiled = false;                // Compiled before this request was made
+    };
+
+    // The shape of the conjunction of `conjuncts` (bound to rows `width`
+    // cells wide), or nullopt if one of them cannot be compiled
+    static std::optional<Shape> describe(const std::vector<std::unique_ptr<Expression>>& conjuncts, size_t width);
+
+    static FilterJit& instance();
+
+    // The cache entry for `shape`, and whether it was already compiled. A
+    // hot request, or the kHotUses-th request, queues its compilation.
+    Lookup request(const Shape& shape, bool hot);
+
+    // Off: scans stay interpreted and nothing more is compiled
+    void setEnabled(bool on) { enabled.store(on); }
+    bool isEnabled() const { return enabled.load(); }
+    // Waits until every queued shape has been compiled
+    void waitIdle();
+    size_t getCompiledCount() const { return compiledCount.load(); }
+
+private:
+    struct Compiler;
+
+    std::mutex mutex;
+    std::condition_variable queuedOrDone;
+    std::unordered_map<std::string, std::shared_ptr<Entry>> cache;
+    std::deque<std::shared_ptr<Entry>> queue;
+    size_t compiling = 0;                 // Queued or being compiled
+    std::atomic<bool> enabled{true};
+    std::atomic<size_t> compiledCount{0};
+    std::unique_ptr<Compiler> compiler;   // Owned by the compiler thread
+    bool started = false;                 // Compiler thread running
+
+    FilterJit() = default;
+    void run();
+};
+
+} // namespace parallaxdb
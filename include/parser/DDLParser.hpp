@@ -24,12 +24,43 @@ struct DropTableStatement {
     DropTableStatement(const std::string& name) : tableName(name) {}
 };
 
+// CREATE MATERIALIZED VIEW name AS SELECT ... FROM base [WHERE ...] [GROUP BY ...]
+struct CreateViewStatement {
+    std::string viewName;
+    ViewDefinition definition;
+};
+
+// CREATE INDEX name ON table USING TRIGRAM (column)
+struct CreateIndexStatement {
+    std::string indexName;
+    std::string tableName;
+    std::string column;
+};
+
+// ALTER TABLE name DROP PARTITION n
+struct AlterTableStatement {
+    std::string tableName;
+    size_t partition = 0;
+};
+
+struct AnalyzeStatement {
+    std::string tableName; // Empty: analyze every table
+    
+    AnalyzeStatement() : tableName("") {}
+    AnalyzeStatement(const std::string& name) : tableName(name) {}
+};
+
 class DDLParser {
 public:
     static std::unique_ptr<CreateTableStatement> parseCreateTable(const std::string& query);
     static std::unique_ptr<DropTableStatement> parseDropTable(const std::string& query);
+    static std::unique_ptr<CreateViewStatement> parseCreateMaterializedView(const std::string& query);
+    static std::unique_ptr<CreateIndexStatement> parseCreateIndex(const std::string& query);
+    static std::unique_ptr<AlterTableStatement> parseAlterTable(const std::string& query);
+    static std::unique_ptr<AnalyzeStatement> parseAnalyze(const std::string& query);
     
 private:
+    static PartitionSpec parsePartitioning(const std::vector<Token>& tokens, size_t& pos);
     static Schema parseTableSchema(const std::vector<Token>& tokens, size_t& pos);
     static Column parseColumnDefinition(const std::vector<Token>& tokens, size_t& pos);
     static std::vector<Constraint> parseConstraints(const std::vector<Token>& tokens, size_t& pos);
@@ -4,6 +4,7 @@
 #include "Token.hpp"
 #include "../storage/Database.hpp"
 #include "../types/Common.hpp"
+#include "Expression.hpp"
 #include <memory>
 #include <stdexcept>
 
@@ -18,14 +19,28 @@ struct InsertStatement {
     InsertStatement(const std::string& name) : tableName(name) {}
 };
 
+struct UpdateStatement {
+    std::string tableName;
+    std::vector<std::pair<std::string, Value>> assignments;  // SET column = value
+    std::unique_ptr<Expression> where;                        // nullptr: every row
+};
+
+struct DeleteStatement {
+    std::string tableName;
+    std::unique_ptr<Expression> where;                        // nullptr: every row
+};
+
 class DMLParser {
 public:
     static std::unique_ptr<InsertStatement> parseInsert(const std::string& query);
+    static std::unique_ptr<UpdateStatement> parseUpdate(const std::string& query);
+    static std::unique_ptr<DeleteStatement> parseDelete(const std::string& query);
     
 private:
     static std::vector<std::string> parseColumnList(const std::vector<Token>& tokens, size_t& pos);
     static std::vector<Value> parseValueList(const std::vector<Token>& tokens, size_t& pos);
     static Value parseValue(const std::vector<Token>& tokens, size_t& pos);
+    static std::unique_ptr<Expression> parseOptionalWhere(const std::vector<Token>& tokens, size_t& pos);
 };
 
 } // namespace parallaxdb 
\ No newline at end of file
@@ -1,24 +1,49 @@
 #pragma once
 #include <string>
 #include <memory>
+#include <vector>
 #include "../types/Common.hpp"
 #include "../storage/Table.hpp"
+#include "../util/Arena.hpp"
 #include "ExpressionEvaluator.hpp"
+#include "PatternMatcher.hpp"
+#include "Token.hpp"
 
 namespace parallaxdb {
 
-struct Expression {
+struct Expression : public ArenaAllocated {
     virtual ~Expression() = default;
     virtual bool evaluate(const Row& row, const Table& table) const = 0;
+
+    // Bound evaluation: bind() resolves column references against the output
+    // columns of the operator feeding this expression, after which evaluate(row)
+    // reads values by position.
+    virtual void bind(const std::vector<std::string>& columns) = 0;
+    virtual bool evaluate(const Row& row) const = 0;
+    // Bound evaluation directly against a table's stored cells
+    virtual bool evaluate(const CompactValue* cells) const = 0;
+
+    virtual void collectColumns(std::vector<std::string>& out) const = 0;
+    virtual std::string toString() const = 0;
 };
 
 struct ComparisonExpr : public Expression {
     std::string column;
     std::string op;
     Value value;
+    int columnIndex = -1;              // Set by bind()
+    CompareOp opCode = CompareOp::EQ;  // Set by bind()
+    CompactValue literal;              // Set by bind(); borrows from value
     ComparisonExpr(const std::string& c, const std::string& o, const Value& v)
         : column(c), op(o), value(v) {}
     bool evaluate(const Row& row, const Table& table) const override;
+    void bind(const std::vector<std::string>& columns) override;
+    bool evaluate(const Row& row) const override;
+    bool evaluate(const CompactValue* cells) const override {
+        return applyComparison(cells[columnIndex], opCode, literal);
+    }
+    void collectColumns(std::vector<std::string>& out) const override { out.push_back(column); }
+    std::string toString() const override;
 };
 
 struct LogicalExpr : public Expression {
@@ -28,6 +53,23 @@ struct LogicalExpr : public Expression {
     LogicalExpr(const std::string& o, std::unique_ptr<Expression> l, std::unique_ptr<Expression> r)
         : op(o), left(std::move(l)), right(std::move(r)) {}
     bool evaluate(const Row& row, const Table& table) const override;
+    void bind(const std::vector<std::string>& columns) override {
+        left->bind(columns);
+        right->bind(columns);
+    }
+    bool evaluate(const Row& row) const override;
+    bool evaluate(const CompactValue* cells) const override {
+        if (op == "AND") return left->evaluate(cells) && right->evaluate(cells);
+        if (op == "OR") return left->evaluate(cells) || right->evaluate(cells);
+        return false;
+    }
+    void collectColumns(std::vector<std::string>& out) const override {
+        left->collectColumns(out);
+        right->collectColumns(out);
+    }
+    std::string toString() const override {
+        return left->toString() + " " + op + " " + right->toString();
+    }
 };
 
 struct ParenExpr : public Expression {
@@ -36,6 +78,82 @@ struct ParenExpr : public Expression {
     bool evaluate(const Row& row, const Table& table) const override {
         return expr->evaluate(row, table);
     }
+    void bind(const std::vector<std::string>& columns) override { expr->bind(columns); }
+    bool evaluate(const Row& row) const override { return expr->evaluate(row); }
+    bool evaluate(const CompactValue* cells) const override { return expr->evaluate(cells); }
+    void collectColumns(std::vector<std::string>& out) const override { expr->collectColumns(out); }
+    std::string toString() const override { return "(" + expr->toString() + ")"; }
 };
 
-} // namespace parallaxdb 
\ No newline at end of file
+// col IN (v1, ..., vN). Up to kLinearMaxValues values are compared in turn;
+// longer lists are bound into an array of value hashes sorted for a
+// branchless binary search, so a row costs O(log N) instead of N comparisons.
+struct InListExpr : public Expression {
+    static constexpr size_t kLinearMaxValues = 8;
+
+    std::string column;
+    std::vector<Value> values;
+    int columnIndex = -1;                // Set by bind()
+    std::vector<CompactValue> literals;  // Set by bind(); borrow from values, in hash order when long
+    std::vector<uint64_t> hashes;        // Set by bind(); sorted, parallel to literals
+    InListExpr(const std::string& c, std::vector<Value> v) : column(c), values(std::move(v)) {}
+    bool evaluate(const Row& row, const Table& table) const override;
+    void bind(const std::vector<std::string>& columns) override;
+    bool evaluate(const Row& row) const override {
+        return contains(CompactValue::borrow(row.values[columnIndex]));
+    }
+    bool evaluate(const CompactValue* cells) const override { return contains(cells[columnIndex]); }
+    void collectColumns(std::vector<std::string>& out) const override { out.push_back(column); }
+    std::string toString() const override;
+
+    bool contains(const CompactValue& cell) const;
+};
+
+enum class PatternOp { LIKE, ILIKE, STARTS_WITH, CONTAINS };
+
+// col [NOT] LIKE | ILIKE 'pattern', STARTS_WITH(col, 'prefix'),
+// CONTAINS(col, 'text'). The pattern is compiled into a PatternMatcher when
+// the expression is built. Non-strings and NULL never match, negated or not.
+struct PatternExpr : public Expression {
+    std::string column;
+    PatternOp op;
+    std::string pattern;
+    bool negated;
+    PatternMatcher matcher;
+    int columnIndex = -1;   // Set by bind()
+    PatternExpr(const std::string& c, PatternOp o, const std::string& p, bool n = false);
+    bool evaluate(const Row& row, const Table& table) const override;
+    void bind(const std::vector<std::string>& columns) override;
+    bool evaluate(const Row& row) const override {
+        const Value& value = row.values[columnIndex];
+        return std::holds_alternative<std::string>(value) &&
+               matcher.matches(std::string_view(std::get<std::string>(value))) != negated;
+    }
+    bool evaluate(const CompactValue* cells) const override {
+        return cells[columnIndex].isString() && matcher.matches(cells[columnIndex]) != negated;
+    }
+    void collectColumns(std::vector<std::string>& out) const override { out.push_back(column); }
+    std::string toString() const override;
+};
+
+// col IN (SELECT ...). The planner turns it into a hash semi-join against the
+// subquery, so it is never evaluated row by row; binding one means it was
+// written somewhere a semi-join cannot replace it, such as under an OR.
+struct InSubqueryExpr : public Expression {
+    std::string column;
+    std::vector<Token> subquery;   // SELECT ... through END_OF_INPUT
+    InSubqueryExpr(const std::string& c, std::vector<Token> q) : column(c), subquery(std::move(q)) {}
+    bool evaluate(const Row&, const Table&) const override { return false; }
+    void bind(const std::vector<std::string>& columns) override;
+    bool evaluate(const Row&) const override { return false; }
+    bool evaluate(const CompactValue*) const override { return false; }
+    void collectColumns(std::vector<std::string>& out) const override { out.push_back(column); }
+    std::string toString() const override;
+};
+
+// Splits an expression into its top-level AND conjuncts (looking through parentheses)
+void splitConjuncts(std::unique_ptr<Expression> expr, std::vector<std::unique_ptr<Expression>>& out);
+// Combines conjuncts back into a left-deep AND chain; returns nullptr for an empty list
+std::unique_ptr<Expression> combineConjuncts(std::vector<std::unique_ptr<Expression>> conjuncts);
+
+} // namespace parallaxdb
@@ -2,6 +2,8 @@
 #include <variant>
 #include <string>
 #include <memory>
+#include "../types/Common.hpp"
+#include "../types/CompactValue.hpp"
 
 namespace parallaxdb {
 
@@ -10,7 +12,14 @@ struct LogicalExpr;
 struct Row;
 class Table;
 
+enum class CompareOp { EQ, NE, LT, GT, LE, GE };
+
+CompareOp parseCompareOp(const std::string& op);
+bool applyComparison(const Value& lhs, CompareOp op, const Value& rhs);
+// Same semantics on stored cells; string mismatches are mostly settled on the prefix
+bool applyComparison(const CompactValue& lhs, CompareOp op, const CompactValue& rhs);
+
 bool evaluateComparison(const ComparisonExpr& expr, const Row& row, const Table& table);
 bool evaluateLogical(const LogicalExpr& expr, const Row& row, const Table& table);
 
-} // namespace parallaxdb 
\ No newline at end of file
+} // namespace parallaxdb
@@ -1,5 +1,7 @@
 #pragma once
 #include "Expression.hpp"
+#include "../planner/Aggregate.hpp"
+#include "../planner/Window.hpp"
 #include "Tokenizer.hpp"
 #include "Token.hpp"
 #include <memory>
@@ -13,11 +15,30 @@ class ExpressionParser {
 public:
     // Parses a WHERE clause expression from tokens starting at pos
     static std::unique_ptr<Expression> parseWhereExpression(const std::vector<Token>& tokens, size_t& pos);
+    // Parses one select-list item: column | FUNC(column) | COUNT(*) |
+    // APPROX_QUANTILE(column, q), each with an optional AS alias
+    static AggregateColumn parseSelectColumn(const std::vector<Token>& tokens, size_t& pos);
+    // Whether the select-list item at pos is FUNC(...) OVER (...)
+    static bool isWindowFunction(const std::vector<Token>& tokens, size_t pos);
+    // Parses FUNC(args) OVER ([PARTITION BY ...] [ORDER BY ...] [ROWS ...]) [AS alias]
+    static WindowSpec parseWindowFunction(const std::vector<Token>& tokens, size_t& pos);
+    // The value of a NUMBER token: INT if it has no decimal point and fits,
+    // else DOUBLE. Every parser, and the result cache's fingerprint, reads
+    // numbers through this.
+    static Value parseNumber(const Token& token);
 
 private:
+    static int64_t parseFrameBound(const std::vector<Token>& tokens, size_t& pos);
+    // A ROWS frame or LAG/LEAD offset: a non-negative integer that fits int64
+    static int64_t parseRowOffset(const Token& token);
     static std::unique_ptr<Expression> parseOr(const std::vector<Token>& tokens, size_t& pos);
     static std::unique_ptr<Expression> parseAnd(const std::vector<Token>& tokens, size_t& pos);
     static std::unique_ptr<Expression> parsePrimary(const std::vector<Token>& tokens, size_t& pos);
+    // "(v1, ..., vN)" or "(SELECT ...)" after col IN
+    static std::unique_ptr<Expression> parseIn(const std::string& column, const std::vector<Token>& tokens, size_t& pos);
+    // STARTS_WITH(column, 'prefix') | CONTAINS(column, 'text')
+    static std::unique_ptr<Expression> parseStringFunction(const std::vector<Token>& tokens, size_t& pos);
+    static Value parseLiteral(const std::vector<Token>& tokens, size_t& pos);
 };
 
 } // namespace parallaxdb 
\ No newline at end of file
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "../types/CompactValue.hpp"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace parallaxdb {
+
+// PatternMatcher: A string predicate compiled once per query instead of
+// interpreted per row. LIKE patterns ('%' matches any run, '_' any one
+// character, '\' escapes the next character) are classified when compiled:
+//
+//   EXACT     'abc'      length check, then memcmp
+//   PREFIX    'abc%'     memcmp of the head
+//   SUFFIX    '%abc'     memcmp of the tail
+//   CONTAINS  '%abc%'    memchr for the first byte, memcmp to verify
+//   SEGMENTS  'a%b%c'    anchored head and tail, middle pieces found left to right
+//   NFA       'a_c%'     bit-parallel NFA, one machine word of states
+//
+// Case-insensitive matchers (ILIKE) fold ASCII letters. On stored cells, the
+// length and the inline string prefix are checked before a long string's
+// pointer is followed.
+class PatternMatcher {
+public:
+    enum class Strategy { EXACT, PREFIX, SUFFIX, CONTAINS, SEGMENTS, NFA };
+
+    // Patterns using '_' compile to an NFA of at most this many elements
+    static constexpr size_t kMaxNfaElements = 63;
+
+    PatternMatcher() = default;
+    static PatternMatcher like(std::string_view pattern, bool foldCase = false);
+    static PatternMatcher startsWith(std::string_view prefix);
+    static PatternMatcher contains(std::string_view needle);
+
+    Strategy getStrategy() const { return strategy; }
+    // Literal pieces every matching string contains, for index lookups;
+    // empty for case-insensitive matchers
+    std::vector<std::string> getRequiredLiterals() const;
+    bool matches(std::string_view text) const;
+    bool matches(const CompactValue& cell) const;
+
+private:
+    Strategy strategy = Strategy::EXACT;
+    bool foldCase = false;
+    // Literal pieces between '%'s (lowercase when folding case). NFA
+    // patterns keep their runs between wildcards here, but do not match by them.
+    std::vector<std::string> segments;
+    bool anchoredStart = true;
+    bool anchoredEnd = true;
+    size_t minLength = 0;                // Shortest text that can match
+
+    // NFA: state i means the first i elements matched
+    size_t elementCount = 0;
+    uint64_t anyRunMask = 0;             // Elements that are '%'
+    std::vector<uint64_t> byteMasks;     // Per byte: elements it satisfies
+
+    void classify();
+    bool equalAt(std::string_view text, size_t at, std::string_view literal) const;
+    size_t find(std::string_view text, std::string_view needle, size_t from) const;
+    bool matchSegments(std::string_view text) const;
+    bool matchNfa(std::string_view text) const;
+};
+
+} // namespace parallaxdb
@@ -3,7 +3,10 @@
 #include "Tokenizer.hpp"
 #include "Expression.hpp"
 #include "../planner/FilterNode.hpp"
+#include "../planner/LogicalPlan.hpp"
+#include "../planner/Optimizer.hpp"
 #include "../storage/Table.hpp"
+#include "../storage/Database.hpp"
 #include <memory>
 #include <vector>
 #include <functional>
@@ -17,9 +20,13 @@ namespace parallaxdb {
 
 struct SelectClause {
     std::vector<std::string> columns;
+    std::vector<AggregateColumn> items;  // The list as written, aggregates included
+    std::vector<WindowSpec> windows;     // Window functions; their items name the window's output
     bool selectAll;
+    bool hasAggregates;
+    bool distinct;
     
-    SelectClause() : selectAll(false) {}
+    SelectClause() : selectAll(false), hasAggregates(false), distinct(false) {}
 };
 
 struct WhereClause {
@@ -31,19 +38,40 @@ struct WhereClause {
     WhereClause() : logicalOp("") {}
 };
 
+struct TableRef {
+    std::string name;
+    std::string alias;                         // Defaults to the table name
+    std::vector<JoinCondition> joinConditions; // ON conditions; empty for the first table
+    TableSample sample;
+};
+
 struct ParsedQuery {
     SelectClause select;
     std::string tableName;
+    std::vector<TableRef> tables;
     std::vector<WhereClause> whereConditions; // old
     std::unique_ptr<Expression> whereExpr; // new
+    std::vector<std::string> groupBy;
 };
 
+using TableResolver = std::function<const Table*(const std::string&)>;
+
 class SQLParser {
 public:
+    // Plans a query against a single table; table names in the query are not checked
     static std::unique_ptr<QueryPlanNode> parse(const std::string& query, const Table& table) {
+        return parse(query, [&table](const std::string&) { return &table; });
+    }
+    
+    // Plans a query against the tables of a database
+    static std::unique_ptr<QueryPlanNode> parse(const std::string& query, const Database& db) {
+        return parse(query, [&db](const std::string& name) { return db.getTable(name); });
+    }
+    
+    static std::unique_ptr<QueryPlanNode> parse(const std::string& query, const TableResolver& resolver) {
         try {
             ParsedQuery parsed = parseQuery(query);
-            return buildQueryPlan(parsed, table);
+            return buildQueryPlan(parsed, resolver);
         } catch (const std::exception& e) {
             // Enhanced error reporting
             const char* what = e.what();
@@ -69,8 +97,10 @@ public:
 private:
     static ParsedQuery parseQuery(const std::string& query) {
         Tokenizer tokenizer(query);
-        auto tokens = tokenizer.tokenize();
-        
+        return parseQuery(tokenizer.tokenize());
+    }
+    
+    static ParsedQuery parseQuery(const std::vector<Token>& tokens) {
         ParsedQuery result;
         size_t pos = 0;
         
@@ -89,11 +119,27 @@ private:
         }
         pos++;
         
-        if (pos >= tokens.size() || tokens[pos].type != TokenType::IDENTIFIER) {
-            throw std::runtime_error("Expected table name [pos=" + std::to_string(tokens[pos].position) + "]");
+        result.tables.push_back(parseTableRef(tokens, pos));
+        result.tableName = result.tables[0].name;
+        
+        // Parse JOIN clauses (optional)
+        while (pos < tokens.size() && (tokens[pos].type == TokenType::JOIN || tokens[pos].type == TokenType::INNER)) {
+            if (tokens[pos].type == TokenType::INNER) {
+                pos++;
+                if (pos >= tokens.size() || tokens[pos].type != TokenType::JOIN) {
+                    throw std::runtime_error("Expected JOIN [pos=" + std::to_string(tokens[pos].position) + "]");
+                }
+            }
+            pos++;
+            
+            TableRef joined = parseTableRef(tokens, pos);
+            if (pos >= tokens.size() || tokens[pos].type != TokenType::ON) {
+                throw std::runtime_error("Expected ON [pos=" + std::to_string(tokens[pos].position) + "]");
+            }
+            pos++;
+            joined.joinConditions = parseJoinConditions(tokens, pos);
+            result.tables.push_back(joined);
         }
-        result.tableName = tokens[pos].value;
-        pos++;
         
         // Parse WHERE clause (optional)
         if (pos < tokens.size() && tokens[pos].type == TokenType::WHERE) {
@@ -101,9 +147,116 @@ private:
             result.whereExpr = ExpressionParser::parseWhereExpression(tokens, pos);
         }
         
+        // Parse GROUP BY clause (optional)
+        if (isWord(tokens, pos, "GROUP")) {
+            pos++;
+            if (!isWord(tokens, pos, "BY")) {
+                throw std::runtime_error("Expected BY [pos=" + std::to_string(tokens[pos].position) + "]");
+            }
+            pos++;
+            while (true) {
+                if (pos >= tokens.size() || tokens[pos].type != TokenType::IDENTIFIER) {
+                    throw std::runtime_error("Expected GROUP BY column [pos=" + std::to_string(tokens[pos].position) + "]");
+                }
+                result.groupBy.push_back(tokens[pos].value);
+                pos++;
+                if (pos < tokens.size() && tokens[pos].type == TokenType::COMMA) {
+                    pos++;
+                } else {
+                    break;
+                }
+            }
+        }
+        
         return result;
     }
     
+    static TableRef parseTableRef(const std::vector<Token>& tokens, size_t& pos) {
+        TableRef ref;
+        if (pos >= tokens.size() || tokens[pos].type != TokenType::IDENTIFIER) {
+            throw std::runtime_error("Expected table name [pos=" + std::to_string(tokens[pos].position) + "]");
+        }
+        ref.name = tokens[pos].value;
+        ref.alias = ref.name;
+        pos++;
+        
+        // Optional alias: "users u" or "users AS u"
+        if (pos < tokens.size() && tokens[pos].type == TokenType::AS) {
+            pos++;
+            if (pos >= tokens.size() || tokens[pos].type != TokenType::IDENTIFIER) {
+                throw std::runtime_error("Expected alias [pos=" + std::to_string(tokens[pos].position) + "]");
+            }
+        }
+        if (pos < tokens.size() && tokens[pos].type == TokenType::IDENTIFIER &&
+            !isWord(tokens, pos, "TABLESAMPLE") && !isWord(tokens, pos, "GROUP")) {
+            ref.alias = tokens[pos].value;
+            pos++;
+        }
+        
+        // Optional TABLESAMPLE BERNOULLI|SYSTEM (percent) [REPEATABLE (seed)]
+        if (isWord(tokens, pos, "TABLESAMPLE")) {
+            pos++;
+            if (isWord(tokens, pos, "BERNOULLI")) {
+                ref.sample.method = TableSample::BERNOULLI;
+            } else if (isWord(tokens, pos, "SYSTEM")) {
+                ref.sample.method = TableSample::SYSTEM;
+            } else {
+                throw std::runtime_error("Expected BERNOULLI or SYSTEM [pos=" + std::to_string(tokens[pos].position) + "]");
+            }
+            pos++;
+            ref.sample.percent = parseParenthesizedNumber(tokens, pos);
+            if (ref.sample.percent > 100.0) {
+                throw std::runtime_error("Sample percentage must be between 0 and 100 [pos=" +
+                                         std::to_string(tokens[pos - 2].position) + "]");
+            }
+            if (isWord(tokens, pos, "REPEATABLE")) {
+                pos++;
+                ref.sample.seed = static_cast<uint64_t>(parseParenthesizedNumber(tokens, pos));
+            }
+        }
+        return ref;
+    }
+    
+    // "(number)"
+    static double parseParenthesizedNumber(const std::vector<Token>& tokens, size_t& pos) {
+        if (pos + 2 >= tokens.size() || tokens[pos].type != TokenType::LEFT_PAREN ||
+            tokens[pos + 1].type != TokenType::NUMBER || tokens[pos + 2].type != TokenType::RIGHT_PAREN) {
+            throw std::runtime_error("Expected '(number)' [pos=" + std::to_string(tokens[pos].position) + "]");
+        }
+        double number = std::stod(tokens[pos + 1].value);
+        pos += 3;
+        return number;
+    }
+    
+    static std::vector<JoinCondition> parseJoinConditions(const std::vector<Token>& tokens, size_t& pos) {
+        std::vector<JoinCondition> conditions;
+        while (true) {
+            JoinCondition condition;
+            if (pos >= tokens.size() || tokens[pos].type != TokenType::IDENTIFIER) {
+                throw std::runtime_error("Expected column name in ON clause [pos=" + std::to_string(tokens[pos].position) + "]");
+            }
+            condition.leftColumn = tokens[pos].value;
+            pos++;
+            if (pos >= tokens.size() || tokens[pos].type != TokenType::EQUALS) {
+                throw std::runtime_error("Expected '=' in ON clause [pos=" + std::to_string(tokens[pos].position) + "]");
+            }
+            pos++;
+            if (pos >= tokens.size() || tokens[pos].type != TokenType::IDENTIFIER) {
+                throw std::runtime_error("Expected column name in ON clause [pos=" + std::to_string(tokens[pos].position) + "]");
+            }
+            condition.rightColumn = tokens[pos].value;
+            pos++;
+            conditions.push_back(condition);
+            
+            if (pos < tokens.size() && tokens[pos].type == TokenType::AND) {
+                pos++;
+            } else {
+                break;
+            }
+        }
+        return conditions;
+    }
+    
     static SelectClause parseSelectClause(const std::vector<Token>& tokens, size_t& pos) {
         SelectClause select;
         
@@ -111,6 +264,10 @@ private:
             throw std::runtime_error("Expected column list or * [pos=" + std::to_string(pos) + "]");
         }
         
+        if (isWord(tokens, pos, "DISTINCT")) {
+            select.distinct = true;
+            pos++;
+        }
         if (tokens[pos].type == TokenType::STAR) {
             select.selectAll = true;
             pos++;
@@ -122,8 +279,17 @@ private:
                     throw std::runtime_error("Expected column name [pos=" + std::to_string(tokens[pos].position) + "]");
                 }
                 
-                select.columns.push_back(tokens[pos].value);
-                pos++;
+                if (ExpressionParser::isWindowFunction(tokens, pos)) {
+                    WindowSpec window = ExpressionParser::parseWindowFunction(tokens, pos);
+                    select.columns.push_back(window.name);
+                    select.items.push_back({window.name, window.name});
+                    select.windows.push_back(std::move(window));
+                } else {
+                    AggregateColumn item = ExpressionParser::parseSelectColumn(tokens, pos);
+                    select.hasAggregates |= item.function != AggregateFunction::NONE;
+                    select.columns.push_back(item.source);
+                    select.items.push_back(item);
+                }
                 
                 if (pos < tokens.size() && tokens[pos].type == TokenType::COMMA) {
                     pos++;
@@ -208,12 +374,100 @@ private:
         return conditions;
     }
     
-    static std::unique_ptr<QueryPlanNode> buildQueryPlan(ParsedQuery& parsed, const Table& table) {
-        auto scan = std::make_unique<TableScanNode>(table, parsed.select.selectAll ? std::vector<std::string>{} : parsed.select.columns);
-        if (!parsed.whereExpr) {
-            return scan;
+    static std::unique_ptr<QueryPlanNode> buildQueryPlan(ParsedQuery& parsed, const TableResolver& resolver) {
+        return Optimizer::plan(buildLogicalPlan(parsed, resolver));
+    }
+    
+    // Builds the logical plan
+    // [Distinct](Project([Window](Filter(SemiJoin*(Join(...Scan...)))))), or
+    // Aggregate(Filter(...)) for aggregating queries, in written order. Each
+    // col IN (SELECT ...) conjunct becomes a semi-join against the subquery.
+    static std::unique_ptr<LogicalNode> buildLogicalPlan(ParsedQuery& parsed, const TableResolver& resolver) {
+        std::unique_ptr<LogicalNode> root;
+        for (const auto& ref : parsed.tables) {
+            const Table* table = resolver(ref.name);
+            if (!table) {
+                throw std::runtime_error("Table '" + ref.name + "' does not exist");
+            }
+            auto scan = LogicalNode::makeScan(*table, ref.alias);
+            scan->sample = ref.sample;
+            root = root ? LogicalNode::makeJoin(std::move(root), std::move(scan), ref.joinConditions)
+                        : std::move(scan);
+        }
+        if (parsed.whereExpr) {
+            std::vector<std::unique_ptr<Expression>> conjuncts, predicates;
+            splitConjuncts(std::move(parsed.whereExpr), conjuncts);
+            for (auto& conjunct : conjuncts) {
+                auto* in = dynamic_cast<InSubqueryExpr*>(conjunct.get());
+                if (!in) {
+                    predicates.push_back(std::move(conjunct));
+                    continue;
+                }
+                ParsedQuery subquery = parseQuery(in->subquery);
+                auto subplan = buildLogicalPlan(subquery, resolver);
+                auto columns = subplan->getOutputColumns();
+                if (columns.size() != 1) {
+                    throw std::runtime_error("Subquery of IN must select exactly one column");
+                }
+                root = LogicalNode::makeSemiJoin(std::move(root), std::move(subplan), {in->column, columns[0]});
+            }
+            if (!predicates.empty()) {
+                root = LogicalNode::makeFilter(std::move(root), std::move(predicates));
+            }
+        }
+        const bool aggregating = parsed.select.hasAggregates || !parsed.groupBy.empty();
+        if (!parsed.select.windows.empty()) {
+            if (aggregating) {
+                throw std::runtime_error("Window functions cannot be combined with GROUP BY or aggregates");
+            }
+            checkAggregateTypes(parsed, resolver);
+            root = LogicalNode::makeWindow(std::move(root), parsed.select.windows);
+        } else if (aggregating) {
+            if (parsed.select.selectAll) {
+                throw std::runtime_error("SELECT * cannot be combined with GROUP BY");
+            }
+            checkAggregateTypes(parsed, resolver);
+            root = LogicalNode::makeAggregate(std::move(root), parsed.groupBy, parsed.select.items);
+            return parsed.select.distinct ? LogicalNode::makeDistinct(std::move(root)) : std::move(root);
+        }
+        for (const auto& item : parsed.select.items) {
+            if (item.name != item.source) {
+                throw std::runtime_error("Column aliases are only supported in aggregating queries");
+            }
+        }
+        std::vector<std::string> columns = parsed.select.selectAll ? root->getOutputColumns() : parsed.select.columns;
+        root = LogicalNode::makeProject(std::move(root), columns);
+        return parsed.select.distinct ? LogicalNode::makeDistinct(std::move(root)) : std::move(root);
+    }
+    
+    // Rejects aggregates and window aggregates over columns of the wrong
+    // type, e.g. SUM of a STRING
+    static void checkAggregateTypes(const ParsedQuery& parsed, const TableResolver& resolver) {
+        std::vector<std::string> names;
+        std::vector<DataType> types;
+        for (const auto& ref : parsed.tables) {
+            for (const auto& column : resolver(ref.name)->getColumns()) {
+                names.push_back(ref.alias + "." + column.name);
+                types.push_back(column.type);
+            }
+        }
+        std::vector<AggregateColumn> items;
+        if (parsed.select.windows.empty()) {
+            items = parsed.select.items;
+        }
+        for (const auto& window : parsed.select.windows) {
+            if (window.function == WindowFunction::AGGREGATE) {
+                items.push_back({window.name, window.source, window.aggregate});
+            }
+        }
+        for (const auto& item : items) {
+            if (item.source.empty()) continue;
+            int index = findColumn(names, item.source);
+            if (index < 0) {
+                throw std::runtime_error("Unknown column: " + item.source);
+            }
+            aggregateType(item, types[index]);
         }
-        return std::make_unique<FilterNode>(std::move(scan), std::move(parsed.whereExpr), table);
     }
     
     static std::function<bool(const Row&)> buildFilterPredicate(
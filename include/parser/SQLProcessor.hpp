@@ -4,6 +4,8 @@
 #include "DDLParser.hpp"
 #include "DMLParser.hpp"
 #include "../storage/Database.hpp"
+#include "../executor/ResultCache.hpp"
+#include "../executor/ResultSink.hpp"
 #include <memory>
 #include <string>
 
@@ -12,8 +14,15 @@ namespace parallaxdb {
 enum class StatementType {
     SELECT,
     INSERT,
+    UPDATE,
+    DELETE,
     CREATE_TABLE,
+    CREATE_VIEW,
+    CREATE_INDEX,
     DROP_TABLE,
+    ALTER_TABLE,
+    ANALYZE,
+    EXPLAIN,
     UNKNOWN
 };
 
@@ -24,13 +33,36 @@ public:
     // Process different types of statements
     static std::unique_ptr<QueryPlanNode> processSelect(const std::string& query, Database& db);
     static void processInsert(const std::string& query, Database& db);
+    static void processUpdate(const std::string& query, Database& db);
+    static void processDelete(const std::string& query, Database& db);
     static void processCreateTable(const std::string& query, Database& db);
+    static void processCreateView(const std::string& query, Database& db);
+    static void processCreateIndex(const std::string& query, Database& db);
     static void processDropTable(const std::string& query, Database& db);
+    static void processAlterTable(const std::string& query, Database& db);
+    static void processAnalyze(const std::string& query, Database& db);
+    static void processExplain(const std::string& query, Database& db);
+    
+    // Runs a SELECT into `sink`, answering it from the result cache when
+    // the same query already ran against unchanged tables. Returns the
+    // number of rows.
+    static size_t executeSelect(const std::string& query, Database& db, ResultSink& sink);
     
     // Main entry point
     static void processStatement(const std::string& query, Database& db);
     
+    // Format used for SELECT results written to stdout
+    static void setOutputFormat(ResultFormat format) { outputFormat = format; }
+    static ResultFormat getOutputFormat() { return outputFormat; }
+    
+    static ResultCache& getResultCache() { return resultCache; }
+    static void setResultCaching(bool enabled) { cachingEnabled = enabled; }
+    
 private:
+    static inline ResultFormat outputFormat = ResultFormat::TABLE;
+    static inline ResultCache resultCache;
+    static inline bool cachingEnabled = true;
+    
     static void printResults(const std::vector<Row>& results, const std::vector<std::string>& columns);
 };
 
@@ -1,5 +1,7 @@
 #pragma once
+#include <algorithm>
 #include <string>
+#include <vector>
 
 namespace parallaxdb {
 
@@ -31,6 +33,17 @@ enum class TokenType {
     INSERT,
     INTO,
     VALUES,
+    UPDATE,
+    SET,
+    DELETE,
+    // Join tokens
+    JOIN,
+    INNER,
+    ON,
+    AS,
+    // Utility tokens
+    ANALYZE,
+    EXPLAIN,
     // Data type tokens
     INT,
     DOUBLE,
@@ -54,4 +67,13 @@ struct Token {
         : type(t), value(v), position(pos) {}
 };
 
+// Words such as PARTITION and BY are not keywords; they arrive as identifiers
+// and are matched case-insensitively
+inline bool isWord(const std::vector<Token>& tokens, size_t pos, const char* word) {
+    if (pos >= tokens.size() || tokens[pos].type != TokenType::IDENTIFIER) return false;
+    std::string upper = tokens[pos].value;
+    std::transform(upper.begin(), upper.end(), upper.begin(), ::toupper);
+    return upper == word;
+}
+
 } // namespace parallaxdb 
\ No newline at end of file
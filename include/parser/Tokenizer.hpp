@@ -4,6 +4,7 @@
 #include <vector>
 #include <sstream>
 #include <cctype>
+#include <algorithm>
 #include "Token.hpp"
 
 namespace parallaxdb {
@@ -14,6 +15,7 @@ public:
     
     std::vector<Token> tokenize() {
         std::vector<Token> tokens;
+        tokens.reserve(input.length() / 4 + 2);
         
         while (position < input.length()) {
             skipWhitespace();
@@ -81,10 +83,16 @@ private:
         }
     }
     
+    // A '.' inside an identifier joins a table qualifier to a column name
+    bool isQualifierDot() const {
+        return input[position] == '.' && position + 1 < input.length() &&
+               (std::isalpha(input[position + 1]) || input[position + 1] == '_');
+    }
+    
     Token readIdentifier() {
         size_t start = position;
         while (position < input.length() && 
-               (std::isalnum(input[position]) || input[position] == '_')) {
+               (std::isalnum(input[position]) || input[position] == '_' || isQualifierDot())) {
             position++;
         }
         
@@ -116,6 +124,24 @@ private:
             return Token(TokenType::INTO, identifier, start);
         } else if (upperIdentifier == "VALUES") {
             return Token(TokenType::VALUES, identifier, start);
+        } else if (upperIdentifier == "UPDATE") {
+            return Token(TokenType::UPDATE, identifier, start);
+        } else if (upperIdentifier == "SET") {
+            return Token(TokenType::SET, identifier, start);
+        } else if (upperIdentifier == "DELETE") {
+            return Token(TokenType::DELETE, identifier, start);
+        } else if (upperIdentifier == "JOIN") {
+            return Token(TokenType::JOIN, identifier, start);
+        } else if (upperIdentifier == "INNER") {
+            return Token(TokenType::INNER, identifier, start);
+        } else if (upperIdentifier == "ON") {
+            return Token(TokenType::ON, identifier, start);
+        } else if (upperIdentifier == "AS") {
+            return Token(TokenType::AS, identifier, start);
+        } else if (upperIdentifier == "ANALYZE") {
+            return Token(TokenType::ANALYZE, identifier, start);
+        } else if (upperIdentifier == "EXPLAIN") {
+            return Token(TokenType::EXPLAIN, identifier, start);
         } else if (upperIdentifier == "INT" || upperIdentifier == "INTEGER") {
             return Token(TokenType::INT, identifier, start);
         } else if (upperIdentifier == "DOUBLE" || upperIdentifier == "FLOAT" || upperIdentifier == "REAL") {
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "../storage/Statistics.hpp"
+#include "../types/Common.hpp"
+#include "../types/CompactValue.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace parallaxdb {
+
+enum class AggregateFunction {
+    NONE,
+    COUNT,
+    SUM,
+    MIN,
+    MAX,
+    AVG,
+    APPROX_COUNT_DISTINCT,   // HyperLogLog estimate
+    APPROX_QUANTILE          // KLL estimate of the value at a quantile
+};
+
+// SQL name of an aggregate function ("COUNT", "APPROX_QUANTILE", ...)
+const char* aggregateName(AggregateFunction function);
+// The function named `name`, in any case; NONE if there is none
+AggregateFunction parseAggregateFunction(const std::string& name);
+
+// One output column of an aggregating select list: a plain column, or an
+// aggregate over one
+struct AggregateColumn {
+    std::string name;                  // Output column name
+    std::string source;                // Input column; empty for COUNT(*)
+    AggregateFunction function = AggregateFunction::NONE;
+    double parameter = 0.0;            // APPROX_QUANTILE: the quantile in [0, 1]
+};
+
+// Type of an aggregate's result over a `source`-typed input; throws if the
+// function does not apply to that type
+DataType aggregateType(const AggregateColumn& column, DataType source);
+
+// Appends a cell to a group key. Numbers are encoded as doubles so that
+// 1 and 1.0 in a DOUBLE column fall into the same group.
+void appendGroupKey(std::string& key, const CompactValue& cell);
+
+// AggregateState: The running state of one aggregate over one group.
+// States of the same function merge, so partial aggregates computed over
+// disjoint inputs (partitions, threads) combine into the total. Sketches are
+// allocated on the first input.
+class AggregateState {
+public:
+    explicit AggregateState(AggregateFunction function = AggregateFunction::NONE, double parameter = 0.0)
+        : function(function), parameter(parameter) {}
+
+    // COUNT(*): one more row
+    void addRow() { count++; }
+    // One input value; NULLs are ignored
+    void add(const CompactValue& value);
+    void merge(const AggregateState& other);
+    // COUNT and APPROX_COUNT_DISTINCT are INT, never NULL; the rest are NULL
+    // without input
+    Value result() const;
+
+private:
+    AggregateFunction function;
+    double parameter;
+    int64_t count = 0;         // Rows (COUNT(*)) or non-NULL inputs seen
+    double sum = 0.0;
+    Value extreme = nullptr;   // MIN / MAX so far
+    std::unique_ptr<HyperLogLog> distinct;
+    std::unique_ptr<QuantileSketch> quantiles;
+};
+
+} // namespace parallaxdb
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "QueryPlan.hpp"
+#include "Aggregate.hpp"
+#include "../types/Common.hpp"
+#include "../util/HugePages.hpp"
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace parallaxdb {
+
+// AggregateNode: Hash aggregation. open() drains the child into one group per
+// distinct GROUP BY key (without GROUP BY, a single group that yields a row
+// even over no input); next() returns the groups in the order they first
+// appeared. Grouping columns in the select list must be GROUP BY columns.
+// Large group tables live on huge pages.
+class AggregateNode : public QueryPlanNode {
+public:
+    AggregateNode(std::unique_ptr<QueryPlanNode> child, const std::vector<std::string>& groupBy,
+                  const std::vector<AggregateColumn>& items, const std::vector<std::string>& outputColumns);
+    const std::vector<std::string>& getOutputColumns() const override { return outputColumns; }
+    std::string getName() const override { return "Aggregate"; }
+    std::string getDetails() const override;
+    std::vector<const QueryPlanNode*> getChildren() const override { return {child.get()}; }
+
+    size_t getGroupCount() const { return groups.size(); }
+
+protected:
+    void doOpen() override;
+    bool doNext(RowBatch& batch) override;
+
+private:
+    struct Group {
+        std::vector<Value> key;
+        std::vector<AggregateState> states;   // One per item
+    };
+
+    std::unique_ptr<QueryPlanNode> child;
+    std::vector<std::string> groupBy;
+    std::vector<AggregateColumn> items;
+    std::vector<std::string> outputColumns;
+    std::vector<int> groupIndices;   // Child columns of the GROUP BY
+    std::vector<int> sources;        // Per item: child column, -1 for COUNT(*)
+    std::vector<int> keySlots;       // Per item: index into the group key, or -1
+
+    using GroupIndex = std::pmr::unordered_map<std::string, size_t>;
+    static constexpr size_t kIndexMemoryInitialBytes = 64 * 1024;
+
+    std::pmr::vector<Group> groups{HugePageResource::get()};
+    std::pmr::monotonic_buffer_resource indexMemory{kIndexMemoryInitialBytes, HugePageResource::get()};
+    GroupIndex groupIndex{&indexMemory};   // Declared after indexMemory, which it lives in
+    size_t emitted = 0;
+    RowBatch input;
+    std::string keyScratch;
+
+    Group newGroup(const Row& row) const;
+};
+
+} // namespace parallaxdb
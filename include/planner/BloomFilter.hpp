@@ -0,0 +1,138 @@
+#pragma once
+
+#include "../util/HugePages.hpp"
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+namespace parallaxdb {
+
+// Folds one column's value hash into a composite join-key hash. Hash joins
+// and runtime filters must combine key columns the same way.
+inline uint64_t combineKeyHash(uint64_t hash, uint64_t valueHash) {
+    return (hash ^ valueHash) * 0x100000001b3ULL;
+}
+constexpr uint64_t kKeyHashSeed = 0x84222325cbf29ce4ULL;
+
+// RuntimeBloomFilter: Split-block Bloom filter over join-key hashes. The high
+// half of a hash picks one 256-bit block; the low half sets one bit in each
+// of the block's eight 32-bit words. A lookup touches a single cache line,
+// and its eight word tests are independent, so the compiler vectorizes them.
+// Filters of 2MB and more sit on huge pages, since every probe is random.
+class RuntimeBloomFilter {
+public:
+    static constexpr size_t kBitsPerKey = 16;          // ~0.5% false positives
+    static constexpr size_t kMaxBytes = 64 << 20;
+
+    void reset(size_t expectedKeys) {
+        size_t blocksWanted = (expectedKeys * kBitsPerKey + 255) / 256;
+        size_t count = 1;
+        while (count < blocksWanted && count * sizeof(Block) < kMaxBytes) count <<= 1;
+        blocks.assign(count, Block{});
+        blockMask = count - 1;
+    }
+
+    void insert(uint64_t hash) {
+        Block& block = blocks[(hash >> 32) & blockMask];
+        uint32_t mask[8];
+        makeMask(static_cast<uint32_t>(hash), mask);
+        for (int i = 0; i < 8; ++i) block.words[i] |= mask[i];
+    }
+
+    bool mayContain(uint64_t hash) const {
+        const Block& block = blocks[(hash >> 32) & blockMask];
+        uint32_t mask[8];
+        makeMask(static_cast<uint32_t>(hash), mask);
+        uint32_t missing = 0;
+        for (int i = 0; i < 8; ++i) missing |= mask[i] & ~block.words[i];
+        return missing == 0;
+    }
+
+    size_t getByteSize() const { return blocks.size() * sizeof(Block); }
+
+private:
+    struct alignas(32) Block {
+        uint32_t words[8];
+    };
+
+    std::pmr::vector<Block> blocks{HugePageResource::get()};
+    uint64_t blockMask = 0;
+
+    static void makeMask(uint32_t key, uint32_t mask[8]) {
+        static constexpr uint32_t kSalt[8] = {0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+                                              0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+        for (int i = 0; i < 8; ++i) mask[i] = 1u << ((key * kSalt[i]) >> 27);
+    }
+};
+
+// RuntimeFilter: A Bloom filter built by a hash join over its build keys and
+// pushed down to the probe-side operator that produces `columns`. That
+// operator drops rows whose keys cannot match before they reach the join.
+// If the filter prunes too little to pay for itself it switches off.
+struct RuntimeFilter {
+    static constexpr uint64_t kSampleRows = 8192;
+    static constexpr double kMaxPassRate = 0.9;
+
+    std::vector<std::string> columns;  // Probe key columns, qualified
+    RuntimeBloomFilter bloom;
+    bool ready = false;                // Set once the build side is loaded
+
+    uint64_t rowsChecked = 0;
+    uint64_t rowsPassed = 0;
+    bool disabled = false;
+
+    void resetStats() {
+        rowsChecked = 0;
+        rowsPassed = 0;
+        disabled = false;
+    }
+
+    bool active() const { return ready && !disabled; }
+
+    // Keeps the entries of `selection` whose key may be in the build side.
+    // keyHash(position, hasNull) returns the composite key hash of a row;
+    // rows with a NULL key never join and are dropped.
+    template <typename KeyHash>
+    void apply(std::vector<uint32_t>& selection, KeyHash keyHash) {
+        if (!active()) return;
+        hashes.resize(selection.size());
+        size_t kept = 0;
+        for (size_t i = 0; i < selection.size(); ++i) {
+            bool hasNull = false;
+            hashes[i] = keyHash(selection[i], hasNull);
+            if (!hasNull) {
+                selection[kept] = selection[i];
+                hashes[kept++] = hashes[i];
+            }
+        }
+        const size_t candidates = selection.size();
+        selection.resize(kept);
+        size_t passed = 0;
+        for (size_t i = 0; i < kept; ++i) {
+            if (bloom.mayContain(hashes[i])) selection[passed++] = selection[i];
+        }
+        selection.resize(passed);
+
+        rowsChecked += candidates;
+        rowsPassed += passed;
+        if (rowsChecked >= kSampleRows && rowsPassed > kMaxPassRate * rowsChecked) {
+            disabled = true;
+        }
+    }
+
+    std::string toString() const {
+        std::string result;
+        for (size_t i = 0; i < columns.size(); ++i) {
+            if (i > 0) result += ", ";
+            result += columns[i];
+        }
+        return result;
+    }
+
+private:
+    std::vector<uint64_t> hashes;
+};
+
+} // namespace parallaxdb
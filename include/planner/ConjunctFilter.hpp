@@ -0,0 +1,135 @@
+#pragma once
+
+#include "../parser/Expression.hpp"
+#include "../types/Common.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace parallaxdb {
+
+// ConjunctFilter evaluates a predicate one conjunct at a time, narrowing a
+// selection vector of row positions. Every kSampleInterval-th batch is timed,
+// and the conjuncts are reordered by cost per row / fraction of rows
+// eliminated so cheap, selective conjuncts run first. Measurements are
+// exponentially smoothed, so the order follows shifts in the data distribution.
+// A scan whose predicate FilterJit has compiled stops calling apply(); the
+// compiled code evaluates the conjuncts as written, without this order.
+class ConjunctFilter {
+public:
+    static constexpr size_t kSampleInterval = 8;
+    static constexpr double kSmoothing = 0.3; // Weight of the newest sample
+
+    ConjunctFilter() = default;
+    ConjunctFilter(std::unique_ptr<Expression> expr, const std::vector<std::string>& columns) {
+        splitConjuncts(std::move(expr), conjuncts);
+        for (size_t i = 0; i < conjuncts.size(); ++i) {
+            conjuncts[i]->bind(columns);
+            order.push_back(i);
+        }
+        stats.resize(conjuncts.size());
+    }
+
+    bool empty() const { return conjuncts.empty(); }
+    void reset() { batchCount = 0; }
+
+    // Current evaluation order as indices into the written conjuncts
+    const std::vector<size_t>& getOrder() const { return order; }
+    // The conjuncts as written
+    const std::vector<std::unique_ptr<Expression>>& getConjuncts() const { return conjuncts; }
+
+    // Keeps the entries of `selection` whose row passes every conjunct.
+    // rowAt(position) returns the row stored at a selection position.
+    template <typename RowAt>
+    void apply(RowAt rowAt, std::vector<uint32_t>& selection) {
+        const bool sample = conjuncts.size() > 1 && batchCount++ % kSampleInterval == 0;
+        for (size_t idx : order) {
+            if (selection.empty()) break;
+            const Expression& conjunct = *conjuncts[idx];
+            const size_t rowsIn = selection.size();
+            auto start = sample ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+
+            size_t kept = 0;
+            for (uint32_t position : selection) {
+                if (conjunct.evaluate(rowAt(position))) {
+                    selection[kept++] = position;
+                }
+            }
+            selection.resize(kept);
+
+            if (sample) {
+                double nanos = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+                record(idx, static_cast<double>(kept) / rowsIn, nanos / rowsIn);
+            }
+        }
+        if (sample) {
+            reorder();
+        }
+    }
+
+    // apply() without measuring or reordering: the conjuncts run in the
+    // current order. Safe to call from several threads at once.
+    template <typename RowAt>
+    void applyFixed(RowAt rowAt, std::vector<uint32_t>& selection) const {
+        for (size_t idx : order) {
+            if (selection.empty()) break;
+            const Expression& conjunct = *conjuncts[idx];
+            size_t kept = 0;
+            for (uint32_t position : selection) {
+                if (conjunct.evaluate(rowAt(position))) {
+                    selection[kept++] = position;
+                }
+            }
+            selection.resize(kept);
+        }
+    }
+
+    std::string toString() const {
+        std::string result;
+        for (size_t i = 0; i < order.size(); ++i) {
+            if (i > 0) result += " AND ";
+            result += conjuncts[order[i]]->toString();
+        }
+        return result;
+    }
+
+private:
+    struct ConjunctStats {
+        bool measured = false;
+        double passRate = 1.0;
+        double nanosPerRow = 0.0;
+    };
+
+    std::vector<std::unique_ptr<Expression>> conjuncts;
+    std::vector<size_t> order;
+    std::vector<ConjunctStats> stats;
+    size_t batchCount = 0;
+
+    void record(size_t idx, double passRate, double nanosPerRow) {
+        ConjunctStats& s = stats[idx];
+        if (!s.measured) {
+            s.passRate = passRate;
+            s.nanosPerRow = nanosPerRow;
+            s.measured = true;
+        } else {
+            s.passRate += kSmoothing * (passRate - s.passRate);
+            s.nanosPerRow += kSmoothing * (nanosPerRow - s.nanosPerRow);
+        }
+    }
+
+    void reorder() {
+        // Conjuncts that have never seen a row keep their relative position
+        auto rank = [this](size_t idx) {
+            const ConjunctStats& s = stats[idx];
+            if (!s.measured) return std::numeric_limits<double>::max();
+            return s.nanosPerRow / std::max(1e-6, 1.0 - s.passRate);
+        };
+        std::stable_sort(order.begin(), order.end(),
+                         [&rank](size_t a, size_t b) { return rank(a) < rank(b); });
+    }
+};
+
+} // namespace parallaxdb
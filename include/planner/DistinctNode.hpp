@@ -0,0 +1,62 @@
+#pragma once
+
+#include "QueryPlan.hpp"
+#include "../types/Common.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace parallaxdb {
+
+// DistinctNode: Drops duplicate rows with a hash set of the rows seen so far,
+// split into kPartitions by key hash. With one thread it streams: each input
+// batch is probed and its new rows emitted at once. With several threads
+// (the default) it works a chunk at a time: up to kParallelChunkRows input
+// rows are gathered before any are emitted, then each worker probes the
+// chunk's rows that hash into its share of the partitions, so no set is
+// shared between threads. Rows keep their input order.
+class DistinctNode : public QueryPlanNode {
+public:
+    static constexpr size_t kPartitions = 64;
+    static constexpr size_t kParallelChunkRows = 64 * 1024;
+
+    explicit DistinctNode(std::unique_ptr<QueryPlanNode> child);
+    const std::vector<std::string>& getOutputColumns() const override { return child->getOutputColumns(); }
+    std::string getName() const override { return "Distinct"; }
+    std::string getDetails() const override;
+    std::vector<const QueryPlanNode*> getChildren() const override { return {child.get()}; }
+
+    // Worker threads for probing chunks; 0 (the default) uses one per core
+    void setParallelism(size_t threads) { parallelism = threads; }
+    // Whether the last run probed a chunk on worker threads
+    bool isParallel() const { return ranParallel; }
+    size_t getDistinctCount() const;
+
+protected:
+    void doOpen() override;
+    bool doNext(RowBatch& batch) override;
+
+private:
+    std::unique_ptr<QueryPlanNode> child;
+    size_t parallelism = 0;
+    size_t threads = 1;
+    bool ranParallel = false;
+
+    std::vector<std::unordered_set<std::string>> seen;   // One per partition
+    RowBatch input;
+    std::string keyScratch;
+
+    // Parallel mode: the current chunk, its rows' new-ness and the next row to emit
+    std::vector<Row> chunk;
+    std::vector<uint8_t> keep;
+    size_t emitted = 0;
+    bool exhausted = false;
+
+    size_t partitionOf(const std::string& key) const { return std::hash<std::string>{}(key) % kPartitions; }
+    void appendKey(std::string& key, const Row& row) const;
+    bool nextChunk();
+};
+
+} // namespace parallaxdb
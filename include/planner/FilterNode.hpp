@@ -1,23 +1,40 @@
 #pragma once
 
 #include "QueryPlan.hpp"
+#include "ConjunctFilter.hpp"
 #include "../storage/Table.hpp"
 #include "../parser/Expression.hpp"
 #include "../types/Common.hpp"
+#include <cstdint>
 #include <memory>
 
 namespace parallaxdb {
 
+// FilterNode applies a predicate to the batches of its child, evaluating and
+// adaptively reordering conjuncts through a ConjunctFilter.
 class FilterNode : public QueryPlanNode {
 public:
     FilterNode(std::unique_ptr<QueryPlanNode> child,
-               std::unique_ptr<Expression> expr,
-               const Table& table);
-    void execute() override;
+               std::unique_ptr<Expression> expr);
+    const std::vector<std::string>& getOutputColumns() const override { return child->getOutputColumns(); }
+    std::string getName() const override { return "Filter"; }
+    std::string getDetails() const override;
+    bool addRuntimeFilter(std::shared_ptr<RuntimeFilter> filter) override;
+    std::vector<const QueryPlanNode*> getChildren() const override { return {child.get()}; }
+
+    // Current evaluation order as indices into the written conjuncts
+    const std::vector<size_t>& getConjunctOrder() const { return filter.getOrder(); }
+
+protected:
+    void doOpen() override;
+    bool doNext(RowBatch& batch) override;
+
 private:
     std::unique_ptr<QueryPlanNode> child;
-    std::unique_ptr<Expression> expr;
-    const Table& table;
+    ConjunctFilter filter;
+    std::vector<PushedRuntimeFilter> runtimeFilters;
+    RowBatch input;
+    std::vector<uint32_t> selection;
 };
 
 } // namespace parallaxdb
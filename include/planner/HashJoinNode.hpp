@@ -0,0 +1,70 @@
+#pragma once
+
+#include "QueryPlan.hpp"
+#include "../types/Common.hpp"
+#include "../util/HugePages.hpp"
+#include <memory>
+#include <memory_resource>
+#include <unordered_map>
+#include <utility>
+
+namespace parallaxdb {
+
+// Equi-join key: a column of the probe input and the matching build column
+struct JoinKey {
+    std::string probeColumn;
+    std::string buildColumn;
+};
+
+enum class JoinType {
+    INNER,
+    SEMI    // Probe rows with at least one match, each once; no build columns
+};
+
+// Hash join. The build input is materialized into a hash table on open();
+// probe batches are streamed through it. Inner join output rows are the probe
+// columns followed by the build columns; with no keys it is a cross product.
+// A semi-join keeps one build row per distinct key and outputs probe rows only.
+// The build keys also fill a Bloom filter that is pushed down to the probe
+// side operator producing the probe keys, so rows without a possible match
+// are dropped before they reach the join. The hash table grows in an arena
+// whose chunks past 2MB are huge pages.
+class HashJoinNode : public QueryPlanNode {
+public:
+    HashJoinNode(std::unique_ptr<QueryPlanNode> probe,
+                 std::unique_ptr<QueryPlanNode> build,
+                 const std::vector<JoinKey>& keys,
+                 JoinType type = JoinType::INNER);
+    const std::vector<std::string>& getOutputColumns() const override { return outputColumns; }
+    std::string getName() const override { return type == JoinType::SEMI ? "HashSemiJoin" : "HashJoin"; }
+    std::string getDetails() const override;
+    std::vector<const QueryPlanNode*> getChildren() const override { return {probe.get(), build.get()}; }
+protected:
+    void doOpen() override;
+    bool doNext(RowBatch& batch) override;
+
+private:
+    using HashTable = std::pmr::unordered_map<uint64_t, std::pmr::vector<size_t>>;
+    static constexpr size_t kHashMemoryInitialBytes = 64 * 1024;
+
+    std::unique_ptr<QueryPlanNode> probe;
+    std::unique_ptr<QueryPlanNode> build;
+    std::vector<JoinKey> keys;
+    JoinType type;
+    std::vector<int> probeKeyIndices;
+    std::vector<int> buildKeyIndices;
+    std::vector<std::string> outputColumns;
+
+    std::shared_ptr<RuntimeFilter> runtimeFilter;   // Null if no probe operator took it
+
+    std::vector<Row> buildRows;
+    std::pmr::monotonic_buffer_resource hashMemory{kHashMemoryInitialBytes, HugePageResource::get()};
+    HashTable hashTable{&hashMemory};   // Declared after hashMemory, which it lives in
+    RowBatch input;
+
+    uint64_t hashKey(const Row& row, const std::vector<int>& indices, bool& hasNull) const;
+    bool keysEqual(const Row& row, const Row& buildRow, const std::vector<int>& rowKeyIndices) const;
+    static bool pushRuntimeFilter(QueryPlanNode& node, const std::shared_ptr<RuntimeFilter>& filter);
+};
+
+} // namespace parallaxdb
@@ -0,0 +1,198 @@
+#pragma once
+
+#include "../parser/Expression.hpp"
+#include "Aggregate.hpp"
+#include "Window.hpp"
+#include "../storage/Table.hpp"
+#include "../types/Common.hpp"
+#include "../util/Arena.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace parallaxdb {
+
+enum class LogicalNodeType {
+    SCAN,
+    FILTER,
+    JOIN,
+    PROJECT,
+    AGGREGATE,
+    WINDOW,
+    SEMI_JOIN,   // Left rows with a match on the right; outputs the left columns
+    DISTINCT
+};
+
+// Equality between a column of the left and a column of the right join input
+struct JoinCondition {
+    std::string leftColumn;
+    std::string rightColumn;
+};
+
+enum class AccessPath {
+    SEQUENTIAL_SCAN,
+    TRIGRAM_INDEX    // Candidate rows from a trigram index, then the predicates
+};
+
+// LogicalNode: Relational-algebra plan produced from a parsed query and
+// rewritten by the Optimizer before being lowered to physical operators.
+struct LogicalNode : public ArenaAllocated {
+    LogicalNodeType type;
+    std::vector<std::unique_ptr<LogicalNode>> children;
+
+    // SCAN
+    const Table* table = nullptr;
+    std::string alias;
+    AccessPath accessPath = AccessPath::SEQUENTIAL_SCAN;
+    // SCAN: partitions left to read after pruning, ascending
+    std::vector<size_t> partitions;
+    TableSample sample;
+    // SCAN through TRIGRAM_INDEX: the table's index slot, literals every
+    // qualifying value contains, and the candidate rows expected
+    int indexSlot = -1;
+    std::vector<std::string> indexLiterals;
+    double indexRows = 0.0;
+
+    // SCAN: table columns read (unqualified); PROJECT and AGGREGATE: output columns
+    std::vector<std::string> columns;
+
+    // SCAN and FILTER: conjunctive predicates
+    std::vector<std::unique_ptr<Expression>> predicates;
+
+    // JOIN and SEMI_JOIN: equi-join conditions
+    std::vector<JoinCondition> joinConditions;
+
+    // AGGREGATE: grouping columns and the select list, one item per output column
+    std::vector<std::string> groupBy;
+    std::vector<AggregateColumn> aggregates;
+
+    // WINDOW: functions whose results are appended to the input columns
+    std::vector<WindowSpec> windows;
+
+    // Filled in by the optimizer's cost estimation
+    double estimatedRows = -1.0;
+    double estimatedCost = -1.0;
+
+    explicit LogicalNode(LogicalNodeType t) : type(t) {}
+
+    // Qualified ("alias.column") names of the columns this node produces
+    std::vector<std::string> getOutputColumns() const {
+        std::vector<std::string> result;
+        switch (type) {
+            case LogicalNodeType::SCAN:
+                for (const auto& column : columns) {
+                    result.push_back(alias + "." + column);
+                }
+                break;
+            case LogicalNodeType::FILTER:
+            case LogicalNodeType::SEMI_JOIN:
+            case LogicalNodeType::DISTINCT:
+                result = children[0]->getOutputColumns();
+                break;
+            case LogicalNodeType::JOIN:
+                for (const auto& child : children) {
+                    auto childColumns = child->getOutputColumns();
+                    result.insert(result.end(), childColumns.begin(), childColumns.end());
+                }
+                break;
+            case LogicalNodeType::PROJECT:
+            case LogicalNodeType::AGGREGATE:
+                result = columns;
+                break;
+            case LogicalNodeType::WINDOW:
+                result = children[0]->getOutputColumns();
+                for (const auto& window : windows) {
+                    result.push_back(window.name);
+                }
+                break;
+        }
+        return result;
+    }
+
+    static std::unique_ptr<LogicalNode> makeScan(const Table& table, const std::string& alias) {
+        auto node = std::make_unique<LogicalNode>(LogicalNodeType::SCAN);
+        node->table = &table;
+        node->alias = alias;
+        for (const auto& column : table.getColumns()) {
+            node->columns.push_back(column.name);
+        }
+        for (size_t p = 0; p < table.getPartitionCount(); ++p) {
+            node->partitions.push_back(p);
+        }
+        return node;
+    }
+
+    static std::unique_ptr<LogicalNode> makeFilter(std::unique_ptr<LogicalNode> child,
+                                                   std::vector<std::unique_ptr<Expression>> predicates) {
+        auto node = std::make_unique<LogicalNode>(LogicalNodeType::FILTER);
+        node->children.push_back(std::move(child));
+        node->predicates = std::move(predicates);
+        return node;
+    }
+
+    static std::unique_ptr<LogicalNode> makeJoin(std::unique_ptr<LogicalNode> left,
+                                                 std::unique_ptr<LogicalNode> right,
+                                                 const std::vector<JoinCondition>& conditions) {
+        auto node = std::make_unique<LogicalNode>(LogicalNodeType::JOIN);
+        node->children.push_back(std::move(left));
+        node->children.push_back(std::move(right));
+        node->joinConditions = conditions;
+        return node;
+    }
+
+    static std::unique_ptr<LogicalNode> makeSemiJoin(std::unique_ptr<LogicalNode> left,
+                                                     std::unique_ptr<LogicalNode> right,
+                                                     const JoinCondition& condition) {
+        auto node = makeJoin(std::move(left), std::move(right), {condition});
+        node->type = LogicalNodeType::SEMI_JOIN;
+        return node;
+    }
+
+    static std::unique_ptr<LogicalNode> makeDistinct(std::unique_ptr<LogicalNode> child) {
+        auto node = std::make_unique<LogicalNode>(LogicalNodeType::DISTINCT);
+        node->children.push_back(std::move(child));
+        return node;
+    }
+
+    static std::unique_ptr<LogicalNode> makeProject(std::unique_ptr<LogicalNode> child,
+                                                    const std::vector<std::string>& columns) {
+        auto node = std::make_unique<LogicalNode>(LogicalNodeType::PROJECT);
+        node->children.push_back(std::move(child));
+        node->columns = columns;
+        return node;
+    }
+
+    // Output columns are the items' names, except that unaliased grouping
+    // columns keep the input's qualified name
+    static std::unique_ptr<LogicalNode> makeAggregate(std::unique_ptr<LogicalNode> child,
+                                                      const std::vector<std::string>& groupBy,
+                                                      const std::vector<AggregateColumn>& aggregates) {
+        auto node = std::make_unique<LogicalNode>(LogicalNodeType::AGGREGATE);
+        auto childColumns = child->getOutputColumns();
+        for (const auto& item : aggregates) {
+            if (item.function != AggregateFunction::NONE) {
+                node->columns.push_back(item.name);
+                continue;
+            }
+            int index = findColumn(childColumns, item.source);
+            if (index < 0) {
+                throw std::runtime_error("Unknown column: " + item.source);
+            }
+            node->columns.push_back(item.name != item.source ? item.name : childColumns[index]);
+        }
+        node->children.push_back(std::move(child));
+        node->groupBy = groupBy;
+        node->aggregates = aggregates;
+        return node;
+    }
+
+    static std::unique_ptr<LogicalNode> makeWindow(std::unique_ptr<LogicalNode> child,
+                                                   const std::vector<WindowSpec>& windows) {
+        auto node = std::make_unique<LogicalNode>(LogicalNodeType::WINDOW);
+        node->children.push_back(std::move(child));
+        node->windows = windows;
+        return node;
+    }
+};
+
+} // namespace parallaxdb
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "LogicalPlan.hpp"
+#include "QueryPlan.hpp"
+#include <memory>
+
+namespace parallaxdb {
+
+// Abstract cost units; a sequential read of one row costs 1
+struct CostModel {
+    static constexpr double kSeqScanRow = 1.0;
+    static constexpr double kPredicateEval = 0.1;   // per row, per conjunct
+    static constexpr double kHashBuildRow = 1.5;
+    static constexpr double kHashProbeRow = 1.0;
+    static constexpr double kOutputRow = 0.1;       // materializing a result row
+    static constexpr double kIndexRow = 2.0;        // reading a row found through an index
+};
+
+// Optimizer: Rewrites a logical plan (predicate pushdown, join ordering,
+// projection pushdown, access path selection), annotates it with cost
+// estimates and lowers it to physical operators.
+class Optimizer {
+public:
+    // Join graphs up to this size are ordered by dynamic programming; larger
+    // ones keep the written join order
+    static constexpr size_t kMaxDPRelations = 10;
+
+    static std::unique_ptr<LogicalNode> optimize(std::unique_ptr<LogicalNode> plan);
+    static std::unique_ptr<QueryPlanNode> lower(std::unique_ptr<LogicalNode> plan);
+
+    static std::unique_ptr<QueryPlanNode> plan(std::unique_ptr<LogicalNode> logical) {
+        return lower(optimize(std::move(logical)));
+    }
+
+private:
+    static std::unique_ptr<LogicalNode> pushDownPredicates(std::unique_ptr<LogicalNode> node);
+    static std::unique_ptr<LogicalNode> pushInto(std::unique_ptr<LogicalNode> node,
+                                                 std::vector<std::unique_ptr<Expression>> predicates);
+    static std::unique_ptr<LogicalNode> reorderJoins(std::unique_ptr<LogicalNode> node);
+    static void pushDownProjections(LogicalNode& node, std::vector<std::string> required);
+    static void chooseAccessPaths(LogicalNode& node);
+    static void estimateCosts(LogicalNode& node);
+};
+
+} // namespace parallaxdb
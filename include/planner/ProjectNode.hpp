@@ -0,0 +1,27 @@
+#pragma once
+
+#include "QueryPlan.hpp"
+#include "../types/Common.hpp"
+#include <memory>
+
+namespace parallaxdb {
+
+class ProjectNode : public QueryPlanNode {
+public:
+    ProjectNode(std::unique_ptr<QueryPlanNode> child, const std::vector<std::string>& columns);
+    const std::vector<std::string>& getOutputColumns() const override { return outputColumns; }
+    std::string getName() const override { return "Project"; }
+    std::string getDetails() const override;
+    std::vector<const QueryPlanNode*> getChildren() const override { return {child.get()}; }
+protected:
+    void doOpen() override;
+    bool doNext(RowBatch& batch) override;
+
+private:
+    std::unique_ptr<QueryPlanNode> child;
+    std::vector<std::string> outputColumns;
+    std::vector<int> columnIndices;
+    RowBatch input;
+};
+
+} // namespace parallaxdb
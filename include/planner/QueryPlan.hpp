@@ -2,27 +2,231 @@
 
 #include "../storage/Table.hpp"
 #include "../types/Common.hpp"
+#include "../util/Arena.hpp"
+#include "BloomFilter.hpp"
+#include "ConjunctFilter.hpp"
+#include "../jit/FilterJit.hpp"
 #include <string>
 #include <vector>
 #include <memory>
+#include <optional>
 
 namespace parallaxdb {
 
-class QueryPlanNode {
+// A batch of rows flowing between operators. Operators keep their batches for
+// the whole query; clearing a batch recycles its rows' value buffers, which
+// appendRow() hands out again, so steady-state batches do not allocate.
+struct RowBatch {
+    static constexpr size_t kDefaultCapacity = 1024;
+    static constexpr size_t kMaxSpareRows = 2 * kDefaultCapacity;
+
+    std::vector<Row> rows;
+
+    void clear() {
+        for (auto& row : rows) {
+            if (spare.size() >= kMaxSpareRows) break;
+            row.values.clear();
+            spare.push_back(std::move(row));
+        }
+        rows.clear();
+    }
+
+    // Appends an empty row, reusing a recycled value buffer when available
+    Row& appendRow() {
+        if (spare.empty()) {
+            rows.emplace_back();
+        } else {
+            rows.push_back(std::move(spare.back()));
+            spare.pop_back();
+        }
+        return rows.back();
+    }
+
+    size_t size() const { return rows.size(); }
+    bool empty() const { return rows.empty(); }
+
+private:
+    std::vector<Row> spare;
+};
+
+// Runtime measurements of one operator, collected when profiling is enabled.
+// Times and allocations include the operator's children; explainPlan()
+// subtracts them to report the operator's own share.
+struct OperatorProfile {
+    uint64_t rowsIn = 0;       // Set by leaf operators; derived from children otherwise
+    uint64_t rowsOut = 0;
+    uint64_t batches = 0;
+    double wallNanos = 0.0;
+    double cpuNanos = 0.0;
+    uint64_t bytesAllocated = 0;
+    int64_t peakBytes = 0;     // Peak heap growth of the subtree
+    int64_t retainedBytes = 0; // Heap held by the subtree between calls
+    double jitCompileNanos = 0.0;
+    uint64_t localMorsels = 0;  // Parallel scan partitions read on their home NUMA node
+    uint64_t remoteMorsels = 0; // ... and read from another node
+};
+
+// A runtime filter accepted by an operator, with the positions of its key
+// columns in the rows that operator filters
+struct PushedRuntimeFilter {
+    std::shared_ptr<RuntimeFilter> filter;
+    std::vector<int> keyIndices;
+};
+
+class QueryPlanNode : public ArenaAllocated {
 public:
     virtual ~QueryPlanNode() = default;
-    virtual void execute() = 0;
+
+    // Pull interface: open() (re)starts the operator, next() replaces the batch
+    // contents with the next rows and returns false once the operator is
+    // exhausted. A true return may carry an empty batch. Operators implement
+    // doOpen()/doNext(); the wrappers add profiling.
+    void open();
+    bool next(RowBatch& batch);
+
+    // Enables profiling on this operator and its whole subtree
+    void enableProfiling();
+    bool isProfiling() const { return profiling; }
+    const OperatorProfile& getProfile() const { return profile; }
+
+    // Names of the columns in produced rows, qualified as "table.column"
+    virtual const std::vector<std::string>& getOutputColumns() const = 0;
+
+    // Runtime filter pushdown: operators that can drop rows by a join-key
+    // Bloom filter take it here; returns false if this operator cannot.
+    virtual bool addRuntimeFilter(std::shared_ptr<RuntimeFilter> /*filter*/) { return false; }
+
+    // EXPLAIN support
+    virtual std::string getName() const = 0;
+    virtual std::string getDetails() const { return ""; }
+    virtual std::vector<const QueryPlanNode*> getChildren() const { return {}; }
+
+    void setEstimates(double rows, double cost) {
+        estimatedRows = rows;
+        estimatedCost = cost;
+    }
+    double getEstimatedRows() const { return estimatedRows; }
+    double getEstimatedCost() const { return estimatedCost; }
+
+protected:
+    virtual void doOpen() = 0;
+    virtual bool doNext(RowBatch& batch) = 0;
+
+    double estimatedRows = -1.0;
+    double estimatedCost = -1.0;
+    OperatorProfile profile;
+
+private:
+    bool profiling = false;
 };
 
+// TableScanNode reads the live rows of the table's selected partitions block
+// by block, with late materialization: a pushed-down predicate is evaluated
+// in place against the stored rows, producing a selection vector of row IDs,
+// and only the selected columns of qualifying rows are copied into the output
+// batch. The predicate is tiered through FilterJit, so blocks are filtered by
+// compiled code once it is ready. With an index lookup the scan visits only
+// the blocks holding candidate rows. With enough rows in two or more
+// partitions it scans them on worker threads, one partition at a time per
+// worker, and still returns batches in partition order; workers are spread
+// over the NUMA nodes and prefer the partitions stored on their own node.
 class TableScanNode : public QueryPlanNode {
 public:
-    TableScanNode(const Table& table, const std::vector<std::string>& selectedColumns = {});
-    void execute() override;
+    // Scans at least this many rows run partitions in parallel
+    static constexpr size_t kParallelScanRows = 64 * 1024;
+    // Scans at least this many rows compile their predicate on first use
+    static constexpr size_t kJitRows = 16 * Table::kBlockRows;
+
+    TableScanNode(const Table& table, const std::vector<std::string>& selectedColumns = {},
+                  const std::string& alias = "", std::unique_ptr<Expression> predicate = nullptr);
+    ~TableScanNode() override;
+    const std::vector<std::string>& getOutputColumns() const override { return outputColumns; }
+    std::string getName() const override { return "TableScan"; }
+    std::string getDetails() const override;
+    bool addRuntimeFilter(std::shared_ptr<RuntimeFilter> filter) override;
     const Table& getTable() const;
     const std::vector<std::string>& getSelectedColumns() const;
+
+    // Restricts the scan to the listed partitions (ascending); all by default
+    void setPartitions(std::vector<size_t> selected) { partitions = std::move(selected); }
+    const std::vector<size_t>& getPartitions() const { return partitions; }
+    // Reads only a sample of the rows
+    void setSample(const TableSample& tableSample) { sample = tableSample; }
+    const TableSample& getSample() const { return sample; }
+    // Reads only the candidate rows that trigram index `slot` returns for
+    // `literals`; the predicate still decides which of them qualify. Index
+    // scans run serially.
+    void setIndexLookup(size_t slot, std::vector<std::string> literals);
+    bool usesIndex() const { return indexed; }
+    // Worker threads for parallel scans; 0 (the default) uses one per core
+    void setParallelism(size_t threads) { parallelism = threads; }
+    // Whether the last scan ran on worker threads
+    bool isParallel() const { return ranParallel; }
+    // Whether the last scan filtered any block with compiled code
+    bool isCompiled() const { return ranCompiled; }
+
+    // Current evaluation order of the pushed-down predicate's conjuncts
+    const std::vector<size_t>& getConjunctOrder() const { return filter.getOrder(); }
+
+protected:
+    void doOpen() override;
+    bool doNext(RowBatch& batch) override;
+
 private:
+    struct ParallelScan;
+
     const Table& table;
     std::vector<std::string> selectedColumns;
+    std::string alias;
+    std::vector<int> columnIndices;
+    std::vector<std::string> outputColumns;
+    ConjunctFilter filter;
+    std::vector<PushedRuntimeFilter> runtimeFilters;   // Key indices are table columns
+    std::vector<uint32_t> selection;
+    std::vector<size_t> partitions;          // Selected partitions
+    TableSample sample;
+    size_t partitionCursor = 0;              // Index into partitions
+    size_t cursor = 0;                       // Next block of that partition
+    std::optional<Table::Pin> pin;           // Held from open() until exhausted
+    std::unique_ptr<ParallelScan> parallel;
+    size_t parallelism = 0;
+    bool ranParallel = false;
+    bool indexed = false;
+    size_t indexSlot = 0;
+    std::vector<std::string> indexLiterals;
+    std::vector<uint32_t> candidates;        // Index row IDs in the partition before partitionCursor
+    size_t candidateCursor = 0;
+    std::shared_ptr<const FilterJit::Entry> jit;   // The predicate's shape, if it compiles
+    std::vector<CompactValue> jitLiterals;
+    bool startedCompiled = false;
+    bool ranCompiled = false;
+
+    // Seeds the sampling decisions for block `block` of partition `partition`
+    uint64_t blockSeed(size_t partition, size_t block) const;
+    // SYSTEM sampling: whether the block is read at all
+    bool blockSampled(uint64_t seed) const;
+    // Fills `selection` with the block's live (and, for BERNOULLI, sampled)
+    // rows that pass the predicate. Worker threads pass adaptive = false:
+    // they share the filter, so they use its current order without
+    // recording measurements. Returns whether compiled code filtered them.
+    bool selectRows(const Table::Block& block, uint64_t seed, std::vector<uint32_t>& selection, bool adaptive);
+    // Narrows `selection` to the rows passing the predicate and runtime filters
+    bool filterRows(const Table::Block& block, std::vector<uint32_t>& selection, bool adaptive);
+    // Records, on the consumer thread, that compiled code took over
+    void noteCompiled();
+    void materialize(const Table::Block& block, const std::vector<uint32_t>& selection, RowBatch& batch) const;
+    size_t workerCount() const;
+    void startParallelScan();
+    void stopParallelScan();
+    bool nextParallel(RowBatch& batch);
+    bool nextIndexed(RowBatch& batch);
 };
 
+// Renders a plan tree with per-node cost estimates, one operator per line.
+// Operators that were profiled also show their measured runtime figures.
+std::string explainPlan(const QueryPlanNode& plan);
+
+// The same tree as a JSON document
+std::string explainPlanJson(const QueryPlanNode& plan);
+
 } // namespace parallaxdb
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "../parser/Expression.hpp"
+#include "../storage/Table.hpp"
+
+namespace parallaxdb {
+
+// SelectivityEstimator: Estimates the fraction of a table's rows that satisfy a
+// WHERE expression, using the table's column statistics.
+class SelectivityEstimator {
+public:
+    static constexpr double kDefaultSelectivity = 1.0 / 3.0;
+
+    static double estimate(const Expression& expr, const Table& table);
+    static double estimateRows(const Expression& expr, const Table& table) {
+        return estimate(expr, table) * static_cast<double>(table.getStatistics().getRowCount());
+    }
+};
+
+} // namespace parallaxdb
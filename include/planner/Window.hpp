@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Aggregate.hpp"
+#include "../types/Common.hpp"
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace parallaxdb {
+
+enum class WindowFunction {
+    ROW_NUMBER,
+    RANK,
+    DENSE_RANK,
+    LAG,
+    LEAD,
+    AGGREGATE      // COUNT / SUM / AVG / MIN / MAX over the frame
+};
+
+struct SortKey {
+    std::string column;
+    bool descending = false;
+};
+
+// ROWS BETWEEN start AND end, as offsets from the current row (negative is
+// PRECEDING). Without ORDER BY the default frame is the whole partition;
+// with it, UNBOUNDED PRECEDING to CURRENT ROW.
+struct WindowFrame {
+    static constexpr int64_t kUnboundedPreceding = std::numeric_limits<int64_t>::min();
+    static constexpr int64_t kUnboundedFollowing = std::numeric_limits<int64_t>::max();
+
+    int64_t start = kUnboundedPreceding;
+    int64_t end = kUnboundedFollowing;
+};
+
+// One window function of a select list:
+// FUNC(args) OVER (PARTITION BY ... ORDER BY ... ROWS BETWEEN ...)
+struct WindowSpec {
+    std::string name;                   // Output column name
+    WindowFunction function = WindowFunction::ROW_NUMBER;
+    AggregateFunction aggregate = AggregateFunction::NONE;   // AGGREGATE only
+    std::string source;                 // Argument column; empty for COUNT(*) and ranks
+    int64_t offset = 1;                 // LAG / LEAD distance
+    Value defaultValue = nullptr;       // LAG / LEAD past the partition's edge
+    std::vector<std::string> partitionBy;
+    std::vector<SortKey> orderBy;
+    WindowFrame frame;
+};
+
+} // namespace parallaxdb
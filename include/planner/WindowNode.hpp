@@ -0,0 +1,66 @@
+#pragma once
+
+#include "QueryPlan.hpp"
+#include "Window.hpp"
+#include "../types/Common.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace parallaxdb {
+
+// WindowNode: Evaluates window functions over its child's rows. open() drains
+// the child, hash-partitions the rows by each function's PARTITION BY keys
+// and sorts every partition by its ORDER BY keys; with enough rows the
+// partitions are sorted on worker threads. Functions sharing a PARTITION BY
+// and ORDER BY share one ordering. Framed aggregates are answered from a
+// segment tree over each partition, so a frame of any width costs O(log n).
+//
+// Output rows are the child's columns followed by one column per function,
+// in the first function's partition and sort order.
+class WindowNode : public QueryPlanNode {
+public:
+    // Windows over at least this many rows sort partitions in parallel
+    static constexpr size_t kParallelSortRows = 64 * 1024;
+
+    WindowNode(std::unique_ptr<QueryPlanNode> child, const std::vector<WindowSpec>& windows);
+    const std::vector<std::string>& getOutputColumns() const override { return outputColumns; }
+    std::string getName() const override { return "Window"; }
+    std::string getDetails() const override;
+    std::vector<const QueryPlanNode*> getChildren() const override { return {child.get()}; }
+
+    // Worker threads for sorting partitions; 0 (the default) uses one per core
+    void setParallelism(size_t threads) { parallelism = threads; }
+    // Whether the last open() sorted on worker threads
+    bool isParallel() const { return ranParallel; }
+
+protected:
+    void doOpen() override;
+    bool doNext(RowBatch& batch) override;
+
+private:
+    struct Resolved {
+        int source = -1;                  // Child column of the argument
+        std::vector<int> partitionBy;
+        std::vector<int> orderBy;
+        std::vector<bool> descending;
+    };
+
+    std::unique_ptr<QueryPlanNode> child;
+    std::vector<WindowSpec> windows;
+    std::vector<Resolved> resolved;
+    std::vector<std::string> outputColumns;
+    size_t parallelism = 0;
+    bool ranParallel = false;
+
+    std::vector<Row> rows;
+    std::vector<size_t> outputOrder;
+    size_t emitted = 0;
+    RowBatch input;
+
+    // Row indices grouped by partition, each partition sorted
+    std::vector<std::vector<size_t>> partitionRows(const Resolved& spec);
+    void evaluate(size_t w, const std::vector<size_t>& partition);
+};
+
+} // namespace parallaxdb
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace parallaxdb {
+
+// AsyncIO: Asynchronous file reads and writes. read() and write() only queue
+// a request; queued requests reach the kernel together on submit() or when a
+// result is awaited, so a batch costs one system call. At most queueDepth
+// requests are outstanding: queuing another first waits for half of them.
+//
+// On Linux the queue is an io_uring. Where io_uring is unavailable (old
+// kernels, seccomp sandboxes) a small pool of threads issues pread() and
+// pwrite() instead. One thread drives an AsyncIO, and a request's buffer must
+// stay valid until the request completes.
+class AsyncIO {
+public:
+    enum class Backend { IO_URING, THREAD_POOL };
+    using Ticket = uint64_t;
+
+    static constexpr size_t kDefaultQueueDepth = 32;
+    // Worker threads of the fallback pool, at most
+    static constexpr size_t kPoolThreads = 4;
+    // Reads or writes at the descriptor's file position, as pipes and
+    // terminals need. Keep one such request per descriptor outstanding so
+    // they cannot reorder.
+    static constexpr uint64_t kCurrentPosition = ~uint64_t(0);
+
+    explicit AsyncIO(size_t queueDepth = kDefaultQueueDepth, Backend preferred = Backend::IO_URING);
+    // Waits for every outstanding request
+    ~AsyncIO();
+    AsyncIO(const AsyncIO&) = delete;
+    AsyncIO& operator=(const AsyncIO&) = delete;
+
+    Ticket read(int fd, void* buffer, size_t length, uint64_t offset);
+    Ticket write(int fd, const void* buffer, size_t length, uint64_t offset);
+    // Hands every queued request to the kernel (or the pool)
+    void submit();
+    // Waits for a request and returns the bytes it transferred, which may be
+    // fewer than asked for. Throws if it failed. Each ticket is waited for once.
+    size_t wait(Ticket ticket);
+    // Waits for every outstanding request, discarding results not waited for
+    void drain();
+
+    Backend getBackend() const { return ring ? Backend::IO_URING : Backend::THREAD_POOL; }
+    size_t getQueueDepth() const { return queueDepth; }
+    // Batches handed over by submit(), explicit or implied
+    uint64_t getSubmitCount() const { return submitCount; }
+
+private:
+    struct Request {
+        Ticket ticket;
+        int fd;
+        bool isWrite;
+        void* buffer;
+        size_t length;
+        uint64_t offset;
+    };
+    struct Ring;
+    struct Pool;
+
+    size_t queueDepth;
+    std::unique_ptr<Ring> ring;
+    std::unique_ptr<Pool> pool;
+    Ticket nextTicket = 1;
+    std::vector<Request> queued;                 // Not yet submitted
+    size_t inFlight = 0;                         // Submitted, not yet reaped
+    std::unordered_map<Ticket, int64_t> results; // Reaped, not yet waited for; negative is -errno
+    uint64_t submitCount = 0;
+
+    Ticket enqueue(Request request);
+    // Moves finished requests into `results`; with `block`, waits for at least one
+    void reap(bool block);
+};
+
+} // namespace parallaxdb
@@ -1,16 +1,25 @@
 #pragma once
 
 #include "Table.hpp"
+#include "MaterializedView.hpp"
 #include "../types/Common.hpp"
 #include <unordered_map>
 #include <memory>
 #include <stdexcept>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
 
 namespace parallaxdb {
 
 class Database {
 public:
     Database() = default;
+    ~Database();
+    Database(const Database&) = delete;
+    Database& operator=(const Database&) = delete;
     
     // Table management
     void createTable(const std::string& tableName, const Schema& schema);
@@ -19,6 +28,14 @@ public:
     const Table* getTable(const std::string& tableName) const;
     Table* getTable(const std::string& tableName);
     
+    // Materialized views: the view's rows live in a table named `viewName`,
+    // which queries read like any other. Writes to it are rejected. An empty
+    // column list selects every base column. Dropping the view's table drops
+    // the view; a base table cannot be dropped while views depend on it.
+    void createMaterializedView(const std::string& viewName, ViewDefinition definition);
+    bool isMaterializedView(const std::string& name) const { return views.count(name) > 0; }
+    const MaterializedView* getMaterializedView(const std::string& name) const;
+    
     // Schema management
     Schema* getSchema(const std::string& tableName);
     const Schema* getSchema(const std::string& tableName) const;
@@ -26,16 +43,57 @@ public:
     // Data manipulation
     void insertInto(const std::string& tableName, const Row& row);
     void insertInto(const std::string& tableName, const std::vector<Value>& values);
+    // Validates the batch as a whole and inserts all rows or none
+    void insertRowsInto(const std::string& tableName, const std::vector<Row>& rows);
+    // Row predicates see a row's cells in column order. Both start the
+    // background compactor, which reclaims the deleted rows later.
+    size_t deleteFrom(const std::string& tableName, const std::function<bool(const CompactValue*)>& match);
+    size_t updateTable(const std::string& tableName, const std::function<bool(const CompactValue*)>& match,
+                       const std::vector<std::pair<size_t, Value>>& assignments);
+    // Builds a trigram index over a STRING column; inserts keep it current
+    void createIndex(const std::string& tableName, const std::string& indexName, const std::string& column);
+    // Empties one partition of a partitioned table; returns the rows removed
+    size_t dropPartition(const std::string& tableName, size_t partition);
+    
+    // Background compaction: a thread that wakes every `interval` (or when
+    // rows are deleted) and runs Table::compact() on every table
+    void startCompaction(std::chrono::milliseconds interval = kCompactionInterval);
+    void stopCompaction();
+    bool isCompacting() const { return compactionThread.joinable(); }
+    // Runs one compaction pass over every table on the calling thread
+    size_t compactAll();
+    
+    // Statistics
+    void analyzeTable(const std::string& tableName);
     
     // Utility methods
     std::vector<std::string> getTableNames() const;
     size_t getTableCount() const { return tables.size(); }
     
     // Clear all data (for testing)
-    void clear() { tables.clear(); }
+    void clear() {
+        std::lock_guard<std::mutex> lock(catalogMutex);
+        views.clear();
+        tables.clear();
+    }
+
+    static constexpr std::chrono::milliseconds kCompactionInterval{1000};
 
 private:
     std::unordered_map<std::string, std::unique_ptr<Table>> tables;
+    // Declared after `tables` so views unregister before their tables go
+    std::unordered_map<std::string, std::unique_ptr<MaterializedView>> views;
+
+    // Held while the table map changes and during compaction passes
+    std::mutex catalogMutex;
+    std::thread compactionThread;
+    std::condition_variable compactionWake;
+    bool compactionStop = false;
+    bool compactionPending = false;
+    
+    void requestCompaction();
+    // The table `tableName` for a write; throws if it is missing or a view
+    Table& writableTable(const std::string& tableName);
 };
 
 } // namespace parallaxdb 
\ No newline at end of file
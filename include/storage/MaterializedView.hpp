@@ -0,0 +1,92 @@
+#pragma once
+
+#include "Table.hpp"
+#include "../parser/Expression.hpp"
+#include "../planner/Aggregate.hpp"
+#include "../types/Common.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace parallaxdb {
+
+// One output column of a view: a base column, or an aggregate over one
+using ViewColumn = AggregateColumn;
+
+// SELECT columns FROM baseTable [WHERE where] [GROUP BY groupBy]
+struct ViewDefinition {
+    std::string baseTable;
+    std::vector<ViewColumn> columns;
+    std::vector<std::string> groupBy;
+    std::unique_ptr<Expression> where;  // Null for no filter
+
+    bool isAggregate() const {
+        if (!groupBy.empty()) return true;
+        for (const auto& column : columns) {
+            if (column.function != AggregateFunction::NONE) return true;
+        }
+        return false;
+    }
+};
+
+// MaterializedView: Keeps a table holding the result of a filter / project /
+// GROUP BY aggregate query over one base table. Appends to the base table
+// are applied as deltas: filtered rows are projected and appended, and for
+// aggregate views each group's running state is updated and only the groups
+// a delta touches are rewritten. Deletes and updates of base rows fall back
+// to recomputing the view.
+//
+// The view's table holds one row per group in the order groups first
+// appeared, so a group's index is its row index. Reads are plain scans.
+class MaterializedView : public TableObserver {
+public:
+    // Output schema for `definition` over `base`; throws if it is invalid
+    static Schema outputSchema(const std::string& name, const ViewDefinition& definition, const Table& base);
+
+    // `target` must be empty and have outputSchema()'s columns. Computes the
+    // view from the base table's current rows, then follows its changes.
+    MaterializedView(ViewDefinition definition, Table& base, Table& target);
+    ~MaterializedView() override;
+    MaterializedView(const MaterializedView&) = delete;
+    MaterializedView& operator=(const MaterializedView&) = delete;
+
+    void onAppend(const Table& table, const CompactValue* rows, size_t count) override;
+    void onModify(const Table& table) override;
+
+    // Recomputes the view from scratch
+    void refresh();
+
+    const ViewDefinition& getDefinition() const { return definition; }
+    const Table& getBaseTable() const { return base; }
+    size_t getGroupCount() const { return groups.size(); }
+
+private:
+    struct Group {
+        std::vector<Value> key;
+        std::vector<AggregateState> states;  // One per output column
+    };
+
+    ViewDefinition definition;
+    Table& base;
+    Table& target;
+    std::vector<int> sources;        // Base column per output column, -1 for COUNT(*)
+    std::vector<int> groupColumns;   // Base columns of the GROUP BY
+    std::vector<int> keySlots;       // Per output column: index into the group key, or -1
+
+    std::vector<Group> groups;
+    std::unordered_map<std::string, size_t> groupIndex;  // Encoded key -> group
+    std::vector<size_t> touched;                         // Existing groups changed by a delta
+    std::vector<uint8_t> isTouched;
+    std::vector<Row> pending;                            // Rows to append to the view
+    size_t flushedGroups = 0;                            // Groups already in the view's table
+    std::string keyScratch;
+
+    std::vector<AggregateState> initialStates() const;
+    void accumulate(const CompactValue* row);
+    void flush();
+    Row groupRow(const Group& group) const;
+};
+
+} // namespace parallaxdb
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "../types/Common.hpp"
+#include "../types/CompactValue.hpp"
+#include <cstdint>
+#include <string>
+#include <functional>
+#include <vector>
+#include <utility>
+#include <optional>
+
+namespace parallaxdb {
+
+// Hashing and ordering helpers shared by statistics, sketches and operators.
+// INT and DOUBLE values hash and compare by numeric value so that 3 and 3.0 agree.
+uint64_t hashValue(const Value& value);
+// Same hash for a stored cell, so cells and Values can meet in one hash table
+uint64_t hashValue(const CompactValue& value);
+int compareValues(const Value& a, const Value& b);
+bool toNumeric(const Value& value, double& out);
+// splitmix64 finalizer: spreads the bits of a key over the whole word
+uint64_t mix64(uint64_t x);
+
+struct ValueLess {
+    bool operator()(const Value& a, const Value& b) const { return compareValues(a, b) < 0; }
+};
+
+// HyperLogLog distinct-count sketch with 2^precision one-byte registers.
+class HyperLogLog {
+public:
+    explicit HyperLogLog(uint8_t precision = 12);
+
+    void add(uint64_t hash);
+    void addValue(const Value& value) { add(hashValue(value)); }
+    void merge(const HyperLogLog& other);
+    double estimate() const;
+    void clear();
+
+    uint8_t getPrecision() const { return precision; }
+
+private:
+    uint8_t precision;
+    std::vector<uint8_t> registers;
+};
+
+// KLL quantile sketch: a stack of compactors, where level h holds items of
+// weight 2^h. A full level is sorted and every other item (from a random
+// offset) is promoted, so the sketch keeps O(k log(n/k)) items and ranks
+// are off by about 1.7/k of n. Sketches with the same k merge level by
+// level, so partial sketches built in parallel combine into one.
+class QuantileSketch {
+public:
+    static constexpr size_t kDefaultK = 200;
+
+    explicit QuantileSketch(size_t k = kDefaultK);
+
+    void add(double value);
+    void merge(const QuantileSketch& other);
+    // The value at rank q * count(), for q in [0, 1]; NaN if empty
+    double quantile(double q) const;
+    uint64_t count() const { return n; }
+
+    // Items retained, for tests and sizing
+    size_t retained() const;
+
+private:
+    size_t k;
+    uint64_t n = 0;
+    double minValue = 0.0;
+    double maxValue = 0.0;
+    std::vector<std::vector<double>> levels;
+    uint64_t rng;
+
+    size_t capacity(size_t level) const;
+    void compress();
+};
+
+// Per-column statistics. Row/null counts, min/max and the distinct-count sketch
+// are maintained incrementally on insert; the histogram and most-common values
+// are (re)built by ANALYZE from a sample of the table.
+struct ColumnStatistics {
+    size_t rowCount = 0;
+    size_t nullCount = 0;
+    HyperLogLog distinct;
+    std::optional<Value> minValue;
+    std::optional<Value> maxValue;
+
+    // Equi-depth histogram over non-null values: bounds.size() - 1 buckets,
+    // each holding the same fraction of rows.
+    std::vector<Value> histogramBounds;
+    // Most common values with their frequency as a fraction of all rows.
+    std::vector<std::pair<Value, double>> mostCommonValues;
+
+    void add(const Value& value);
+    void clear();
+
+    double nullFraction() const;
+    double distinctCount() const;
+
+    // Estimated fraction of rows satisfying "column op value".
+    double estimateSelectivity(const std::string& op, const Value& value) const;
+
+private:
+    double estimateEquality(const Value& value) const;
+    double estimateFractionBelow(const Value& value) const;
+};
+
+class TableStatistics {
+public:
+    static constexpr size_t kSampleSize = 30000;
+    static constexpr size_t kHistogramBuckets = 100;
+    static constexpr size_t kMostCommonValues = 10;
+
+    TableStatistics() = default;
+    explicit TableStatistics(size_t columnCount) : columns(columnCount) {}
+
+    void recordInsert(const Row& row);
+    void recordDelete(size_t rows);
+    // valueAt(row, column) returns the stored value of a cell
+    void analyze(size_t rows, const std::function<Value(size_t, size_t)>& valueAt);
+    void reset(size_t columnCount);
+
+    size_t getRowCount() const { return rowCount; }
+    size_t getColumnCount() const { return columns.size(); }
+    const ColumnStatistics& getColumn(size_t index) const { return columns.at(index); }
+
+    bool isAnalyzed() const { return analyzed; }
+    size_t getModificationsSinceAnalyze() const { return modificationsSinceAnalyze; }
+
+private:
+    std::vector<ColumnStatistics> columns;
+    size_t rowCount = 0;
+    size_t modificationsSinceAnalyze = 0;
+    bool analyzed = false;
+};
+
+} // namespace parallaxdb
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace parallaxdb {
+
+// StringHeap: Append-only storage for the strings of a table that are too
+// long to inline in a CompactValue. Blocks never move and are only freed with
+// the heap, so cells can point into them for the table's lifetime.
+class StringHeap {
+public:
+    static constexpr size_t kBlockSize = 64 * 1024;
+
+    StringHeap() = default;
+    StringHeap(const StringHeap&) = delete;
+    StringHeap& operator=(const StringHeap&) = delete;
+    // Moving hands over the blocks; views into them stay valid
+    StringHeap(StringHeap&&) = default;
+    StringHeap& operator=(StringHeap&&) = default;
+
+    // Copies `s` into the heap and returns a view of the stored bytes
+    std::string_view store(std::string_view s) {
+        char* dest;
+        if (s.size() > kBlockSize / 4) {
+            // Large strings get a block of their own so they don't waste the tail
+            largeBlocks.push_back(std::make_unique<char[]>(s.size()));
+            dest = largeBlocks.back().get();
+            bytesReserved += s.size();
+        } else {
+            if (blocks.empty() || currentUsed + s.size() > kBlockSize) {
+                blocks.push_back(std::make_unique<char[]>(kBlockSize));
+                currentUsed = 0;
+                bytesReserved += kBlockSize;
+            }
+            dest = blocks.back().get() + currentUsed;
+            currentUsed += s.size();
+        }
+        std::memcpy(dest, s.data(), s.size());
+        bytesUsed += s.size();
+        return std::string_view(dest, s.size());
+    }
+
+    void clear() {
+        blocks.clear();
+        largeBlocks.clear();
+        currentUsed = 0;
+        bytesUsed = 0;
+        bytesReserved = 0;
+    }
+
+    size_t getBytesUsed() const { return bytesUsed; }
+    size_t getBytesReserved() const { return bytesReserved; }
+
+private:
+    std::vector<std::unique_ptr<char[]>> blocks;   // Last block is the one being filled
+    std::vector<std::unique_ptr<char[]>> largeBlocks;
+    size_t currentUsed = 0;
+    size_t bytesUsed = 0;
+    size_t bytesReserved = 0;
+};
+
+} // namespace parallaxdb
@@ -5,41 +5,244 @@
 #include <unordered_map>
 #include <variant>
 #include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <algorithm>
+#include <atomic>
+#include <functional>
 #include "../types/Common.hpp"
+#include "../types/CompactValue.hpp"
+#include "../types/ValidationProgram.hpp"
+#include "../parser/ExpressionEvaluator.hpp"
+#include "../util/HugePages.hpp"
+#include "Statistics.hpp"
+#include "StringHeap.hpp"
+#include "TrigramIndex.hpp"
 
 namespace parallaxdb {
 
+class Table;
+
+// TableObserver: Follows changes to a table, e.g. to maintain a materialized
+// view. Callbacks run on the mutating thread after the table's own lock is
+// released, so observers may read the table.
+class TableObserver {
+public:
+    virtual ~TableObserver() = default;
+    // `count` rows were appended; `rows` holds their cells row after row and
+    // is only valid during the call
+    virtual void onAppend(const Table& table, const CompactValue* rows, size_t count) = 0;
+    // Rows were deleted or changed in place
+    virtual void onModify(const Table& table) = 0;
+};
+
+// Table: Row-format storage, split into partitions by the schema's
+// PartitionSpec (a single partition if the table is not partitioned). Each
+// partition stores blocks of up to kBlockRows rows; a block lays its 16-byte
+// CompactValue cells out row after row, and strings too long to inline live
+// in the partition's StringHeap. Deleted rows are only marked in the block's
+// deletion bitmap until compact() rewrites the block without them. Once a
+// table's cells outgrow kHugePageTableBytes, new blocks are carved from
+// huge-page slabs.
 class Table {
 public:
-    Table(const std::string& name, const Schema& schema)
-        : name(name), schema(schema) {}
+    static constexpr size_t kBlockRows = 1024;
+    // Blocks with at least this fraction of deleted rows are rewritten
+    static constexpr double kCompactThreshold = 0.25;
+    // Bulk loads at least this large fill partitions on parallel threads
+    static constexpr size_t kParallelLoadRows = 64 * 1024;
+    // Cell bytes past which new blocks come from the table's huge-page slab
+    static constexpr size_t kHugePageTableBytes = HugePageSlab::kChunkBytes;
 
-    // Legacy constructor for backward compatibility
-    Table(const std::string& name, const std::vector<Column>& columns)
-        : name(name), schema(name) {
-        schema.columns = columns;
-    }
+    class Block {
+    public:
+        // Cells are allocated from `memory`
+        explicit Block(std::pmr::memory_resource* memory) : cells(memory) {}
+
+        size_t getRowCount() const { return rows; }
+        size_t getDeletedCount() const { return deletedCount; }
+        size_t getLiveCount() const { return rows - deletedCount; }
 
-    void insertRow(const Row& row) {
-        if (!DataValidator::validateRow(row, schema)) {
-            throw std::runtime_error("Row validation failed for table: " + name);
+        // The cells of row `row`, one per column
+        const CompactValue* getRowCells(size_t row, size_t width) const { return cells.data() + row * width; }
+        const CompactValue* getCells() const { return cells.data(); }
+
+        bool isDeleted(size_t row) const {
+            return deletedCount > 0 && ((deleted[row >> 6] >> (row & 63)) & 1);
         }
-        rows.push_back(row);
-    }
+        // One bit per row, set = deleted; empty while nothing is deleted
+        const std::vector<uint64_t>& getDeletionBitmap() const { return deleted; }
+
+    private:
+        friend class Table;
+        std::pmr::vector<CompactValue> cells;
+        size_t rows = 0;
+        std::vector<uint64_t> deleted;
+        size_t deletedCount = 0;
+
+        void markDeleted(size_t row) {
+            if (deleted.empty()) deleted.assign(kBlockRows / 64, 0);
+            deleted[row >> 6] |= uint64_t(1) << (row & 63);
+            deletedCount++;
+        }
+    };
+
+    class Partition {
+    public:
+        size_t getBlockCount() const { return blocks.size(); }
+        const Block& getBlock(size_t index) const { return blocks[index]; }
+        size_t getRowCount() const { return liveRows; }
+        size_t getStoredRowCount() const { return storedRows; }
+        // This partition's share of trigram index `slot`
+        const TrigramIndex& getTrigramIndex(size_t slot) const { return trigrams[slot]; }
+
+    private:
+        friend class Table;
+        std::vector<Block> blocks;
+        size_t storedRows = 0;
+        size_t liveRows = 0;
+        StringHeap strings;
+        std::vector<TrigramIndex> trigrams;   // One per table trigram index
+    };
+
+    struct TrigramIndexInfo {
+        std::string name;
+        std::string column;
+        int columnIndex;
+    };
+
+    // Scans pin the table for their lifetime; compaction never moves rows
+    // under a pinned table. Cell pointers obtained outside a scan are only
+    // stable while a Pin is held.
+    class Pin {
+    public:
+        explicit Pin(const Table& table) : table(&table) { table.pin(); }
+        ~Pin() { release(); }
+        Pin(const Pin&) = delete;
+        Pin& operator=(const Pin&) = delete;
+        void release() {
+            if (table) table->unpin();
+            table = nullptr;
+        }
+
+    private:
+        const Table* table;
+    };
+
+    Table(const std::string& name, const Schema& schema);
+
+    // Legacy constructor for backward compatibility
+    Table(const std::string& name, const std::vector<Column>& columns);
+
+    Table(const Table&) = delete;
+    Table& operator=(const Table&) = delete;
+
+    void insertRow(const Row& row);
 
     void insertRow(const std::vector<Value>& values) {
         Row row{values};
         insertRow(row);
     }
 
+    // Bulk insert: encodes every row, validates the whole batch with the
+    // compiled ValidationProgram, then appends all rows or none. Throws a
+    // ValidationError that lists every offending row. Large batches into a
+    // partitioned table load each partition on its own thread.
+    void insertRows(const std::vector<Row>& rows);
+
+    // Marks every live row for which match(cells) holds as deleted and
+    // returns how many were. match sees the row's cells in column order.
+    size_t deleteWhere(const std::function<bool(const CompactValue*)>& match);
+
+    // Sets the given columns of every live row matching `match`. Rows whose
+    // new cells all fit in place (numbers, NULL, inlined strings) are
+    // overwritten where they are; the rest are deleted and re-appended. The
+    // new rows are validated as one batch first, so either every matching
+    // row is updated or none is. Returns the number of rows updated.
+    size_t updateWhere(const std::function<bool(const CompactValue*)>& match,
+                       const std::vector<std::pair<size_t, Value>>& assignments);
+
+    // Partitions
+    bool isPartitioned() const { return schema.partitioning.method != PartitionSpec::NONE; }
+    size_t getPartitionCount() const { return partitions.size(); }
+    const Partition& getPartition(size_t index) const { return partitions[index]; }
+    // Schema index of the partition key column, or -1
+    int getPartitionColumn() const { return partitionColumn; }
+    // The partition a row with partition key `key` is stored in
+    size_t partitionFor(const CompactValue& key) const;
+    // False only if no row of partition `index` can satisfy "key op value"
+    bool partitionMayMatch(size_t index, CompareOp op, const CompactValue& value) const;
+    // Threads for parallel bulk loads; 0 (the default) uses one per core
+    void setLoadParallelism(size_t threads) { loadParallelism = threads; }
+    // NUMA node partition `index` is placed on. Parallel loads fill it from
+    // a thread pinned to that node; blocks appended from elsewhere are bound
+    // to it with mbind.
+    size_t getHomeNode(size_t index) const;
+    // Empties partition `index` at once, releasing its blocks and strings.
+    // Returns the number of live rows removed.
+    size_t dropPartition(size_t index);
+    // "[lo, hi)" for RANGE partitions, "hash % n = i" for HASH
+    std::string describePartition(size_t index) const;
+
+    // Trigram indexes over STRING columns. Each partition indexes its own rows
+    // by position (see indexRowId); appends extend the posting lists, and
+    // anything that moves or rewrites stored rows rebuilds the partition's.
+    void createTrigramIndex(const std::string& indexName, const std::string& column);
+    const std::vector<TrigramIndexInfo>& getTrigramIndexes() const { return trigramIndexes; }
+    // Slot of the trigram index on schema column `column`, or -1
+    int findTrigramIndex(int column) const;
+    // Bytes held by the posting lists of every trigram index
+    size_t getIndexBytes() const;
+    static uint32_t indexRowId(size_t block, size_t row) { return static_cast<uint32_t>(block * kBlockRows + row); }
+
+    // Overwrites the index-th live row with `row`, which must be valid
+    void replaceRow(size_t index, const Row& row);
+
+    // Removes every row at once. Throws while the table is being scanned.
+    void truncate();
+
+    // Changes whenever the table's contents or schema do. Versions come from
+    // one process-wide counter, so a dropped and re-created table never
+    // repeats one.
+    uint64_t getVersion() const { return version.load(std::memory_order_acquire); }
+
+    // Observers are not owned and must unregister before they are destroyed
+    void addObserver(TableObserver* observer) { observers.push_back(observer); }
+    void removeObserver(TableObserver* observer) {
+        observers.erase(std::remove(observers.begin(), observers.end(), observer), observers.end());
+    }
+
+    // Rewrites blocks whose deleted fraction is at least `threshold` without
+    // their deleted rows, folding them into the previous block when they fit.
+    // Skipped while the table is pinned; returns the number of rows reclaimed.
+    size_t compact(double threshold = kCompactThreshold);
+
     const std::vector<Column>& getColumns() const {
         return schema.columns;
     }
 
-    const std::vector<Row>& getRows() const {
-        return rows;
+    // Live (not deleted) rows
+    size_t getRowCount() const {
+        return liveRows;
+    }
+
+    // Rows still stored, including deleted ones awaiting compaction
+    size_t getStoredRowCount() const {
+        std::lock_guard<std::mutex> lock(storageMutex);
+        return storedRows;
     }
 
+    // Blocks across all partitions
+    size_t getBlockCount() const;
+
+    // The cells of the index-th live row
+    const CompactValue* getRowCells(size_t index) const;
+
+    Row getRow(size_t index) const;
+
+    // Bytes held by cells, deletion bitmaps and the string heap
+    size_t getStorageBytes() const;
+
     const std::string& getName() const {
         return name;
     }
@@ -48,14 +251,28 @@ public:
         return schema;
     }
 
-    // Schema management
-    void setSchema(const Schema& newSchema) {
-        schema = newSchema;
+    // Schema management. The partitioning cannot change.
+    void setSchema(const Schema& newSchema);
+
+    // Statistics
+    const TableStatistics& getStatistics() const {
+        return statistics;
     }
 
+    // Rebuild histograms and most-common values from a sample of the rows
+    void analyze();
+
     // Data validation
     bool validateRow(const Row& row) const {
-        return DataValidator::validateRow(row, schema);
+        std::vector<CompactValue> rowCells;
+        for (const auto& value : row.values) {
+            rowCells.push_back(CompactValue::borrow(value));
+        }
+        return validation->validateRow(rowCells.data(), rowCells.size());
+    }
+
+    const ValidationProgram& getValidationProgram() const {
+        return *validation;
     }
 
     // Get column index by name
@@ -77,7 +294,52 @@ public:
 private:
     std::string name;
     Schema schema;
-    std::vector<Row> rows;
+    std::unique_ptr<ValidationProgram> validation;  // Compiled from schema
+    HugePageSlab slab;                              // Declared first: outlives the blocks in it
+    std::vector<Partition> partitions;
+    int partitionColumn = -1;
+    std::vector<CompactValue> partitionBounds;      // Borrows from schema.partitioning
+    size_t storedRows = 0;
+    size_t liveRows = 0;
+    size_t loadParallelism = 0;
+    std::vector<CompactValue> encoded;   // Scratch for inserts and updates
+    TableStatistics statistics;
+    std::vector<TableObserver*> observers;
+    std::vector<TrigramIndexInfo> trigramIndexes;
+    std::atomic<uint64_t> version{nextVersion()};
+
+    // Guards partitions against the background compactor. Mutations run on the
+    // statement thread and take it briefly; compaction holds it throughout.
+    mutable std::mutex storageMutex;
+    mutable size_t pins = 0;
+
+    void pin() const {
+        std::lock_guard<std::mutex> lock(storageMutex);
+        pins++;
+    }
+    void unpin() const {
+        std::lock_guard<std::mutex> lock(storageMutex);
+        pins--;
+    }
+
+    void initPartitions();
+    // Appends `count` encoded rows to their partitions
+    void appendEncoded(const CompactValue* rows, size_t count);
+    // Appends the listed rows to one partition, copying long strings into its
+    // heap. New blocks take their cells from `memory`.
+    void appendToPartition(Partition& partition, const CompactValue* rows, const uint32_t* indices, size_t count,
+                           std::pmr::memory_resource* memory);
+    // The index-th live row, and optionally the partition holding it
+    const CompactValue* locateLive(size_t index, const Partition** owner = nullptr) const;
+    static uint64_t nextVersion();
+    // Bump the version, then tell the observers
+    void notifyAppend(const CompactValue* rows, size_t count);
+    void notifyModify();
+    void compactBlock(Partition& partition, size_t index);
+    // Adds a stored row's indexed strings to the partition's trigram indexes
+    void indexRow(Partition& partition, uint32_t rowId, const CompactValue* row);
+    // Re-indexes the partition's live rows from scratch
+    void rebuildIndexes(Partition& partition);
 };
 
 } // namespace parallaxdb
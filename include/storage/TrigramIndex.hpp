@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace parallaxdb {
+
+// TrigramIndex: Inverted index over the strings of one column, mapping every
+// three-byte sequence to the rows whose value contains it. Each posting list
+// holds ascending row IDs as varint-encoded gaps, so dense lists cost about a
+// byte per row. A literal of three or more bytes can only occur in rows found
+// in the posting list of every one of its trigrams; intersecting those lists
+// yields candidate rows, which still have to be checked against the predicate.
+class TrigramIndex {
+public:
+    static constexpr size_t kGramLength = 3;
+
+    // Row IDs must be added in ascending order
+    void add(uint32_t rowId, std::string_view text);
+    void clear();
+
+    // Whether some literal is long enough to have trigrams
+    static bool usable(const std::vector<std::string>& literals);
+    // Rows that may contain every literal, ascending. Literals shorter than
+    // kGramLength do not restrict the result; at least one must be usable.
+    void lookup(const std::vector<std::string>& literals, std::vector<uint32_t>& out) const;
+    // Upper bound on lookup()'s result size: the shortest posting list
+    size_t estimate(const std::vector<std::string>& literals) const;
+
+    size_t getTrigramCount() const { return lists.size(); }
+    // Bytes of encoded posting lists
+    size_t getBytes() const;
+
+private:
+    struct PostingList {
+        std::vector<uint8_t> bytes;
+        uint32_t last = 0;
+        uint32_t count = 0;
+    };
+
+    std::unordered_map<uint32_t, PostingList> lists;
+
+    static uint32_t gramAt(std::string_view text, size_t at) {
+        return (static_cast<uint32_t>(static_cast<unsigned char>(text[at])) << 16) |
+               (static_cast<uint32_t>(static_cast<unsigned char>(text[at + 1])) << 8) |
+               static_cast<unsigned char>(text[at + 2]);
+    }
+    // The posting lists of the literals' trigrams, shortest first; an entry is
+    // null if a trigram occurs nowhere
+    std::vector<const PostingList*> listsFor(const std::vector<std::string>& literals) const;
+};
+
+} // namespace parallaxdb
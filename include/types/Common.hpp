@@ -1,10 +1,12 @@
 #pragma once
+#include <cstdint>
 #include <variant>
 #include <string>
 #include <vector>
 #include <optional>
 #include <functional>
 #include <iostream>
+#include <stdexcept>
 
 namespace parallaxdb {
     using Value = std::variant<int, double, std::string, std::nullptr_t>;
@@ -44,23 +46,84 @@ namespace parallaxdb {
         Column(const std::string& n, DataType t) : name(n), type(t) {}
     };
     
+    // How a table's rows are split into partitions. RANGE partition i holds
+    // keys in [bounds[i-1], bounds[i]); the first and last partitions are
+    // open-ended, so there are bounds.size() + 1 of them. HASH spreads rows
+    // over partitionCount partitions by the key's hash.
+    struct PartitionSpec {
+        enum Method { NONE, RANGE, HASH };
+        
+        Method method = NONE;
+        std::string column;
+        std::vector<Value> bounds;    // RANGE: ascending
+        size_t partitionCount = 1;    // HASH
+        
+        size_t count() const {
+            if (method == RANGE) return bounds.size() + 1;
+            if (method == HASH) return partitionCount;
+            return 1;
+        }
+    };
+    
+    // TABLESAMPLE on a table reference. BERNOULLI keeps each row with
+    // probability percent / 100; SYSTEM keeps or skips whole storage blocks
+    // with that probability, so skipped blocks are never read. A sample is a
+    // deterministic function of the seed (REPEATABLE) and the rows' places.
+    struct TableSample {
+        enum Method { NONE, BERNOULLI, SYSTEM };
+        
+        Method method = NONE;
+        double percent = 100.0;
+        uint64_t seed = 0;
+        
+        double fraction() const { return method == NONE ? 1.0 : percent / 100.0; }
+    };
+    
     struct Schema {
         std::string tableName;
         std::vector<Column> columns;
         std::vector<std::string> primaryKeys;
+        PartitionSpec partitioning;
         
         Schema(const std::string& name) : tableName(name) {}
     };
     
-    // Data validation utilities
+    class CompactValue;
+    
+    // Data validation utilities. Rows are validated in their stored
+    // CompactValue form; the Value overloads encode and delegate.
     class DataValidator {
     public:
         static bool validateValue(const Value& value, DataType type);
         static bool validateRow(const Row& row, const Schema& schema);
+        static bool validateValue(const CompactValue& value, DataType type);
+        static bool validateRow(const CompactValue* cells, size_t count, const Schema& schema);
         static std::string getTypeName(DataType type);
         static DataType parseTypeName(const std::string& typeName);
     };
     
+    // Resolves a column reference against an operator's output column names.
+    // Output columns are qualified ("table.column"); an unqualified reference
+    // matches by suffix. Returns -1 if not found, throws if ambiguous.
+    inline int findColumn(const std::vector<std::string>& columns, const std::string& name) {
+        for (size_t i = 0; i < columns.size(); ++i) {
+            if (columns[i] == name) return static_cast<int>(i);
+        }
+        if (name.find('.') != std::string::npos) return -1;
+        int found = -1;
+        for (size_t i = 0; i < columns.size(); ++i) {
+            const std::string& col = columns[i];
+            if (col.size() > name.size() && col[col.size() - name.size() - 1] == '.' &&
+                col.compare(col.size() - name.size(), name.size(), name) == 0) {
+                if (found >= 0) {
+                    throw std::runtime_error("Ambiguous column reference: " + name);
+                }
+                found = static_cast<int>(i);
+            }
+        }
+        return found;
+    }
+    
     // Helper function to print variant values
     inline std::ostream& operator<<(std::ostream& os, const Value& val) {
         std::visit([&os](const auto& v) { os << v; }, val);
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "Common.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+
+namespace parallaxdb {
+
+// CompactValue: 16-byte tagged cell used by row-format table storage in place
+// of the 40-byte Value variant.
+//
+//   bytes 0-3    kind (top 4 bits) | string length (low 28 bits)
+//   bytes 4-7    STRING: first four characters, zero padded
+//   bytes 8-15   INT / DOUBLE payload; STRING: characters 4-11 when the
+//                string fits inline (up to 12 bytes), else a pointer to it
+//
+// Long strings are not owned: the pointer refers to storage kept alive by
+// whoever built the cell (a table's StringHeap, an expression's literal).
+// The inline prefix lets most string comparisons finish without following
+// the pointer.
+class alignas(8) CompactValue {
+public:
+    enum class Kind : uint8_t { NULL_VALUE = 0, INT, DOUBLE, STRING };
+
+    static constexpr size_t kInlineLength = 12;
+    static constexpr size_t kPrefixLength = 4;
+    static constexpr uint32_t kMaxLength = (1u << 28) - 1;
+
+    CompactValue() : header(0), bytes{} {}
+
+    static CompactValue ofInt(int v) {
+        CompactValue cell(Kind::INT, 0);
+        std::memcpy(cell.bytes + kPrefixLength, &v, sizeof(v));
+        return cell;
+    }
+
+    static CompactValue ofDouble(double v) {
+        CompactValue cell(Kind::DOUBLE, 0);
+        std::memcpy(cell.bytes + kPrefixLength, &v, sizeof(v));
+        return cell;
+    }
+
+    // Strings longer than kInlineLength point at `s`, which must outlive the cell
+    static CompactValue ofString(std::string_view s) {
+        if (s.size() > kMaxLength) {
+            throw std::length_error("String value too long");
+        }
+        CompactValue cell(Kind::STRING, s.size());
+        if (s.size() <= kInlineLength) {
+            std::memcpy(cell.bytes, s.data(), s.size());
+        } else {
+            const char* data = s.data();
+            std::memcpy(cell.bytes, data, kPrefixLength);
+            std::memcpy(cell.bytes + kPrefixLength, &data, sizeof(data));
+        }
+        return cell;
+    }
+
+    // Encodes a Value; long strings borrow the Value's buffer
+    static CompactValue borrow(const Value& value) {
+        if (std::holds_alternative<int>(value)) return ofInt(std::get<int>(value));
+        if (std::holds_alternative<double>(value)) return ofDouble(std::get<double>(value));
+        if (std::holds_alternative<std::string>(value)) return ofString(std::get<std::string>(value));
+        return CompactValue();
+    }
+
+    Kind kind() const { return static_cast<Kind>(header >> 28); }
+    bool isNull() const { return kind() == Kind::NULL_VALUE; }
+    bool isString() const { return kind() == Kind::STRING; }
+    bool isNumeric() const { return kind() == Kind::INT || kind() == Kind::DOUBLE; }
+    bool isInlined() const { return length() <= kInlineLength; }
+
+    int asInt() const {
+        int v;
+        std::memcpy(&v, bytes + kPrefixLength, sizeof(v));
+        return v;
+    }
+
+    double asDouble() const {
+        double v;
+        std::memcpy(&v, bytes + kPrefixLength, sizeof(v));
+        return v;
+    }
+
+    double asNumber() const { return kind() == Kind::INT ? asInt() : asDouble(); }
+
+    size_t length() const { return header & kMaxLength; }
+
+    std::string_view asString() const {
+        if (isInlined()) {
+            return std::string_view(bytes, length());
+        }
+        const char* data;
+        std::memcpy(&data, bytes + kPrefixLength, sizeof(data));
+        return std::string_view(data, length());
+    }
+
+    // A string's first kPrefixLength characters (fewer if it is shorter),
+    // read without following the pointer of a long string
+    std::string_view prefix() const {
+        return std::string_view(bytes, std::min(length(), kPrefixLength));
+    }
+
+    Value toValue() const {
+        switch (kind()) {
+            case Kind::INT: return asInt();
+            case Kind::DOUBLE: return asDouble();
+            case Kind::STRING: return std::string(asString());
+            default: return nullptr;
+        }
+    }
+
+    // String equality; length and prefix mismatches are rejected in place
+    static bool stringsEqual(const CompactValue& a, const CompactValue& b) {
+        if (a.header != b.header || std::memcmp(a.bytes, b.bytes, kPrefixLength) != 0) {
+            return false;
+        }
+        if (a.isInlined()) {
+            // Inline strings are zero padded, so the tails compare directly
+            return std::memcmp(a.bytes + kPrefixLength, b.bytes + kPrefixLength,
+                               kInlineLength - kPrefixLength) == 0;
+        }
+        return a.asString() == b.asString();
+    }
+
+    // Three-way string comparison, decided on the prefix when it differs
+    static int compareStrings(const CompactValue& a, const CompactValue& b) {
+        size_t prefix = std::min({a.length(), b.length(), kPrefixLength});
+        int cmp = std::memcmp(a.bytes, b.bytes, prefix);
+        if (cmp != 0) return cmp;
+        return a.asString().compare(b.asString());
+    }
+
+private:
+    uint32_t header;
+    char bytes[kInlineLength];
+
+    CompactValue(Kind kind, size_t length)
+        : header((static_cast<uint32_t>(kind) << 28) | static_cast<uint32_t>(length)), bytes{} {}
+};
+
+static_assert(sizeof(CompactValue) == 16, "CompactValue must stay 16 bytes");
+
+} // namespace parallaxdb
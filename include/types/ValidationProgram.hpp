@@ -0,0 +1,87 @@
+#pragma once
+
+#include "Common.hpp"
+#include "CompactValue.hpp"
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace parallaxdb {
+
+struct Expression;
+
+// One rejected cell (or, for CHECK, row) of a validated batch
+struct ValidationFailure {
+    enum Reason { TYPE_MISMATCH, NOT_NULL, BOOLEAN_RANGE, CHECK };
+
+    size_t row;           // Index within the batch
+    size_t column;        // Schema column; for CHECK, the column it is declared on
+    Reason reason;
+    std::string constraint; // CHECK expression text, otherwise empty
+
+    std::string toString(const Schema& schema) const;
+};
+
+// ValidationProgram: A schema's validation rules compiled once into flat
+// per-column steps. validate() walks a batch column by column, so each step
+// is a tight loop over one column's cells: the type check and NOT NULL are a
+// single bit test of the cell's kind against a precomputed mask. CHECK
+// constraints are parsed and bound to the schema's columns at compile time.
+//
+// Compile outside any ArenaScope; the CHECK expressions outlive statements.
+class ValidationProgram {
+public:
+    explicit ValidationProgram(const Schema& schema);
+    ~ValidationProgram();
+    ValidationProgram(const ValidationProgram&) = delete;
+    ValidationProgram& operator=(const ValidationProgram&) = delete;
+
+    // Validates `rows` rows of row-major cells, width() cells per row.
+    // Failures are appended to `failures` ordered by row, then column.
+    // Returns true if every row is valid.
+    bool validate(const CompactValue* cells, size_t rows, std::vector<ValidationFailure>& failures) const;
+
+    // Single-row form; stops at the first failure
+    bool validateRow(const CompactValue* cells, size_t count) const;
+
+    size_t width() const { return columns.size(); }
+    bool hasChecks() const { return !checks.empty(); }
+
+private:
+    struct ColumnStep {
+        uint32_t allowedKinds;  // Bit per CompactValue::Kind
+        bool notNull;
+        bool boolean;           // INT cells must be 0 or 1
+    };
+    struct CheckStep {
+        size_t column;
+        std::string text;
+        std::unique_ptr<Expression> expr;
+        std::vector<size_t> inputs; // Columns read; a NULL input makes the check pass
+    };
+
+    std::vector<ColumnStep> columns;
+    std::vector<CheckStep> checks;
+
+    static uint32_t kindBit(CompactValue::Kind kind) { return 1u << static_cast<uint32_t>(kind); }
+    bool checkPasses(const CheckStep& check, const CompactValue* row) const;
+};
+
+// Thrown when a batch insert is rejected; carries every offending row
+class ValidationError : public std::runtime_error {
+public:
+    ValidationError(const std::string& message, std::vector<ValidationFailure> failures)
+        : std::runtime_error(message), failures(std::move(failures)) {}
+
+    const std::vector<ValidationFailure>& getFailures() const { return failures; }
+
+    // Distinct offending row indices, ascending
+    std::vector<size_t> getRows() const;
+
+private:
+    std::vector<ValidationFailure> failures;
+};
+
+} // namespace parallaxdb
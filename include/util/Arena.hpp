@@ -0,0 +1,109 @@
+#pragma once
+
+#include "HugePages.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+#include <vector>
+
+namespace parallaxdb {
+
+// QueryArena: Monotonic per-query memory. Everything allocated from it is
+// released at once by reset(); individual deallocations are no-ops. The
+// first block is kept across resets so steady-state queries never reach
+// the global allocator for plan and expression nodes. Growth past 2MB is
+// mapped on huge pages.
+class QueryArena {
+public:
+    static constexpr size_t kInitialBlockSize = 64 * 1024;
+
+    QueryArena()
+        : initialBlock(kInitialBlockSize),
+          resource(initialBlock.data(), initialBlock.size(), HugePageResource::get()) {}
+    QueryArena(const QueryArena&) = delete;
+    QueryArena& operator=(const QueryArena&) = delete;
+
+    void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+        bytesAllocated += bytes;
+        return resource.allocate(bytes, alignment);
+    }
+
+    void reset() {
+        resource.release();
+        bytesAllocated = 0;
+    }
+
+    std::pmr::memory_resource* getResource() { return &resource; }
+    size_t getBytesAllocated() const { return bytesAllocated; }
+
+    // The arena that ArenaAllocated objects are placed in on this thread, if any
+    static QueryArena* current() { return currentArena(); }
+
+    // One reusable arena per thread for statement processing
+    static QueryArena& forThread() {
+        static thread_local QueryArena arena;
+        return arena;
+    }
+
+private:
+    friend class ArenaScope;
+
+    std::vector<std::byte> initialBlock;
+    std::pmr::monotonic_buffer_resource resource;
+    size_t bytesAllocated = 0;
+
+    static QueryArena*& currentArena() {
+        static thread_local QueryArena* arena = nullptr;
+        return arena;
+    }
+};
+
+// ArenaScope: Makes an arena current for its lifetime and resets it on exit.
+// Every arena-allocated object created inside the scope must be destroyed
+// before the scope ends; objects that outlive a statement (catalog entries,
+// stored expressions) must be created outside any scope.
+class ArenaScope {
+public:
+    explicit ArenaScope(QueryArena& arena) : arena(arena), previous(QueryArena::currentArena()) {
+        QueryArena::currentArena() = &arena;
+    }
+    ~ArenaScope() {
+        QueryArena::currentArena() = previous;
+        arena.reset();
+    }
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+private:
+    QueryArena& arena;
+    QueryArena* previous;
+};
+
+// ArenaAllocated: Base for per-query objects (plan nodes, expressions).
+// Instances created while an ArenaScope is active come from its arena and
+// their delete is free; otherwise they use the global heap. A small header in
+// front of each object records which.
+struct ArenaAllocated {
+    static void* operator new(size_t size) {
+        QueryArena* arena = QueryArena::current();
+        void* block = arena ? arena->allocate(size + kHeaderSize) : ::operator new(size + kHeaderSize);
+        *static_cast<uint64_t*>(block) = arena ? kArenaTag : kHeapTag;
+        return static_cast<std::byte*>(block) + kHeaderSize;
+    }
+
+    static void operator delete(void* ptr) {
+        if (!ptr) return;
+        void* block = static_cast<std::byte*>(ptr) - kHeaderSize;
+        if (*static_cast<uint64_t*>(block) == kHeapTag) {
+            ::operator delete(block);
+        }
+    }
+
+private:
+    static constexpr size_t kHeaderSize = alignof(std::max_align_t);
+    static constexpr uint64_t kHeapTag = 0;
+    static constexpr uint64_t kArenaTag = 1;
+};
+
+} // namespace parallaxdb
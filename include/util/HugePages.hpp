@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace parallaxdb {
+
+enum class HugePagePolicy {
+    OFF,           // Regular pages only
+    TRANSPARENT,   // 2MB-aligned mappings advised with MADV_HUGEPAGE (the default)
+    EXPLICIT       // MAP_HUGETLB from the reserved pool, else as TRANSPARENT
+};
+
+// What large allocations actually got. Byte counts are of live mappings.
+struct HugePageStats {
+    uint64_t explicitBytes = 0;      // From the hugetlb pool
+    uint64_t transparentBytes = 0;   // Advised for transparent huge pages
+    uint64_t regularBytes = 0;       // Left on regular pages
+    uint64_t fallbacks = 0;          // Requests that got less than the policy asked for
+};
+
+// HugePageResource: Backs large buffers (hash tables, Bloom filters, table
+// storage slabs, arena growth) with 2MB pages, so random probes into them
+// miss the TLB far less often. Requests of at least kMinBytes get their own
+// 2MB-aligned mapping; smaller ones go to the global heap. Where huge pages
+// are refused (no hugetlb pool, THP disabled) the mapping keeps regular
+// pages. Thread-safe.
+class HugePageResource : public std::pmr::memory_resource {
+public:
+    static constexpr size_t kPageBytes = size_t(2) << 20;
+    static constexpr size_t kMinBytes = kPageBytes;
+
+    static HugePageResource* get();
+    // Applies to allocations made after the call
+    static void setPolicy(HugePagePolicy policy);
+    static HugePagePolicy getPolicy();
+    static HugePageStats getStats();
+    // Anonymous memory of this process the kernel currently backs with
+    // transparent huge pages (AnonHugePages); 0 where it is not reported
+    static uint64_t getResidentTransparentBytes();
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* data, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+
+// HugePageSlab: Serves many equally sized buffers (a table's blocks) from
+// shared huge-page chunks, keeping a free list per size so buffers freed by
+// compaction are reused. Chunks return to the system only on release() or
+// destruction. Requests too large to share a chunk go straight to
+// HugePageResource. Thread-safe.
+class HugePageSlab : public std::pmr::memory_resource {
+public:
+    static constexpr size_t kChunkBytes = 4 * HugePageResource::kPageBytes;
+
+    HugePageSlab() = default;
+    ~HugePageSlab() override { release(); }
+    HugePageSlab(const HugePageSlab&) = delete;
+    HugePageSlab& operator=(const HugePageSlab&) = delete;
+
+    // Unmaps every chunk; nothing may still be allocated from them
+    void release();
+    // Bytes of the chunks mapped so far
+    size_t getMappedBytes() const;
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* data, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+private:
+    mutable std::mutex mutex;
+    std::vector<void*> chunks;
+    size_t used = kChunkBytes;                                // Carved from the last chunk
+    std::unordered_map<size_t, std::vector<void*>> reusable;  // Freed buffers by size
+};
+
+} // namespace parallaxdb
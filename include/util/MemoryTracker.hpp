@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace parallaxdb {
+
+// MemoryTracker: Per-thread heap accounting fed by the global operator
+// new/delete replacements in MemoryTracker.cpp. Counters are cumulative, so
+// callers measure an interval by differencing two readings.
+class MemoryTracker {
+public:
+    // Total bytes requested through operator new on this thread
+    static uint64_t getBytesAllocated();
+    // Bytes currently live that this thread allocated (or freed)
+    static int64_t getCurrentBytes();
+    // High-water mark of getCurrentBytes() since the last setPeakBytes()
+    static int64_t getPeakBytes();
+    static void setPeakBytes(int64_t peak);
+    // Accounts memory mapped directly rather than obtained through operator
+    // new: positive when mapped, negative when unmapped
+    static void recordMapped(int64_t bytes);
+};
+
+} // namespace parallaxdb
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace parallaxdb {
+
+// NumaTopology: The machine's NUMA nodes and the CPUs of each, read from
+// sysfs. Machines without NUMA (or without sysfs) appear as one node holding
+// every CPU. Threads are placed with sched_setaffinity and memory with mbind;
+// both are best effort, since containers often forbid them.
+//
+// Partition p of every table has home node p % getNodeCount(): bulk loads
+// fill it from a thread on that node, so its blocks are first touched there,
+// and parallel scans prefer to read it from a worker on that node.
+class NumaTopology {
+public:
+    static constexpr const char* kSysfsRoot = "/sys/devices/system/node";
+
+    // Reads node<N>/cpulist under `sysfsRoot`
+    static NumaTopology detect(const std::string& sysfsRoot = kSysfsRoot);
+    // One node with the CPUs this process may run on
+    static NumaTopology flat();
+    // The topology used by the engine, detected on first use
+    static std::shared_ptr<const NumaTopology> current();
+    // Replaces the engine's topology, e.g. with flat() to turn placement off
+    static void install(NumaTopology topology);
+
+    size_t getNodeCount() const { return nodes.size(); }
+    const std::vector<int>& getCpus(size_t node) const { return nodes[node]; }
+    // Node of `cpu`; 0 for CPUs the topology does not list
+    size_t nodeOfCpu(int cpu) const;
+    // Node of the CPU the calling thread is running on
+    size_t currentNode() const;
+
+    // Restricts the calling thread to the node's CPUs. False if refused.
+    bool pinThread(size_t node) const;
+    // Lets the calling thread run anywhere again
+    static void unpinThread();
+    // Asks for the whole pages of [data, data + bytes) to be allocated on
+    // `node` when first touched. False if refused.
+    bool bindMemory(void* data, size_t bytes, size_t node) const;
+
+    // "0-3,8,10-11" -> {0, 1, 2, 3, 8, 10, 11}
+    static std::vector<int> parseCpuList(const std::string& list);
+
+private:
+    std::vector<std::vector<int>> nodes;   // CPUs per node, ascending
+    std::vector<int> ids;                  // Kernel node number of each node
+};
+
+} // namespace parallaxdb
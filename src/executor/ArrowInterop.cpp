@@ -0,0 +1,290 @@
+#include "../../include/executor/ArrowInterop.hpp"
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+
+namespace parallaxdb {
+
+namespace {
+
+// Buffers and struct storage for one exported column
+struct ExportedColumn {
+    std::string format;
+    std::string name;
+    std::vector<uint8_t> validity;
+    std::vector<int32_t> ints;      // int32 values, or utf8 offsets
+    std::vector<double> doubles;
+    std::string chars;
+    std::vector<const void*> buffers;
+    ArrowSchema schema{};
+    ArrowArray array{};
+};
+
+// Everything behind one exported struct array. The schema and the array are
+// released independently by the consumer, so both hold a reference.
+struct ExportedBatch {
+    std::vector<std::unique_ptr<ExportedColumn>> columns;
+    std::vector<ArrowSchema*> schemaChildren;
+    std::vector<ArrowArray*> arrayChildren;
+    const void* structBuffers[1] = {nullptr};
+    int references = 2;
+};
+
+void dropReference(ExportedBatch* batch) {
+    if (--batch->references == 0) delete batch;
+}
+
+// Children are owned by the parent; releasing one only marks it released
+void releaseChildSchema(ArrowSchema* schema) { schema->release = nullptr; }
+void releaseChildArray(ArrowArray* array) { array->release = nullptr; }
+
+void releaseSchema(ArrowSchema* schema) {
+    for (int64_t i = 0; i < schema->n_children; ++i) {
+        if (schema->children[i]->release) schema->children[i]->release(schema->children[i]);
+    }
+    dropReference(static_cast<ExportedBatch*>(schema->private_data));
+    schema->release = nullptr;
+}
+
+void releaseArray(ArrowArray* array) {
+    for (int64_t i = 0; i < array->n_children; ++i) {
+        if (array->children[i]->release) array->children[i]->release(array->children[i]);
+    }
+    dropReference(static_cast<ExportedBatch*>(array->private_data));
+    array->release = nullptr;
+}
+
+enum class ColumnKind { NULLS, INT, DOUBLE, STRING };
+
+ColumnKind inferKind(const std::vector<Row>& rows, size_t c) {
+    ColumnKind kind = ColumnKind::NULLS;
+    for (const auto& row : rows) {
+        const Value& v = row.values[c];
+        if (std::holds_alternative<std::string>(v)) return ColumnKind::STRING;
+        if (std::holds_alternative<double>(v)) kind = ColumnKind::DOUBLE;
+        if (std::holds_alternative<int>(v) && kind == ColumnKind::NULLS) kind = ColumnKind::INT;
+    }
+    return kind;
+}
+
+std::string toText(const Value& v) {
+    if (std::holds_alternative<std::string>(v)) return std::get<std::string>(v);
+    std::ostringstream os;
+    os << v;
+    return os.str();
+}
+
+void fillColumn(ExportedColumn& col, const std::vector<Row>& rows, size_t c) {
+    const size_t n = rows.size();
+    ColumnKind kind = inferKind(rows, c);
+    col.validity.assign((n + 7) / 8, 0);
+    int64_t nullCount = 0;
+    for (size_t r = 0; r < n; ++r) {
+        if (std::holds_alternative<std::nullptr_t>(rows[r].values[c])) {
+            nullCount++;
+        } else {
+            col.validity[r / 8] |= static_cast<uint8_t>(1 << (r % 8));
+        }
+    }
+
+    const void* validity = nullCount > 0 ? col.validity.data() : nullptr;
+    switch (kind) {
+        case ColumnKind::NULLS:
+            col.format = "n";
+            break;
+        case ColumnKind::INT:
+            col.format = "i";
+            col.ints.resize(n);
+            for (size_t r = 0; r < n; ++r) {
+                const Value& v = rows[r].values[c];
+                col.ints[r] = std::holds_alternative<int>(v) ? std::get<int>(v) : 0;
+            }
+            col.buffers = {validity, col.ints.data()};
+            break;
+        case ColumnKind::DOUBLE:
+            col.format = "g";
+            col.doubles.resize(n);
+            for (size_t r = 0; r < n; ++r) {
+                const Value& v = rows[r].values[c];
+                if (std::holds_alternative<double>(v)) col.doubles[r] = std::get<double>(v);
+                else if (std::holds_alternative<int>(v)) col.doubles[r] = std::get<int>(v);
+            }
+            col.buffers = {validity, col.doubles.data()};
+            break;
+        case ColumnKind::STRING:
+            col.format = "u";
+            col.ints.reserve(n + 1);
+            col.ints.push_back(0);
+            for (size_t r = 0; r < n; ++r) {
+                const Value& v = rows[r].values[c];
+                if (!std::holds_alternative<std::nullptr_t>(v)) col.chars += toText(v);
+                if (col.chars.size() > static_cast<size_t>(std::numeric_limits<int32_t>::max())) {
+                    throw std::runtime_error("Column '" + col.name + "' exceeds 2GB of utf8 data");
+                }
+                col.ints.push_back(static_cast<int32_t>(col.chars.size()));
+            }
+            col.buffers = {validity, col.ints.data(), col.chars.data()};
+            break;
+    }
+
+    col.schema.format = col.format.c_str();
+    col.schema.name = col.name.c_str();
+    col.schema.flags = ARROW_FLAG_NULLABLE;
+    col.schema.release = releaseChildSchema;
+
+    col.array.length = static_cast<int64_t>(n);
+    col.array.null_count = kind == ColumnKind::NULLS ? static_cast<int64_t>(n) : nullCount;
+    col.array.n_buffers = static_cast<int64_t>(col.buffers.size());
+    col.array.buffers = col.buffers.empty() ? nullptr : col.buffers.data();
+    col.array.release = releaseChildArray;
+}
+
+// Import helpers
+
+bool isValid(const ArrowArray* array, int64_t index) {
+    const auto* validity = static_cast<const uint8_t*>(array->buffers[0]);
+    return array->null_count == 0 || !validity || ((validity[index / 8] >> (index % 8)) & 1);
+}
+
+template <typename T>
+T valueAt(const ArrowArray* array, int64_t index) {
+    return static_cast<const T*>(array->buffers[1])[index];
+}
+
+DataType typeForFormat(const std::string& format, const std::string& column) {
+    if (format == "c" || format == "s" || format == "i" || format == "l") return DataType::INT;
+    if (format == "f" || format == "g") return DataType::DOUBLE;
+    if (format == "u" || format == "U" || format == "n") return DataType::STRING;
+    if (format == "b") return DataType::BOOLEAN;
+    throw std::runtime_error("Unsupported Arrow format '" + format + "' for column '" + column + "'");
+}
+
+Value importValue(const std::string& format, const ArrowArray* array, int64_t index, const std::string& column) {
+    if (format == "n" || !isValid(array, index)) return nullptr;
+    switch (format[0]) {
+        case 'c': return static_cast<int>(valueAt<int8_t>(array, index));
+        case 's': return static_cast<int>(valueAt<int16_t>(array, index));
+        case 'i': return valueAt<int32_t>(array, index);
+        case 'l': {
+            int64_t v = valueAt<int64_t>(array, index);
+            if (v < std::numeric_limits<int>::min() || v > std::numeric_limits<int>::max()) {
+                throw std::runtime_error("Value " + std::to_string(v) + " in column '" + column +
+                                         "' does not fit in INT");
+            }
+            return static_cast<int>(v);
+        }
+        case 'f': return static_cast<double>(valueAt<float>(array, index));
+        case 'g': return valueAt<double>(array, index);
+        case 'b': {
+            const auto* bits = static_cast<const uint8_t*>(array->buffers[1]);
+            return (bits[index / 8] >> (index % 8)) & 1;
+        }
+        case 'u': {
+            const auto* offsets = static_cast<const int32_t*>(array->buffers[1]);
+            const char* data = static_cast<const char*>(array->buffers[2]);
+            return std::string(data + offsets[index], offsets[index + 1] - offsets[index]);
+        }
+        case 'U': {
+            const auto* offsets = static_cast<const int64_t*>(array->buffers[1]);
+            const char* data = static_cast<const char*>(array->buffers[2]);
+            return std::string(data + offsets[index], static_cast<size_t>(offsets[index + 1] - offsets[index]));
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+void exportArrow(const std::vector<Row>& rows, const std::vector<std::string>& columns,
+                 ArrowSchema* schema, ArrowArray* array) {
+    for (const auto& row : rows) {
+        if (row.values.size() != columns.size()) {
+            throw std::runtime_error("Row width does not match the exported columns");
+        }
+    }
+
+    auto batch = std::make_unique<ExportedBatch>();
+    for (size_t c = 0; c < columns.size(); ++c) {
+        auto col = std::make_unique<ExportedColumn>();
+        col->name = columns[c];
+        fillColumn(*col, rows, c);
+        batch->schemaChildren.push_back(&col->schema);
+        batch->arrayChildren.push_back(&col->array);
+        batch->columns.push_back(std::move(col));
+    }
+
+    *schema = ArrowSchema{};
+    schema->format = "+s";
+    schema->name = "";
+    schema->n_children = static_cast<int64_t>(columns.size());
+    schema->children = batch->schemaChildren.data();
+    schema->release = releaseSchema;
+    schema->private_data = batch.get();
+
+    *array = ArrowArray{};
+    array->length = static_cast<int64_t>(rows.size());
+    array->n_buffers = 1;
+    array->buffers = batch->structBuffers;
+    array->n_children = static_cast<int64_t>(columns.size());
+    array->children = batch->arrayChildren.data();
+    array->release = releaseArray;
+    array->private_data = batch.release();
+}
+
+size_t importArrowTable(Database& db, const std::string& tableName, ArrowSchema* schema, ArrowArray* array) {
+    struct Releaser {
+        ArrowSchema* schema;
+        ArrowArray* array;
+        ~Releaser() {
+            if (schema->release) schema->release(schema);
+            if (array->release) array->release(array);
+        }
+    } releaser{schema, array};
+
+    if (std::strcmp(schema->format, "+s") != 0) {
+        throw std::runtime_error("Arrow import expects a struct array, got format '" +
+                                 std::string(schema->format) + "'");
+    }
+    if (schema->n_children != array->n_children) {
+        throw std::runtime_error("Arrow schema and array have different column counts");
+    }
+
+    Schema tableSchema(tableName);
+    std::vector<std::string> formats;
+    for (int64_t c = 0; c < schema->n_children; ++c) {
+        const ArrowSchema* child = schema->children[c];
+        std::string name = child->name ? child->name : "column" + std::to_string(c);
+        if (child->dictionary) {
+            throw std::runtime_error("Dictionary-encoded column '" + name + "' is not supported");
+        }
+        formats.push_back(child->format);
+        tableSchema.columns.emplace_back(name, typeForFormat(formats.back(), name));
+    }
+    db.createTable(tableName, tableSchema);
+
+    try {
+        // Converted up front and loaded as one batch, which validates once
+        // and fills partitions in parallel
+        std::vector<Row> rows;
+        rows.reserve(static_cast<size_t>(array->length));
+        for (int64_t r = 0; r < array->length; ++r) {
+            if (!isValid(array, array->offset + r)) continue; // A NULL struct slot has no row
+            Row& row = rows.emplace_back();
+            row.values.reserve(formats.size());
+            for (size_t c = 0; c < formats.size(); ++c) {
+                const ArrowArray* child = array->children[c];
+                row.values.push_back(importValue(formats[c], child, child->offset + array->offset + r,
+                                                 tableSchema.columns[c].name));
+            }
+        }
+        db.insertRowsInto(tableName, rows);
+    } catch (...) {
+        db.dropTable(tableName);
+        throw;
+    }
+    return db.getTable(tableName)->getRowCount();
+}
+
+} // namespace parallaxdb
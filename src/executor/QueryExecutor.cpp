@@ -1,18 +1,87 @@
 #include "../../include/executor/QueryExecutor.hpp"
 #include "../../include/planner/QueryPlan.hpp"
 #include "../../include/planner/FilterNode.hpp"
+#include <chrono>
+#include <iomanip>
 #include <iostream>
+#include <sstream>
 
 namespace parallaxdb {
 
 std::vector<Row> QueryExecutor::execute(const QueryPlanNode& plan) {
     std::vector<Row> results;
     
-    // For now, we'll just call the execute method which prints to stdout
-    // In a real implementation, we'd collect the results
-    const_cast<QueryPlanNode&>(plan).execute();
+    QueryPlanNode& root = const_cast<QueryPlanNode&>(plan);
+    root.open();
+    RowBatch batch;
+    while (root.next(batch)) {
+        for (auto& row : batch.rows) {
+            results.push_back(std::move(row));
+        }
+    }
     
     return results;
 }
 
-} // namespace parallaxdb 
\ No newline at end of file
+std::vector<std::string> QueryExecutor::displayColumns(const QueryPlanNode& plan) {
+    std::vector<std::string> columns = plan.getOutputColumns();
+    for (auto& column : columns) {
+        size_t dot = column.rfind('.');
+        if (dot == std::string::npos) continue;
+        std::string bare = column.substr(dot + 1);
+        try {
+            if (findColumn(plan.getOutputColumns(), bare) >= 0) column = bare;
+        } catch (const std::runtime_error&) {
+            // Ambiguous: keep the qualified name
+        }
+    }
+    return columns;
+}
+
+size_t QueryExecutor::exportArrow(const QueryPlanNode& plan, ArrowSchema* schema, ArrowArray* array) {
+    std::vector<Row> rows = execute(plan);
+    parallaxdb::exportArrow(rows, displayColumns(plan), schema, array);
+    return rows.size();
+}
+
+size_t QueryExecutor::execute(const QueryPlanNode& plan, ResultSink& sink) {
+    std::vector<std::string> columns = displayColumns(plan);
+    
+    QueryPlanNode& root = const_cast<QueryPlanNode&>(plan);
+    size_t rows = 0;
+    sink.begin(columns);
+    root.open();
+    RowBatch batch;
+    while (root.next(batch)) {
+        sink.consume(batch);
+        rows += batch.size();
+    }
+    sink.finish();
+    return rows;
+}
+
+std::string QueryExecutor::explainAnalyze(QueryPlanNode& plan, ExplainFormat format) {
+    plan.enableProfiling();
+    auto start = std::chrono::steady_clock::now();
+    size_t rows = 0;
+    plan.open();
+    RowBatch batch;
+    while (plan.next(batch)) {
+        rows += batch.size();
+    }
+    double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    
+    std::ostringstream os;
+    if (format == ExplainFormat::JSON) {
+        os << "{\"plan\": " << explainPlanJson(plan)
+           << ", \"rows\": " << rows
+           << ", \"execution_ms\": " << elapsedMs << "}\n";
+    } else {
+        os << explainPlan(plan)
+           << std::fixed << std::setprecision(3)
+           << "Execution time: " << elapsedMs << " ms (" << rows << " rows)\n";
+    }
+    return os.str();
+}
+
+} // namespace parallaxdb
@@ -0,0 +1,178 @@
+#include "../../include/executor/ResultCache.hpp"
+#include "../../include/parser/ExpressionParser.hpp"
+#include "../../include/parser/Tokenizer.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+
+namespace parallaxdb {
+
+std::string QueryFingerprint::key() const {
+    std::string result = shape;
+    for (const auto& literal : literals) {
+        // A type tag keeps 1 and '1' apart
+        result += '\x1f';
+        result += static_cast<char>('0' + literal.index());
+        if (std::holds_alternative<std::string>(literal)) {
+            result += std::get<std::string>(literal);
+        } else if (std::holds_alternative<int>(literal)) {
+            result += std::to_string(std::get<int>(literal));
+        } else if (std::holds_alternative<double>(literal)) {
+            // Round-trippable, so literals differing past six decimals stay apart
+            char text[32];
+            std::snprintf(text, sizeof(text), "%.17g", std::get<double>(literal));
+            result += text;
+        }
+    }
+    return result;
+}
+
+QueryFingerprint fingerprintQuery(const std::string& query) {
+    QueryFingerprint fingerprint;
+    std::vector<Token> tokens;
+    try {
+        Tokenizer tokenizer(query);
+        tokens = tokenizer.tokenize();
+    } catch (const std::exception&) {
+        return fingerprint;
+    }
+    for (const Token& token : tokens) {
+        switch (token.type) {
+            case TokenType::ERROR:
+                return fingerprint;
+            case TokenType::END_OF_INPUT:
+            case TokenType::SEMICOLON:
+                continue;
+            case TokenType::NUMBER:
+                try {
+                    fingerprint.literals.push_back(ExpressionParser::parseNumber(token));
+                } catch (const std::runtime_error&) {
+                    return QueryFingerprint();   // Left to the parser to report
+                }
+                fingerprint.shape += "? ";
+                continue;
+            case TokenType::STRING_LITERAL:
+                fingerprint.literals.push_back(token.value);
+                fingerprint.shape += "? ";
+                continue;
+            case TokenType::IDENTIFIER:
+                fingerprint.shape += token.value;
+                break;
+            default: {
+                // Keywords and punctuation: compare case-insensitively
+                std::string upper = token.value;
+                std::transform(upper.begin(), upper.end(), upper.begin(), ::toupper);
+                fingerprint.shape += upper;
+                break;
+            }
+        }
+        fingerprint.shape += ' ';
+    }
+    fingerprint.cacheable = true;
+    return fingerprint;
+}
+
+size_t ResultCache::rowBytes(const Row& row) {
+    size_t size = sizeof(Row) + row.values.capacity() * sizeof(Value);
+    for (const auto& value : row.values) {
+        if (std::holds_alternative<std::string>(value)) {
+            size += std::get<std::string>(value).capacity();
+        }
+    }
+    return size;
+}
+
+const ResultCache::Entry* ResultCache::lookup(const std::string& key, const Database& db) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(key);
+    if (it == entries.end()) {
+        stats.misses++;
+        return nullptr;
+    }
+    for (const auto& [name, version] : it->second.tableVersions) {
+        const Table* table = db.getTable(name);
+        if (!table || table->getVersion() != version) {
+            erase(it);
+            stats.invalidations++;
+            stats.misses++;
+            return nullptr;
+        }
+    }
+    stats.hits++;
+    Entry& entry = it->second;
+    entry.priority = clock + entry.costNanos / std::max<size_t>(entry.bytes, 1);
+    return &entry;
+}
+
+void ResultCache::insert(const std::string& key, Entry entry) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!fits(entry.bytes)) return;
+    auto existing = entries.find(key);
+    if (existing != entries.end()) erase(existing);
+    evictTo(capacityBytes - entry.bytes);
+    entry.priority = clock + entry.costNanos / std::max<size_t>(entry.bytes, 1);
+    bytes += entry.bytes;
+    entries.emplace(key, std::move(entry));
+}
+
+void ResultCache::setCapacity(size_t newCapacity) {
+    std::lock_guard<std::mutex> lock(mutex);
+    capacityBytes = newCapacity;
+    evictTo(capacityBytes);
+}
+
+void ResultCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    bytes = 0;
+    clock = 0.0;
+}
+
+ResultCacheStats ResultCache::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    ResultCacheStats result = stats;
+    result.entries = entries.size();
+    result.bytes = bytes;
+    return result;
+}
+
+void ResultCache::evictTo(size_t limit) {
+    // Linear in the number of entries, which stays small: results are large
+    // relative to the cap, and eviction only runs on inserts
+    while (bytes > limit && !entries.empty()) {
+        auto victim = entries.begin();
+        for (auto it = entries.begin(); it != entries.end(); ++it) {
+            if (it->second.priority < victim->second.priority) victim = it;
+        }
+        clock = victim->second.priority;
+        erase(victim);
+        stats.evictions++;
+    }
+}
+
+void ResultCache::erase(std::unordered_map<std::string, Entry>::iterator it) {
+    bytes -= it->second.bytes;
+    entries.erase(it);
+}
+
+void RecordingSink::begin(const std::vector<std::string>& names) {
+    columns = names;
+    target.begin(names);
+}
+
+void RecordingSink::consume(const RowBatch& batch) {
+    target.consume(batch);
+    if (overflowed) return;
+    for (const auto& row : batch.rows) {
+        bytes += ResultCache::rowBytes(row);
+    }
+    if (bytes > limitBytes) {
+        overflowed = true;
+        rows.clear();
+        rows.shrink_to_fit();
+        return;
+    }
+    rows.insert(rows.end(), batch.rows.begin(), batch.rows.end());
+}
+
+} // namespace parallaxdb
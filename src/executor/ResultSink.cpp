@@ -0,0 +1,520 @@
+#include "../../include/executor/ResultSink.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <unistd.h>
+
+namespace parallaxdb {
+
+namespace {
+
+void appendInt(std::string& out, long long v) {
+    char buf[24];
+    auto result = std::to_chars(buf, buf + sizeof(buf), v);
+    out.append(buf, result.ptr);
+}
+
+// `precision` < 0 gives the shortest round-trip form
+void appendDouble(std::string& out, double v, int precision) {
+    char buf[32];
+    auto result = precision < 0
+        ? std::to_chars(buf, buf + sizeof(buf), v)
+        : std::to_chars(buf, buf + sizeof(buf), v, std::chars_format::general, precision);
+    out.append(buf, result.ptr);
+}
+
+// Same rendering as operator<< on Value (six significant digits)
+std::string displayText(const Value& value) {
+    std::string text;
+    if (std::holds_alternative<int>(value)) {
+        appendInt(text, std::get<int>(value));
+    } else if (std::holds_alternative<double>(value)) {
+        appendDouble(text, std::get<double>(value), 6);
+    } else if (std::holds_alternative<std::string>(value)) {
+        text = std::get<std::string>(value);
+    } else {
+        text = "NULL";
+    }
+    return text;
+}
+
+void appendJsonString(std::string& out, const std::string& s) {
+    out += '"';
+    for (char c : s) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    static const char* hex = "0123456789abcdef";
+                    out += "\\u00";
+                    out += hex[(c >> 4) & 0xf];
+                    out += hex[c & 0xf];
+                } else {
+                    out += c;
+                }
+        }
+    }
+    out += '"';
+}
+
+template <typename T>
+void appendRaw(std::string& out, T v) {
+    out.append(reinterpret_cast<const char*>(&v), sizeof(v));
+}
+
+template <typename T>
+T readRaw(const std::string& data, size_t& pos) {
+    if (pos + sizeof(T) > data.size()) {
+        throw std::runtime_error("Truncated binary result at byte " + std::to_string(pos));
+    }
+    T v;
+    std::memcpy(&v, data.data() + pos, sizeof(T));
+    pos += sizeof(T);
+    return v;
+}
+
+std::string readBytes(const std::string& data, size_t& pos, size_t length) {
+    if (pos + length > data.size()) {
+        throw std::runtime_error("Truncated binary result at byte " + std::to_string(pos));
+    }
+    std::string s = data.substr(pos, length);
+    pos += length;
+    return s;
+}
+
+using ColumnType = BinaryColumnarSink::ColumnType;
+
+ColumnType typeOf(const Value& value) {
+    if (std::holds_alternative<int>(value)) return ColumnType::INT;
+    if (std::holds_alternative<double>(value)) return ColumnType::DOUBLE;
+    if (std::holds_alternative<std::string>(value)) return ColumnType::STRING;
+    return ColumnType::NULLS;
+}
+
+void appendPayload(std::string& out, const Value& value) {
+    switch (typeOf(value)) {
+        case ColumnType::INT: appendRaw<int32_t>(out, std::get<int>(value)); break;
+        case ColumnType::DOUBLE: appendRaw<double>(out, std::get<double>(value)); break;
+        case ColumnType::STRING: {
+            const std::string& s = std::get<std::string>(value);
+            appendRaw<uint32_t>(out, static_cast<uint32_t>(s.size()));
+            out += s;
+            break;
+        }
+        default: break;
+    }
+}
+
+} // namespace
+
+BufferedSink::~BufferedSink() {
+    try {
+        flush();
+    } catch (const std::exception&) {
+        // Destructors must not throw; finish() reports write errors
+    }
+}
+
+void BufferedSink::flush() {
+    completeWrite();
+    if (buffer.empty()) return;
+    if (fd == STDOUT_FILENO) {
+        std::cout.flush();
+    }
+    // Nothing is left to format, so there is nothing for an asynchronous
+    // write to overlap with: most results never need an AsyncIO
+    size_t offset = 0;
+    while (offset < buffer.size()) {
+        const ssize_t n = ::write(fd, buffer.data() + offset, buffer.size() - offset);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            buffer.clear();
+            throw std::runtime_error(std::string("Failed to write results: ") +
+                                     (n < 0 ? std::strerror(errno) : "nothing was written"));
+        }
+        offset += static_cast<size_t>(n);
+        bytesWritten += static_cast<size_t>(n);
+    }
+    buffer.clear();
+}
+
+void BufferedSink::startWrite() {
+    if (buffer.empty()) return;
+    if (fd == STDOUT_FILENO) {
+        // Keep ordering with anything already written through std::cout
+        std::cout.flush();
+    }
+    // One write at a time keeps the chunks in order on pipes and terminals
+    completeWrite();
+    // Only results spanning several chunks get here
+    if (!io) io = std::make_unique<AsyncIO>(1);
+    writing.swap(buffer);
+    buffer.clear();
+    buffer.reserve(kFlushBytes + 4096);
+    writeOffset = 0;
+    ticket = io->write(fd, writing.data(), writing.size(), AsyncIO::kCurrentPosition);
+    io->submit();
+}
+
+void BufferedSink::completeWrite() {
+    while (ticket != 0) {
+        size_t n;
+        try {
+            n = io->wait(ticket);
+        } catch (const std::runtime_error& e) {
+            ticket = 0;
+            writing.clear();
+            throw std::runtime_error(std::string("Failed to write results: ") + e.what());
+        }
+        if (n == 0) {
+            ticket = 0;
+            writing.clear();
+            throw std::runtime_error("Failed to write results: nothing was written");
+        }
+        writeOffset += n;
+        bytesWritten += n;
+        ticket = 0;
+        if (writeOffset < writing.size()) {
+            ticket = io->write(fd, writing.data() + writeOffset, writing.size() - writeOffset,
+                               AsyncIO::kCurrentPosition);
+            io->submit();
+        }
+    }
+    writing.clear();
+}
+
+// TextTableSink
+
+void TextTableSink::begin(const std::vector<std::string>& cols) {
+    columns = cols;
+    widths.clear();
+    for (const auto& column : columns) {
+        widths.push_back(column.size());
+    }
+}
+
+void TextTableSink::consume(const RowBatch& batch) {
+    for (const auto& row : batch.rows) {
+        std::vector<std::string> cells;
+        cells.reserve(row.values.size());
+        for (const auto& value : row.values) {
+            cells.push_back(displayText(value));
+        }
+        rowCount++;
+        if (widthsFixed) {
+            appendRow(cells);
+            maybeFlush();
+            continue;
+        }
+        for (size_t i = 0; i < cells.size() && i < widths.size(); ++i) {
+            widths[i] = std::max(widths[i], cells[i].size());
+        }
+        pending.push_back(std::move(cells));
+        if (pending.size() >= kWidthSampleRows) {
+            fixWidths();
+        }
+    }
+}
+
+void TextTableSink::finish() {
+    if (rowCount == 0) {
+        buffer += "No results\n";
+    } else {
+        if (!widthsFixed) fixWidths();
+        buffer += "(" + std::to_string(rowCount) + (rowCount == 1 ? " row)\n" : " rows)\n");
+    }
+    flush();
+}
+
+void TextTableSink::fixWidths() {
+    widthsFixed = true;
+    appendRow(columns);
+    for (size_t i = 0; i < widths.size(); ++i) {
+        if (i > 0) buffer += "-+-";
+        buffer.append(widths[i], '-');
+    }
+    buffer += '\n';
+    for (const auto& cells : pending) {
+        appendRow(cells);
+    }
+    pending.clear();
+    maybeFlush();
+}
+
+void TextTableSink::appendRow(const std::vector<std::string>& cells) {
+    for (size_t i = 0; i < cells.size(); ++i) {
+        if (i > 0) buffer += " | ";
+        buffer += cells[i];
+        // The last column is not padded, so lines carry no trailing spaces
+        if (i + 1 < cells.size() && i < widths.size() && cells[i].size() < widths[i]) {
+            buffer.append(widths[i] - cells[i].size(), ' ');
+        }
+    }
+    buffer += '\n';
+}
+
+// CsvSink
+
+namespace {
+
+void appendCsvField(std::string& out, const std::string& s) {
+    if (s.find_first_of(",\"\r\n") == std::string::npos) {
+        out += s;
+        return;
+    }
+    out += '"';
+    for (char c : s) {
+        if (c == '"') out += '"';
+        out += c;
+    }
+    out += '"';
+}
+
+} // namespace
+
+void CsvSink::begin(const std::vector<std::string>& columns) {
+    for (size_t i = 0; i < columns.size(); ++i) {
+        if (i > 0) buffer += ',';
+        appendCsvField(buffer, columns[i]);
+    }
+    buffer += "\r\n";
+}
+
+void CsvSink::consume(const RowBatch& batch) {
+    for (const auto& row : batch.rows) {
+        for (size_t i = 0; i < row.values.size(); ++i) {
+            if (i > 0) buffer += ',';
+            const Value& value = row.values[i];
+            if (std::holds_alternative<int>(value)) {
+                appendInt(buffer, std::get<int>(value));
+            } else if (std::holds_alternative<double>(value)) {
+                appendDouble(buffer, std::get<double>(value), -1);
+            } else if (std::holds_alternative<std::string>(value)) {
+                appendCsvField(buffer, std::get<std::string>(value));
+            }
+        }
+        buffer += "\r\n";
+    }
+    maybeFlush();
+}
+
+// NdjsonSink
+
+void NdjsonSink::begin(const std::vector<std::string>& columns) {
+    keys.clear();
+    for (const auto& column : columns) {
+        std::string key;
+        appendJsonString(key, column);
+        keys.push_back(key + ":");
+    }
+}
+
+void NdjsonSink::consume(const RowBatch& batch) {
+    for (const auto& row : batch.rows) {
+        buffer += '{';
+        for (size_t i = 0; i < row.values.size() && i < keys.size(); ++i) {
+            if (i > 0) buffer += ',';
+            buffer += keys[i];
+            const Value& value = row.values[i];
+            if (std::holds_alternative<int>(value)) {
+                appendInt(buffer, std::get<int>(value));
+            } else if (std::holds_alternative<double>(value) && std::isfinite(std::get<double>(value))) {
+                appendDouble(buffer, std::get<double>(value), -1);
+            } else if (std::holds_alternative<std::string>(value)) {
+                appendJsonString(buffer, std::get<std::string>(value));
+            } else {
+                buffer += "null"; // NULL, NaN and infinities
+            }
+        }
+        buffer += "}\n";
+    }
+    maybeFlush();
+}
+
+// BinaryColumnarSink
+
+void BinaryColumnarSink::begin(const std::vector<std::string>& columns) {
+    columnCount = columns.size();
+    buffer += "PXCB";
+    appendRaw<uint32_t>(buffer, kVersion);
+    appendRaw<uint32_t>(buffer, static_cast<uint32_t>(columns.size()));
+    for (const auto& column : columns) {
+        appendRaw<uint32_t>(buffer, static_cast<uint32_t>(column.size()));
+        buffer += column;
+    }
+}
+
+void BinaryColumnarSink::consume(const RowBatch& batch) {
+    const size_t rows = batch.size();
+    if (rows == 0) return;
+    appendRaw<uint32_t>(buffer, static_cast<uint32_t>(rows));
+
+    for (size_t c = 0; c < columnCount; ++c) {
+        auto valueAt = [&batch, c](size_t r) -> const Value& { return batch.rows[r].values[c]; };
+
+        ColumnType type = ColumnType::NULLS;
+        for (size_t r = 0; r < rows; ++r) {
+            ColumnType t = typeOf(valueAt(r));
+            if (t == ColumnType::NULLS || t == type) continue;
+            type = (type == ColumnType::NULLS) ? t : ColumnType::MIXED;
+            if (type == ColumnType::MIXED) break;
+        }
+        buffer += static_cast<char>(type);
+
+        std::string bitmap((rows + 7) / 8, '\0');
+        for (size_t r = 0; r < rows; ++r) {
+            if (typeOf(valueAt(r)) != ColumnType::NULLS) {
+                bitmap[r / 8] = static_cast<char>(bitmap[r / 8] | (1 << (r % 8)));
+            }
+        }
+        buffer += bitmap;
+
+        switch (type) {
+            case ColumnType::INT:
+                for (size_t r = 0; r < rows; ++r) {
+                    const Value& v = valueAt(r);
+                    appendRaw<int32_t>(buffer, std::holds_alternative<int>(v) ? std::get<int>(v) : 0);
+                }
+                break;
+            case ColumnType::DOUBLE:
+                for (size_t r = 0; r < rows; ++r) {
+                    const Value& v = valueAt(r);
+                    appendRaw<double>(buffer, std::holds_alternative<double>(v) ? std::get<double>(v) : 0.0);
+                }
+                break;
+            case ColumnType::STRING: {
+                uint32_t offset = 0;
+                appendRaw<uint32_t>(buffer, offset);
+                for (size_t r = 0; r < rows; ++r) {
+                    const Value& v = valueAt(r);
+                    if (std::holds_alternative<std::string>(v)) {
+                        offset += static_cast<uint32_t>(std::get<std::string>(v).size());
+                    }
+                    appendRaw<uint32_t>(buffer, offset);
+                }
+                for (size_t r = 0; r < rows; ++r) {
+                    const Value& v = valueAt(r);
+                    if (std::holds_alternative<std::string>(v)) buffer += std::get<std::string>(v);
+                }
+                break;
+            }
+            case ColumnType::MIXED:
+                for (size_t r = 0; r < rows; ++r) {
+                    buffer += static_cast<char>(typeOf(valueAt(r)));
+                    appendPayload(buffer, valueAt(r));
+                }
+                break;
+            case ColumnType::NULLS:
+                break;
+        }
+    }
+    maybeFlush();
+}
+
+void BinaryColumnarSink::finish() {
+    appendRaw<uint32_t>(buffer, 0);
+    flush();
+}
+
+std::vector<Row> decodeBinaryColumnar(const std::string& data, std::vector<std::string>* columns) {
+    size_t pos = 0;
+    if (readBytes(data, pos, 4) != "PXCB") {
+        throw std::runtime_error("Not a binary columnar result");
+    }
+    uint32_t version = readRaw<uint32_t>(data, pos);
+    if (version != BinaryColumnarSink::kVersion) {
+        throw std::runtime_error("Unsupported binary result version " + std::to_string(version));
+    }
+    uint32_t columnCount = readRaw<uint32_t>(data, pos);
+    std::vector<std::string> names;
+    for (uint32_t c = 0; c < columnCount; ++c) {
+        names.push_back(readBytes(data, pos, readRaw<uint32_t>(data, pos)));
+    }
+    if (columns) *columns = names;
+
+    auto readPayload = [&data, &pos](ColumnType type) -> Value {
+        switch (type) {
+            case ColumnType::INT: return static_cast<int>(readRaw<int32_t>(data, pos));
+            case ColumnType::DOUBLE: return readRaw<double>(data, pos);
+            case ColumnType::STRING: return readBytes(data, pos, readRaw<uint32_t>(data, pos));
+            case ColumnType::NULLS: return nullptr;
+            default: throw std::runtime_error("Invalid value tag in binary result");
+        }
+    };
+
+    std::vector<Row> rows;
+    while (uint32_t count = readRaw<uint32_t>(data, pos)) {
+        size_t base = rows.size();
+        rows.resize(base + count);
+        for (size_t r = base; r < rows.size(); ++r) rows[r].values.resize(columnCount);
+
+        for (uint32_t c = 0; c < columnCount; ++c) {
+            auto type = static_cast<ColumnType>(readRaw<uint8_t>(data, pos));
+            std::string bitmap = readBytes(data, pos, (count + 7) / 8);
+            auto valid = [&bitmap](size_t r) { return (bitmap[r / 8] >> (r % 8)) & 1; };
+            switch (type) {
+                case ColumnType::INT:
+                case ColumnType::DOUBLE:
+                    for (uint32_t r = 0; r < count; ++r) {
+                        Value v = readPayload(type);
+                        rows[base + r].values[c] = valid(r) ? v : Value(nullptr);
+                    }
+                    break;
+                case ColumnType::STRING: {
+                    std::vector<uint32_t> offsets(count + 1);
+                    for (auto& offset : offsets) offset = readRaw<uint32_t>(data, pos);
+                    std::string bytes = readBytes(data, pos, offsets.back());
+                    for (uint32_t r = 0; r < count; ++r) {
+                        if (!valid(r)) {
+                            rows[base + r].values[c] = nullptr;
+                        } else {
+                            rows[base + r].values[c] = bytes.substr(offsets[r], offsets[r + 1] - offsets[r]);
+                        }
+                    }
+                    break;
+                }
+                case ColumnType::MIXED:
+                    for (uint32_t r = 0; r < count; ++r) {
+                        rows[base + r].values[c] = readPayload(static_cast<ColumnType>(readRaw<uint8_t>(data, pos)));
+                    }
+                    break;
+                case ColumnType::NULLS:
+                    for (uint32_t r = 0; r < count; ++r) rows[base + r].values[c] = nullptr;
+                    break;
+                default:
+                    throw std::runtime_error("Invalid column type in binary result");
+            }
+        }
+    }
+    return rows;
+}
+
+ResultFormat parseResultFormat(const std::string& name) {
+    std::string lower = name;
+    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+    if (lower == "table" || lower == "text") return ResultFormat::TABLE;
+    if (lower == "csv") return ResultFormat::CSV;
+    if (lower == "ndjson" || lower == "json") return ResultFormat::NDJSON;
+    if (lower == "binary") return ResultFormat::BINARY;
+    throw std::runtime_error("Unknown output format: " + name);
+}
+
+std::unique_ptr<ResultSink> makeResultSink(ResultFormat format, int fd) {
+    switch (format) {
+        case ResultFormat::CSV: return std::make_unique<CsvSink>(fd);
+        case ResultFormat::NDJSON: return std::make_unique<NdjsonSink>(fd);
+        case ResultFormat::BINARY: return std::make_unique<BinaryColumnarSink>(fd);
+        case ResultFormat::TABLE: break;
+    }
+    return std::make_unique<TextTableSink>(fd);
+}
+
+} // namespace parallaxdb
@@ -0,0 +1,332 @@
+#include "../../include/jit/FilterJit.hpp"
+#include <chrono>
+#include <thread>
+
+#include <llvm/ExecutionEngine/Orc/LLJIT.h>
+#include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/Verifier.h>
+#include <llvm/Support/TargetSelect.h>
+
+namespace parallaxdb {
+
+namespace {
+
+using Node = FilterJit::Node;
+
+bool describeExpression(const Expression& expr, FilterJit::Shape& shape) {
+    if (auto* paren = dynamic_cast<const ParenExpr*>(&expr)) {
+        return describeExpression(*paren->expr, shape);
+    }
+    if (auto* logical = dynamic_cast<const LogicalExpr*>(&expr)) {
+        if (logical->op != "AND" && logical->op != "OR") return false;
+        shape.nodes.push_back({logical->op == "AND" ? Node::Type::AND : Node::Type::OR});
+        return describeExpression(*logical->left, shape) && describeExpression(*logical->right, shape);
+    }
+    auto* comparison = dynamic_cast<const ComparisonExpr*>(&expr);
+    if (!comparison || comparison->columnIndex < 0) return false;
+    const CompactValue& literal = comparison->literal;
+    if (literal.isNull()) {
+        shape.nodes.push_back({Node::Type::NEVER});
+        return true;
+    }
+    // Ordering strings, or equality against a long one, follows pointers
+    if (literal.isString() && (!literal.isInlined() ||
+                               (comparison->opCode != CompareOp::EQ && comparison->opCode != CompareOp::NE))) {
+        return false;
+    }
+    shape.nodes.push_back({Node::Type::COMPARE, comparison->columnIndex, comparison->opCode, literal.kind()});
+    shape.literals.push_back(literal);
+    return true;
+}
+
+// Emits one shape as
+//   size_t f(const CompactValue* cells, uint32_t* selection, size_t count, const CompactValue* literals)
+// with a branchless loop: every position is written to selection[kept] and
+// kept advances only for rows that pass.
+class CodeGen {
+public:
+    CodeGen(llvm::LLVMContext& context, llvm::Module& module, const std::vector<Node>& nodes, size_t width)
+        : b(context), nodes(nodes), width(width) {
+        i8Ptr = b.getInt8PtrTy();
+        llvm::FunctionType* type = llvm::FunctionType::get(
+            b.getInt64Ty(), {i8Ptr, b.getInt32Ty()->getPointerTo(), b.getInt64Ty(), i8Ptr}, false);
+        function = llvm::Function::Create(type, llvm::Function::ExternalLinkage, module.getName(), module);
+    }
+
+    llvm::Function* emit() {
+        llvm::LLVMContext& context = b.getContext();
+        llvm::Value* cells = function->getArg(0);
+        llvm::Value* selection = function->getArg(1);
+        llvm::Value* count = function->getArg(2);
+        literals = function->getArg(3);
+
+        llvm::BasicBlock* entry = llvm::BasicBlock::Create(context, "entry", function);
+        llvm::BasicBlock* loop = llvm::BasicBlock::Create(context, "loop", function);
+        llvm::BasicBlock* exit = llvm::BasicBlock::Create(context, "exit", function);
+        b.SetInsertPoint(entry);
+        b.CreateCondBr(b.CreateICmpEQ(count, b.getInt64(0)), exit, loop);
+
+        b.SetInsertPoint(loop);
+        llvm::PHINode* i = b.CreatePHI(b.getInt64Ty(), 2);
+        llvm::PHINode* kept = b.CreatePHI(b.getInt64Ty(), 2);
+        i->addIncoming(b.getInt64(0), entry);
+        kept->addIncoming(b.getInt64(0), entry);
+        llvm::Value* position = b.CreateLoad(b.getInt32Ty(), b.CreateGEP(b.getInt32Ty(), selection, i));
+        row = b.CreateGEP(b.getInt8Ty(), cells,
+                          b.CreateMul(b.CreateZExt(position, b.getInt64Ty()),
+                                      b.getInt64(width * sizeof(CompactValue))));
+        cursor = 0;
+        literalIndex = 0;
+        llvm::Value* pass = emitNode();
+        b.CreateStore(position, b.CreateGEP(b.getInt32Ty(), selection, kept));
+        llvm::Value* nextKept = b.CreateAdd(kept, b.CreateZExt(pass, b.getInt64Ty()));
+        llvm::Value* next = b.CreateAdd(i, b.getInt64(1));
+        i->addIncoming(next, loop);
+        kept->addIncoming(nextKept, loop);
+        b.CreateCondBr(b.CreateICmpULT(next, count), loop, exit);
+
+        b.SetInsertPoint(exit);
+        llvm::PHINode* result = b.CreatePHI(b.getInt64Ty(), 2);
+        result->addIncoming(b.getInt64(0), entry);
+        result->addIncoming(nextKept, loop);
+        b.CreateRet(result);
+        return function;
+    }
+
+private:
+    llvm::IRBuilder<> b;
+    const std::vector<Node>& nodes;
+    size_t width;
+    llvm::Type* i8Ptr;
+    llvm::Function* function;
+    llvm::Value* literals = nullptr;
+    llvm::Value* row = nullptr;
+    size_t cursor = 0;
+    size_t literalIndex = 0;
+
+    llvm::Value* load(llvm::Type* type, llvm::Value* base, size_t offset) {
+        llvm::Value* address = b.CreateGEP(b.getInt8Ty(), base, b.getInt64(offset));
+        return b.CreateAlignedLoad(type, b.CreateBitCast(address, type->getPointerTo()), llvm::Align(4));
+    }
+
+    // CompactValue compares doubles three-way with < and >, so NaN equals everything
+    llvm::Value* compareDoubles(CompareOp op, llvm::Value* x, llvm::Value* y) {
+        llvm::Value* lt = b.CreateFCmpOLT(x, y);
+        llvm::Value* gt = b.CreateFCmpOGT(x, y);
+        switch (op) {
+            case CompareOp::EQ: return b.CreateNot(b.CreateOr(lt, gt));
+            case CompareOp::NE: return b.CreateOr(lt, gt);
+            case CompareOp::LT: return lt;
+            case CompareOp::GT: return gt;
+            case CompareOp::LE: return b.CreateNot(gt);
+            case CompareOp::GE: return b.CreateNot(lt);
+        }
+        return b.getFalse();
+    }
+
+    llvm::Value* compareInts(CompareOp op, llvm::Value* x, llvm::Value* y) {
+        switch (op) {
+            case CompareOp::EQ: return b.CreateICmpEQ(x, y);
+            case CompareOp::NE: return b.CreateICmpNE(x, y);
+            case CompareOp::LT: return b.CreateICmpSLT(x, y);
+            case CompareOp::GT: return b.CreateICmpSGT(x, y);
+            case CompareOp::LE: return b.CreateICmpSLE(x, y);
+            case CompareOp::GE: return b.CreateICmpSGE(x, y);
+        }
+        return b.getFalse();
+    }
+
+    llvm::Value* kindIs(llvm::Value* kind, CompactValue::Kind wanted) {
+        return b.CreateICmpEQ(kind, b.getInt32(static_cast<uint32_t>(wanted)));
+    }
+
+    // Mirrors applyComparison(cell, op, literal)
+    llvm::Value* emitCompare(const Node& node) {
+        llvm::Value* cell = b.CreateGEP(b.getInt8Ty(), row, b.getInt64(node.column * sizeof(CompactValue)));
+        llvm::Value* literal = b.CreateGEP(b.getInt8Ty(), literals,
+                                           b.getInt64(literalIndex++ * sizeof(CompactValue)));
+        llvm::Value* header = load(b.getInt32Ty(), cell, 0);
+        llvm::Value* kind = b.CreateLShr(header, b.getInt32(28));
+        llvm::Value* isInt = kindIs(kind, CompactValue::Kind::INT);
+        llvm::Value* isDouble = kindIs(kind, CompactValue::Kind::DOUBLE);
+        // A number against a string, or a string against a number, is only unequal
+        llvm::Value* mismatched = node.op == CompareOp::NE ? b.getTrue() : b.getFalse();
+
+        switch (node.literalKind) {
+            case CompactValue::Kind::INT: {
+                llvm::Value* value = load(b.getInt32Ty(), cell, 8);
+                llvm::Value* bound = load(b.getInt32Ty(), literal, 8);
+                llvm::Value* asDouble = compareDoubles(node.op, load(b.getDoubleTy(), cell, 8),
+                                                       b.CreateSIToFP(bound, b.getDoubleTy()));
+                llvm::Value* other = b.CreateAnd(kindIs(kind, CompactValue::Kind::STRING), mismatched);
+                return b.CreateSelect(isInt, compareInts(node.op, value, bound),
+                                      b.CreateSelect(isDouble, asDouble, other));
+            }
+            case CompactValue::Kind::DOUBLE: {
+                llvm::Value* bound = load(b.getDoubleTy(), literal, 8);
+                llvm::Value* value = b.CreateSelect(isInt, b.CreateSIToFP(load(b.getInt32Ty(), cell, 8), b.getDoubleTy()),
+                                                    load(b.getDoubleTy(), cell, 8));
+                llvm::Value* other = b.CreateAnd(kindIs(kind, CompactValue::Kind::STRING), mismatched);
+                return b.CreateSelect(b.CreateOr(isInt, isDouble), compareDoubles(node.op, value, bound), other);
+            }
+            case CompactValue::Kind::STRING: {
+                // Inline literal: equal cells have the same header and zero-padded bytes
+                llvm::Value* equal = b.CreateAnd(
+                    b.CreateICmpEQ(header, load(b.getInt32Ty(), literal, 0)),
+                    b.CreateAnd(b.CreateICmpEQ(load(b.getInt64Ty(), cell, 4), load(b.getInt64Ty(), literal, 4)),
+                                b.CreateICmpEQ(load(b.getInt32Ty(), cell, 12), load(b.getInt32Ty(), literal, 12))));
+                if (node.op == CompareOp::EQ) return equal;
+                return b.CreateAnd(b.CreateNot(kindIs(kind, CompactValue::Kind::NULL_VALUE)), b.CreateNot(equal));
+            }
+            default:
+                return b.getFalse();
+        }
+    }
+
+    llvm::Value* emitNode() {
+        const Node& node = nodes[cursor++];
+        switch (node.type) {
+            case Node::Type::AND: {
+                llvm::Value* left = emitNode();
+                return b.CreateAnd(left, emitNode());
+            }
+            case Node::Type::OR: {
+                llvm::Value* left = emitNode();
+                return b.CreateOr(left, emitNode());
+            }
+            case Node::Type::NEVER:
+                return b.getFalse();
+            case Node::Type::COMPARE:
+                return emitCompare(node);
+        }
+        return b.getFalse();
+    }
+};
+
+} // namespace
+
+struct FilterJit::Compiler {
+    std::unique_ptr<llvm::orc::LLJIT> jit;
+    size_t compiled = 0;
+
+    Compiler() {
+        llvm::InitializeNativeTarget();
+        llvm::InitializeNativeTargetAsmPrinter();
+        auto created = llvm::orc::LLJITBuilder().create();
+        if (created) {
+            jit = std::move(*created);
+        } else {
+            llvm::consumeError(created.takeError());
+        }
+    }
+
+    Function compile(const std::vector<Node>& nodes, size_t width) {
+        if (!jit) return nullptr;
+        auto context = std::make_unique<llvm::LLVMContext>();
+        const std::string name = "parallaxdb_filter_" + std::to_string(compiled++);
+        auto module = std::make_unique<llvm::Module>(name, *context);
+        module->setDataLayout(jit->getDataLayout());
+        llvm::Function* function = CodeGen(*context, *module, nodes, width).emit();
+        if (llvm::verifyFunction(*function)) return nullptr;
+        if (auto error = jit->addIRModule(llvm::orc::ThreadSafeModule(std::move(module), std::move(context)))) {
+            llvm::consumeError(std::move(error));
+            return nullptr;
+        }
+        auto symbol = jit->lookup(name);
+        if (!symbol) {
+            llvm::consumeError(symbol.takeError());
+            return nullptr;
+        }
+        return reinterpret_cast<Function>(symbol->getAddress());
+    }
+};
+
+std::optional<FilterJit::Shape> FilterJit::describe(const std::vector<std::unique_ptr<Expression>>& conjuncts,
+                                                    size_t width) {
+    Shape shape;
+    shape.width = width;
+    for (size_t i = 0; i < conjuncts.size(); ++i) {
+        if (i + 1 < conjuncts.size()) shape.nodes.push_back({Node::Type::AND});
+        if (!describeExpression(*conjuncts[i], shape)) return std::nullopt;
+    }
+    if (shape.nodes.empty()) return std::nullopt;
+
+    shape.key = "w" + std::to_string(width) + ":";
+    for (const Node& node : shape.nodes) {
+        switch (node.type) {
+            case Node::Type::AND: shape.key += "&"; break;
+            case Node::Type::OR: shape.key += "|"; break;
+            case Node::Type::NEVER: shape.key += "0"; break;
+            case Node::Type::COMPARE:
+                shape.key += "c" + std::to_string(node.column) + "." + std::to_string(static_cast<int>(node.op)) +
+                             "." + std::to_string(static_cast<int>(node.literalKind));
+                break;
+        }
+        shape.key += " ";
+    }
+    return shape;
+}
+
+FilterJit& FilterJit::instance() {
+    // Never destroyed: the compiler thread may still be waiting at exit
+    static FilterJit* jit = new FilterJit();
+    return *jit;
+}
+
+FilterJit::Lookup FilterJit::request(const Shape& shape, bool hot) {
+    if (!enabled.load()) return {};
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = cache.find(shape.key);
+    if (it == cache.end()) {
+        if (cache.size() >= kMaxEntries) return {};
+        auto entry = std::make_shared<Entry>();
+        entry->nodes = shape.nodes;
+        entry->width = shape.width;
+        it = cache.emplace(shape.key, std::move(entry)).first;
+    }
+    Entry& entry = *it->second;
+    entry.uses++;
+    if (!entry.queued && (hot || entry.uses >= kHotUses)) {
+        entry.queued = true;
+        queue.push_back(it->second);
+        compiling++;
+        if (!started) {
+            started = true;
+            std::thread([this] { run(); }).detach();
+        }
+        queuedOrDone.notify_all();
+    }
+    return {it->second, entry.compiled};
+}
+
+void FilterJit::waitIdle() {
+    std::unique_lock<std::mutex> lock(mutex);
+    queuedOrDone.wait(lock, [this] { return compiling == 0; });
+}
+
+void FilterJit::run() {
+    compiler = std::make_unique<Compiler>();
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        queuedOrDone.wait(lock, [this] { return !queue.empty(); });
+        std::shared_ptr<Entry> entry = std::move(queue.front());
+        queue.pop_front();
+        lock.unlock();
+
+        const auto start = std::chrono::steady_clock::now();
+        Function function = compiler->compile(entry->nodes, entry->width);
+        entry->compileNanos.store(
+            std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count(),
+            std::memory_order_release);
+        entry->function.store(function, std::memory_order_release);
+        if (function) compiledCount++;
+
+        lock.lock();
+        entry->compiled = function != nullptr;
+        compiling--;
+        queuedOrDone.notify_all();
+    }
+}
+
+} // namespace parallaxdb
@@ -8,7 +8,8 @@ using namespace parallaxdb;
 
 int main() {
     std::cout << "Welcome to ParallaxDB!\n";
-    std::cout << "Supported commands: SELECT, INSERT, CREATE TABLE, DROP TABLE\n\n";
+    std::cout << "Supported commands: SELECT, INSERT, CREATE TABLE, DROP TABLE, ANALYZE, EXPLAIN\n";
+    std::cout << "Output format: \\format table|csv|ndjson|binary\n\n";
 
     Database db;
     
@@ -40,6 +41,17 @@ int main() {
         if (query.empty()) {
             continue;
         }
+        
+        if (query.rfind("\\format", 0) == 0) {
+            try {
+                std::string name = query.substr(7);
+                name.erase(0, name.find_first_not_of(' '));
+                SQLProcessor::setOutputFormat(parseResultFormat(name));
+            } catch (const std::exception& e) {
+                std::cout << "Error: " << e.what() << std::endl;
+            }
+            continue;
+        }
 
         try {
             SQLProcessor::processStatement(query, db);
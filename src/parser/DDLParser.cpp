@@ -1,8 +1,29 @@
 #include "../../include/parser/DDLParser.hpp"
+#include "../../include/parser/ExpressionParser.hpp"
 #include <algorithm>
 
 namespace parallaxdb {
 
+namespace {
+
+void expectWord(const std::vector<Token>& tokens, size_t& pos, const char* word) {
+    if (!isWord(tokens, pos, word)) {
+        throw std::runtime_error(std::string("Expected ") + word + " [pos=" +
+                                 std::to_string(tokens[pos].position) + "]");
+    }
+    pos++;
+}
+
+void expectToken(const std::vector<Token>& tokens, size_t& pos, TokenType type, const char* what) {
+    if (pos >= tokens.size() || tokens[pos].type != type) {
+        throw std::runtime_error(std::string("Expected ") + what + " [pos=" +
+                                 std::to_string(tokens[pos].position) + "]");
+    }
+    pos++;
+}
+
+} // namespace
+
 std::unique_ptr<CreateTableStatement> DDLParser::parseCreateTable(const std::string& query) {
     Tokenizer tokenizer(query);
     auto tokens = tokenizer.tokenize();
@@ -42,6 +63,10 @@ std::unique_ptr<CreateTableStatement> DDLParser::parseCreateTable(const std::str
     }
     pos++;
     
+    if (isWord(tokens, pos, "PARTITION")) {
+        schema.partitioning = parsePartitioning(tokens, pos);
+    }
+    
     auto result = std::make_unique<CreateTableStatement>();
     result->tableName = tableName;
     result->schema = schema;
@@ -78,6 +103,259 @@ std::unique_ptr<DropTableStatement> DDLParser::parseDropTable(const std::string&
     return result;
 }
 
+std::unique_ptr<CreateViewStatement> DDLParser::parseCreateMaterializedView(const std::string& query) {
+    Tokenizer tokenizer(query);
+    auto tokens = tokenizer.tokenize();
+    size_t pos = 0;
+    
+    // Parse CREATE MATERIALIZED VIEW name AS SELECT
+    expectToken(tokens, pos, TokenType::CREATE, "CREATE");
+    expectWord(tokens, pos, "MATERIALIZED");
+    expectWord(tokens, pos, "VIEW");
+    if (pos >= tokens.size() || tokens[pos].type != TokenType::IDENTIFIER) {
+        throw std::runtime_error("Expected view name [pos=" + std::to_string(tokens[pos].position) + "]");
+    }
+    auto result = std::make_unique<CreateViewStatement>();
+    result->viewName = tokens[pos].value;
+    pos++;
+    expectToken(tokens, pos, TokenType::AS, "AS");
+    expectToken(tokens, pos, TokenType::SELECT, "SELECT");
+    
+    ViewDefinition& definition = result->definition;
+    if (pos < tokens.size() && tokens[pos].type == TokenType::STAR) {
+        pos++;  // Every base column
+    } else {
+        while (true) {
+            definition.columns.push_back(ExpressionParser::parseSelectColumn(tokens, pos));
+            if (pos < tokens.size() && tokens[pos].type == TokenType::COMMA) {
+                pos++;
+            } else {
+                break;
+            }
+        }
+    }
+    
+    expectToken(tokens, pos, TokenType::FROM, "FROM");
+    if (pos >= tokens.size() || tokens[pos].type != TokenType::IDENTIFIER) {
+        throw std::runtime_error("Expected table name [pos=" + std::to_string(tokens[pos].position) + "]");
+    }
+    definition.baseTable = tokens[pos].value;
+    pos++;
+    
+    if (pos < tokens.size() && tokens[pos].type == TokenType::WHERE) {
+        pos++;
+        definition.where = ExpressionParser::parseWhereExpression(tokens, pos);
+    }
+    
+    if (isWord(tokens, pos, "GROUP")) {
+        pos++;
+        expectWord(tokens, pos, "BY");
+        while (true) {
+            if (pos >= tokens.size() || tokens[pos].type != TokenType::IDENTIFIER) {
+                throw std::runtime_error("Expected GROUP BY column [pos=" + std::to_string(tokens[pos].position) + "]");
+            }
+            definition.groupBy.push_back(tokens[pos].value);
+            pos++;
+            if (pos < tokens.size() && tokens[pos].type == TokenType::COMMA) {
+                pos++;
+            } else {
+                break;
+            }
+        }
+    }
+    
+    if (pos < tokens.size() && tokens[pos].type == TokenType::SEMICOLON) {
+        pos++;
+    }
+    if (pos >= tokens.size() || tokens[pos].type != TokenType::END_OF_INPUT) {
+        throw std::runtime_error("Unexpected token in view definition [pos=" + std::to_string(tokens[pos].position) + "]");
+    }
+    
+    // Columns may be qualified with the base table's name
+    const std::string prefix = definition.baseTable + ".";
+    auto unqualify = [&prefix](std::string& name) {
+        if (name.compare(0, prefix.size(), prefix) == 0) name = name.substr(prefix.size());
+    };
+    for (auto& column : definition.columns) {
+        unqualify(column.source);
+        if (column.function == AggregateFunction::NONE) unqualify(column.name);
+    }
+    for (auto& name : definition.groupBy) {
+        unqualify(name);
+    }
+    
+    return result;
+}
+
+std::unique_ptr<CreateIndexStatement> DDLParser::parseCreateIndex(const std::string& query) {
+    Tokenizer tokenizer(query);
+    auto tokens = tokenizer.tokenize();
+    size_t pos = 0;
+    
+    // Parse CREATE INDEX name ON table USING TRIGRAM (column)
+    expectToken(tokens, pos, TokenType::CREATE, "CREATE");
+    expectWord(tokens, pos, "INDEX");
+    if (pos >= tokens.size() || tokens[pos].type != TokenType::IDENTIFIER) {
+        throw std::runtime_error("Expected index name [pos=" + std::to_string(tokens[pos].position) + "]");
+    }
+    auto result = std::make_unique<CreateIndexStatement>();
+    result->indexName = tokens[pos].value;
+    pos++;
+    
+    expectToken(tokens, pos, TokenType::ON, "ON");
+    if (pos >= tokens.size() || tokens[pos].type != TokenType::IDENTIFIER) {
+        throw std::runtime_error("Expected table name [pos=" + std::to_string(tokens[pos].position) + "]");
+    }
+    result->tableName = tokens[pos].value;
+    pos++;
+    
+    // Trigram indexes are the only kind, but the method is spelled out
+    expectWord(tokens, pos, "USING");
+    if (!isWord(tokens, pos, "TRIGRAM")) {
+        throw std::runtime_error("Unsupported index method; expected TRIGRAM [pos=" +
+                                 std::to_string(tokens[pos].position) + "]");
+    }
+    pos++;
+    
+    expectToken(tokens, pos, TokenType::LEFT_PAREN, "'('");
+    if (pos >= tokens.size() || tokens[pos].type != TokenType::IDENTIFIER) {
+        throw std::runtime_error("Expected column name [pos=" + std::to_string(tokens[pos].position) + "]");
+    }
+    result->column = tokens[pos].value;
+    pos++;
+    expectToken(tokens, pos, TokenType::RIGHT_PAREN, "')'");
+    
+    if (pos < tokens.size() && tokens[pos].type == TokenType::SEMICOLON) {
+        pos++;
+    }
+    if (pos >= tokens.size() || tokens[pos].type != TokenType::END_OF_INPUT) {
+        throw std::runtime_error("Unexpected token after CREATE INDEX [pos=" + std::to_string(tokens[pos].position) + "]");
+    }
+    
+    return result;
+}
+
+std::unique_ptr<AlterTableStatement> DDLParser::parseAlterTable(const std::string& query) {
+    Tokenizer tokenizer(query);
+    auto tokens = tokenizer.tokenize();
+    size_t pos = 0;
+    
+    // Parse ALTER TABLE name DROP PARTITION n
+    expectWord(tokens, pos, "ALTER");
+    expectToken(tokens, pos, TokenType::TABLE, "TABLE");
+    
+    if (pos >= tokens.size() || tokens[pos].type != TokenType::IDENTIFIER) {
+        throw std::runtime_error("Expected table name [pos=" + std::to_string(tokens[pos].position) + "]");
+    }
+    auto result = std::make_unique<AlterTableStatement>();
+    result->tableName = tokens[pos].value;
+    pos++;
+    
+    expectToken(tokens, pos, TokenType::DROP, "DROP");
+    expectWord(tokens, pos, "PARTITION");
+    if (pos >= tokens.size() || tokens[pos].type != TokenType::NUMBER ||
+        tokens[pos].value.find_first_not_of("0123456789") != std::string::npos) {
+        throw std::runtime_error("Expected partition number [pos=" + std::to_string(tokens[pos].position) + "]");
+    }
+    result->partition = std::stoul(tokens[pos].value);
+    pos++;
+    
+    if (pos < tokens.size() && tokens[pos].type == TokenType::SEMICOLON) {
+        pos++;
+    }
+    if (pos >= tokens.size() || tokens[pos].type != TokenType::END_OF_INPUT) {
+        throw std::runtime_error("Unexpected token after ALTER TABLE [pos=" + std::to_string(tokens[pos].position) + "]");
+    }
+    
+    return result;
+}
+
+std::unique_ptr<AnalyzeStatement> DDLParser::parseAnalyze(const std::string& query) {
+    Tokenizer tokenizer(query);
+    auto tokens = tokenizer.tokenize();
+    size_t pos = 0;
+    
+    // Parse ANALYZE
+    if (pos >= tokens.size() || tokens[pos].type != TokenType::ANALYZE) {
+        throw std::runtime_error("Expected ANALYZE [pos=" + std::to_string(tokens[pos].position) + "]");
+    }
+    pos++;
+    
+    auto result = std::make_unique<AnalyzeStatement>();
+    
+    // Parse optional table name
+    if (pos < tokens.size() && tokens[pos].type == TokenType::IDENTIFIER) {
+        result->tableName = tokens[pos].value;
+        pos++;
+    }
+    
+    if (pos < tokens.size() && tokens[pos].type == TokenType::SEMICOLON) {
+        pos++;
+    }
+    if (pos >= tokens.size() || tokens[pos].type != TokenType::END_OF_INPUT) {
+        throw std::runtime_error("Unexpected token after ANALYZE [pos=" + std::to_string(tokens[pos].position) + "]");
+    }
+    
+    return result;
+}
+
+PartitionSpec DDLParser::parsePartitioning(const std::vector<Token>& tokens, size_t& pos) {
+    // PARTITION BY RANGE (col) VALUES (b1, b2, ...) | PARTITION BY HASH (col) PARTITIONS n
+    PartitionSpec spec;
+    expectWord(tokens, pos, "PARTITION");
+    expectWord(tokens, pos, "BY");
+    if (isWord(tokens, pos, "RANGE")) {
+        spec.method = PartitionSpec::RANGE;
+    } else if (isWord(tokens, pos, "HASH")) {
+        spec.method = PartitionSpec::HASH;
+    } else {
+        throw std::runtime_error("Expected RANGE or HASH [pos=" + std::to_string(tokens[pos].position) + "]");
+    }
+    pos++;
+    
+    expectToken(tokens, pos, TokenType::LEFT_PAREN, "'('");
+    if (pos >= tokens.size() || tokens[pos].type != TokenType::IDENTIFIER) {
+        throw std::runtime_error("Expected partition column [pos=" + std::to_string(tokens[pos].position) + "]");
+    }
+    spec.column = tokens[pos].value;
+    pos++;
+    expectToken(tokens, pos, TokenType::RIGHT_PAREN, "')'");
+    
+    if (spec.method == PartitionSpec::RANGE) {
+        // Each bound starts a new partition: (b1, b2) makes (-inf, b1), [b1, b2), [b2, +inf)
+        expectToken(tokens, pos, TokenType::VALUES, "VALUES");
+        expectToken(tokens, pos, TokenType::LEFT_PAREN, "'('");
+        while (true) {
+            if (pos < tokens.size() && tokens[pos].type == TokenType::NUMBER) {
+                spec.bounds.push_back(ExpressionParser::parseNumber(tokens[pos]));
+            } else if (pos < tokens.size() && tokens[pos].type == TokenType::STRING_LITERAL) {
+                spec.bounds.push_back(tokens[pos].value);
+            } else {
+                throw std::runtime_error("Expected partition bound [pos=" + std::to_string(tokens[pos].position) + "]");
+            }
+            pos++;
+            if (pos < tokens.size() && tokens[pos].type == TokenType::COMMA) {
+                pos++;
+            } else {
+                break;
+            }
+        }
+        expectToken(tokens, pos, TokenType::RIGHT_PAREN, "')'");
+    } else {
+        expectWord(tokens, pos, "PARTITIONS");
+        if (pos >= tokens.size() || tokens[pos].type != TokenType::NUMBER ||
+            tokens[pos].value.find_first_not_of("0123456789") != std::string::npos) {
+            throw std::runtime_error("Expected partition count [pos=" + std::to_string(tokens[pos].position) + "]");
+        }
+        spec.partitionCount = std::stoul(tokens[pos].value);
+        if (spec.partitionCount == 0) {
+            throw std::runtime_error("Partition count must be positive [pos=" + std::to_string(tokens[pos].position) + "]");
+        }
+        pos++;
+    }
+    return spec;
+}
+
 Schema DDLParser::parseTableSchema(const std::vector<Token>& tokens, size_t& pos) {
     Schema schema("");
     
@@ -108,8 +386,11 @@ Column DDLParser::parseColumnDefinition(const std::vector<Token>& tokens, size_t
     std::string columnName = tokens[pos].value;
     pos++;
     
-    // Parse data type
-    if (pos >= tokens.size() || tokens[pos].type != TokenType::IDENTIFIER) {
+    // Parse data type; the tokenizer turns the built-in type names into keywords
+    if (pos >= tokens.size() ||
+        (tokens[pos].type != TokenType::INT && tokens[pos].type != TokenType::DOUBLE &&
+         tokens[pos].type != TokenType::STRING && tokens[pos].type != TokenType::BOOLEAN &&
+         tokens[pos].type != TokenType::IDENTIFIER)) {
         throw std::runtime_error("Expected data type [pos=" + std::to_string(tokens[pos].position) + "]");
     }
     std::string typeName = tokens[pos].value;
@@ -119,10 +400,7 @@ Column DDLParser::parseColumnDefinition(const std::vector<Token>& tokens, size_t
     Column column(columnName, dataType);
     
     // Parse constraints (optional)
-    while (pos < tokens.size() && tokens[pos].type == TokenType::IDENTIFIER) {
-        std::vector<Constraint> constraints = parseConstraints(tokens, pos);
-        column.constraints.insert(column.constraints.end(), constraints.begin(), constraints.end());
-    }
+    column.constraints = parseConstraints(tokens, pos);
     
     return column;
 }
@@ -130,30 +408,69 @@ Column DDLParser::parseColumnDefinition(const std::vector<Token>& tokens, size_t
 std::vector<Constraint> DDLParser::parseConstraints(const std::vector<Token>& tokens, size_t& pos) {
     std::vector<Constraint> constraints;
     
-    while (pos < tokens.size() && tokens[pos].type == TokenType::IDENTIFIER) {
-        std::string constraintName = tokens[pos].value;
-        std::transform(constraintName.begin(), constraintName.end(), constraintName.begin(), ::toupper);
+    while (pos < tokens.size() && tokens[pos].type != TokenType::COMMA &&
+           tokens[pos].type != TokenType::RIGHT_PAREN && tokens[pos].type != TokenType::END_OF_INPUT) {
+        constraints.push_back(parseConstraint(tokens, pos));
+    }
+    
+    return constraints;
+}
+
+Constraint DDLParser::parseConstraint(const std::vector<Token>& tokens, size_t& pos) {
+    const Token& token = tokens[pos];
+    if (token.type == TokenType::NOT && pos + 1 < tokens.size() &&
+        tokens[pos + 1].type == TokenType::NULL_TOKEN) {
+        pos += 2;
+        return Constraint(Constraint::NOT_NULL, "NOT_NULL");
+    }
+    if (token.type == TokenType::UNIQUE) {
+        pos++;
+        return Constraint(Constraint::UNIQUE, "UNIQUE");
+    }
+    if (token.type == TokenType::PRIMARY && pos + 1 < tokens.size() &&
+        tokens[pos + 1].type == TokenType::KEY) {
+        pos += 2;
+        return Constraint(Constraint::PRIMARY_KEY, "PRIMARY_KEY");
+    }
+    
+    std::string upper = token.value;
+    std::transform(upper.begin(), upper.end(), upper.begin(), ::toupper);
+    if (token.type == TokenType::IDENTIFIER && upper == "CHECK") {
+        pos++;
+        if (pos >= tokens.size() || tokens[pos].type != TokenType::LEFT_PAREN) {
+            throw std::runtime_error("Expected '(' after CHECK [pos=" + std::to_string(tokens[pos].position) + "]");
+        }
+        pos++;
         
-        if (constraintName == "NOT" && pos + 1 < tokens.size() && 
-            tokens[pos + 1].type == TokenType::IDENTIFIER && 
-            tokens[pos + 1].value == "NULL") {
-            pos += 2;
-            constraints.emplace_back(Constraint::NOT_NULL, "NOT_NULL");
-        } else if (constraintName == "UNIQUE") {
-            pos++;
-            constraints.emplace_back(Constraint::UNIQUE, "UNIQUE");
-        } else if (constraintName == "PRIMARY" && pos + 1 < tokens.size() && 
-                   tokens[pos + 1].type == TokenType::IDENTIFIER && 
-                   tokens[pos + 1].value == "KEY") {
-            pos += 2;
-            constraints.emplace_back(Constraint::PRIMARY_KEY, "PRIMARY_KEY");
-        } else {
-            // Unknown constraint, skip it
+        // Keep the expression as text; tables compile it into their ValidationProgram
+        std::string expression;
+        int depth = 0;
+        while (pos < tokens.size() && tokens[pos].type != TokenType::END_OF_INPUT &&
+               (depth > 0 || tokens[pos].type != TokenType::RIGHT_PAREN)) {
+            if (tokens[pos].type == TokenType::LEFT_PAREN) depth++;
+            if (tokens[pos].type == TokenType::RIGHT_PAREN) depth--;
+            if (!expression.empty()) expression += " ";
+            if (tokens[pos].type == TokenType::STRING_LITERAL) {
+                expression += "'" + tokens[pos].value + "'";
+            } else {
+                expression += tokens[pos].value;
+            }
             pos++;
         }
+        if (pos >= tokens.size() || tokens[pos].type != TokenType::RIGHT_PAREN) {
+            throw std::runtime_error("Expected ')' after CHECK expression [pos=" + std::to_string(tokens[pos].position) + "]");
+        }
+        if (expression.empty()) {
+            throw std::runtime_error("Empty CHECK expression [pos=" + std::to_string(tokens[pos].position) + "]");
+        }
+        pos++;
+        
+        Constraint constraint(Constraint::CHECK, "CHECK");
+        constraint.checkExpression = expression;
+        return constraint;
     }
     
-    return constraints;
+    throw std::runtime_error("Unknown column constraint '" + token.value + "' [pos=" + std::to_string(token.position) + "]");
 }
 
 } // namespace parallaxdb 
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "../../include/parser/DMLParser.hpp"
+#include "../../include/parser/ExpressionParser.hpp"
 #include <algorithm>
 
 namespace parallaxdb {
@@ -59,6 +60,96 @@ std::unique_ptr<InsertStatement> DMLParser::parseInsert(const std::string& query
     return result;
 }
 
+std::unique_ptr<UpdateStatement> DMLParser::parseUpdate(const std::string& query) {
+    Tokenizer tokenizer(query);
+    auto tokens = tokenizer.tokenize();
+    size_t pos = 0;
+    
+    // Parse UPDATE table SET
+    if (pos >= tokens.size() || tokens[pos].type != TokenType::UPDATE) {
+        throw std::runtime_error("Expected UPDATE [pos=" + std::to_string(tokens[pos].position) + "]");
+    }
+    pos++;
+    
+    if (pos >= tokens.size() || tokens[pos].type != TokenType::IDENTIFIER) {
+        throw std::runtime_error("Expected table name [pos=" + std::to_string(tokens[pos].position) + "]");
+    }
+    auto result = std::make_unique<UpdateStatement>();
+    result->tableName = tokens[pos].value;
+    pos++;
+    
+    if (pos >= tokens.size() || tokens[pos].type != TokenType::SET) {
+        throw std::runtime_error("Expected SET [pos=" + std::to_string(tokens[pos].position) + "]");
+    }
+    pos++;
+    
+    // Parse assignments: column = value [, ...]
+    while (true) {
+        if (pos >= tokens.size() || tokens[pos].type != TokenType::IDENTIFIER) {
+            throw std::runtime_error("Expected column name [pos=" + std::to_string(tokens[pos].position) + "]");
+        }
+        std::string column = tokens[pos].value;
+        pos++;
+        if (pos >= tokens.size() || tokens[pos].type != TokenType::EQUALS) {
+            throw std::runtime_error("Expected '=' [pos=" + std::to_string(tokens[pos].position) + "]");
+        }
+        pos++;
+        result->assignments.emplace_back(column, parseValue(tokens, pos));
+        
+        if (pos < tokens.size() && tokens[pos].type == TokenType::COMMA) {
+            pos++;
+        } else {
+            break;
+        }
+    }
+    
+    result->where = parseOptionalWhere(tokens, pos);
+    return result;
+}
+
+std::unique_ptr<DeleteStatement> DMLParser::parseDelete(const std::string& query) {
+    Tokenizer tokenizer(query);
+    auto tokens = tokenizer.tokenize();
+    size_t pos = 0;
+    
+    // Parse DELETE FROM table
+    if (pos >= tokens.size() || tokens[pos].type != TokenType::DELETE) {
+        throw std::runtime_error("Expected DELETE [pos=" + std::to_string(tokens[pos].position) + "]");
+    }
+    pos++;
+    
+    if (pos >= tokens.size() || tokens[pos].type != TokenType::FROM) {
+        throw std::runtime_error("Expected FROM [pos=" + std::to_string(tokens[pos].position) + "]");
+    }
+    pos++;
+    
+    if (pos >= tokens.size() || tokens[pos].type != TokenType::IDENTIFIER) {
+        throw std::runtime_error("Expected table name [pos=" + std::to_string(tokens[pos].position) + "]");
+    }
+    auto result = std::make_unique<DeleteStatement>();
+    result->tableName = tokens[pos].value;
+    pos++;
+    
+    result->where = parseOptionalWhere(tokens, pos);
+    return result;
+}
+
+std::unique_ptr<Expression> DMLParser::parseOptionalWhere(const std::vector<Token>& tokens, size_t& pos) {
+    std::unique_ptr<Expression> where;
+    if (pos < tokens.size() && tokens[pos].type == TokenType::WHERE) {
+        pos++;
+        where = ExpressionParser::parseWhereExpression(tokens, pos);
+    }
+    
+    if (pos < tokens.size() && tokens[pos].type == TokenType::SEMICOLON) {
+        pos++;
+    }
+    if (pos >= tokens.size() || tokens[pos].type != TokenType::END_OF_INPUT) {
+        throw std::runtime_error("Unexpected token [pos=" + std::to_string(tokens[pos].position) + "]");
+    }
+    return where;
+}
+
 std::vector<std::string> DMLParser::parseColumnList(const std::vector<Token>& tokens, size_t& pos) {
     std::vector<std::string> columns;
     
@@ -124,23 +215,14 @@ Value DMLParser::parseValue(const std::vector<Token>& tokens, size_t& pos) {
     }
     
     if (tokens[pos].type == TokenType::NUMBER) {
-        std::string numStr = tokens[pos].value;
-        pos++;
-        
-        // Try to parse as integer first, then as double
-        try {
-            return std::stoi(numStr);
-        } catch (...) {
-            try {
-                return std::stod(numStr);
-            } catch (...) {
-                throw std::runtime_error("Invalid number: " + numStr + " [pos=" + std::to_string(tokens[pos-1].position) + "]");
-            }
-        }
+        return ExpressionParser::parseNumber(tokens[pos++]);
     } else if (tokens[pos].type == TokenType::STRING_LITERAL) {
         std::string str = tokens[pos].value;
         pos++;
         return str;
+    } else if (tokens[pos].type == TokenType::NULL_TOKEN) {
+        pos++;
+        return std::nullptr_t{};
     } else if (tokens[pos].type == TokenType::IDENTIFIER) {
         std::string identifier = tokens[pos].value;
         std::transform(identifier.begin(), identifier.end(), identifier.begin(), ::toupper);
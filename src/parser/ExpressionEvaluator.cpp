@@ -1,55 +1,93 @@
 #include "../../include/parser/ExpressionEvaluator.hpp"
 #include "../../include/parser/Expression.hpp"
+#include "../../include/storage/Statistics.hpp"
+#include <algorithm>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
 
 namespace parallaxdb {
 
-bool evaluateComparison(const ComparisonExpr& expr, const Row& row, const Table& table) {
-    int columnIndex = -1;
-    const auto& columns = table.getColumns();
-    for (size_t i = 0; i < columns.size(); i++) {
-        if (columns[i].name == expr.column) {
-            columnIndex = i;
-            break;
-        }
+CompareOp parseCompareOp(const std::string& op) {
+    if (op == "=") return CompareOp::EQ;
+    if (op == "!=") return CompareOp::NE;
+    if (op == "<") return CompareOp::LT;
+    if (op == ">") return CompareOp::GT;
+    if (op == "<=") return CompareOp::LE;
+    if (op == ">=") return CompareOp::GE;
+    throw std::runtime_error("Unknown comparison operator: " + op);
+}
+
+bool applyComparison(const Value& lhs, CompareOp op, const Value& rhs) {
+    // NULL never satisfies a comparison
+    if (std::holds_alternative<std::nullptr_t>(lhs) || std::holds_alternative<std::nullptr_t>(rhs)) {
+        return false;
+    }
+    int cmp;
+    if (std::holds_alternative<int>(lhs) && std::holds_alternative<int>(rhs)) {
+        int a = std::get<int>(lhs), b = std::get<int>(rhs);
+        cmp = (a < b) ? -1 : (a > b ? 1 : 0);
+    } else if (std::holds_alternative<std::string>(lhs) && std::holds_alternative<std::string>(rhs)) {
+        cmp = std::get<std::string>(lhs).compare(std::get<std::string>(rhs));
+    } else if (!std::holds_alternative<std::string>(lhs) && !std::holds_alternative<std::string>(rhs)) {
+        // Mixed INT/DOUBLE compares numerically
+        double a = std::holds_alternative<int>(lhs) ? std::get<int>(lhs) : std::get<double>(lhs);
+        double b = std::holds_alternative<int>(rhs) ? std::get<int>(rhs) : std::get<double>(rhs);
+        cmp = (a < b) ? -1 : (a > b ? 1 : 0);
+    } else {
+        // String vs number: only inequality holds
+        return op == CompareOp::NE;
     }
+    switch (op) {
+        case CompareOp::EQ: return cmp == 0;
+        case CompareOp::NE: return cmp != 0;
+        case CompareOp::LT: return cmp < 0;
+        case CompareOp::GT: return cmp > 0;
+        case CompareOp::LE: return cmp <= 0;
+        case CompareOp::GE: return cmp >= 0;
+    }
+    return false;
+}
+
+bool applyComparison(const CompactValue& lhs, CompareOp op, const CompactValue& rhs) {
+    if (lhs.isNull() || rhs.isNull()) {
+        return false;
+    }
+    int cmp;
+    if (lhs.isString() && rhs.isString()) {
+        if (op == CompareOp::EQ) return CompactValue::stringsEqual(lhs, rhs);
+        if (op == CompareOp::NE) return !CompactValue::stringsEqual(lhs, rhs);
+        cmp = CompactValue::compareStrings(lhs, rhs);
+    } else if (lhs.kind() == CompactValue::Kind::INT && rhs.kind() == CompactValue::Kind::INT) {
+        int a = lhs.asInt(), b = rhs.asInt();
+        cmp = (a < b) ? -1 : (a > b ? 1 : 0);
+    } else if (lhs.isNumeric() && rhs.isNumeric()) {
+        double a = lhs.asNumber(), b = rhs.asNumber();
+        cmp = (a < b) ? -1 : (a > b ? 1 : 0);
+    } else {
+        return op == CompareOp::NE;
+    }
+    switch (op) {
+        case CompareOp::EQ: return cmp == 0;
+        case CompareOp::NE: return cmp != 0;
+        case CompareOp::LT: return cmp < 0;
+        case CompareOp::GT: return cmp > 0;
+        case CompareOp::LE: return cmp <= 0;
+        case CompareOp::GE: return cmp >= 0;
+    }
+    return false;
+}
+
+bool evaluateComparison(const ComparisonExpr& expr, const Row& row, const Table& table) {
+    int columnIndex = table.getColumnIndex(expr.column);
     if (columnIndex == -1 || columnIndex >= static_cast<int>(row.values.size())) {
         return false;
     }
-    const Value& rowValue = row.values[columnIndex];
     try {
-        if (expr.op == ">") {
-            if (std::holds_alternative<int>(rowValue) && std::holds_alternative<int>(expr.value)) {
-                return std::get<int>(rowValue) > std::get<int>(expr.value);
-            } else if (std::holds_alternative<double>(rowValue) && std::holds_alternative<double>(expr.value)) {
-                return std::get<double>(rowValue) > std::get<double>(expr.value);
-            }
-        } else if (expr.op == "<") {
-            if (std::holds_alternative<int>(rowValue) && std::holds_alternative<int>(expr.value)) {
-                return std::get<int>(rowValue) < std::get<int>(expr.value);
-            } else if (std::holds_alternative<double>(rowValue) && std::holds_alternative<double>(expr.value)) {
-                return std::get<double>(rowValue) < std::get<double>(expr.value);
-            }
-        } else if (expr.op == "=") {
-            return rowValue == expr.value;
-        } else if (expr.op == ">=") {
-            if (std::holds_alternative<int>(rowValue) && std::holds_alternative<int>(expr.value)) {
-                return std::get<int>(rowValue) >= std::get<int>(expr.value);
-            } else if (std::holds_alternative<double>(rowValue) && std::holds_alternative<double>(expr.value)) {
-                return std::get<double>(rowValue) >= std::get<double>(expr.value);
-            }
-        } else if (expr.op == "<=") {
-            if (std::holds_alternative<int>(rowValue) && std::holds_alternative<int>(expr.value)) {
-                return std::get<int>(rowValue) <= std::get<int>(expr.value);
-            } else if (std::holds_alternative<double>(rowValue) && std::holds_alternative<double>(expr.value)) {
-                return std::get<double>(rowValue) <= std::get<double>(expr.value);
-            }
-        } else if (expr.op == "!=") {
-            return rowValue != expr.value;
-        }
-    } catch (const std::bad_variant_access&) {
+        return applyComparison(row.values[columnIndex], parseCompareOp(expr.op), expr.value);
+    } catch (const std::runtime_error&) {
         return false;
     }
-    return false;
 }
 
 bool evaluateLogical(const LogicalExpr& expr, const Row& row, const Table& table) {
@@ -66,8 +104,197 @@ bool ComparisonExpr::evaluate(const Row& row, const Table& table) const {
     return evaluateComparison(*this, row, table);
 }
 
+void ComparisonExpr::bind(const std::vector<std::string>& columns) {
+    columnIndex = findColumn(columns, column);
+    if (columnIndex < 0) {
+        throw std::runtime_error("Unknown column: " + column);
+    }
+    opCode = parseCompareOp(op);
+    literal = CompactValue::borrow(value);
+}
+
+bool ComparisonExpr::evaluate(const Row& row) const {
+    return applyComparison(row.values[columnIndex], opCode, value);
+}
+
+std::string ComparisonExpr::toString() const {
+    std::ostringstream os;
+    os << column << " " << op << " ";
+    if (std::holds_alternative<std::string>(value)) {
+        os << "'" << std::get<std::string>(value) << "'";
+    } else if (std::holds_alternative<std::nullptr_t>(value)) {
+        os << "NULL";
+    } else {
+        os << value;
+    }
+    return os.str();
+}
+
 bool LogicalExpr::evaluate(const Row& row, const Table& table) const {
     return evaluateLogical(*this, row, table);
 }
 
-} // namespace parallaxdb 
\ No newline at end of file
+bool LogicalExpr::evaluate(const Row& row) const {
+    if (op == "AND") {
+        return left->evaluate(row) && right->evaluate(row);
+    } else if (op == "OR") {
+        return left->evaluate(row) || right->evaluate(row);
+    }
+    return false;
+}
+
+bool InListExpr::evaluate(const Row& row, const Table& table) const {
+    int index = table.getColumnIndex(column);
+    if (index == -1 || index >= static_cast<int>(row.values.size())) {
+        return false;
+    }
+    return contains(CompactValue::borrow(row.values[index]));
+}
+
+void InListExpr::bind(const std::vector<std::string>& columns) {
+    columnIndex = findColumn(columns, column);
+    if (columnIndex < 0) {
+        throw std::runtime_error("Unknown column: " + column);
+    }
+    literals.clear();
+    hashes.clear();
+    if (values.size() <= kLinearMaxValues) {
+        for (const auto& value : values) {
+            literals.push_back(CompactValue::borrow(value));
+        }
+        return;
+    }
+    std::vector<uint64_t> valueHashes;
+    for (const auto& value : values) {
+        valueHashes.push_back(hashValue(value));
+    }
+    std::vector<size_t> order(values.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&valueHashes](size_t a, size_t b) {
+        return valueHashes[a] < valueHashes[b];
+    });
+    for (size_t i : order) {
+        literals.push_back(CompactValue::borrow(values[i]));
+        hashes.push_back(valueHashes[i]);
+    }
+}
+
+bool InListExpr::contains(const CompactValue& cell) const {
+    if (cell.isNull()) {
+        return false;
+    }
+    if (hashes.empty()) {
+        for (const auto& literal : literals) {
+            if (applyComparison(cell, CompareOp::EQ, literal)) return true;
+        }
+        return false;
+    }
+    // Lower bound without data-dependent branches: the loop runs log2(N)
+    // times whatever the key, and the step compiles to a conditional move
+    const uint64_t h = hashValue(cell);
+    const uint64_t* base = hashes.data();
+    size_t n = hashes.size();
+    while (n > 1) {
+        size_t half = n / 2;
+        base = base[half - 1] < h ? base + half : base;
+        n -= half;
+    }
+    size_t i = static_cast<size_t>(base - hashes.data()) + (*base < h);
+    for (; i < hashes.size() && hashes[i] == h; ++i) {
+        if (applyComparison(cell, CompareOp::EQ, literals[i])) return true;
+    }
+    return false;
+}
+
+std::string InListExpr::toString() const {
+    std::ostringstream os;
+    os << column << " IN (";
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (i > 0) os << ", ";
+        if (std::holds_alternative<std::string>(values[i])) {
+            os << "'" << std::get<std::string>(values[i]) << "'";
+        } else {
+            os << values[i];
+        }
+    }
+    os << ")";
+    return os.str();
+}
+
+PatternExpr::PatternExpr(const std::string& c, PatternOp o, const std::string& p, bool n)
+    : column(c), op(o), pattern(p), negated(n) {
+    switch (op) {
+        case PatternOp::LIKE: matcher = PatternMatcher::like(pattern); break;
+        case PatternOp::ILIKE: matcher = PatternMatcher::like(pattern, true); break;
+        case PatternOp::STARTS_WITH: matcher = PatternMatcher::startsWith(pattern); break;
+        case PatternOp::CONTAINS: matcher = PatternMatcher::contains(pattern); break;
+    }
+}
+
+bool PatternExpr::evaluate(const Row& row, const Table& table) const {
+    int index = table.getColumnIndex(column);
+    if (index == -1 || index >= static_cast<int>(row.values.size())) {
+        return false;
+    }
+    const Value& value = row.values[index];
+    return std::holds_alternative<std::string>(value) &&
+           matcher.matches(std::string_view(std::get<std::string>(value))) != negated;
+}
+
+void PatternExpr::bind(const std::vector<std::string>& columns) {
+    columnIndex = findColumn(columns, column);
+    if (columnIndex < 0) {
+        throw std::runtime_error("Unknown column: " + column);
+    }
+}
+
+std::string PatternExpr::toString() const {
+    switch (op) {
+        case PatternOp::STARTS_WITH: return "STARTS_WITH(" + column + ", '" + pattern + "')";
+        case PatternOp::CONTAINS: return "CONTAINS(" + column + ", '" + pattern + "')";
+        default:
+            return column + (negated ? " NOT " : " ") + (op == PatternOp::LIKE ? "LIKE" : "ILIKE") + " '" + pattern + "'";
+    }
+}
+
+void InSubqueryExpr::bind(const std::vector<std::string>&) {
+    throw std::runtime_error("IN (SELECT ...) is only supported as a top-level WHERE conjunct");
+}
+
+std::string InSubqueryExpr::toString() const {
+    std::string text = column + " IN (";
+    for (size_t i = 0; i < subquery.size() && subquery[i].type != TokenType::END_OF_INPUT; ++i) {
+        if (i > 0) text += " ";
+        text += subquery[i].type == TokenType::STRING_LITERAL ? "'" + subquery[i].value + "'" : subquery[i].value;
+    }
+    return text + ")";
+}
+
+void splitConjuncts(std::unique_ptr<Expression> expr, std::vector<std::unique_ptr<Expression>>& out) {
+    if (auto logical = dynamic_cast<LogicalExpr*>(expr.get())) {
+        if (logical->op == "AND") {
+            splitConjuncts(std::move(logical->left), out);
+            splitConjuncts(std::move(logical->right), out);
+            return;
+        }
+    }
+    if (auto paren = dynamic_cast<ParenExpr*>(expr.get())) {
+        splitConjuncts(std::move(paren->expr), out);
+        return;
+    }
+    out.push_back(std::move(expr));
+}
+
+std::unique_ptr<Expression> combineConjuncts(std::vector<std::unique_ptr<Expression>> conjuncts) {
+    std::unique_ptr<Expression> result;
+    for (auto& conjunct : conjuncts) {
+        if (!result) {
+            result = std::move(conjunct);
+        } else {
+            result = std::make_unique<LogicalExpr>("AND", std::move(result), std::move(conjunct));
+        }
+    }
+    return result;
+}
+
+} // namespace parallaxdb
@@ -1,5 +1,6 @@
 #include "../../include/parser/ExpressionParser.hpp"
 #include "../../include/parser/Expression.hpp"
+#include <algorithm>
 #include <stdexcept>
 
 namespace parallaxdb {
@@ -35,15 +36,38 @@ std::unique_ptr<Expression> ExpressionParser::parsePrimary(const std::vector<Tok
         pos++;
         return std::make_unique<ParenExpr>(std::move(expr));
     }
-    // Parse comparison: col op value
+    // Parse comparison: col op value, col IN (...), col [NOT] LIKE | ILIKE 'pattern'
     if (tokens[pos].type != TokenType::IDENTIFIER) {
         throw std::runtime_error("Expected column name in WHERE clause [pos=" + std::to_string(tokens[pos].position) + "]");
     }
+    if (pos + 1 < tokens.size() && tokens[pos + 1].type == TokenType::LEFT_PAREN) {
+        return parseStringFunction(tokens, pos);
+    }
     std::string col = tokens[pos].value;
     pos++;
     if (pos >= tokens.size()) {
         throw std::runtime_error("Expected operator in WHERE clause [pos=" + std::to_string(pos) + "]");
     }
+    if (isWord(tokens, pos, "IN")) {
+        pos++;
+        return parseIn(col, tokens, pos);
+    }
+    bool negated = false;
+    if (tokens[pos].type == TokenType::NOT) {
+        negated = true;
+        pos++;
+    }
+    if (isWord(tokens, pos, "LIKE") || isWord(tokens, pos, "ILIKE")) {
+        PatternOp patternOp = isWord(tokens, pos, "LIKE") ? PatternOp::LIKE : PatternOp::ILIKE;
+        pos++;
+        if (pos >= tokens.size() || tokens[pos].type != TokenType::STRING_LITERAL) {
+            throw std::runtime_error("Expected pattern string [pos=" + std::to_string(tokens[pos].position) + "]");
+        }
+        return std::make_unique<PatternExpr>(col, patternOp, tokens[pos++].value, negated);
+    }
+    if (negated) {
+        throw std::runtime_error("Expected LIKE or ILIKE after NOT [pos=" + std::to_string(tokens[pos].position) + "]");
+    }
     std::string op;
     if (tokens[pos].type == TokenType::GREATER_THAN) op = ">";
     else if (tokens[pos].type == TokenType::LESS_THAN) op = "<";
@@ -56,24 +80,348 @@ std::unique_ptr<Expression> ExpressionParser::parsePrimary(const std::vector<Tok
     if (pos >= tokens.size()) {
         throw std::runtime_error("Expected value in WHERE clause [pos=" + std::to_string(pos) + "]");
     }
-    Value val;
-    if (tokens[pos].type == TokenType::NUMBER) {
-        try {
-            val = std::stoi(tokens[pos].value);
-        } catch (...) {
+    Value val = parseLiteral(tokens, pos);
+    return std::make_unique<ComparisonExpr>(col, op, val);
+}
+
+std::unique_ptr<Expression> ExpressionParser::parseIn(const std::string& column, const std::vector<Token>& tokens,
+                                                      size_t& pos) {
+    if (pos >= tokens.size() || tokens[pos].type != TokenType::LEFT_PAREN) {
+        throw std::runtime_error("Expected '(' after IN [pos=" + std::to_string(tokens[pos].position) + "]");
+    }
+    pos++;
+    if (pos < tokens.size() && tokens[pos].type == TokenType::SELECT) {
+        // The subquery runs to the matching ')'; SQLParser plans it
+        size_t start = pos;
+        int depth = 1;
+        for (; pos < tokens.size() && tokens[pos].type != TokenType::END_OF_INPUT; ++pos) {
+            if (tokens[pos].type == TokenType::LEFT_PAREN) depth++;
+            if (tokens[pos].type == TokenType::RIGHT_PAREN && --depth == 0) break;
+        }
+        if (depth != 0) {
+            throw std::runtime_error("Expected ')' [pos=" + std::to_string(tokens[pos].position) + "]");
+        }
+        std::vector<Token> subquery(tokens.begin() + start, tokens.begin() + pos);
+        subquery.emplace_back(TokenType::END_OF_INPUT, "", tokens[pos].position);
+        pos++;
+        return std::make_unique<InSubqueryExpr>(column, std::move(subquery));
+    }
+    std::vector<Value> values;
+    while (true) {
+        values.push_back(parseLiteral(tokens, pos));
+        if (pos < tokens.size() && tokens[pos].type == TokenType::COMMA) {
+            pos++;
+        } else {
+            break;
+        }
+    }
+    if (pos >= tokens.size() || tokens[pos].type != TokenType::RIGHT_PAREN) {
+        throw std::runtime_error("Expected ')' [pos=" + std::to_string(tokens[pos].position) + "]");
+    }
+    pos++;
+    return std::make_unique<InListExpr>(column, std::move(values));
+}
+
+std::unique_ptr<Expression> ExpressionParser::parseStringFunction(const std::vector<Token>& tokens, size_t& pos) {
+    const Token& name = tokens[pos];
+    PatternOp op;
+    if (isWord(tokens, pos, "STARTS_WITH")) {
+        op = PatternOp::STARTS_WITH;
+    } else if (isWord(tokens, pos, "CONTAINS")) {
+        op = PatternOp::CONTAINS;
+    } else {
+        throw std::runtime_error("Unknown function '" + name.value + "' in WHERE clause [pos=" +
+                                 std::to_string(name.position) + "]");
+    }
+    pos += 2;
+    if (pos + 3 >= tokens.size() || tokens[pos].type != TokenType::IDENTIFIER || tokens[pos + 1].type != TokenType::COMMA ||
+        tokens[pos + 2].type != TokenType::STRING_LITERAL || tokens[pos + 3].type != TokenType::RIGHT_PAREN) {
+        throw std::runtime_error("Expected '(column, 'text')' [pos=" + std::to_string(tokens[pos].position) + "]");
+    }
+    auto expr = std::make_unique<PatternExpr>(tokens[pos].value, op, tokens[pos + 2].value);
+    pos += 4;
+    return expr;
+}
+
+Value ExpressionParser::parseNumber(const Token& token) {
+    try {
+        if (token.value.find('.') == std::string::npos) {
             try {
-                val = std::stod(tokens[pos].value);
-            } catch (...) {
-                throw std::runtime_error("Invalid number: " + tokens[pos].value + " [pos=" + std::to_string(tokens[pos].position) + "]");
+                return std::stoi(token.value);
+            } catch (const std::out_of_range&) {
+                // Too wide for an int: read as a double below
             }
         }
+        return std::stod(token.value);
+    } catch (const std::logic_error&) {
+        throw std::runtime_error("Invalid number: " + token.value + " [pos=" + std::to_string(token.position) + "]");
+    }
+}
+
+Value ExpressionParser::parseLiteral(const std::vector<Token>& tokens, size_t& pos) {
+    Value val;
+    if (tokens[pos].type == TokenType::NUMBER) {
+        val = parseNumber(tokens[pos]);
     } else if (tokens[pos].type == TokenType::STRING_LITERAL) {
         val = tokens[pos].value;
     } else {
         throw std::runtime_error("Expected value [pos=" + std::to_string(tokens[pos].position) + "]");
     }
     pos++;
-    return std::make_unique<ComparisonExpr>(col, op, val);
+    return val;
+}
+
+AggregateColumn ExpressionParser::parseSelectColumn(const std::vector<Token>& tokens, size_t& pos) {
+    AggregateColumn column;
+    if (pos >= tokens.size() || tokens[pos].type != TokenType::IDENTIFIER) {
+        throw std::runtime_error("Expected column or aggregate [pos=" + std::to_string(tokens[pos].position) + "]");
+    }
+    if (pos + 1 < tokens.size() && tokens[pos + 1].type == TokenType::LEFT_PAREN) {
+        column.function = parseAggregateFunction(tokens[pos].value);
+        if (column.function == AggregateFunction::NONE) {
+            throw std::runtime_error("Unknown aggregate '" + tokens[pos].value + "' [pos=" +
+                                     std::to_string(tokens[pos].position) + "]");
+        }
+        std::string name = tokens[pos].value;
+        std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+        pos += 2;
+        if (column.function == AggregateFunction::COUNT && pos < tokens.size() &&
+            tokens[pos].type == TokenType::STAR) {
+            pos++;
+        } else if (pos < tokens.size() && tokens[pos].type == TokenType::IDENTIFIER) {
+            column.source = tokens[pos].value;
+            std::string unqualified = column.source.substr(column.source.rfind('.') + 1);
+            name += "_" + unqualified;
+            pos++;
+        } else {
+            throw std::runtime_error("Expected aggregate argument [pos=" + std::to_string(tokens[pos].position) + "]");
+        }
+        if (column.function == AggregateFunction::APPROX_QUANTILE) {
+            if (pos + 1 >= tokens.size() || tokens[pos].type != TokenType::COMMA ||
+                tokens[pos + 1].type != TokenType::NUMBER) {
+                throw std::runtime_error("Expected ', quantile' [pos=" + std::to_string(tokens[pos].position) + "]");
+            }
+            const Value quantile = parseNumber(tokens[pos + 1]);
+            column.parameter = std::holds_alternative<int>(quantile) ? std::get<int>(quantile) : std::get<double>(quantile);
+            if (column.parameter > 1.0) {
+                throw std::runtime_error("Quantile must be between 0 and 1 [pos=" +
+                                         std::to_string(tokens[pos + 1].position) + "]");
+            }
+            pos += 2;
+        }
+        if (pos >= tokens.size() || tokens[pos].type != TokenType::RIGHT_PAREN) {
+            throw std::runtime_error("Expected ')' [pos=" + std::to_string(tokens[pos].position) + "]");
+        }
+        pos++;
+        column.name = name;
+    } else {
+        column.source = tokens[pos].value;
+        column.name = column.source;
+        pos++;
+    }
+    
+    if (pos < tokens.size() && tokens[pos].type == TokenType::AS) {
+        pos++;
+        if (pos >= tokens.size() || tokens[pos].type != TokenType::IDENTIFIER) {
+            throw std::runtime_error("Expected column alias [pos=" + std::to_string(tokens[pos].position) + "]");
+        }
+        column.name = tokens[pos].value;
+        pos++;
+    }
+    return column;
+}
+
+bool ExpressionParser::isWindowFunction(const std::vector<Token>& tokens, size_t pos) {
+    if (pos + 1 >= tokens.size() || tokens[pos].type != TokenType::IDENTIFIER ||
+        tokens[pos + 1].type != TokenType::LEFT_PAREN) {
+        return false;
+    }
+    int depth = 0;
+    for (size_t i = pos + 1; i < tokens.size(); ++i) {
+        if (tokens[i].type == TokenType::LEFT_PAREN) depth++;
+        if (tokens[i].type == TokenType::RIGHT_PAREN && --depth == 0) return isWord(tokens, i + 1, "OVER");
+    }
+    return false;
+}
+
+WindowSpec ExpressionParser::parseWindowFunction(const std::vector<Token>& tokens, size_t& pos) {
+    auto expect = [&tokens, &pos](TokenType type, const char* what) {
+        if (pos >= tokens.size() || tokens[pos].type != type) {
+            throw std::runtime_error(std::string("Expected ") + what + " [pos=" + std::to_string(tokens[pos].position) + "]");
+        }
+        pos++;
+    };
+    auto expectWord = [&tokens, &pos](const char* word) {
+        if (!isWord(tokens, pos, word)) {
+            throw std::runtime_error(std::string("Expected ") + word + " [pos=" + std::to_string(tokens[pos].position) + "]");
+        }
+        pos++;
+    };
+    auto expectColumn = [&tokens, &pos]() {
+        if (pos >= tokens.size() || tokens[pos].type != TokenType::IDENTIFIER) {
+            throw std::runtime_error("Expected column name [pos=" + std::to_string(tokens[pos].position) + "]");
+        }
+        return tokens[pos++].value;
+    };
+
+    WindowSpec spec;
+    const Token& nameToken = tokens[pos];
+    std::string name = nameToken.value;
+    std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+    if (isWord(tokens, pos, "ROW_NUMBER")) {
+        spec.function = WindowFunction::ROW_NUMBER;
+    } else if (isWord(tokens, pos, "RANK")) {
+        spec.function = WindowFunction::RANK;
+    } else if (isWord(tokens, pos, "DENSE_RANK")) {
+        spec.function = WindowFunction::DENSE_RANK;
+    } else if (isWord(tokens, pos, "LAG")) {
+        spec.function = WindowFunction::LAG;
+    } else if (isWord(tokens, pos, "LEAD")) {
+        spec.function = WindowFunction::LEAD;
+    } else {
+        spec.function = WindowFunction::AGGREGATE;
+        spec.aggregate = parseAggregateFunction(nameToken.value);
+        if (spec.aggregate == AggregateFunction::NONE || spec.aggregate == AggregateFunction::APPROX_COUNT_DISTINCT ||
+            spec.aggregate == AggregateFunction::APPROX_QUANTILE) {
+            throw std::runtime_error("Unknown window function '" + nameToken.value + "' [pos=" +
+                                     std::to_string(nameToken.position) + "]");
+        }
+    }
+    pos += 2;
+
+    switch (spec.function) {
+        case WindowFunction::ROW_NUMBER:
+        case WindowFunction::RANK:
+        case WindowFunction::DENSE_RANK:
+            break;
+        case WindowFunction::LAG:
+        case WindowFunction::LEAD:
+            spec.source = expectColumn();
+            if (pos < tokens.size() && tokens[pos].type == TokenType::COMMA) {
+                pos++;
+                if (pos >= tokens.size() || tokens[pos].type != TokenType::NUMBER ||
+                    tokens[pos].value.find('.') != std::string::npos) {
+                    throw std::runtime_error("Expected row offset [pos=" + std::to_string(tokens[pos].position) + "]");
+                }
+                spec.offset = parseRowOffset(tokens[pos++]);
+                if (pos < tokens.size() && tokens[pos].type == TokenType::COMMA) {
+                    pos++;
+                    if (pos < tokens.size() && tokens[pos].type == TokenType::NUMBER) {
+                        spec.defaultValue = parseNumber(tokens[pos]);
+                    } else if (pos < tokens.size() && tokens[pos].type == TokenType::STRING_LITERAL) {
+                        spec.defaultValue = tokens[pos].value;
+                    } else if (pos < tokens.size() && tokens[pos].type != TokenType::NULL_TOKEN) {
+                        throw std::runtime_error("Expected default value [pos=" + std::to_string(tokens[pos].position) + "]");
+                    }
+                    pos++;
+                }
+            }
+            break;
+        case WindowFunction::AGGREGATE:
+            if (spec.aggregate == AggregateFunction::COUNT && pos < tokens.size() && tokens[pos].type == TokenType::STAR) {
+                pos++;
+            } else {
+                spec.source = expectColumn();
+            }
+            break;
+    }
+    expect(TokenType::RIGHT_PAREN, "')'");
+    if (!spec.source.empty()) {
+        name += "_" + spec.source.substr(spec.source.rfind('.') + 1);
+    }
+    spec.name = name;
+
+    expectWord("OVER");
+    expect(TokenType::LEFT_PAREN, "'('");
+    if (isWord(tokens, pos, "PARTITION")) {
+        pos++;
+        expectWord("BY");
+        while (true) {
+            spec.partitionBy.push_back(expectColumn());
+            if (pos >= tokens.size() || tokens[pos].type != TokenType::COMMA) break;
+            pos++;
+        }
+    }
+    if (isWord(tokens, pos, "ORDER")) {
+        pos++;
+        expectWord("BY");
+        while (true) {
+            SortKey key;
+            key.column = expectColumn();
+            if (isWord(tokens, pos, "DESC")) {
+                key.descending = true;
+                pos++;
+            } else if (isWord(tokens, pos, "ASC")) {
+                pos++;
+            }
+            spec.orderBy.push_back(key);
+            if (pos >= tokens.size() || tokens[pos].type != TokenType::COMMA) break;
+            pos++;
+        }
+        spec.frame.end = 0;   // Running aggregates by default
+    }
+    if (isWord(tokens, pos, "ROWS")) {
+        size_t framePos = pos;
+        pos++;
+        if (isWord(tokens, pos, "BETWEEN")) {
+            pos++;
+            spec.frame.start = parseFrameBound(tokens, pos);
+            expect(TokenType::AND, "AND");
+            spec.frame.end = parseFrameBound(tokens, pos);
+        } else {
+            spec.frame.start = parseFrameBound(tokens, pos);
+            spec.frame.end = 0;
+        }
+        if (spec.frame.start == WindowFrame::kUnboundedFollowing || spec.frame.end == WindowFrame::kUnboundedPreceding ||
+            spec.frame.start > spec.frame.end) {
+            throw std::runtime_error("Window frame starts after it ends [pos=" + std::to_string(tokens[framePos].position) + "]");
+        }
+    }
+    expect(TokenType::RIGHT_PAREN, "')'");
+
+    if (pos < tokens.size() && tokens[pos].type == TokenType::AS) {
+        pos++;
+        spec.name = expectColumn();
+    }
+    return spec;
+}
+
+int64_t ExpressionParser::parseRowOffset(const Token& token) {
+    try {
+        return std::stoll(token.value);
+    } catch (const std::logic_error&) {
+        throw std::runtime_error("Row offset out of range: " + token.value + " [pos=" + std::to_string(token.position) + "]");
+    }
+}
+
+int64_t ExpressionParser::parseFrameBound(const std::vector<Token>& tokens, size_t& pos) {
+    if (isWord(tokens, pos, "UNBOUNDED")) {
+        pos++;
+        if (isWord(tokens, pos, "PRECEDING")) {
+            pos++;
+            return WindowFrame::kUnboundedPreceding;
+        }
+        if (isWord(tokens, pos, "FOLLOWING")) {
+            pos++;
+            return WindowFrame::kUnboundedFollowing;
+        }
+    } else if (isWord(tokens, pos, "CURRENT") && isWord(tokens, pos + 1, "ROW")) {
+        pos += 2;
+        return 0;
+    } else if (pos < tokens.size() && tokens[pos].type == TokenType::NUMBER &&
+               tokens[pos].value.find('.') == std::string::npos) {
+        int64_t offset = parseRowOffset(tokens[pos]);
+        if (isWord(tokens, pos + 1, "PRECEDING")) {
+            pos += 2;
+            return -offset;
+        }
+        if (isWord(tokens, pos + 1, "FOLLOWING")) {
+            pos += 2;
+            return offset;
+        }
+        pos++;
+    }
+    throw std::runtime_error("Expected frame bound [pos=" + std::to_string(tokens[pos].position) + "]");
 }
 
-} // namespace parallaxdb 
\ No newline at end of file
+} // namespace parallaxdb
@@ -0,0 +1,269 @@
+#include "../../include/parser/PatternMatcher.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <stdexcept>
+
+namespace parallaxdb {
+
+namespace {
+
+char lower(char c) {
+    return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+}
+
+} // namespace
+
+PatternMatcher PatternMatcher::like(std::string_view pattern, bool foldCase) {
+    enum class Kind { LITERAL, ANY_ONE, ANY_RUN };
+    struct Element {
+        Kind kind;
+        char c;
+    };
+    std::vector<Element> elements;
+    bool anyOne = false;
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        char c = pattern[i];
+        if (c == '\\' && i + 1 < pattern.size()) {
+            elements.push_back({Kind::LITERAL, pattern[++i]});
+        } else if (c == '%') {
+            // Consecutive '%'s match what one does
+            if (elements.empty() || elements.back().kind != Kind::ANY_RUN) {
+                elements.push_back({Kind::ANY_RUN, 0});
+            }
+        } else if (c == '_') {
+            elements.push_back({Kind::ANY_ONE, 0});
+            anyOne = true;
+        } else {
+            elements.push_back({Kind::LITERAL, c});
+        }
+    }
+
+    PatternMatcher matcher;
+    matcher.foldCase = foldCase;
+    if (anyOne) {
+        if (elements.size() > kMaxNfaElements) {
+            throw std::runtime_error("LIKE pattern is too long: " + std::string(pattern));
+        }
+        matcher.strategy = Strategy::NFA;
+        matcher.elementCount = elements.size();
+        std::string run;
+        for (const auto& element : elements) {
+            if (element.kind == Kind::LITERAL) {
+                run += foldCase ? lower(element.c) : element.c;
+            } else if (!run.empty()) {
+                matcher.segments.push_back(run);
+                run.clear();
+            }
+        }
+        if (!run.empty()) matcher.segments.push_back(run);
+        matcher.byteMasks.assign(256, 0);
+        for (size_t i = 0; i < elements.size(); ++i) {
+            const uint64_t bit = uint64_t(1) << i;
+            switch (elements[i].kind) {
+                case Kind::ANY_RUN:
+                    matcher.anyRunMask |= bit;
+                    continue;
+                case Kind::ANY_ONE:
+                    for (auto& mask : matcher.byteMasks) {
+                        mask |= bit;
+                    }
+                    break;
+                case Kind::LITERAL: {
+                    unsigned char c = static_cast<unsigned char>(elements[i].c);
+                    matcher.byteMasks[c] |= bit;
+                    if (foldCase) {
+                        matcher.byteMasks[static_cast<unsigned char>(std::tolower(c))] |= bit;
+                        matcher.byteMasks[static_cast<unsigned char>(std::toupper(c))] |= bit;
+                    }
+                    break;
+                }
+            }
+            matcher.minLength++;
+        }
+        return matcher;
+    }
+
+    matcher.anchoredStart = elements.empty() || elements.front().kind != Kind::ANY_RUN;
+    matcher.anchoredEnd = elements.empty() || elements.back().kind != Kind::ANY_RUN;
+    std::string current;
+    for (const auto& element : elements) {
+        if (element.kind == Kind::ANY_RUN) {
+            if (!current.empty()) matcher.segments.push_back(current);
+            current.clear();
+        } else {
+            current += foldCase ? lower(element.c) : element.c;
+        }
+    }
+    if (!current.empty()) matcher.segments.push_back(current);
+    matcher.classify();
+    return matcher;
+}
+
+PatternMatcher PatternMatcher::startsWith(std::string_view prefix) {
+    PatternMatcher matcher;
+    matcher.segments.emplace_back(prefix);
+    matcher.anchoredEnd = false;
+    matcher.classify();
+    return matcher;
+}
+
+PatternMatcher PatternMatcher::contains(std::string_view needle) {
+    PatternMatcher matcher;
+    matcher.segments.emplace_back(needle);
+    matcher.anchoredStart = matcher.anchoredEnd = false;
+    matcher.classify();
+    return matcher;
+}
+
+void PatternMatcher::classify() {
+    minLength = 0;
+    for (const auto& segment : segments) {
+        minLength += segment.size();
+    }
+    if (segments.empty()) {
+        // '' matches only the empty string; '%' matches everything
+        segments.emplace_back();
+    }
+    if (anchoredStart && anchoredEnd) {
+        strategy = segments.size() == 1 ? Strategy::EXACT : Strategy::SEGMENTS;
+    } else if (segments.size() > 1) {
+        strategy = Strategy::SEGMENTS;
+    } else {
+        strategy = anchoredStart ? Strategy::PREFIX : anchoredEnd ? Strategy::SUFFIX : Strategy::CONTAINS;
+    }
+}
+
+std::vector<std::string> PatternMatcher::getRequiredLiterals() const {
+    std::vector<std::string> literals;
+    if (foldCase) return literals;
+    for (const auto& segment : segments) {
+        if (!segment.empty()) literals.push_back(segment);
+    }
+    return literals;
+}
+
+bool PatternMatcher::equalAt(std::string_view text, size_t at, std::string_view literal) const {
+    if (!foldCase) {
+        return std::memcmp(text.data() + at, literal.data(), literal.size()) == 0;
+    }
+    for (size_t i = 0; i < literal.size(); ++i) {
+        if (lower(text[at + i]) != literal[i]) return false;
+    }
+    return true;
+}
+
+// First position at or after `from` where `needle` starts. Candidates are
+// located by their first byte with memchr, which scans a vector at a time,
+// and then verified.
+size_t PatternMatcher::find(std::string_view text, std::string_view needle, size_t from) const {
+    if (needle.empty()) {
+        return from <= text.size() ? from : std::string_view::npos;
+    }
+    if (text.size() < needle.size()) {
+        return std::string_view::npos;
+    }
+    const char* data = text.data();
+    const size_t lastStart = text.size() - needle.size();
+    const char first = needle[0];
+    const char firstUpper = static_cast<char>(std::toupper(static_cast<unsigned char>(first)));
+    const bool bothCases = foldCase && firstUpper != first;
+    for (size_t pos = from; pos <= lastStart; ++pos) {
+        const size_t span = lastStart - pos + 1;
+        const void* hit = std::memchr(data + pos, first, span);
+        if (bothCases) {
+            // Only a capital before the lowercase hit can come first
+            size_t before = hit ? static_cast<size_t>(static_cast<const char*>(hit) - (data + pos)) : span;
+            if (const void* upperHit = std::memchr(data + pos, firstUpper, before)) hit = upperHit;
+        }
+        if (!hit) {
+            return std::string_view::npos;
+        }
+        pos = static_cast<const char*>(hit) - data;
+        if (equalAt(text, pos + 1, needle.substr(1))) {
+            return pos;
+        }
+    }
+    return std::string_view::npos;
+}
+
+bool PatternMatcher::matchSegments(std::string_view text) const {
+    size_t lo = 0;
+    size_t hi = text.size();
+    size_t first = 0;
+    size_t last = segments.size();
+    if (anchoredStart) {
+        if (!equalAt(text, 0, segments[0])) return false;
+        lo = segments[0].size();
+        first = 1;
+    }
+    if (anchoredEnd) {
+        const std::string& tail = segments.back();
+        if (!equalAt(text, hi - tail.size(), tail)) return false;
+        hi -= tail.size();
+        last--;
+    }
+    // Taking each piece at its leftmost match leaves the most room for the rest
+    std::string_view middle = text.substr(0, hi);
+    for (size_t i = first; i < last; ++i) {
+        size_t at = find(middle, segments[i], lo);
+        if (at == std::string_view::npos) return false;
+        lo = at + segments[i].size();
+    }
+    return true;
+}
+
+bool PatternMatcher::matchNfa(std::string_view text) const {
+    // A '%' may match nothing, so reaching it also reaches the element after
+    // it; '%'s are never adjacent, so one step closes the set
+    auto close = [this](uint64_t states) { return states | ((states & anyRunMask) << 1); };
+    uint64_t states = close(1);
+    for (char c : text) {
+        const uint64_t advanced = (states & byteMasks[static_cast<unsigned char>(c)]) << 1;
+        states = close(advanced | (states & anyRunMask));
+        if (states == 0) return false;
+    }
+    return (states >> elementCount) & 1;
+}
+
+bool PatternMatcher::matches(std::string_view text) const {
+    if (text.size() < minLength) {
+        return false;
+    }
+    std::string_view head = segments.empty() ? std::string_view() : std::string_view(segments[0]);
+    switch (strategy) {
+        case Strategy::EXACT:
+            return text.size() == head.size() && equalAt(text, 0, head);
+        case Strategy::PREFIX:
+            return equalAt(text, 0, head);
+        case Strategy::SUFFIX:
+            return equalAt(text, text.size() - head.size(), head);
+        case Strategy::CONTAINS:
+            return find(text, head, 0) != std::string_view::npos;
+        case Strategy::SEGMENTS:
+            return matchSegments(text);
+        case Strategy::NFA:
+            return matchNfa(text);
+    }
+    return false;
+}
+
+bool PatternMatcher::matches(const CompactValue& cell) const {
+    if (!cell.isString() || cell.length() < minLength) {
+        return false;
+    }
+    if (strategy == Strategy::EXACT && cell.length() != segments[0].size()) {
+        return false;
+    }
+    if (anchoredStart && strategy != Strategy::NFA) {
+        // Most mismatches are settled on the inline prefix
+        std::string_view prefix = cell.prefix();
+        std::string_view head = segments[0];
+        if (!equalAt(prefix, 0, head.substr(0, std::min(prefix.size(), head.size())))) {
+            return false;
+        }
+    }
+    return matches(cell.asString());
+}
+
+} // namespace parallaxdb
@@ -2,6 +2,8 @@
 #include "../../include/executor/QueryExecutor.hpp"
 #include <iostream>
 #include <algorithm>
+#include <chrono>
+#include <unistd.h>
 
 namespace parallaxdb {
 
@@ -19,31 +21,95 @@ StatementType SQLProcessor::getStatementType(const std::string& query) {
         return StatementType::SELECT;
     } else if (upperQuery.substr(0, 6) == "INSERT") {
         return StatementType::INSERT;
+    } else if (upperQuery.substr(0, 6) == "UPDATE") {
+        return StatementType::UPDATE;
+    } else if (upperQuery.substr(0, 6) == "DELETE") {
+        return StatementType::DELETE;
     } else if (upperQuery.substr(0, 6) == "CREATE") {
+        size_t next = upperQuery.find_first_not_of(" \t\n\r", 6);
+        if (next != std::string::npos && upperQuery.compare(next, 12, "MATERIALIZED") == 0) {
+            return StatementType::CREATE_VIEW;
+        }
+        if (next != std::string::npos && upperQuery.compare(next, 5, "INDEX") == 0) {
+            return StatementType::CREATE_INDEX;
+        }
         return StatementType::CREATE_TABLE;
     } else if (upperQuery.substr(0, 4) == "DROP") {
         return StatementType::DROP_TABLE;
+    } else if (upperQuery.substr(0, 5) == "ALTER") {
+        return StatementType::ALTER_TABLE;
+    } else if (upperQuery.substr(0, 7) == "ANALYZE") {
+        return StatementType::ANALYZE;
+    } else if (upperQuery.substr(0, 7) == "EXPLAIN") {
+        return StatementType::EXPLAIN;
     }
     
     return StatementType::UNKNOWN;
 }
 
 std::unique_ptr<QueryPlanNode> SQLProcessor::processSelect(const std::string& query, Database& db) {
-    // For now, we'll assume the table exists and use the first table
-    // In a real implementation, you'd parse the table name from the query
-    auto tableNames = db.getTableNames();
-    if (tableNames.empty()) {
-        std::cout << "No tables available for SELECT" << std::endl;
-        return nullptr;
+    return SQLParser::parse(query, db);
+}
+
+namespace {
+
+void collectTables(const QueryPlanNode& node, std::vector<const Table*>& out) {
+    if (const auto* scan = dynamic_cast<const TableScanNode*>(&node)) {
+        if (std::find(out.begin(), out.end(), &scan->getTable()) == out.end()) {
+            out.push_back(&scan->getTable());
+        }
+    }
+    for (const QueryPlanNode* child : node.getChildren()) {
+        collectTables(*child, out);
+    }
+}
+
+} // namespace
+
+size_t SQLProcessor::executeSelect(const std::string& query, Database& db, ResultSink& sink) {
+    QueryFingerprint fingerprint;
+    std::string key;
+    if (cachingEnabled) {
+        fingerprint = fingerprintQuery(query);
+        if (fingerprint.cacheable) key = fingerprint.key();
+    }
+    if (!key.empty()) {
+        if (const ResultCache::Entry* entry = resultCache.lookup(key, db)) {
+            sink.begin(entry->columns);
+            RowBatch batch;
+            for (size_t start = 0; start < entry->rows.size(); start += RowBatch::kDefaultCapacity) {
+                size_t end = std::min(entry->rows.size(), start + RowBatch::kDefaultCapacity);
+                batch.rows.assign(entry->rows.begin() + start, entry->rows.begin() + end);
+                sink.consume(batch);
+            }
+            sink.finish();
+            return entry->rows.size();
+        }
     }
     
-    const Table* table = db.getTable(tableNames[0]);
-    if (!table) {
-        std::cout << "Table not found: " << tableNames[0] << std::endl;
-        return nullptr;
+    auto plan = processSelect(query, db);
+    if (!plan) return 0;
+    if (key.empty()) {
+        return QueryExecutor::execute(*plan, sink);
     }
     
-    return SQLParser::parse(query, *table);
+    ResultCache::Entry entry;
+    std::vector<const Table*> tables;
+    collectTables(*plan, tables);
+    for (const Table* table : tables) {
+        entry.tableVersions.emplace_back(table->getName(), table->getVersion());
+    }
+    RecordingSink recorder(sink, static_cast<size_t>(ResultCache::kMaxEntryShare * resultCache.getCapacity()));
+    auto start = std::chrono::steady_clock::now();
+    size_t rows = QueryExecutor::execute(*plan, recorder);
+    entry.costNanos = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    if (recorder.complete()) {
+        entry.columns = std::move(recorder.getColumns());
+        entry.rows = std::move(recorder.getRows());
+        entry.bytes = recorder.getBytes();
+        resultCache.insert(key, std::move(entry));
+    }
+    return rows;
 }
 
 void SQLProcessor::processInsert(const std::string& query, Database& db) {
@@ -61,14 +127,26 @@ void SQLProcessor::processInsert(const std::string& query, Database& db) {
             return;
         }
         
-        // Insert each row
-        for (const auto& values : insertStmt->values) {
-            try {
-                db.insertInto(insertStmt->tableName, values);
+        // The rows are validated as one batch and inserted together
+        std::vector<Row> rows;
+        rows.reserve(insertStmt->values.size());
+        for (auto& values : insertStmt->values) {
+            rows.push_back(Row{std::move(values)});
+        }
+        try {
+            db.insertRowsInto(insertStmt->tableName, rows);
+            if (rows.size() == 1) {
                 std::cout << "Inserted row into " << insertStmt->tableName << std::endl;
-            } catch (const std::exception& e) {
-                std::cout << "Error inserting row: " << e.what() << std::endl;
+            } else {
+                std::cout << "Inserted " << rows.size() << " rows into " << insertStmt->tableName << std::endl;
+            }
+        } catch (const ValidationError& e) {
+            for (const auto& failure : e.getFailures()) {
+                std::cout << "Error inserting row: " << failure.toString(table->getSchema()) << std::endl;
             }
+            std::cout << "No rows inserted" << std::endl;
+        } catch (const std::exception& e) {
+            std::cout << "Error inserting row: " << e.what() << std::endl;
         }
         
     } catch (const std::exception& e) {
@@ -76,6 +154,71 @@ void SQLProcessor::processInsert(const std::string& query, Database& db) {
     }
 }
 
+namespace {
+
+// Binds a DML WHERE clause to the table's columns and wraps it as a row
+// predicate over stored cells
+std::function<bool(const CompactValue*)> rowPredicate(Expression* where, const Table& table) {
+    if (!where) {
+        return [](const CompactValue*) { return true; };
+    }
+    std::vector<std::string> columns;
+    for (const auto& column : table.getColumns()) {
+        columns.push_back(table.getName() + "." + column.name);
+    }
+    where->bind(columns);
+    return [where](const CompactValue* cells) { return where->evaluate(cells); };
+}
+
+} // namespace
+
+void SQLProcessor::processUpdate(const std::string& query, Database& db) {
+    try {
+        auto updateStmt = DMLParser::parseUpdate(query);
+        
+        const Table* table = db.getTable(updateStmt->tableName);
+        if (!table) {
+            std::cout << "Table '" << updateStmt->tableName << "' does not exist" << std::endl;
+            return;
+        }
+        
+        std::vector<std::pair<size_t, Value>> assignments;
+        for (const auto& assignment : updateStmt->assignments) {
+            int index = table->getColumnIndex(assignment.first);
+            if (index < 0) {
+                std::cout << "Unknown column '" << assignment.first << "' in table " << table->getName() << std::endl;
+                return;
+            }
+            assignments.emplace_back(static_cast<size_t>(index), assignment.second);
+        }
+        
+        size_t updated = db.updateTable(updateStmt->tableName, rowPredicate(updateStmt->where.get(), *table),
+                                        assignments);
+        std::cout << "Updated " << updated << " rows in " << updateStmt->tableName << std::endl;
+        
+    } catch (const std::exception& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+    }
+}
+
+void SQLProcessor::processDelete(const std::string& query, Database& db) {
+    try {
+        auto deleteStmt = DMLParser::parseDelete(query);
+        
+        const Table* table = db.getTable(deleteStmt->tableName);
+        if (!table) {
+            std::cout << "Table '" << deleteStmt->tableName << "' does not exist" << std::endl;
+            return;
+        }
+        
+        size_t deleted = db.deleteFrom(deleteStmt->tableName, rowPredicate(deleteStmt->where.get(), *table));
+        std::cout << "Deleted " << deleted << " rows from " << deleteStmt->tableName << std::endl;
+        
+    } catch (const std::exception& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+    }
+}
+
 void SQLProcessor::processCreateTable(const std::string& query, Database& db) {
     try {
         auto createStmt = DDLParser::parseCreateTable(query);
@@ -94,6 +237,40 @@ void SQLProcessor::processCreateTable(const std::string& query, Database& db) {
     }
 }
 
+void SQLProcessor::processCreateView(const std::string& query, Database& db) {
+    std::unique_ptr<CreateViewStatement> viewStmt;
+    try {
+        viewStmt = DDLParser::parseCreateMaterializedView(query);
+    } catch (const std::exception& e) {
+        std::cout << "Parse error: " << e.what() << std::endl;
+        return;
+    }
+    try {
+        db.createMaterializedView(viewStmt->viewName, std::move(viewStmt->definition));
+        std::cout << "Created materialized view '" << viewStmt->viewName << "' with "
+                  << db.getTable(viewStmt->viewName)->getRowCount() << " rows" << std::endl;
+    } catch (const std::exception& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+    }
+}
+
+void SQLProcessor::processCreateIndex(const std::string& query, Database& db) {
+    std::unique_ptr<CreateIndexStatement> indexStmt;
+    try {
+        indexStmt = DDLParser::parseCreateIndex(query);
+    } catch (const std::exception& e) {
+        std::cout << "Parse error: " << e.what() << std::endl;
+        return;
+    }
+    try {
+        db.createIndex(indexStmt->tableName, indexStmt->indexName, indexStmt->column);
+        std::cout << "Created trigram index '" << indexStmt->indexName << "' on " << indexStmt->tableName
+                  << " (" << indexStmt->column << ")" << std::endl;
+    } catch (const std::exception& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+    }
+}
+
 void SQLProcessor::processDropTable(const std::string& query, Database& db) {
     try {
         auto dropStmt = DDLParser::parseDropTable(query);
@@ -111,26 +288,141 @@ void SQLProcessor::processDropTable(const std::string& query, Database& db) {
     }
 }
 
+void SQLProcessor::processAlterTable(const std::string& query, Database& db) {
+    std::unique_ptr<AlterTableStatement> alterStmt;
+    try {
+        alterStmt = DDLParser::parseAlterTable(query);
+    } catch (const std::exception& e) {
+        std::cout << "Parse error: " << e.what() << std::endl;
+        return;
+    }
+    try {
+        size_t removed = db.dropPartition(alterStmt->tableName, alterStmt->partition);
+        std::cout << "Dropped partition " << alterStmt->partition << " of '" << alterStmt->tableName
+                  << "' (" << removed << " rows)" << std::endl;
+    } catch (const std::exception& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+    }
+}
+
+void SQLProcessor::processAnalyze(const std::string& query, Database& db) {
+    try {
+        auto analyzeStmt = DDLParser::parseAnalyze(query);
+        
+        std::vector<std::string> tableNames;
+        if (analyzeStmt->tableName.empty()) {
+            tableNames = db.getTableNames();
+        } else if (db.tableExists(analyzeStmt->tableName)) {
+            tableNames.push_back(analyzeStmt->tableName);
+        } else {
+            std::cout << "Table '" << analyzeStmt->tableName << "' does not exist" << std::endl;
+            return;
+        }
+        
+        for (const auto& tableName : tableNames) {
+            db.analyzeTable(tableName);
+            const Table* table = db.getTable(tableName);
+            const TableStatistics& stats = table->getStatistics();
+            std::cout << "Analyzed table '" << tableName << "' (" << stats.getRowCount() << " rows)" << std::endl;
+            for (size_t i = 0; i < stats.getColumnCount(); ++i) {
+                const ColumnStatistics& col = stats.getColumn(i);
+                std::cout << "  " << table->getColumns()[i].name
+                          << ": distinct~" << static_cast<size_t>(col.distinctCount() + 0.5)
+                          << ", null_frac=" << col.nullFraction()
+                          << ", mcv=" << col.mostCommonValues.size()
+                          << ", buckets=" << (col.histogramBounds.empty() ? 0 : col.histogramBounds.size() - 1)
+                          << std::endl;
+            }
+        }
+        
+    } catch (const std::exception& e) {
+        std::cout << "Parse error: " << e.what() << std::endl;
+    }
+}
+
+void SQLProcessor::processExplain(const std::string& query, Database& db) {
+    Tokenizer tokenizer(query);
+    auto tokens = tokenizer.tokenize();
+    if (tokens.size() < 2 || tokens[0].type != TokenType::EXPLAIN) {
+        std::cout << "Parse error: Expected EXPLAIN" << std::endl;
+        return;
+    }
+    
+    // EXPLAIN ANALYZE [FORMAT JSON|TEXT] <query> runs the query with profiling
+    size_t start = 1;
+    bool analyze = tokens[start].type == TokenType::ANALYZE;
+    ExplainFormat format = ExplainFormat::TEXT;
+    if (analyze) {
+        start++;
+        auto upper = [&tokens](size_t i) {
+            std::string value = i < tokens.size() ? tokens[i].value : "";
+            std::transform(value.begin(), value.end(), value.begin(), ::toupper);
+            return value;
+        };
+        if (upper(start) == "FORMAT") {
+            if (upper(start + 1) == "JSON") {
+                format = ExplainFormat::JSON;
+            } else if (upper(start + 1) != "TEXT") {
+                std::cout << "Parse error: Expected JSON or TEXT after FORMAT" << std::endl;
+                return;
+            }
+            start += 2;
+        }
+        if (start >= tokens.size() || tokens[start].type == TokenType::END_OF_INPUT) {
+            std::cout << "Parse error: Expected query after EXPLAIN ANALYZE" << std::endl;
+            return;
+        }
+    }
+    
+    auto plan = SQLParser::parse(query.substr(tokens[start].position), db);
+    if (plan) {
+        std::cout << (analyze ? QueryExecutor::explainAnalyze(*plan, format) : explainPlan(*plan));
+    }
+}
+
 void SQLProcessor::processStatement(const std::string& query, Database& db) {
     StatementType type = getStatementType(query);
     
     switch (type) {
         case StatementType::SELECT: {
-            auto plan = processSelect(query, db);
-            if (plan) {
-                plan->execute();
-            }
+            // Plan, expressions and operator state live in the per-query arena
+            ArenaScope scope(QueryArena::forThread());
+            auto sink = makeResultSink(outputFormat, STDOUT_FILENO);
+            executeSelect(query, db, *sink);
             break;
         }
         case StatementType::INSERT:
             processInsert(query, db);
             break;
+        case StatementType::UPDATE:
+            processUpdate(query, db);
+            break;
+        case StatementType::DELETE:
+            processDelete(query, db);
+            break;
         case StatementType::CREATE_TABLE:
             processCreateTable(query, db);
             break;
+        case StatementType::CREATE_VIEW:
+            processCreateView(query, db);
+            break;
+        case StatementType::CREATE_INDEX:
+            processCreateIndex(query, db);
+            break;
         case StatementType::DROP_TABLE:
             processDropTable(query, db);
             break;
+        case StatementType::ALTER_TABLE:
+            processAlterTable(query, db);
+            break;
+        case StatementType::ANALYZE:
+            processAnalyze(query, db);
+            break;
+        case StatementType::EXPLAIN: {
+            ArenaScope scope(QueryArena::forThread());
+            processExplain(query, db);
+            break;
+        }
         case StatementType::UNKNOWN:
             std::cout << "Unknown statement type" << std::endl;
             break;
@@ -138,33 +430,12 @@ void SQLProcessor::processStatement(const std::string& query, Database& db) {
 }
 
 void SQLProcessor::printResults(const std::vector<Row>& results, const std::vector<std::string>& columns) {
-    if (results.empty()) {
-        std::cout << "No results" << std::endl;
-        return;
-    }
-    
-    // Print header
-    for (size_t i = 0; i < columns.size(); ++i) {
-        if (i > 0) std::cout << " | ";
-        std::cout << columns[i];
-    }
-    std::cout << std::endl;
-    
-    // Print separator
-    for (size_t i = 0; i < columns.size(); ++i) {
-        if (i > 0) std::cout << " | ";
-        std::cout << std::string(columns[i].length(), '-');
-    }
-    std::cout << std::endl;
-    
-    // Print rows
-    for (const auto& row : results) {
-        for (size_t i = 0; i < row.values.size(); ++i) {
-            if (i > 0) std::cout << " | ";
-            std::visit([](const auto& v) { std::cout << v; }, row.values[i]);
-        }
-        std::cout << std::endl;
-    }
+    TextTableSink sink(STDOUT_FILENO);
+    sink.begin(columns);
+    RowBatch batch;
+    batch.rows = results;
+    sink.consume(batch);
+    sink.finish();
 }
 
 } // namespace parallaxdb 
\ No newline at end of file
@@ -0,0 +1,144 @@
+#include "../../include/planner/Aggregate.hpp"
+#include "../../include/parser/ExpressionEvaluator.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace parallaxdb {
+
+namespace {
+
+const std::pair<const char*, AggregateFunction> kFunctions[] = {
+    {"COUNT", AggregateFunction::COUNT},
+    {"SUM", AggregateFunction::SUM},
+    {"MIN", AggregateFunction::MIN},
+    {"MAX", AggregateFunction::MAX},
+    {"AVG", AggregateFunction::AVG},
+    {"APPROX_COUNT_DISTINCT", AggregateFunction::APPROX_COUNT_DISTINCT},
+    {"APPROX_QUANTILE", AggregateFunction::APPROX_QUANTILE},
+};
+
+} // namespace
+
+const char* aggregateName(AggregateFunction function) {
+    for (const auto& [name, candidate] : kFunctions) {
+        if (candidate == function) return name;
+    }
+    return "";
+}
+
+AggregateFunction parseAggregateFunction(const std::string& name) {
+    std::string upper = name;
+    std::transform(upper.begin(), upper.end(), upper.begin(), ::toupper);
+    for (const auto& [candidate, function] : kFunctions) {
+        if (upper == candidate) return function;
+    }
+    return AggregateFunction::NONE;
+}
+
+DataType aggregateType(const AggregateColumn& column, DataType source) {
+    switch (column.function) {
+        case AggregateFunction::NONE:
+        case AggregateFunction::MIN:
+        case AggregateFunction::MAX:
+            return source;
+        case AggregateFunction::COUNT:
+        case AggregateFunction::APPROX_COUNT_DISTINCT:
+            return DataType::INT;
+        case AggregateFunction::SUM:
+        case AggregateFunction::AVG:
+        case AggregateFunction::APPROX_QUANTILE:
+            if (source == DataType::STRING) {
+                throw std::runtime_error(std::string(aggregateName(column.function)) +
+                                         " needs a numeric column, '" + column.source + "' is STRING");
+            }
+            return DataType::DOUBLE;
+    }
+    return source;
+}
+
+void appendGroupKey(std::string& key, const CompactValue& cell) {
+    key.push_back(static_cast<char>(cell.isNumeric() ? CompactValue::Kind::DOUBLE : cell.kind()));
+    if (cell.isNumeric()) {
+        double number = cell.asNumber();
+        key.append(reinterpret_cast<const char*>(&number), sizeof(number));
+    } else if (cell.isString()) {
+        std::string_view text = cell.asString();
+        uint32_t length = static_cast<uint32_t>(text.size());
+        key.append(reinterpret_cast<const char*>(&length), sizeof(length));
+        key.append(text.data(), text.size());
+    }
+}
+
+void AggregateState::add(const CompactValue& value) {
+    if (value.isNull()) return;
+    count++;
+    switch (function) {
+        case AggregateFunction::SUM:
+        case AggregateFunction::AVG:
+            sum += value.asNumber();
+            break;
+        case AggregateFunction::MIN:
+        case AggregateFunction::MAX: {
+            CompactValue current = CompactValue::borrow(extreme);
+            CompareOp better = function == AggregateFunction::MIN ? CompareOp::LT : CompareOp::GT;
+            if (current.isNull() || applyComparison(value, better, current)) {
+                extreme = value.toValue();
+            }
+            break;
+        }
+        case AggregateFunction::APPROX_COUNT_DISTINCT:
+            if (!distinct) distinct = std::make_unique<HyperLogLog>();
+            distinct->add(hashValue(value));
+            break;
+        case AggregateFunction::APPROX_QUANTILE:
+            if (!quantiles) quantiles = std::make_unique<QuantileSketch>();
+            quantiles->add(value.asNumber());
+            break;
+        case AggregateFunction::NONE:
+        case AggregateFunction::COUNT:
+            break;
+    }
+}
+
+void AggregateState::merge(const AggregateState& other) {
+    count += other.count;
+    sum += other.sum;
+    if (!std::holds_alternative<std::nullptr_t>(other.extreme)) {
+        add(CompactValue::borrow(other.extreme));
+        count--;  // add() counted the extreme as an input
+    }
+    if (other.distinct) {
+        if (!distinct) distinct = std::make_unique<HyperLogLog>(other.distinct->getPrecision());
+        distinct->merge(*other.distinct);
+    }
+    if (other.quantiles) {
+        if (!quantiles) quantiles = std::make_unique<QuantileSketch>();
+        quantiles->merge(*other.quantiles);
+    }
+}
+
+Value AggregateState::result() const {
+    switch (function) {
+        case AggregateFunction::COUNT:
+            return static_cast<int>(count);
+        case AggregateFunction::SUM:
+            return count > 0 ? Value(sum) : Value(nullptr);
+        case AggregateFunction::AVG:
+            return count > 0 ? Value(sum / count) : Value(nullptr);
+        case AggregateFunction::MIN:
+        case AggregateFunction::MAX:
+            return extreme;
+        case AggregateFunction::APPROX_COUNT_DISTINCT:
+            if (!distinct) return 0;
+            // Never report more distinct values than inputs
+            return static_cast<int>(std::min<double>(std::llround(distinct->estimate()), count));
+        case AggregateFunction::APPROX_QUANTILE:
+            return quantiles ? Value(quantiles->quantile(parameter)) : Value(nullptr);
+        case AggregateFunction::NONE:
+            break;
+    }
+    return nullptr;
+}
+
+} // namespace parallaxdb
@@ -0,0 +1,133 @@
+#include "../../include/planner/AggregateNode.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace parallaxdb {
+
+AggregateNode::AggregateNode(std::unique_ptr<QueryPlanNode> child, const std::vector<std::string>& groupBy,
+                             const std::vector<AggregateColumn>& items, const std::vector<std::string>& outputColumns)
+    : child(std::move(child)), groupBy(groupBy), items(items), outputColumns(outputColumns) {
+    const auto& childColumns = this->child->getOutputColumns();
+    for (const auto& name : groupBy) {
+        int idx = findColumn(childColumns, name);
+        if (idx < 0) {
+            throw std::runtime_error("Unknown GROUP BY column: " + name);
+        }
+        groupIndices.push_back(idx);
+    }
+    for (const auto& item : items) {
+        int idx = -1;
+        if (!item.source.empty()) {
+            idx = findColumn(childColumns, item.source);
+            if (idx < 0) {
+                throw std::runtime_error("Unknown column: " + item.source);
+            }
+        }
+        sources.push_back(idx);
+        int slot = -1;
+        if (item.function == AggregateFunction::NONE) {
+            for (size_t g = 0; g < groupIndices.size(); ++g) {
+                if (groupIndices[g] == idx) slot = static_cast<int>(g);
+            }
+            if (slot < 0) {
+                throw std::runtime_error("Column '" + item.source + "' must appear in GROUP BY or be aggregated");
+            }
+        }
+        keySlots.push_back(slot);
+    }
+}
+
+AggregateNode::Group AggregateNode::newGroup(const Row& row) const {
+    Group group;
+    for (int idx : groupIndices) {
+        group.key.push_back(row.values[idx]);
+    }
+    group.states.reserve(items.size());
+    for (const auto& item : items) {
+        group.states.emplace_back(item.function, item.parameter);
+    }
+    return group;
+}
+
+void AggregateNode::doOpen() {
+    groups.clear();
+    groupIndex = GroupIndex(&indexMemory);   // Gives up its memory before the arena does
+    indexMemory.release();
+    emitted = 0;
+    if (groupIndices.empty()) {
+        groups.push_back(newGroup(Row{}));
+        groupIndex.emplace("", 0);
+    }
+
+    child->open();
+    while (child->next(input)) {
+        for (const auto& row : input.rows) {
+            keyScratch.clear();
+            for (int idx : groupIndices) {
+                appendGroupKey(keyScratch, CompactValue::borrow(row.values[idx]));
+            }
+            auto [it, inserted] = groupIndex.try_emplace(keyScratch, groups.size());
+            if (inserted) groups.push_back(newGroup(row));
+            Group& group = groups[it->second];
+            for (size_t i = 0; i < items.size(); ++i) {
+                if (items[i].function == AggregateFunction::NONE) continue;
+                if (sources[i] < 0) {
+                    group.states[i].addRow();
+                } else {
+                    group.states[i].add(CompactValue::borrow(row.values[sources[i]]));
+                }
+            }
+        }
+    }
+    input.clear();
+}
+
+bool AggregateNode::doNext(RowBatch& batch) {
+    batch.clear();
+    if (emitted >= groups.size()) {
+        return false;
+    }
+    size_t end = std::min(groups.size(), emitted + RowBatch::kDefaultCapacity);
+    batch.rows.reserve(end - emitted);
+    for (; emitted < end; ++emitted) {
+        const Group& group = groups[emitted];
+        std::vector<Value>& out = batch.appendRow().values;
+        out.reserve(items.size());
+        for (size_t i = 0; i < items.size(); ++i) {
+            out.push_back(keySlots[i] >= 0 ? group.key[keySlots[i]] : group.states[i].result());
+        }
+    }
+    return true;
+}
+
+std::string AggregateNode::getDetails() const {
+    std::string details = "[";
+    for (size_t i = 0; i < items.size(); ++i) {
+        if (i > 0) details += ", ";
+        const AggregateColumn& item = items[i];
+        if (item.function == AggregateFunction::NONE) {
+            details += item.source;
+            continue;
+        }
+        details += std::string(aggregateName(item.function)) + "(" + (item.source.empty() ? "*" : item.source);
+        if (item.function == AggregateFunction::APPROX_QUANTILE) {
+            std::string quantile = std::to_string(item.parameter);
+            quantile.erase(quantile.find_last_not_of('0') + 1);
+            if (quantile.back() == '.') quantile.pop_back();
+            details += ", " + quantile;
+        }
+        details += ")";
+    }
+    details += "]";
+    if (!groupBy.empty()) {
+        details += " GROUP BY [";
+        for (size_t i = 0; i < groupBy.size(); ++i) {
+            if (i > 0) details += ", ";
+            details += groupBy[i];
+        }
+        details += "]";
+    }
+    return details;
+}
+
+} // namespace parallaxdb
@@ -0,0 +1,151 @@
+#include "../../include/planner/DistinctNode.hpp"
+#include "../../include/planner/Aggregate.hpp"
+#include <algorithm>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+namespace parallaxdb {
+
+namespace {
+
+// Runs work(t) for t in [0, threads) on worker threads, rethrowing the first error
+template <typename Work>
+void runWorkers(size_t threads, Work work) {
+    std::exception_ptr error;
+    std::mutex errorMutex;
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            try {
+                work(t);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error) error = std::current_exception();
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    if (error) std::rethrow_exception(error);
+}
+
+} // namespace
+
+DistinctNode::DistinctNode(std::unique_ptr<QueryPlanNode> child) : child(std::move(child)) {}
+
+size_t DistinctNode::getDistinctCount() const {
+    size_t count = 0;
+    for (const auto& partition : seen) {
+        count += partition.size();
+    }
+    return count;
+}
+
+void DistinctNode::appendKey(std::string& key, const Row& row) const {
+    for (const auto& value : row.values) {
+        appendGroupKey(key, CompactValue::borrow(value));
+    }
+}
+
+void DistinctNode::doOpen() {
+    seen.assign(kPartitions, {});
+    chunk.clear();
+    keep.clear();
+    emitted = 0;
+    exhausted = false;
+    ranParallel = false;
+    threads = parallelism > 0 ? parallelism : std::max(1u, std::thread::hardware_concurrency());
+    child->open();
+}
+
+// Gathers the next chunk and marks its new rows; false once the input is done
+bool DistinctNode::nextChunk() {
+    chunk.clear();
+    while (!exhausted && chunk.size() < kParallelChunkRows) {
+        if (!child->next(input)) {
+            exhausted = true;
+            break;
+        }
+        for (auto& row : input.rows) {
+            chunk.push_back(std::move(row));
+        }
+    }
+    if (chunk.empty()) {
+        return false;
+    }
+    keep.assign(chunk.size(), 0);
+    emitted = 0;
+
+    std::vector<std::string> keys(chunk.size());
+    std::vector<uint8_t> partitions(chunk.size());
+    auto hashRows = [&](size_t begin, size_t end) {
+        for (size_t r = begin; r < end; ++r) {
+            appendKey(keys[r], chunk[r]);
+            partitions[r] = static_cast<uint8_t>(partitionOf(keys[r]));
+        }
+    };
+    // Rows are probed in input order within each partition, so the first
+    // occurrence of a key is the one kept
+    auto probe = [&](size_t t, size_t stride) {
+        for (size_t r = 0; r < chunk.size(); ++r) {
+            if (partitions[r] % stride != t) continue;
+            keep[r] = seen[partitions[r]].insert(std::move(keys[r])).second;
+        }
+    };
+
+    if (chunk.size() < kParallelChunkRows || threads < 2) {
+        hashRows(0, chunk.size());
+        probe(0, 1);
+        return true;
+    }
+    ranParallel = true;
+    const size_t workers = std::min(threads, kPartitions);
+    const size_t span = (chunk.size() + workers - 1) / workers;
+    runWorkers(workers, [&](size_t t) {
+        hashRows(std::min(chunk.size(), t * span), std::min(chunk.size(), (t + 1) * span));
+    });
+    runWorkers(workers, [&](size_t t) { probe(t, workers); });
+    return true;
+}
+
+bool DistinctNode::doNext(RowBatch& batch) {
+    batch.clear();
+    if (threads < 2) {
+        if (!child->next(input)) {
+            return false;
+        }
+        for (auto& row : input.rows) {
+            keyScratch.clear();
+            appendKey(keyScratch, row);
+            if (seen[partitionOf(keyScratch)].insert(keyScratch).second) {
+                batch.appendRow().values = std::move(row.values);
+            }
+        }
+        return true;
+    }
+
+    if (emitted >= chunk.size() && !nextChunk()) {
+        return false;
+    }
+    while (emitted < chunk.size() && batch.size() < RowBatch::kDefaultCapacity) {
+        if (keep[emitted]) {
+            batch.appendRow().values = std::move(chunk[emitted].values);
+        }
+        emitted++;
+    }
+    return true;
+}
+
+std::string DistinctNode::getDetails() const {
+    std::string details = "[";
+    const auto& columns = getOutputColumns();
+    for (size_t i = 0; i < columns.size(); ++i) {
+        if (i > 0) details += ", ";
+        details += columns[i];
+    }
+    return details + "]";
+}
+
+} // namespace parallaxdb
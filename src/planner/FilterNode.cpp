@@ -1,27 +1,68 @@
 #include "../../include/planner/FilterNode.hpp"
 #include "../../include/planner/QueryPlan.hpp"
+#include "../../include/storage/Statistics.hpp"
 #include "../../include/types/Common.hpp"
 #include <iostream>
 
 namespace parallaxdb {
 
-FilterNode::FilterNode(std::unique_ptr<QueryPlanNode> child, std::unique_ptr<Expression> expr, const Table& table)
-    : child(std::move(child)), expr(std::move(expr)), table(table) {}
+FilterNode::FilterNode(std::unique_ptr<QueryPlanNode> child, std::unique_ptr<Expression> expr)
+    : child(std::move(child)), filter(std::move(expr), this->child->getOutputColumns()) {}
 
-void FilterNode::execute() {
-    TableScanNode* scan = dynamic_cast<TableScanNode*>(child.get());
-    if (scan == nullptr) {
-        std::cerr << "FilterNode currently supports only TableScanNode child" << std::endl;
-        return;
+void FilterNode::doOpen() {
+    filter.reset();
+    child->open();
+}
+
+bool FilterNode::doNext(RowBatch& batch) {
+    batch.clear();
+    if (!child->next(input)) {
+        return false;
+    }
+    
+    selection.resize(input.size());
+    for (size_t i = 0; i < input.size(); ++i) {
+        selection[i] = static_cast<uint32_t>(i);
     }
-    for (const auto& row : table.getRows()) {
-        if (expr->evaluate(row, table)) {
-            for (const auto& val : row.values) {
-                std::cout << val << " ";
+    filter.apply([this](uint32_t i) -> const Row& { return input.rows[i]; }, selection);
+    for (auto& pushed : runtimeFilters) {
+        const std::vector<int>& keys = pushed.keyIndices;
+        pushed.filter->apply(selection, [this, &keys](uint32_t i, bool& hasNull) {
+            const Row& row = input.rows[i];
+            uint64_t h = kKeyHashSeed;
+            for (int idx : keys) {
+                hasNull |= std::holds_alternative<std::nullptr_t>(row.values[idx]);
+                h = combineKeyHash(h, hashValue(row.values[idx]));
             }
-            std::cout << std::endl;
-        }
+            return h;
+        });
+    }
+    
+    batch.rows.reserve(selection.size());
+    for (uint32_t rowIdx : selection) {
+        // Swap so the input batch gets a recycled buffer back
+        std::swap(batch.appendRow(), input.rows[rowIdx]);
+    }
+    return true;
+}
+
+std::string FilterNode::getDetails() const {
+    std::string details = "[" + filter.toString() + "]";
+    for (const auto& pushed : runtimeFilters) {
+        details += " BLOOM [" + pushed.filter->toString() + "]";
+    }
+    return details;
+}
+
+bool FilterNode::addRuntimeFilter(std::shared_ptr<RuntimeFilter> runtimeFilter) {
+    PushedRuntimeFilter pushed{runtimeFilter, {}};
+    for (const auto& column : runtimeFilter->columns) {
+        int idx = findColumn(getOutputColumns(), column);
+        if (idx < 0) return false;
+        pushed.keyIndices.push_back(idx);
     }
+    runtimeFilters.push_back(std::move(pushed));
+    return true;
 }
 
-} // namespace parallaxdb 
\ No newline at end of file
+} // namespace parallaxdb
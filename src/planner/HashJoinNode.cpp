@@ -0,0 +1,150 @@
+#include "../../include/planner/HashJoinNode.hpp"
+#include "../../include/storage/Statistics.hpp"
+#include <stdexcept>
+
+namespace parallaxdb {
+
+HashJoinNode::HashJoinNode(std::unique_ptr<QueryPlanNode> probe,
+                           std::unique_ptr<QueryPlanNode> build,
+                           const std::vector<JoinKey>& keys,
+                           JoinType type)
+    : probe(std::move(probe)), build(std::move(build)), keys(keys), type(type) {
+    const auto& probeColumns = this->probe->getOutputColumns();
+    const auto& buildColumns = this->build->getOutputColumns();
+    for (const auto& key : keys) {
+        int p = findColumn(probeColumns, key.probeColumn);
+        int b = findColumn(buildColumns, key.buildColumn);
+        if (p < 0 || b < 0) {
+            throw std::runtime_error("Unknown join column: " + (p < 0 ? key.probeColumn : key.buildColumn));
+        }
+        probeKeyIndices.push_back(p);
+        buildKeyIndices.push_back(b);
+    }
+    outputColumns = probeColumns;
+    if (type == JoinType::INNER) {
+        outputColumns.insert(outputColumns.end(), buildColumns.begin(), buildColumns.end());
+    }
+
+    if (!keys.empty()) {
+        auto filter = std::make_shared<RuntimeFilter>();
+        for (int idx : probeKeyIndices) {
+            filter->columns.push_back(probeColumns[idx]);
+        }
+        if (pushRuntimeFilter(*this->probe, filter)) {
+            runtimeFilter = filter;
+        }
+    }
+}
+
+bool HashJoinNode::pushRuntimeFilter(QueryPlanNode& node, const std::shared_ptr<RuntimeFilter>& filter) {
+    // Go as deep as possible: the lowest operator producing every key column
+    auto producesKeys = [&filter](const QueryPlanNode& candidate) {
+        for (const auto& column : filter->columns) {
+            if (findColumn(candidate.getOutputColumns(), column) < 0) return false;
+        }
+        return true;
+    };
+    for (const QueryPlanNode* child : node.getChildren()) {
+        if (producesKeys(*child) && pushRuntimeFilter(const_cast<QueryPlanNode&>(*child), filter)) {
+            return true;
+        }
+    }
+    return node.addRuntimeFilter(filter);
+}
+
+uint64_t HashJoinNode::hashKey(const Row& row, const std::vector<int>& indices, bool& hasNull) const {
+    uint64_t h = kKeyHashSeed;
+    hasNull = false;
+    for (int idx : indices) {
+        const Value& v = row.values[idx];
+        if (std::holds_alternative<std::nullptr_t>(v)) hasNull = true;
+        h = combineKeyHash(h, hashValue(v));
+    }
+    return h;
+}
+
+// `row` is compared through `rowKeyIndices`: a probe row, or another build row
+bool HashJoinNode::keysEqual(const Row& row, const Row& buildRow, const std::vector<int>& rowKeyIndices) const {
+    for (size_t k = 0; k < rowKeyIndices.size(); ++k) {
+        if (compareValues(row.values[rowKeyIndices[k]], buildRow.values[buildKeyIndices[k]]) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void HashJoinNode::doOpen() {
+    buildRows.clear();
+    hashTable = HashTable(&hashMemory);   // Gives up its memory before the arena does
+    hashMemory.release();
+    build->open();
+    RowBatch batch;
+    while (build->next(batch)) {
+        for (auto& row : batch.rows) {
+            bool hasNull;
+            uint64_t h = hashKey(row, buildKeyIndices, hasNull);
+            if (hasNull) continue; // NULL keys never match
+            std::pmr::vector<size_t>& bucket = hashTable[h];
+            if (type == JoinType::SEMI) {
+                // One row per key answers every probe
+                bool duplicate = false;
+                for (size_t idx : bucket) {
+                    duplicate = duplicate || keysEqual(row, buildRows[idx], buildKeyIndices);
+                }
+                if (duplicate) continue;
+            }
+            bucket.push_back(buildRows.size());
+            buildRows.push_back(std::move(row));
+        }
+    }
+    if (runtimeFilter) {
+        runtimeFilter->bloom.reset(hashTable.size());
+        for (const auto& entry : hashTable) {
+            runtimeFilter->bloom.insert(entry.first);
+        }
+        runtimeFilter->resetStats();
+        runtimeFilter->ready = true;
+    }
+    probe->open();
+}
+
+bool HashJoinNode::doNext(RowBatch& batch) {
+    batch.clear();
+    if (!probe->next(input)) {
+        return false;
+    }
+    for (const auto& probeRow : input.rows) {
+        bool hasNull;
+        uint64_t h = hashKey(probeRow, probeKeyIndices, hasNull);
+        if (hasNull) continue;
+        auto it = hashTable.find(h);
+        if (it == hashTable.end()) continue;
+        for (size_t buildIdx : it->second) {
+            const Row& buildRow = buildRows[buildIdx];
+            if (!keysEqual(probeRow, buildRow, probeKeyIndices)) continue;
+            if (type == JoinType::SEMI) {
+                batch.appendRow().values = probeRow.values;
+                break;
+            }
+            std::vector<Value>& out = batch.appendRow().values;
+            out.reserve(probeRow.values.size() + buildRow.values.size());
+            out.insert(out.end(), probeRow.values.begin(), probeRow.values.end());
+            out.insert(out.end(), buildRow.values.begin(), buildRow.values.end());
+        }
+    }
+    return true;
+}
+
+std::string HashJoinNode::getDetails() const {
+    if (keys.empty()) {
+        return "[cross product]";
+    }
+    std::string details = "[";
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (i > 0) details += " AND ";
+        details += keys[i].probeColumn + " = " + keys[i].buildColumn;
+    }
+    return details + "]";
+}
+
+} // namespace parallaxdb
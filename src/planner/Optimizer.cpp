@@ -0,0 +1,757 @@
+#include "../../include/planner/Optimizer.hpp"
+#include "../../include/planner/AggregateNode.hpp"
+#include "../../include/planner/DistinctNode.hpp"
+#include "../../include/planner/FilterNode.hpp"
+#include "../../include/planner/HashJoinNode.hpp"
+#include "../../include/planner/ProjectNode.hpp"
+#include "../../include/planner/SelectivityEstimator.hpp"
+#include "../../include/planner/WindowNode.hpp"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace parallaxdb {
+
+namespace {
+
+bool resolvesIn(const std::vector<std::string>& columns, const std::string& name) {
+    try {
+        return findColumn(columns, name) >= 0;
+    } catch (const std::runtime_error&) {
+        return false;
+    }
+}
+
+std::vector<std::string> expressionColumns(const Expression& expr) {
+    std::vector<std::string> columns;
+    expr.collectColumns(columns);
+    return columns;
+}
+
+bool resolvesAll(const std::vector<std::string>& columns, const Expression& expr) {
+    for (const auto& name : expressionColumns(expr)) {
+        if (!resolvesIn(columns, name)) return false;
+    }
+    return true;
+}
+
+// Finds the scan under `node` that produces `column`
+const LogicalNode* findScanFor(const LogicalNode& node, const std::string& column) {
+    if (node.type == LogicalNodeType::SCAN) {
+        return resolvesIn(node.getOutputColumns(), column) ? &node : nullptr;
+    }
+    for (const auto& child : node.children) {
+        if (const LogicalNode* scan = findScanFor(*child, column)) return scan;
+    }
+    return nullptr;
+}
+
+double columnDistinct(const LogicalNode& node, const std::string& column) {
+    const LogicalNode* scan = findScanFor(node, column);
+    if (!scan) return -1.0;
+    std::string name = column.substr(column.rfind('.') == std::string::npos ? 0 : column.rfind('.') + 1);
+    int index = scan->table->getColumnIndex(name);
+    const TableStatistics& stats = scan->table->getStatistics();
+    if (index < 0 || static_cast<size_t>(index) >= stats.getColumnCount()) return -1.0;
+    return stats.getColumn(index).distinctCount();
+}
+
+double joinSelectivity(const LogicalNode& left, const LogicalNode& right, const JoinCondition& cond) {
+    double ndv = std::max(columnDistinct(left, cond.leftColumn), columnDistinct(right, cond.rightColumn));
+    if (ndv <= 0.0) {
+        return SelectivityEstimator::kDefaultSelectivity;
+    }
+    return 1.0 / std::max(1.0, ndv);
+}
+
+double predicateSelectivity(const LogicalNode& input, const Expression& pred) {
+    auto columns = expressionColumns(pred);
+    if (!columns.empty()) {
+        const LogicalNode* scan = findScanFor(input, columns[0]);
+        if (scan && resolvesAll(scan->getOutputColumns(), pred)) {
+            return SelectivityEstimator::estimate(pred, *scan->table);
+        }
+    }
+    return SelectivityEstimator::kDefaultSelectivity;
+}
+
+double hashJoinCost(double leftRows, double rightRows, double outputRows) {
+    return CostModel::kHashBuildRow * std::min(leftRows, rightRows) +
+           CostModel::kHashProbeRow * std::max(leftRows, rightRows) +
+           CostModel::kOutputRow * outputRows;
+}
+
+void collectJoinRegion(std::unique_ptr<LogicalNode> node,
+                       std::vector<std::unique_ptr<LogicalNode>>& relations,
+                       std::vector<JoinCondition>& conditions,
+                       std::vector<std::unique_ptr<Expression>>& residuals) {
+    if (node->type == LogicalNodeType::JOIN) {
+        conditions.insert(conditions.end(), node->joinConditions.begin(), node->joinConditions.end());
+        for (auto& child : node->children) {
+            collectJoinRegion(std::move(child), relations, conditions, residuals);
+        }
+    } else if (node->type == LogicalNodeType::FILTER) {
+        for (auto& pred : node->predicates) {
+            residuals.push_back(std::move(pred));
+        }
+        collectJoinRegion(std::move(node->children[0]), relations, conditions, residuals);
+    } else {
+        relations.push_back(std::move(node));
+    }
+}
+
+} // namespace
+
+std::unique_ptr<LogicalNode> Optimizer::optimize(std::unique_ptr<LogicalNode> plan) {
+    plan = pushDownPredicates(std::move(plan));
+    plan = reorderJoins(std::move(plan));
+    pushDownProjections(*plan, plan->getOutputColumns());
+    chooseAccessPaths(*plan);
+    estimateCosts(*plan);
+    return plan;
+}
+
+// Predicate pushdown: every conjunct of a FILTER moves to the lowest node whose
+// output contains all the columns it references.
+
+std::unique_ptr<LogicalNode> Optimizer::pushDownPredicates(std::unique_ptr<LogicalNode> node) {
+    if (node->type == LogicalNodeType::FILTER) {
+        auto child = pushDownPredicates(std::move(node->children[0]));
+        return pushInto(std::move(child), std::move(node->predicates));
+    }
+    for (auto& child : node->children) {
+        child = pushDownPredicates(std::move(child));
+    }
+    return node;
+}
+
+std::unique_ptr<LogicalNode> Optimizer::pushInto(std::unique_ptr<LogicalNode> node,
+                                                 std::vector<std::unique_ptr<Expression>> predicates) {
+    if (predicates.empty()) {
+        return node;
+    }
+    switch (node->type) {
+        case LogicalNodeType::SCAN:
+            for (auto& pred : predicates) {
+                node->predicates.push_back(std::move(pred));
+            }
+            return node;
+        case LogicalNodeType::FILTER: {
+            for (auto& pred : node->predicates) {
+                predicates.push_back(std::move(pred));
+            }
+            return pushInto(std::move(node->children[0]), std::move(predicates));
+        }
+        case LogicalNodeType::JOIN: {
+            auto leftColumns = node->children[0]->getOutputColumns();
+            auto rightColumns = node->children[1]->getOutputColumns();
+            std::vector<std::unique_ptr<Expression>> leftPreds, rightPreds, remaining;
+            for (auto& pred : predicates) {
+                if (resolvesAll(leftColumns, *pred)) {
+                    leftPreds.push_back(std::move(pred));
+                } else if (resolvesAll(rightColumns, *pred)) {
+                    rightPreds.push_back(std::move(pred));
+                } else {
+                    remaining.push_back(std::move(pred));
+                }
+            }
+            node->children[0] = pushInto(std::move(node->children[0]), std::move(leftPreds));
+            node->children[1] = pushInto(std::move(node->children[1]), std::move(rightPreds));
+            if (remaining.empty()) {
+                return node;
+            }
+            return LogicalNode::makeFilter(std::move(node), std::move(remaining));
+        }
+        case LogicalNodeType::SEMI_JOIN: {
+            // Only the left input's columns are visible above a semi-join
+            auto leftColumns = node->children[0]->getOutputColumns();
+            std::vector<std::unique_ptr<Expression>> leftPreds, remaining;
+            for (auto& pred : predicates) {
+                (resolvesAll(leftColumns, *pred) ? leftPreds : remaining).push_back(std::move(pred));
+            }
+            node->children[0] = pushInto(std::move(node->children[0]), std::move(leftPreds));
+            if (remaining.empty()) {
+                return node;
+            }
+            return LogicalNode::makeFilter(std::move(node), std::move(remaining));
+        }
+        case LogicalNodeType::PROJECT:
+        case LogicalNodeType::AGGREGATE:
+        case LogicalNodeType::WINDOW:
+        case LogicalNodeType::DISTINCT:
+            // Filtering a window's input would change its partitions
+            break;
+    }
+    return LogicalNode::makeFilter(std::move(node), std::move(predicates));
+}
+
+// Join ordering: dynamic programming over subsets of the relations in a join
+// region, minimizing the summed cost of hash joins. Cross products are only
+// considered for subsets that have no connecting join condition.
+
+std::unique_ptr<LogicalNode> Optimizer::reorderJoins(std::unique_ptr<LogicalNode> node) {
+    bool isRegion = node->type == LogicalNodeType::JOIN ||
+                    (node->type == LogicalNodeType::FILTER && node->children[0]->type == LogicalNodeType::JOIN);
+    if (!isRegion) {
+        for (auto& child : node->children) {
+            child = reorderJoins(std::move(child));
+        }
+        return node;
+    }
+
+    std::vector<std::unique_ptr<LogicalNode>> relations;
+    std::vector<JoinCondition> conditions;
+    std::vector<std::unique_ptr<Expression>> residuals;
+    collectJoinRegion(std::move(node), relations, conditions, residuals);
+
+    const size_t n = relations.size();
+    if (n > 64) {
+        throw std::runtime_error("Too many tables in join");
+    }
+    std::vector<std::vector<std::string>> relationColumns;
+    for (auto& relation : relations) {
+        relation = reorderJoins(std::move(relation));
+        estimateCosts(*relation);
+        relationColumns.push_back(relation->getOutputColumns());
+    }
+    auto relationOf = [&](const std::string& column) {
+        int found = -1;
+        for (size_t i = 0; i < n; ++i) {
+            if (resolvesIn(relationColumns[i], column)) {
+                if (found >= 0) throw std::runtime_error("Ambiguous column reference: " + column);
+                found = static_cast<int>(i);
+            }
+        }
+        if (found < 0) throw std::runtime_error("Unknown column: " + column);
+        return found;
+    };
+
+    struct Edge {
+        int left;
+        int right;
+        JoinCondition condition;
+        double selectivity;
+    };
+    std::vector<Edge> edges;
+    for (const auto& cond : conditions) {
+        int l = relationOf(cond.leftColumn);
+        int r = relationOf(cond.rightColumn);
+        if (l == r) {
+            throw std::runtime_error("Join condition must compare columns of two tables: " +
+                                     cond.leftColumn + " = " + cond.rightColumn);
+        }
+        edges.push_back({l, r, cond, joinSelectivity(*relations[l], *relations[r], cond)});
+    }
+    std::vector<uint64_t> residualMasks;
+    for (const auto& pred : residuals) {
+        uint64_t mask = 0;
+        for (const auto& column : expressionColumns(*pred)) {
+            mask |= uint64_t(1) << relationOf(column);
+        }
+        residualMasks.push_back(mask);
+    }
+
+    auto bit = [](int i) { return uint64_t(1) << i; };
+    auto cardinality = [&](uint64_t mask) {
+        double rows = 1.0;
+        for (size_t i = 0; i < n; ++i) {
+            if (mask & bit(i)) rows *= relations[i]->estimatedRows;
+        }
+        for (const auto& edge : edges) {
+            if ((mask & bit(edge.left)) && (mask & bit(edge.right))) rows *= edge.selectivity;
+        }
+        for (uint64_t rmask : residualMasks) {
+            if ((rmask & ~mask) == 0 && __builtin_popcountll(rmask) > 1) {
+                rows *= SelectivityEstimator::kDefaultSelectivity;
+            }
+        }
+        return rows;
+    };
+    auto connected = [&](uint64_t a, uint64_t b) {
+        for (const auto& edge : edges) {
+            if (((a & bit(edge.left)) && (b & bit(edge.right))) ||
+                ((a & bit(edge.right)) && (b & bit(edge.left)))) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    std::unordered_map<uint64_t, uint64_t> splits;
+    const uint64_t full = (n == 64) ? ~uint64_t(0) : bit(n) - 1;
+    if (n <= kMaxDPRelations) {
+        const double inf = std::numeric_limits<double>::infinity();
+        std::vector<double> cost(full + 1, inf);
+        std::vector<double> rows(full + 1, 0.0);
+        for (uint64_t mask = 1; mask <= full; ++mask) {
+            rows[mask] = cardinality(mask);
+            if (__builtin_popcountll(mask) == 1) {
+                cost[mask] = relations[__builtin_ctzll(mask)]->estimatedCost;
+                continue;
+            }
+            uint64_t lowest = mask & (~mask + 1);
+            for (int allowCross = 0; allowCross < 2 && cost[mask] == inf; ++allowCross) {
+                for (uint64_t sub = (mask - 1) & mask; sub > 0; sub = (sub - 1) & mask) {
+                    if (!(sub & lowest)) continue; // each split once
+                    uint64_t other = mask ^ sub;
+                    if (cost[sub] == inf || cost[other] == inf) continue;
+                    if (!allowCross && !connected(sub, other)) continue;
+                    double c = cost[sub] + cost[other] + hashJoinCost(rows[sub], rows[other], rows[mask]);
+                    if (c < cost[mask]) {
+                        cost[mask] = c;
+                        splits[mask] = sub;
+                    }
+                }
+            }
+        }
+    } else {
+        // Left-deep in the written order
+        for (size_t k = 2; k <= n; ++k) {
+            uint64_t prefix = (k == 64) ? ~uint64_t(0) : bit(k) - 1;
+            splits[prefix] = bit(k - 1) - 1;
+        }
+    }
+
+    std::vector<bool> placed(residuals.size(), false);
+    std::function<std::unique_ptr<LogicalNode>(uint64_t)> rebuild = [&](uint64_t mask) {
+        std::unique_ptr<LogicalNode> result;
+        if (__builtin_popcountll(mask) == 1) {
+            result = std::move(relations[__builtin_ctzll(mask)]);
+        } else {
+            uint64_t sub = splits.at(mask);
+            uint64_t other = mask ^ sub;
+            auto left = rebuild(sub);
+            auto right = rebuild(other);
+            std::vector<JoinCondition> joinConditions;
+            for (const auto& edge : edges) {
+                if ((sub & bit(edge.left)) && (other & bit(edge.right))) {
+                    joinConditions.push_back(edge.condition);
+                } else if ((sub & bit(edge.right)) && (other & bit(edge.left))) {
+                    joinConditions.push_back({edge.condition.rightColumn, edge.condition.leftColumn});
+                }
+            }
+            result = LogicalNode::makeJoin(std::move(left), std::move(right), joinConditions);
+        }
+        std::vector<std::unique_ptr<Expression>> filters;
+        for (size_t i = 0; i < residuals.size(); ++i) {
+            if (!placed[i] && (residualMasks[i] & ~mask) == 0) {
+                filters.push_back(std::move(residuals[i]));
+                placed[i] = true;
+            }
+        }
+        if (!filters.empty()) {
+            result = LogicalNode::makeFilter(std::move(result), std::move(filters));
+        }
+        return result;
+    };
+    return rebuild(full);
+}
+
+// Projection pushdown: scans read only the columns needed above them
+
+void Optimizer::pushDownProjections(LogicalNode& node, std::vector<std::string> required) {
+    switch (node.type) {
+        case LogicalNodeType::PROJECT:
+            pushDownProjections(*node.children[0], node.columns);
+            return;
+        case LogicalNodeType::AGGREGATE: {
+            std::vector<std::string> inputs = node.groupBy;
+            for (const auto& item : node.aggregates) {
+                if (!item.source.empty()) inputs.push_back(item.source);
+            }
+            pushDownProjections(*node.children[0], inputs);
+            return;
+        }
+        case LogicalNodeType::WINDOW: {
+            // Window outputs are produced here; their inputs come from below
+            std::vector<std::string> inputs;
+            for (const auto& name : required) {
+                bool produced = false;
+                for (const auto& window : node.windows) {
+                    produced = produced || window.name == name;
+                }
+                if (!produced) inputs.push_back(name);
+            }
+            for (const auto& window : node.windows) {
+                if (!window.source.empty()) inputs.push_back(window.source);
+                inputs.insert(inputs.end(), window.partitionBy.begin(), window.partitionBy.end());
+                for (const auto& key : window.orderBy) {
+                    inputs.push_back(key.column);
+                }
+            }
+            pushDownProjections(*node.children[0], inputs);
+            return;
+        }
+        case LogicalNodeType::DISTINCT:
+            // Every column takes part in the comparison
+            pushDownProjections(*node.children[0], node.getOutputColumns());
+            return;
+        case LogicalNodeType::SEMI_JOIN:
+            required.push_back(node.joinConditions[0].leftColumn);
+            pushDownProjections(*node.children[0], required);
+            pushDownProjections(*node.children[1], {node.joinConditions[0].rightColumn});
+            return;
+        case LogicalNodeType::FILTER:
+            for (const auto& pred : node.predicates) {
+                pred->collectColumns(required);
+            }
+            pushDownProjections(*node.children[0], required);
+            return;
+        case LogicalNodeType::JOIN:
+            for (const auto& cond : node.joinConditions) {
+                required.push_back(cond.leftColumn);
+                required.push_back(cond.rightColumn);
+            }
+            for (auto& child : node.children) {
+                pushDownProjections(*child, required);
+            }
+            return;
+        case LogicalNodeType::SCAN: {
+            // Pushed-down predicates read stored rows directly (late
+            // materialization), so their columns are not part of the output
+            std::vector<std::string> keep;
+            for (const auto& column : node.table->getColumns()) {
+                std::string qualified = node.alias + "." + column.name;
+                for (const auto& name : required) {
+                    if (name == qualified || name == column.name) {
+                        keep.push_back(column.name);
+                        break;
+                    }
+                }
+            }
+            if (keep.empty() && !node.table->getColumns().empty()) {
+                keep.push_back(node.table->getColumns()[0].name);
+            }
+            node.columns = keep;
+            return;
+        }
+    }
+}
+
+// Access path selection. A scan reads every row of its partitions unless a
+// trigram index on a column its predicates search returns fewer candidate
+// rows than that, weighted by kIndexRow. Scans of partitioned tables also
+// drop the partitions their predicates rule out.
+
+namespace {
+
+// For each partition of the scanned table, whether it may hold rows
+// satisfying `expr`. Comparisons and IN lists on the partition key prune; AND
+// intersects, OR unions, and anything else keeps every partition.
+std::vector<bool> partitionsMatching(const LogicalNode& scan, const Expression& expr) {
+    const Table& table = *scan.table;
+    std::vector<bool> keep(table.getPartitionCount(), true);
+    if (const auto* paren = dynamic_cast<const ParenExpr*>(&expr)) {
+        return partitionsMatching(scan, *paren->expr);
+    }
+    if (const auto* logical = dynamic_cast<const LogicalExpr*>(&expr)) {
+        std::vector<bool> left = partitionsMatching(scan, *logical->left);
+        std::vector<bool> right = partitionsMatching(scan, *logical->right);
+        for (size_t p = 0; p < keep.size(); ++p) {
+            keep[p] = logical->op == "AND" ? left[p] && right[p] : left[p] || right[p];
+        }
+        return keep;
+    }
+    if (const auto* comparison = dynamic_cast<const ComparisonExpr*>(&expr)) {
+        const std::string& key = table.getColumns()[table.getPartitionColumn()].name;
+        if (comparison->column != key && comparison->column != scan.alias + "." + key) return keep;
+        CompareOp op = parseCompareOp(comparison->op);
+        CompactValue value = CompactValue::borrow(comparison->value);
+        for (size_t p = 0; p < keep.size(); ++p) {
+            keep[p] = table.partitionMayMatch(p, op, value);
+        }
+    }
+    if (const auto* in = dynamic_cast<const InListExpr*>(&expr)) {
+        const std::string& key = table.getColumns()[table.getPartitionColumn()].name;
+        if (in->column != key && in->column != scan.alias + "." + key) return keep;
+        for (size_t p = 0; p < keep.size(); ++p) {
+            keep[p] = false;
+            for (const auto& value : in->values) {
+                keep[p] = keep[p] || table.partitionMayMatch(p, CompareOp::EQ, CompactValue::borrow(value));
+            }
+        }
+    }
+    return keep;
+}
+
+bool namesColumn(const LogicalNode& scan, const std::string& name, const std::string& column) {
+    return name == column || name == scan.alias + "." + column;
+}
+
+// Literals that `column` of every row satisfying `expr` contains: the pieces
+// of a case-sensitive LIKE, STARTS_WITH or CONTAINS, or an equality's string
+std::vector<std::string> indexableLiterals(const LogicalNode& scan, const Expression& expr,
+                                           const std::string& column) {
+    if (const auto* paren = dynamic_cast<const ParenExpr*>(&expr)) {
+        return indexableLiterals(scan, *paren->expr, column);
+    }
+    if (const auto* pattern = dynamic_cast<const PatternExpr*>(&expr)) {
+        if (pattern->negated || pattern->op == PatternOp::ILIKE || !namesColumn(scan, pattern->column, column)) {
+            return {};
+        }
+        return pattern->matcher.getRequiredLiterals();
+    }
+    if (const auto* comparison = dynamic_cast<const ComparisonExpr*>(&expr)) {
+        if (comparison->op != "=" || !std::holds_alternative<std::string>(comparison->value) ||
+            !namesColumn(scan, comparison->column, column)) {
+            return {};
+        }
+        return {std::get<std::string>(comparison->value)};
+    }
+    return {};
+}
+
+// Switches the scan to the trigram index promising the fewest candidates, if
+// reading those costs less than reading every row
+void chooseTrigramIndex(LogicalNode& node) {
+    const Table& table = *node.table;
+    if (table.getTrigramIndexes().empty() || node.sample.method != TableSample::NONE) return;
+    // Holds off compaction, which rebuilds the posting lists
+    Table::Pin pin(table);
+    double best = 0.0;
+    for (size_t p : node.partitions) {
+        best += static_cast<double>(table.getPartition(p).getStoredRowCount()) * CostModel::kSeqScanRow;
+    }
+    const auto& indexes = table.getTrigramIndexes();
+    for (size_t slot = 0; slot < indexes.size(); ++slot) {
+        std::vector<std::string> literals;
+        for (const auto& pred : node.predicates) {
+            for (auto& literal : indexableLiterals(node, *pred, indexes[slot].column)) {
+                literals.push_back(std::move(literal));
+            }
+        }
+        if (!TrigramIndex::usable(literals)) continue;
+        double candidates = 0.0;
+        for (size_t p : node.partitions) {
+            candidates += static_cast<double>(table.getPartition(p).getTrigramIndex(slot).estimate(literals));
+        }
+        if (candidates * CostModel::kIndexRow < best) {
+            best = candidates * CostModel::kIndexRow;
+            node.accessPath = AccessPath::TRIGRAM_INDEX;
+            node.indexSlot = static_cast<int>(slot);
+            node.indexLiterals = std::move(literals);
+            node.indexRows = candidates;
+        }
+    }
+}
+
+} // namespace
+
+void Optimizer::chooseAccessPaths(LogicalNode& node) {
+    if (node.type == LogicalNodeType::SCAN) {
+        node.accessPath = AccessPath::SEQUENTIAL_SCAN;
+        if (node.table->isPartitioned()) {
+            std::vector<bool> keep(node.table->getPartitionCount(), true);
+            for (const auto& pred : node.predicates) {
+                std::vector<bool> matching = partitionsMatching(node, *pred);
+                for (size_t p = 0; p < keep.size(); ++p) {
+                    keep[p] = keep[p] && matching[p];
+                }
+            }
+            node.partitions.clear();
+            for (size_t p = 0; p < keep.size(); ++p) {
+                if (keep[p]) node.partitions.push_back(p);
+            }
+        }
+        chooseTrigramIndex(node);
+    }
+    for (auto& child : node.children) {
+        chooseAccessPaths(*child);
+    }
+}
+
+void Optimizer::estimateCosts(LogicalNode& node) {
+    for (auto& child : node.children) {
+        estimateCosts(*child);
+    }
+    switch (node.type) {
+        case LogicalNodeType::SCAN: {
+            double base = static_cast<double>(node.table->getStatistics().getRowCount());
+            double selectivity = 1.0;
+            for (const auto& pred : node.predicates) {
+                selectivity *= SelectivityEstimator::estimate(*pred, *node.table);
+            }
+            // Pruned partitions are never read; the predicates still filter
+            // the rest, so they alone determine the output estimate
+            double scanned = base;
+            if (node.table->isPartitioned() && node.table->getRowCount() > 0) {
+                size_t rows = 0;
+                for (size_t p : node.partitions) {
+                    rows += node.table->getPartition(p).getRowCount();
+                }
+                scanned = base * static_cast<double>(rows) / node.table->getRowCount();
+            }
+            // SYSTEM samples skip whole blocks; BERNOULLI still visits every
+            // row but evaluates predicates only on the sampled ones
+            const double fraction = node.sample.fraction();
+            const double sampled = scanned * fraction;
+            const double read = node.sample.method == TableSample::SYSTEM ? sampled : scanned;
+            node.estimatedRows = std::min(base * selectivity, scanned) * fraction;
+            node.estimatedCost = read * CostModel::kSeqScanRow +
+                                 sampled * CostModel::kPredicateEval * node.predicates.size();
+            if (node.accessPath == AccessPath::TRIGRAM_INDEX) {
+                // Only the index's candidates are read and checked
+                const double candidates = std::min(node.indexRows, scanned);
+                node.estimatedRows = std::min(node.estimatedRows, candidates);
+                node.estimatedCost = candidates * (CostModel::kIndexRow +
+                                                   CostModel::kPredicateEval * node.predicates.size());
+            }
+            break;
+        }
+        case LogicalNodeType::FILTER: {
+            const LogicalNode& child = *node.children[0];
+            double selectivity = 1.0;
+            for (const auto& pred : node.predicates) {
+                selectivity *= predicateSelectivity(child, *pred);
+            }
+            node.estimatedRows = child.estimatedRows * selectivity;
+            node.estimatedCost = child.estimatedCost +
+                                 child.estimatedRows * CostModel::kPredicateEval * node.predicates.size();
+            break;
+        }
+        case LogicalNodeType::JOIN: {
+            const LogicalNode& left = *node.children[0];
+            const LogicalNode& right = *node.children[1];
+            double rows = left.estimatedRows * right.estimatedRows;
+            for (const auto& cond : node.joinConditions) {
+                rows *= joinSelectivity(left, right, cond);
+            }
+            node.estimatedRows = rows;
+            node.estimatedCost = left.estimatedCost + right.estimatedCost +
+                                 hashJoinCost(left.estimatedRows, right.estimatedRows, rows);
+            break;
+        }
+        case LogicalNodeType::PROJECT: {
+            const LogicalNode& child = *node.children[0];
+            node.estimatedRows = child.estimatedRows;
+            node.estimatedCost = child.estimatedCost + child.estimatedRows * CostModel::kOutputRow;
+            break;
+        }
+        case LogicalNodeType::AGGREGATE: {
+            // At most one group per combination of grouping-column values
+            const LogicalNode& child = *node.children[0];
+            double groups = 1.0;
+            for (const auto& column : node.groupBy) {
+                double distinct = columnDistinct(child, column);
+                groups *= distinct > 0.0 ? distinct : child.estimatedRows;
+            }
+            node.estimatedRows = std::max(1.0, std::min(groups, child.estimatedRows));
+            node.estimatedCost = child.estimatedCost + child.estimatedRows * CostModel::kHashProbeRow +
+                                 node.estimatedRows * CostModel::kOutputRow;
+            break;
+        }
+        case LogicalNodeType::SEMI_JOIN: {
+            // A left row survives if its key is among the right input's keys
+            const LogicalNode& left = *node.children[0];
+            const LogicalNode& right = *node.children[1];
+            double distinct = columnDistinct(left, node.joinConditions[0].leftColumn);
+            double selectivity = distinct > 0.0 ? std::min(1.0, right.estimatedRows / distinct)
+                                                : SelectivityEstimator::kDefaultSelectivity;
+            node.estimatedRows = left.estimatedRows * selectivity;
+            node.estimatedCost = left.estimatedCost + right.estimatedCost +
+                                 CostModel::kHashBuildRow * right.estimatedRows +
+                                 CostModel::kHashProbeRow * left.estimatedRows +
+                                 CostModel::kOutputRow * node.estimatedRows;
+            break;
+        }
+        case LogicalNodeType::DISTINCT: {
+            const LogicalNode& child = *node.children[0];
+            double combinations = 1.0;
+            for (const auto& column : child.getOutputColumns()) {
+                double distinct = columnDistinct(child, column);
+                combinations *= distinct > 0.0 ? distinct : child.estimatedRows;
+            }
+            node.estimatedRows = std::max(1.0, std::min(combinations, child.estimatedRows));
+            node.estimatedCost = child.estimatedCost + child.estimatedRows * CostModel::kHashProbeRow +
+                                 node.estimatedRows * CostModel::kOutputRow;
+            break;
+        }
+        case LogicalNodeType::WINDOW: {
+            // Each function sorts its input and answers frames in O(log n)
+            const LogicalNode& child = *node.children[0];
+            const double rows = child.estimatedRows;
+            const double logRows = std::log2(std::max(2.0, rows));
+            node.estimatedRows = rows;
+            node.estimatedCost = child.estimatedCost + rows * CostModel::kOutputRow +
+                                 node.windows.size() * rows * logRows * CostModel::kPredicateEval;
+            break;
+        }
+    }
+}
+
+// Lowering to physical operators
+
+std::unique_ptr<QueryPlanNode> Optimizer::lower(std::unique_ptr<LogicalNode> node) {
+    std::unique_ptr<QueryPlanNode> result;
+    switch (node->type) {
+        case LogicalNodeType::SCAN: {
+            auto scan = std::make_unique<TableScanNode>(*node->table, node->columns, node->alias,
+                                                        combineConjuncts(std::move(node->predicates)));
+            scan->setPartitions(node->partitions);
+            scan->setSample(node->sample);
+            if (node->accessPath == AccessPath::TRIGRAM_INDEX) {
+                scan->setIndexLookup(static_cast<size_t>(node->indexSlot), std::move(node->indexLiterals));
+            }
+            result = std::move(scan);
+            break;
+        }
+        case LogicalNodeType::FILTER:
+            result = std::make_unique<FilterNode>(lower(std::move(node->children[0])),
+                                                  combineConjuncts(std::move(node->predicates)));
+            break;
+        case LogicalNodeType::JOIN: {
+            // Build the hash table on the smaller input
+            bool buildLeft = node->children[0]->estimatedRows < node->children[1]->estimatedRows;
+            auto left = lower(std::move(node->children[0]));
+            auto right = lower(std::move(node->children[1]));
+            std::vector<JoinKey> keys;
+            for (const auto& cond : node->joinConditions) {
+                keys.push_back(buildLeft ? JoinKey{cond.rightColumn, cond.leftColumn}
+                                         : JoinKey{cond.leftColumn, cond.rightColumn});
+            }
+            result = buildLeft ? std::make_unique<HashJoinNode>(std::move(right), std::move(left), keys)
+                               : std::make_unique<HashJoinNode>(std::move(left), std::move(right), keys);
+            break;
+        }
+        case LogicalNodeType::PROJECT: {
+            auto child = lower(std::move(node->children[0]));
+            const auto& childColumns = child->getOutputColumns();
+            bool identity = node->columns.size() == childColumns.size();
+            for (size_t i = 0; identity && i < node->columns.size(); ++i) {
+                identity = findColumn(childColumns, node->columns[i]) == static_cast<int>(i);
+            }
+            if (identity) {
+                return child;
+            }
+            result = std::make_unique<ProjectNode>(std::move(child), node->columns);
+            break;
+        }
+        case LogicalNodeType::AGGREGATE:
+            result = std::make_unique<AggregateNode>(lower(std::move(node->children[0])), node->groupBy,
+                                                     node->aggregates, node->columns);
+            break;
+        case LogicalNodeType::WINDOW:
+            result = std::make_unique<WindowNode>(lower(std::move(node->children[0])), node->windows);
+            break;
+        case LogicalNodeType::SEMI_JOIN: {
+            // The right input is always the build side: its keys are the set tested
+            const JoinCondition& cond = node->joinConditions[0];
+            auto left = lower(std::move(node->children[0]));
+            auto right = lower(std::move(node->children[1]));
+            result = std::make_unique<HashJoinNode>(std::move(left), std::move(right),
+                                                    std::vector<JoinKey>{{cond.leftColumn, cond.rightColumn}},
+                                                    JoinType::SEMI);
+            break;
+        }
+        case LogicalNodeType::DISTINCT:
+            result = std::make_unique<DistinctNode>(lower(std::move(node->children[0])));
+            break;
+    }
+    result->setEstimates(node->estimatedRows, node->estimatedCost);
+    return result;
+}
+
+} // namespace parallaxdb
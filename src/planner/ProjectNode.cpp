@@ -0,0 +1,48 @@
+#include "../../include/planner/ProjectNode.hpp"
+#include <stdexcept>
+
+namespace parallaxdb {
+
+ProjectNode::ProjectNode(std::unique_ptr<QueryPlanNode> child, const std::vector<std::string>& columns)
+    : child(std::move(child)) {
+    const auto& childColumns = this->child->getOutputColumns();
+    for (const auto& name : columns) {
+        int idx = findColumn(childColumns, name);
+        if (idx < 0) {
+            throw std::runtime_error("Unknown column: " + name);
+        }
+        columnIndices.push_back(idx);
+        outputColumns.push_back(childColumns[idx]);
+    }
+}
+
+void ProjectNode::doOpen() {
+    child->open();
+}
+
+bool ProjectNode::doNext(RowBatch& batch) {
+    batch.clear();
+    if (!child->next(input)) {
+        return false;
+    }
+    batch.rows.reserve(input.size());
+    for (auto& row : input.rows) {
+        std::vector<Value>& out = batch.appendRow().values;
+        out.reserve(columnIndices.size());
+        for (int idx : columnIndices) {
+            out.push_back(row.values[idx]);
+        }
+    }
+    return true;
+}
+
+std::string ProjectNode::getDetails() const {
+    std::string details = "[";
+    for (size_t i = 0; i < outputColumns.size(); ++i) {
+        if (i > 0) details += ", ";
+        details += outputColumns[i];
+    }
+    return details + "]";
+}
+
+} // namespace parallaxdb
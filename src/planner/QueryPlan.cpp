@@ -1,43 +1,693 @@
 #include "../../include/planner/QueryPlan.hpp"
 #include "../../include/types/Common.hpp"
+#include "../../include/storage/Statistics.hpp"
+#include "../../include/util/MemoryTracker.hpp"
+#include "../../include/util/Numa.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <ctime>
 #include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <cstdio>
+#include <exception>
+#include <mutex>
+#include <thread>
 
 namespace parallaxdb {
 
-TableScanNode::TableScanNode(const Table& table, const std::vector<std::string>& selectedColumns)
-    : table(table), selectedColumns(selectedColumns) {}
+namespace {
 
-void TableScanNode::execute() {
+double threadCpuNanos() {
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// Measures one call into an operator and folds it into the operator's profile
+class ProfileSample {
+public:
+    explicit ProfileSample(OperatorProfile& profile)
+        : profile(profile),
+          wallStart(std::chrono::steady_clock::now()),
+          cpuStart(threadCpuNanos()),
+          allocStart(MemoryTracker::getBytesAllocated()),
+          liveStart(MemoryTracker::getCurrentBytes()),
+          outerPeak(MemoryTracker::getPeakBytes()) {
+        MemoryTracker::setPeakBytes(liveStart);
+    }
+
+    ~ProfileSample() {
+        profile.wallNanos += std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - wallStart).count();
+        profile.cpuNanos += threadCpuNanos() - cpuStart;
+        profile.bytesAllocated += MemoryTracker::getBytesAllocated() - allocStart;
+        int64_t peak = MemoryTracker::getPeakBytes();
+        profile.peakBytes = std::max(profile.peakBytes, profile.retainedBytes + peak - liveStart);
+        profile.retainedBytes += MemoryTracker::getCurrentBytes() - liveStart;
+        MemoryTracker::setPeakBytes(std::max(outerPeak, peak));
+    }
+
+private:
+    OperatorProfile& profile;
+    std::chrono::steady_clock::time_point wallStart;
+    double cpuStart;
+    uint64_t allocStart;
+    int64_t liveStart;
+    int64_t outerPeak;
+};
+
+} // namespace
+
+void QueryPlanNode::open() {
+    if (!profiling) {
+        doOpen();
+        return;
+    }
+    ProfileSample sample(profile);
+    doOpen();
+}
+
+bool QueryPlanNode::next(RowBatch& batch) {
+    if (!profiling) {
+        return doNext(batch);
+    }
+    bool more;
+    {
+        ProfileSample sample(profile);
+        more = doNext(batch);
+    }
+    if (more) {
+        profile.batches++;
+        profile.rowsOut += batch.size();
+    }
+    return more;
+}
+
+void QueryPlanNode::enableProfiling() {
+    profiling = true;
+    profile = OperatorProfile();
+    for (const QueryPlanNode* child : getChildren()) {
+        const_cast<QueryPlanNode*>(child)->enableProfiling();
+    }
+}
+
+TableScanNode::TableScanNode(const Table& table, const std::vector<std::string>& selectedColumns,
+                             const std::string& alias, std::unique_ptr<Expression> predicate)
+    : table(table), selectedColumns(selectedColumns), alias(alias.empty() ? table.getName() : alias) {
     const auto& columns = table.getColumns();
-    std::vector<int> colIndices;
-    if (!selectedColumns.empty()) {
+    if (predicate) {
+        // The predicate reads stored rows, so bind it to the full table layout
+        std::vector<std::string> tableColumns;
+        for (const auto& column : columns) {
+            tableColumns.push_back(this->alias + "." + column.name);
+        }
+        filter = ConjunctFilter(std::move(predicate), tableColumns);
+    }
+    if (selectedColumns.empty()) {
+        for (size_t i = 0; i < columns.size(); ++i) {
+            columnIndices.push_back(static_cast<int>(i));
+        }
+    } else {
         for (const auto& colName : selectedColumns) {
-            for (size_t i = 0; i < columns.size(); ++i) {
-                if (columns[i].name == colName) {
-                    colIndices.push_back(i);
-                    break;
-                }
+            int idx = table.getColumnIndex(colName);
+            if (idx < 0) {
+                throw std::runtime_error("Unknown column '" + colName + "' in table " + table.getName());
             }
+            columnIndices.push_back(idx);
         }
     }
-    for (const auto& row : table.getRows()) {
-        if (!selectedColumns.empty()) {
-            for (size_t j = 0; j < colIndices.size(); ++j) {
-                int idx = colIndices[j];
-                if (idx >= 0 && idx < (int)row.values.size()) {
-                    std::cout << row.values[idx] << " ";
-                }
+    for (int idx : columnIndices) {
+        outputColumns.push_back(this->alias + "." + columns[idx].name);
+    }
+    for (size_t p = 0; p < table.getPartitionCount(); ++p) {
+        partitions.push_back(p);
+    }
+}
+
+// Workers claim partitions at most `lookahead` ahead of the one being
+// returned and leave each partition's batches in its slot. Worker t lives on
+// NUMA node t % nodes; within the window it takes the first unclaimed
+// partition homed on its node, and only steals a remote one when none is
+// left or the consumer is waiting for it.
+struct TableScanNode::ParallelScan {
+    struct Slot {
+        std::vector<RowBatch> batches;
+        uint64_t rowsIn = 0;
+        bool compiled = false;            // Filtered by compiled code
+        size_t node = 0;                  // Home node of the partition
+        bool claimed = false;
+        bool local = false;               // Read by a worker on its home node
+        bool done = false;
+    };
+
+    std::vector<Slot> slots;              // One per selected partition
+    size_t lookahead = 0;
+    std::mutex mutex;
+    std::condition_variable filled;       // A slot was completed
+    std::condition_variable drained;      // The consumer moved to the next slot
+    size_t firstUnclaimed = 0;
+    size_t current = 0;                   // Slot being returned
+    size_t nextBatch = 0;
+    bool stopping = false;
+    std::exception_ptr error;
+    std::vector<std::thread> workers;
+};
+
+TableScanNode::~TableScanNode() {
+    stopParallelScan();
+}
+
+void TableScanNode::doOpen() {
+    stopParallelScan();
+    partitionCursor = 0;
+    cursor = 0;
+    filter.reset();
+    pin.reset();
+    pin.emplace(table);
+    candidates.clear();
+    candidateCursor = 0;
+
+    size_t rows = 0;
+    for (size_t p : partitions) {
+        rows += table.getPartition(p).getRowCount();
+    }
+    // Tiered predicate: interpreted until its shape has been compiled
+    jit.reset();
+    jitLiterals.clear();
+    startedCompiled = false;
+    ranCompiled = false;
+    if (!filter.empty() && FilterJit::instance().isEnabled()) {
+        if (auto shape = FilterJit::describe(filter.getConjuncts(), table.getColumns().size())) {
+            // Decided with the lookup: a compile finishing after it was
+            // still paid for by this scan
+            FilterJit::Lookup lookup = FilterJit::instance().request(*shape, rows >= kJitRows);
+            jit = std::move(lookup.entry);
+            jitLiterals = std::move(shape->literals);
+            startedCompiled = lookup.compiled;
+        }
+    }
+
+    // Runtime filters adapt as they see rows, so they keep the scan serial
+    ranParallel = false;
+    if (!indexed && partitions.size() > 1 && runtimeFilters.empty() && rows >= kParallelScanRows && workerCount() > 1) {
+        startParallelScan();
+    }
+}
+
+bool TableScanNode::doNext(RowBatch& batch) {
+    batch.clear();
+    if (parallel) {
+        return nextParallel(batch);
+    }
+    if (indexed) {
+        return nextIndexed(batch);
+    }
+    for (;;) {
+        while (partitionCursor < partitions.size() &&
+               cursor >= table.getPartition(partitions[partitionCursor]).getBlockCount()) {
+            partitionCursor++;
+            cursor = 0;
+        }
+        if (partitionCursor >= partitions.size()) {
+            pin.reset();
+            return false;
+        }
+        const size_t blockIndex = cursor++;
+        const uint64_t seed = blockSeed(partitions[partitionCursor], blockIndex);
+        if (!blockSampled(seed)) continue;
+        const Table::Block& block = table.getPartition(partitions[partitionCursor]).getBlock(blockIndex);
+        profile.rowsIn += block.getLiveCount();
+        selectRows(block, seed, selection, true);
+        materialize(block, selection, batch);
+        return true;
+    }
+}
+
+void TableScanNode::setIndexLookup(size_t slot, std::vector<std::string> literals) {
+    indexed = true;
+    indexSlot = slot;
+    indexLiterals = std::move(literals);
+}
+
+bool TableScanNode::nextIndexed(RowBatch& batch) {
+    for (;;) {
+        if (candidateCursor >= candidates.size()) {
+            if (partitionCursor >= partitions.size()) {
+                pin.reset();
+                return false;
+            }
+            table.getPartition(partitions[partitionCursor++]).getTrigramIndex(indexSlot)
+                .lookup(indexLiterals, candidates);
+            candidateCursor = 0;
+            continue;
+        }
+        // Candidate IDs ascend, so each block's candidates are one run of them
+        const Table::Partition& partition = table.getPartition(partitions[partitionCursor - 1]);
+        const size_t blockIndex = candidates[candidateCursor] / Table::kBlockRows;
+        const Table::Block& block = partition.getBlock(blockIndex);
+        selection.clear();
+        while (candidateCursor < candidates.size() && candidates[candidateCursor] / Table::kBlockRows == blockIndex) {
+            const uint32_t row = candidates[candidateCursor++] % Table::kBlockRows;
+            if (!block.isDeleted(row)) selection.push_back(row);
+        }
+        profile.rowsIn += selection.size();
+        filterRows(block, selection, true);
+        materialize(block, selection, batch);
+        return true;
+    }
+}
+
+uint64_t TableScanNode::blockSeed(size_t partition, size_t block) const {
+    return mix64(sample.seed ^ mix64((static_cast<uint64_t>(partition) << 32) | block));
+}
+
+bool TableScanNode::blockSampled(uint64_t seed) const {
+    if (sample.method != TableSample::SYSTEM) return true;
+    return static_cast<double>(seed >> 11) * 0x1.0p-53 < sample.fraction();
+}
+
+bool TableScanNode::selectRows(const Table::Block& block, uint64_t seed, std::vector<uint32_t>& selection,
+                               bool adaptive) {
+    const size_t count = block.getRowCount();
+
+    // Phase 1: row IDs that pass the predicate, starting from the block's
+    // live rows. Blocks without deletions skip the bitmap entirely.
+    selection.resize(count);
+    if (sample.method == TableSample::BERNOULLI) {
+        // Jump between sampled rows by geometrically distributed gaps, so the
+        // cost follows the sample size rather than the block size
+        const double fraction = sample.fraction();
+        const double logMiss = std::log1p(-std::min(fraction, 1.0 - 1e-12));
+        uint64_t state = seed;
+        size_t sampled = 0;
+        size_t row = 0;
+        while (fraction > 0.0) {
+            state = mix64(state + 0x9e3779b97f4a7c15ULL);
+            const double u = (static_cast<double>(state >> 11) + 0.5) * 0x1.0p-53;
+            const double gap = fraction >= 1.0 ? 0.0 : std::floor(std::log(u) / logMiss);
+            if (gap >= static_cast<double>(count - row)) break;
+            row += static_cast<size_t>(gap);
+            if (!block.isDeleted(row)) selection[sampled++] = static_cast<uint32_t>(row);
+            if (++row >= count) break;
+        }
+        selection.resize(sampled);
+    } else if (block.getDeletedCount() == 0) {
+        for (size_t i = 0; i < count; ++i) {
+            selection[i] = static_cast<uint32_t>(i);
+        }
+    } else {
+        const std::vector<uint64_t>& deleted = block.getDeletionBitmap();
+        size_t live = 0;
+        for (size_t w = 0; w * 64 < count; ++w) {
+            uint64_t bits = ~deleted[w];
+            if (count - w * 64 < 64) bits &= (uint64_t(1) << (count - w * 64)) - 1;
+            while (bits) {
+                selection[live++] = static_cast<uint32_t>(w * 64 + __builtin_ctzll(bits));
+                bits &= bits - 1;
             }
+        }
+        selection.resize(live);
+    }
+    return filterRows(block, selection, adaptive);
+}
+
+bool TableScanNode::filterRows(const Table::Block& block, std::vector<uint32_t>& selection, bool adaptive) {
+    const size_t width = table.getColumns().size();
+    const CompactValue* chunk = block.getCells();
+    auto rowAt = [chunk, width](uint32_t i) { return chunk + i * width; };
+    // Each block is a tier boundary: compiled code is used as soon as it exists
+    const FilterJit::Function compiled = jit ? jit->get() : nullptr;
+    if (compiled) {
+        selection.resize(compiled(chunk, selection.data(), selection.size(), jitLiterals.data()));
+        if (adaptive) noteCompiled();
+    } else if (!filter.empty()) {
+        if (adaptive) {
+            filter.apply(rowAt, selection);
         } else {
-            for (const auto& val : row.values) {
-                std::cout << val << " ";
+            filter.applyFixed(rowAt, selection);
+        }
+    }
+    for (auto& pushed : runtimeFilters) {
+        const std::vector<int>& keys = pushed.keyIndices;
+        pushed.filter->apply(selection, [chunk, width, &keys](uint32_t i, bool& hasNull) {
+            const CompactValue* row = chunk + i * width;
+            uint64_t h = kKeyHashSeed;
+            for (int idx : keys) {
+                hasNull |= row[idx].isNull();
+                h = combineKeyHash(h, hashValue(row[idx]));
             }
+            return h;
+        });
+    }
+    return compiled != nullptr;
+}
+
+void TableScanNode::noteCompiled() {
+    if (ranCompiled) return;
+    ranCompiled = true;
+    // A scan that started interpreted waited out the compile in the background
+    if (!startedCompiled) profile.jitCompileNanos += jit->getCompileNanos();
+}
+
+void TableScanNode::materialize(const Table::Block& block, const std::vector<uint32_t>& selection,
+                                RowBatch& batch) const {
+    // Phase 2: materialize the projected columns of qualifying rows
+    const size_t width = table.getColumns().size();
+    const CompactValue* chunk = block.getCells();
+    batch.rows.reserve(selection.size());
+    for (size_t i = 0; i < selection.size(); ++i) {
+        const CompactValue* row = chunk + selection[i] * width;
+        std::vector<Value>& out = batch.appendRow().values;
+        out.reserve(columnIndices.size());
+        for (int idx : columnIndices) {
+            out.push_back(row[idx].toValue());
+        }
+    }
+}
+
+size_t TableScanNode::workerCount() const {
+    size_t threads = parallelism > 0 ? parallelism : std::thread::hardware_concurrency();
+    return std::min(threads, partitions.size());
+}
+
+void TableScanNode::startParallelScan() {
+    parallel = std::make_unique<ParallelScan>();
+    ranParallel = true;
+    ParallelScan& scan = *parallel;
+    const size_t threads = workerCount();
+    scan.slots.resize(partitions.size());
+    scan.lookahead = 2 * threads;
+    for (size_t s = 0; s < partitions.size(); ++s) {
+        scan.slots[s].node = table.getHomeNode(partitions[s]);
+    }
+
+    std::shared_ptr<const NumaTopology> numa = NumaTopology::current();
+    auto work = [this, &scan, numa](size_t node) {
+        if (numa->getNodeCount() > 1) numa->pinThread(node);
+        std::vector<uint32_t> rows;
+        for (;;) {
+            size_t slot;
+            {
+                std::unique_lock<std::mutex> lock(scan.mutex);
+                scan.drained.wait(lock, [&scan] {
+                    return scan.stopping || scan.firstUnclaimed >= scan.slots.size() ||
+                           scan.firstUnclaimed < scan.current + scan.lookahead;
+                });
+                if (scan.stopping || scan.firstUnclaimed >= scan.slots.size()) return;
+                slot = scan.firstUnclaimed;
+                if (slot > scan.current) {
+                    const size_t end = std::min(scan.slots.size(), scan.current + scan.lookahead);
+                    for (size_t s = slot; s < end; ++s) {
+                        if (!scan.slots[s].claimed && scan.slots[s].node == node) {
+                            slot = s;
+                            break;
+                        }
+                    }
+                }
+                scan.slots[slot].claimed = true;
+                scan.slots[slot].local = scan.slots[slot].node == node;
+                while (scan.firstUnclaimed < scan.slots.size() && scan.slots[scan.firstUnclaimed].claimed) {
+                    scan.firstUnclaimed++;
+                }
+            }
+            std::vector<RowBatch> batches;
+            uint64_t rowsIn = 0;
+            bool compiled = false;
+            try {
+                const Table::Partition& partition = table.getPartition(partitions[slot]);
+                for (size_t b = 0; b < partition.getBlockCount(); ++b) {
+                    const uint64_t seed = blockSeed(partitions[slot], b);
+                    if (!blockSampled(seed)) continue;
+                    const Table::Block& block = partition.getBlock(b);
+                    rowsIn += block.getLiveCount();
+                    compiled |= selectRows(block, seed, rows, false);
+                    if (rows.empty()) continue;
+                    batches.emplace_back();
+                    materialize(block, rows, batches.back());
+                }
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(scan.mutex);
+                if (!scan.error) scan.error = std::current_exception();
+            }
+            {
+                std::lock_guard<std::mutex> lock(scan.mutex);
+                scan.slots[slot].batches = std::move(batches);
+                scan.slots[slot].rowsIn = rowsIn;
+                scan.slots[slot].compiled = compiled;
+                scan.slots[slot].done = true;
+            }
+            scan.filled.notify_all();
+        }
+    };
+    for (size_t t = 0; t < threads; ++t) {
+        scan.workers.emplace_back(work, t % numa->getNodeCount());
+    }
+}
+
+void TableScanNode::stopParallelScan() {
+    if (!parallel) return;
+    {
+        std::lock_guard<std::mutex> lock(parallel->mutex);
+        parallel->stopping = true;
+    }
+    parallel->drained.notify_all();
+    for (auto& worker : parallel->workers) {
+        worker.join();
+    }
+    parallel.reset();
+}
+
+bool TableScanNode::nextParallel(RowBatch& batch) {
+    ParallelScan& scan = *parallel;
+    {
+        std::unique_lock<std::mutex> lock(scan.mutex);
+        while (scan.current < scan.slots.size()) {
+            ParallelScan::Slot& slot = scan.slots[scan.current];
+            scan.filled.wait(lock, [&scan, &slot] { return slot.done || scan.error; });
+            if (scan.error) {
+                std::exception_ptr error = scan.error;
+                lock.unlock();
+                stopParallelScan();
+                pin.reset();
+                std::rethrow_exception(error);
+            }
+            if (scan.nextBatch == 0) {
+                profile.rowsIn += slot.rowsIn;
+                (slot.local ? profile.localMorsels : profile.remoteMorsels)++;
+                if (slot.compiled) noteCompiled();
+            }
+            if (scan.nextBatch < slot.batches.size()) {
+                batch.rows.swap(slot.batches[scan.nextBatch++].rows);
+                return true;
+            }
+            slot.batches.clear();
+            slot.batches.shrink_to_fit();
+            scan.current++;
+            scan.nextBatch = 0;
+            scan.drained.notify_all();
         }
-        std::cout << std::endl;
     }
+    stopParallelScan();
+    pin.reset();
+    return false;
+}
+
+std::string TableScanNode::getDetails() const {
+    std::string details = table.getName();
+    if (alias != table.getName()) {
+        details += " AS " + alias;
+    }
+    details += " [";
+    const auto& columns = table.getColumns();
+    for (size_t i = 0; i < columnIndices.size(); ++i) {
+        if (i > 0) details += ", ";
+        details += columns[columnIndices[i]].name;
+    }
+    details += "]";
+    if (!filter.empty()) {
+        details += " WHERE [" + filter.toString() + "]";
+    }
+    if (indexed) {
+        details += " TRIGRAM INDEX " + table.getTrigramIndexes()[indexSlot].name + " [";
+        for (size_t i = 0; i < indexLiterals.size(); ++i) {
+            if (i > 0) details += ", ";
+            details += "'" + indexLiterals[i] + "'";
+        }
+        details += "]";
+    }
+    for (const auto& pushed : runtimeFilters) {
+        details += " BLOOM [" + pushed.filter->toString() + "]";
+    }
+    if (table.isPartitioned()) {
+        details += " PARTITIONS [";
+        for (size_t i = 0; i < partitions.size(); ++i) {
+            if (i > 0) details += ", ";
+            details += std::to_string(partitions[i]);
+        }
+        details += "] of " + std::to_string(table.getPartitionCount());
+    }
+    if (sample.method != TableSample::NONE) {
+        std::ostringstream percent;
+        percent << sample.percent;
+        details += std::string(" SAMPLE ") + (sample.method == TableSample::SYSTEM ? "SYSTEM" : "BERNOULLI") +
+                   " (" + percent.str() + "%)";
+    }
+    return details;
+}
+
+bool TableScanNode::addRuntimeFilter(std::shared_ptr<RuntimeFilter> runtimeFilter) {
+    PushedRuntimeFilter pushed{runtimeFilter, {}};
+    for (const auto& column : runtimeFilter->columns) {
+        int output = findColumn(outputColumns, column);
+        if (output < 0) return false;
+        pushed.keyIndices.push_back(columnIndices[output]);
+    }
+    runtimeFilters.push_back(std::move(pushed));
+    return true;
 }
 
 const Table& TableScanNode::getTable() const { return table; }
 const std::vector<std::string>& TableScanNode::getSelectedColumns() const { return selectedColumns; }
 
-} // namespace parallaxdb 
\ No newline at end of file
+namespace {
+
+// A profiled operator's own share: its measurements minus its children's
+struct SelfProfile {
+    uint64_t rowsIn;
+    double wallNanos;
+    double cpuNanos;
+    uint64_t bytesAllocated;
+};
+
+SelfProfile selfProfile(const QueryPlanNode& node) {
+    const OperatorProfile& p = node.getProfile();
+    SelfProfile self{p.rowsIn, p.wallNanos, p.cpuNanos, p.bytesAllocated};
+    auto children = node.getChildren();
+    if (!children.empty()) self.rowsIn = 0;
+    for (const QueryPlanNode* child : children) {
+        const OperatorProfile& c = child->getProfile();
+        self.rowsIn += c.rowsOut;
+        self.wallNanos -= c.wallNanos;
+        self.cpuNanos -= c.cpuNanos;
+        self.bytesAllocated -= std::min(self.bytesAllocated, c.bytesAllocated);
+    }
+    self.wallNanos = std::max(0.0, self.wallNanos);
+    self.cpuNanos = std::max(0.0, self.cpuNanos);
+    return self;
+}
+
+std::string formatBytes(double bytes) {
+    std::ostringstream os;
+    os << std::fixed << std::setprecision(1);
+    if (bytes < 1024) {
+        os << std::setprecision(0) << bytes << "B";
+    } else if (bytes < 1024 * 1024) {
+        os << bytes / 1024 << "KB";
+    } else {
+        os << bytes / (1024 * 1024) << "MB";
+    }
+    return os.str();
+}
+
+std::string jsonString(const std::string& s) {
+    std::string out = "\"";
+    for (char c : s) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out += buf;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    return out + "\"";
+}
+
+void explainNode(const QueryPlanNode& node, int depth, std::ostringstream& os) {
+    os << std::string(depth * 2, ' ');
+    if (depth > 0) os << "-> ";
+    os << node.getName();
+    std::string details = node.getDetails();
+    if (!details.empty()) os << " " << details;
+    if (node.getEstimatedRows() >= 0) {
+        os << std::fixed << std::setprecision(2)
+           << "  (rows=" << node.getEstimatedRows() << " cost=" << node.getEstimatedCost() << ")";
+    }
+    if (node.isProfiling()) {
+        const OperatorProfile& p = node.getProfile();
+        SelfProfile self = selfProfile(node);
+        os << std::fixed << std::setprecision(3)
+           << "  [actual rows=" << p.rowsOut << " in=" << self.rowsIn << " batches=" << p.batches
+           << " time=" << self.wallNanos / 1e6 << "ms cpu=" << self.cpuNanos / 1e6 << "ms"
+           << " alloc=" << formatBytes(self.bytesAllocated) << " peak=" << formatBytes(p.peakBytes);
+        if (p.jitCompileNanos > 0) {
+            os << " jit=" << p.jitCompileNanos / 1e6 << "ms";
+        }
+        if (p.localMorsels + p.remoteMorsels > 0) {
+            os << " numa local=" << p.localMorsels << " remote=" << p.remoteMorsels;
+        }
+        os << "]";
+    }
+    os << "\n";
+    for (const QueryPlanNode* child : node.getChildren()) {
+        explainNode(*child, depth + 1, os);
+    }
+}
+
+void explainNodeJson(const QueryPlanNode& node, std::ostringstream& os) {
+    os << "{\"operator\": " << jsonString(node.getName())
+       << ", \"details\": " << jsonString(node.getDetails());
+    if (node.getEstimatedRows() >= 0) {
+        os << ", \"estimated_rows\": " << node.getEstimatedRows()
+           << ", \"estimated_cost\": " << node.getEstimatedCost();
+    }
+    if (node.isProfiling()) {
+        const OperatorProfile& p = node.getProfile();
+        SelfProfile self = selfProfile(node);
+        os << ", \"actual\": {\"rows_in\": " << self.rowsIn
+           << ", \"rows_out\": " << p.rowsOut
+           << ", \"batches\": " << p.batches
+           << ", \"wall_ms\": " << self.wallNanos / 1e6
+           << ", \"cpu_ms\": " << self.cpuNanos / 1e6
+           << ", \"bytes_allocated\": " << self.bytesAllocated
+           << ", \"peak_bytes\": " << p.peakBytes
+           << ", \"jit_compile_ms\": " << p.jitCompileNanos / 1e6
+           << ", \"local_morsels\": " << p.localMorsels
+           << ", \"remote_morsels\": " << p.remoteMorsels << "}";
+    }
+    os << ", \"children\": [";
+    auto children = node.getChildren();
+    for (size_t i = 0; i < children.size(); ++i) {
+        if (i > 0) os << ", ";
+        explainNodeJson(*children[i], os);
+    }
+    os << "]}";
+}
+
+} // namespace
+
+std::string explainPlan(const QueryPlanNode& plan) {
+    std::ostringstream os;
+    explainNode(plan, 0, os);
+    return os.str();
+}
+
+std::string explainPlanJson(const QueryPlanNode& plan) {
+    std::ostringstream os;
+    os << std::setprecision(6);
+    explainNodeJson(plan, os);
+    return os.str();
+}
+
+} // namespace parallaxdb
@@ -0,0 +1,50 @@
+#include "../../include/planner/SelectivityEstimator.hpp"
+#include <algorithm>
+
+namespace parallaxdb {
+
+double SelectivityEstimator::estimate(const Expression& expr, const Table& table) {
+    if (auto cmp = dynamic_cast<const ComparisonExpr*>(&expr)) {
+        int index = table.getColumnIndex(cmp->column);
+        size_t dot = cmp->column.rfind('.');
+        if (index < 0 && dot != std::string::npos) {
+            index = table.getColumnIndex(cmp->column.substr(dot + 1));
+        }
+        const TableStatistics& stats = table.getStatistics();
+        if (index < 0 || static_cast<size_t>(index) >= stats.getColumnCount()) {
+            return kDefaultSelectivity;
+        }
+        return stats.getColumn(index).estimateSelectivity(cmp->op, cmp->value);
+    }
+    if (auto in = dynamic_cast<const InListExpr*>(&expr)) {
+        // Disjoint equalities
+        double selectivity = 0.0;
+        for (const auto& value : in->values) {
+            selectivity += estimate(ComparisonExpr(in->column, "=", value), table);
+        }
+        return std::min(1.0, selectivity);
+    }
+    if (auto pattern = dynamic_cast<const PatternExpr*>(&expr)) {
+        // A LIKE without wildcards is an equality; other patterns are guessed
+        double selectivity = kDefaultSelectivity;
+        if (pattern->op == PatternOp::LIKE && pattern->matcher.getStrategy() == PatternMatcher::Strategy::EXACT &&
+            pattern->pattern.find('\\') == std::string::npos) {
+            selectivity = estimate(ComparisonExpr(pattern->column, "=", pattern->pattern), table);
+        }
+        return pattern->negated ? 1.0 - selectivity : selectivity;
+    }
+    if (auto logical = dynamic_cast<const LogicalExpr*>(&expr)) {
+        double left = estimate(*logical->left, table);
+        double right = estimate(*logical->right, table);
+        // Assume independence between predicates
+        if (logical->op == "AND") return left * right;
+        if (logical->op == "OR") return left + right - left * right;
+        return kDefaultSelectivity;
+    }
+    if (auto paren = dynamic_cast<const ParenExpr*>(&expr)) {
+        return estimate(*paren->expr, table);
+    }
+    return kDefaultSelectivity;
+}
+
+} // namespace parallaxdb
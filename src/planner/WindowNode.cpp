@@ -0,0 +1,380 @@
+#include "../../include/planner/WindowNode.hpp"
+#include "../../include/storage/Statistics.hpp"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+namespace parallaxdb {
+
+namespace {
+
+struct FrameSummary {
+    int64_t count = 0;            // Non-NULL values
+    double sum = 0.0;
+    const Value* min = nullptr;
+    const Value* max = nullptr;
+};
+
+// `row + offset` with the offset clamped to just past a partition of `m`
+// rows on either side, so huge ROWS and LAG/LEAD offsets cannot overflow
+int64_t offsetRow(size_t row, int64_t offset, size_t m) {
+    const int64_t limit = static_cast<int64_t>(m) + 1;
+    return static_cast<int64_t>(row) + std::clamp(offset, -limit, limit);
+}
+
+// Segment tree over one partition's argument values in sort order; answers
+// COUNT / SUM / MIN / MAX of any contiguous range in O(log n)
+class FrameTree {
+public:
+    FrameTree(const std::vector<const Value*>& values, bool extremes) : n(values.size()), extremes(extremes) {
+        nodes.resize(2 * n);
+        for (size_t i = 0; i < n; ++i) {
+            FrameSummary& leaf = nodes[n + i];
+            if (!values[i]) continue;
+            leaf.count = 1;
+            toNumeric(*values[i], leaf.sum);
+            leaf.min = leaf.max = values[i];
+        }
+        for (size_t i = n - 1; i > 0; --i) {
+            nodes[i] = combine(nodes[2 * i], nodes[2 * i + 1]);
+        }
+    }
+
+    // Summary of positions [lo, hi)
+    FrameSummary query(size_t lo, size_t hi) const {
+        FrameSummary result;
+        for (lo += n, hi += n; lo < hi; lo /= 2, hi /= 2) {
+            if (lo & 1) result = combine(result, nodes[lo++]);
+            if (hi & 1) result = combine(result, nodes[--hi]);
+        }
+        return result;
+    }
+
+private:
+    size_t n;
+    bool extremes;   // Whether MIN / MAX are needed; comparing values is the costly part
+    std::vector<FrameSummary> nodes;
+
+    FrameSummary combine(const FrameSummary& a, const FrameSummary& b) const {
+        FrameSummary result{a.count + b.count, a.sum + b.sum, a.min, a.max};
+        if (extremes && b.count > 0) {
+            if (!result.min || compareValues(*b.min, *result.min) < 0) result.min = b.min;
+            if (!result.max || compareValues(*b.max, *result.max) > 0) result.max = b.max;
+        }
+        return result;
+    }
+};
+
+std::string orderingKey(const WindowSpec& spec) {
+    std::string key;
+    for (const auto& column : spec.partitionBy) {
+        key += column + ',';
+    }
+    key += '|';
+    for (const auto& sortKey : spec.orderBy) {
+        key += sortKey.column + (sortKey.descending ? "-," : "+,");
+    }
+    return key;
+}
+
+std::string frameBound(int64_t offset) {
+    if (offset == WindowFrame::kUnboundedPreceding) return "UNBOUNDED PRECEDING";
+    if (offset == WindowFrame::kUnboundedFollowing) return "UNBOUNDED FOLLOWING";
+    if (offset == 0) return "CURRENT ROW";
+    return offset < 0 ? std::to_string(-offset) + " PRECEDING" : std::to_string(offset) + " FOLLOWING";
+}
+
+std::string describe(const WindowSpec& spec) {
+    std::ostringstream os;
+    switch (spec.function) {
+        case WindowFunction::ROW_NUMBER: os << "ROW_NUMBER()"; break;
+        case WindowFunction::RANK: os << "RANK()"; break;
+        case WindowFunction::DENSE_RANK: os << "DENSE_RANK()"; break;
+        case WindowFunction::LAG:
+        case WindowFunction::LEAD:
+            os << (spec.function == WindowFunction::LAG ? "LAG(" : "LEAD(") << spec.source << ", " << spec.offset << ")";
+            break;
+        case WindowFunction::AGGREGATE:
+            os << aggregateName(spec.aggregate) << "(" << (spec.source.empty() ? "*" : spec.source) << ")";
+            break;
+    }
+    os << " OVER (";
+    const char* separator = "";
+    if (!spec.partitionBy.empty()) {
+        os << "PARTITION BY ";
+        for (size_t i = 0; i < spec.partitionBy.size(); ++i) {
+            os << (i > 0 ? ", " : "") << spec.partitionBy[i];
+        }
+        separator = " ";
+    }
+    if (!spec.orderBy.empty()) {
+        os << separator << "ORDER BY ";
+        for (size_t i = 0; i < spec.orderBy.size(); ++i) {
+            os << (i > 0 ? ", " : "") << spec.orderBy[i].column << (spec.orderBy[i].descending ? " DESC" : "");
+        }
+        separator = " ";
+    }
+    if (spec.function == WindowFunction::AGGREGATE) {
+        os << separator << "ROWS BETWEEN " << frameBound(spec.frame.start) << " AND " << frameBound(spec.frame.end);
+    }
+    os << ")";
+    return os.str();
+}
+
+} // namespace
+
+WindowNode::WindowNode(std::unique_ptr<QueryPlanNode> child, const std::vector<WindowSpec>& windows)
+    : child(std::move(child)), windows(windows) {
+    outputColumns = this->child->getOutputColumns();
+    auto resolve = [this](const std::string& name) {
+        int idx = findColumn(this->child->getOutputColumns(), name);
+        if (idx < 0) {
+            throw std::runtime_error("Unknown column: " + name);
+        }
+        return idx;
+    };
+    for (const auto& spec : windows) {
+        Resolved r;
+        if (!spec.source.empty()) r.source = resolve(spec.source);
+        for (const auto& column : spec.partitionBy) {
+            r.partitionBy.push_back(resolve(column));
+        }
+        for (const auto& key : spec.orderBy) {
+            r.orderBy.push_back(resolve(key.column));
+            r.descending.push_back(key.descending);
+        }
+        resolved.push_back(std::move(r));
+        outputColumns.push_back(spec.name);
+    }
+}
+
+std::vector<std::vector<size_t>> WindowNode::partitionRows(const Resolved& spec) {
+    std::vector<std::vector<size_t>> partitions;
+    if (spec.partitionBy.empty()) {
+        partitions.emplace_back(rows.size());
+        for (size_t r = 0; r < rows.size(); ++r) {
+            partitions[0][r] = r;
+        }
+        return partitions;
+    }
+    std::unordered_map<std::string, size_t> index;
+    std::string key;
+    for (size_t r = 0; r < rows.size(); ++r) {
+        key.clear();
+        for (int idx : spec.partitionBy) {
+            appendGroupKey(key, CompactValue::borrow(rows[r].values[idx]));
+        }
+        auto [it, inserted] = index.try_emplace(key, partitions.size());
+        if (inserted) partitions.emplace_back();
+        partitions[it->second].push_back(r);
+    }
+    return partitions;
+}
+
+void WindowNode::evaluate(size_t w, const std::vector<size_t>& partition) {
+    const WindowSpec& spec = windows[w];
+    const Resolved& r = resolved[w];
+    const size_t slot = child->getOutputColumns().size() + w;
+    const size_t m = partition.size();
+    if (m == 0) return;
+    auto peers = [this, &r](size_t a, size_t b) {
+        for (int idx : r.orderBy) {
+            if (compareValues(rows[a].values[idx], rows[b].values[idx]) != 0) return false;
+        }
+        return true;
+    };
+
+    switch (spec.function) {
+        case WindowFunction::ROW_NUMBER:
+            for (size_t i = 0; i < m; ++i) {
+                rows[partition[i]].values[slot] = static_cast<int>(i + 1);
+            }
+            return;
+        case WindowFunction::RANK:
+        case WindowFunction::DENSE_RANK: {
+            int rank = 0;
+            for (size_t i = 0; i < m; ++i) {
+                if (i == 0 || !peers(partition[i - 1], partition[i])) {
+                    rank = spec.function == WindowFunction::RANK ? static_cast<int>(i + 1) : rank + 1;
+                }
+                rows[partition[i]].values[slot] = rank;
+            }
+            return;
+        }
+        case WindowFunction::LAG:
+        case WindowFunction::LEAD: {
+            const int64_t step = spec.function == WindowFunction::LAG ? -spec.offset : spec.offset;
+            for (size_t i = 0; i < m; ++i) {
+                int64_t other = offsetRow(i, step, m);
+                rows[partition[i]].values[slot] = other >= 0 && other < static_cast<int64_t>(m)
+                    ? rows[partition[other]].values[r.source] : spec.defaultValue;
+            }
+            return;
+        }
+        case WindowFunction::AGGREGATE:
+            break;
+    }
+
+    // COUNT(*) counts every row, so each position gets a non-NULL stand-in
+    static const Value kRow = 1;
+    std::vector<const Value*> values(m);
+    for (size_t i = 0; i < m; ++i) {
+        if (r.source < 0) {
+            values[i] = &kRow;
+        } else {
+            const Value& value = rows[partition[i]].values[r.source];
+            values[i] = std::holds_alternative<std::nullptr_t>(value) ? nullptr : &value;
+        }
+    }
+    const bool extremes = spec.aggregate == AggregateFunction::MIN || spec.aggregate == AggregateFunction::MAX;
+    FrameTree tree(values, extremes);
+    for (size_t i = 0; i < m; ++i) {
+        int64_t lo = spec.frame.start == WindowFrame::kUnboundedPreceding
+            ? 0 : std::max<int64_t>(0, offsetRow(i, spec.frame.start, m));
+        int64_t hi = spec.frame.end == WindowFrame::kUnboundedFollowing
+            ? static_cast<int64_t>(m) : std::min<int64_t>(static_cast<int64_t>(m), offsetRow(i, spec.frame.end, m) + 1);
+        FrameSummary frame = lo < hi ? tree.query(lo, hi) : FrameSummary{};
+        Value& result = rows[partition[i]].values[slot];
+        switch (spec.aggregate) {
+            case AggregateFunction::COUNT:
+                result = static_cast<int>(frame.count);
+                break;
+            case AggregateFunction::SUM:
+                result = frame.count > 0 ? Value(frame.sum) : Value(nullptr);
+                break;
+            case AggregateFunction::AVG:
+                result = frame.count > 0 ? Value(frame.sum / frame.count) : Value(nullptr);
+                break;
+            case AggregateFunction::MIN:
+                result = frame.min ? *frame.min : Value(nullptr);
+                break;
+            case AggregateFunction::MAX:
+                result = frame.max ? *frame.max : Value(nullptr);
+                break;
+            default:
+                throw std::runtime_error(std::string(aggregateName(spec.aggregate)) + " is not a window function");
+        }
+    }
+}
+
+void WindowNode::doOpen() {
+    rows.clear();
+    outputOrder.clear();
+    emitted = 0;
+    ranParallel = false;
+
+    child->open();
+    while (child->next(input)) {
+        for (auto& row : input.rows) {
+            rows.push_back(std::move(row));
+        }
+    }
+    input.clear();
+    const size_t width = child->getOutputColumns().size();
+    for (auto& row : rows) {
+        row.values.resize(width + windows.size(), Value(nullptr));
+    }
+
+    std::vector<bool> done(windows.size(), false);
+    for (size_t w = 0; w < windows.size(); ++w) {
+        if (done[w]) continue;
+        // Every function with this ordering is evaluated over the same partitions
+        const std::string key = orderingKey(windows[w]);
+        std::vector<size_t> group;
+        for (size_t other = w; other < windows.size(); ++other) {
+            if (!done[other] && orderingKey(windows[other]) == key) {
+                group.push_back(other);
+                done[other] = true;
+            }
+        }
+        const Resolved& spec = resolved[w];
+        std::vector<std::vector<size_t>> partitions = partitionRows(spec);
+
+        auto process = [this, &spec, &group](std::vector<size_t>& partition) {
+            std::stable_sort(partition.begin(), partition.end(), [this, &spec](size_t a, size_t b) {
+                for (size_t k = 0; k < spec.orderBy.size(); ++k) {
+                    int c = compareValues(rows[a].values[spec.orderBy[k]], rows[b].values[spec.orderBy[k]]);
+                    if (c != 0) return spec.descending[k] ? c > 0 : c < 0;
+                }
+                return false;
+            });
+            for (size_t member : group) {
+                evaluate(member, partition);
+            }
+        };
+
+        size_t threads = parallelism > 0 ? parallelism : std::thread::hardware_concurrency();
+        threads = std::min(threads, partitions.size());
+        if (rows.size() >= kParallelSortRows && threads > 1) {
+            // Partitions own disjoint rows, so workers never write the same cell
+            ranParallel = true;
+            std::atomic<size_t> next{0};
+            std::exception_ptr error;
+            std::mutex errorMutex;
+            std::vector<std::thread> workers;
+            for (size_t t = 0; t < threads; ++t) {
+                workers.emplace_back([&] {
+                    for (size_t p = next++; p < partitions.size(); p = next++) {
+                        try {
+                            process(partitions[p]);
+                        } catch (...) {
+                            std::lock_guard<std::mutex> lock(errorMutex);
+                            if (!error) error = std::current_exception();
+                        }
+                    }
+                });
+            }
+            for (auto& worker : workers) {
+                worker.join();
+            }
+            if (error) std::rethrow_exception(error);
+        } else {
+            for (auto& partition : partitions) {
+                process(partition);
+            }
+        }
+
+        if (w == 0) {
+            outputOrder.reserve(rows.size());
+            for (const auto& partition : partitions) {
+                outputOrder.insert(outputOrder.end(), partition.begin(), partition.end());
+            }
+        }
+    }
+    if (windows.empty()) {
+        for (size_t r = 0; r < rows.size(); ++r) {
+            outputOrder.push_back(r);
+        }
+    }
+}
+
+bool WindowNode::doNext(RowBatch& batch) {
+    batch.clear();
+    if (emitted >= outputOrder.size()) {
+        rows.clear();
+        rows.shrink_to_fit();
+        return false;
+    }
+    size_t end = std::min(outputOrder.size(), emitted + RowBatch::kDefaultCapacity);
+    batch.rows.reserve(end - emitted);
+    for (; emitted < end; ++emitted) {
+        batch.appendRow().values = std::move(rows[outputOrder[emitted]].values);
+    }
+    return true;
+}
+
+std::string WindowNode::getDetails() const {
+    std::string details = "[";
+    for (size_t i = 0; i < windows.size(); ++i) {
+        if (i > 0) details += ", ";
+        details += describe(windows[i]) + " AS " + windows[i].name;
+    }
+    return details + "]";
+}
+
+} // namespace parallaxdb
@@ -0,0 +1,309 @@
+#include "../../include/storage/AsyncIO.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace parallaxdb {
+
+namespace {
+
+unsigned loadAcquire(const unsigned* p) {
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+void storeRelease(unsigned* p, unsigned value) {
+    __atomic_store_n(p, value, __ATOMIC_RELEASE);
+}
+
+} // namespace
+
+// The submission and completion rings shared with the kernel. Created
+// without liburing, straight from the io_uring system calls.
+struct AsyncIO::Ring {
+    int fd = -1;
+    void* sqMap = MAP_FAILED;
+    size_t sqMapSize = 0;
+    void* cqMap = MAP_FAILED;
+    size_t cqMapSize = 0;
+    io_uring_sqe* sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+    size_t sqesSize = 0;
+
+    unsigned* sqTail = nullptr;
+    unsigned sqMask = 0;
+    unsigned* sqArray = nullptr;
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned cqMask = 0;
+    io_uring_cqe* cqes = nullptr;
+
+    ~Ring() {
+        if (sqes != MAP_FAILED) munmap(sqes, sqesSize);
+        if (cqMap != MAP_FAILED && cqMap != sqMap) munmap(cqMap, cqMapSize);
+        if (sqMap != MAP_FAILED) munmap(sqMap, sqMapSize);
+        if (fd >= 0) close(fd);
+    }
+
+    // Null if the kernel does not offer io_uring or forbids it
+    static std::unique_ptr<Ring> create(unsigned entries) {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        auto ring = std::make_unique<Ring>();
+        ring->fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (ring->fd < 0) return nullptr;
+        // IORING_OP_READ/WRITE and reads at the file position arrived with
+        // Linux 5.6, which also has the single-mmap layout used here
+        const unsigned required = IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | IORING_FEAT_RW_CUR_POS;
+        if ((params.features & required) != required) {
+            return nullptr;
+        }
+        ring->sqMapSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        ring->cqMapSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        ring->sqMapSize = ring->cqMapSize = std::max(ring->sqMapSize, ring->cqMapSize);
+        ring->sqMap = mmap(nullptr, ring->sqMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                           ring->fd, IORING_OFF_SQ_RING);
+        if (ring->sqMap == MAP_FAILED) return nullptr;
+        ring->cqMap = ring->sqMap;
+        ring->sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        ring->sqes = static_cast<io_uring_sqe*>(mmap(nullptr, ring->sqesSize, PROT_READ | PROT_WRITE,
+                                                     MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES));
+        if (ring->sqes == MAP_FAILED) return nullptr;
+
+        char* sq = static_cast<char*>(ring->sqMap);
+        ring->sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        ring->sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        ring->sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        char* cq = static_cast<char*>(ring->cqMap);
+        ring->cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        ring->cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        ring->cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        ring->cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        return ring;
+    }
+
+    void push(const Request& request) {
+        const unsigned tail = *sqTail;
+        const unsigned index = tail & sqMask;
+        io_uring_sqe& sqe = sqes[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = request.isWrite ? IORING_OP_WRITE : IORING_OP_READ;
+        sqe.fd = request.fd;
+        sqe.addr = reinterpret_cast<uint64_t>(request.buffer);
+        sqe.len = static_cast<uint32_t>(request.length);
+        sqe.off = request.offset;   // ~0 is the file position, as kCurrentPosition
+        sqe.user_data = request.ticket;
+        sqArray[index] = index;
+        storeRelease(sqTail, tail + 1);
+    }
+
+    // Submits `count` pushed entries and, with `wait`, blocks for a completion
+    void enter(unsigned count, bool wait) {
+        for (;;) {
+            long done = syscall(__NR_io_uring_enter, fd, count, wait ? 1u : 0u,
+                                wait ? IORING_ENTER_GETEVENTS : 0u, nullptr, 0);
+            if (done >= 0) {
+                count -= static_cast<unsigned>(done);
+                if (count == 0) return;
+                continue;
+            }
+            if (errno == EINTR) continue;
+            throw std::runtime_error(std::string("io_uring_enter failed: ") + std::strerror(errno));
+        }
+    }
+};
+
+// Fallback: worker threads running blocking pread()/pwrite() calls
+struct AsyncIO::Pool {
+    std::mutex mutex;
+    std::condition_variable work;
+    std::condition_variable done;
+    std::deque<Request> pending;
+    std::vector<std::pair<Ticket, int64_t>> completed;
+    bool stopping = false;
+    std::vector<std::thread> workers;
+
+    explicit Pool(size_t threads) {
+        for (size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([this] { run(); });
+        }
+    }
+
+    ~Pool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        work.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    static int64_t perform(const Request& request) {
+        for (;;) {
+            ssize_t n;
+            const bool atPosition = request.offset == kCurrentPosition;
+            const off_t offset = static_cast<off_t>(request.offset);
+            if (request.isWrite) {
+                n = atPosition ? ::write(request.fd, request.buffer, request.length)
+                               : pwrite(request.fd, request.buffer, request.length, offset);
+            } else {
+                n = atPosition ? ::read(request.fd, request.buffer, request.length)
+                               : pread(request.fd, request.buffer, request.length, offset);
+            }
+            if (n >= 0) return n;
+            if (errno != EINTR) return -errno;
+        }
+    }
+
+    void run() {
+        for (;;) {
+            Request request;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                work.wait(lock, [this] { return stopping || !pending.empty(); });
+                if (pending.empty()) return;
+                request = pending.front();
+                pending.pop_front();
+            }
+            const int64_t result = perform(request);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                completed.emplace_back(request.ticket, result);
+            }
+            done.notify_one();
+        }
+    }
+};
+
+AsyncIO::AsyncIO(size_t queueDepth, Backend preferred) : queueDepth(std::max<size_t>(queueDepth, 1)) {
+    if (preferred == Backend::IO_URING) {
+        ring = Ring::create(static_cast<unsigned>(this->queueDepth));
+    }
+    if (!ring) {
+        pool = std::make_unique<Pool>(std::min(this->queueDepth, kPoolThreads));
+    }
+    queued.reserve(this->queueDepth);
+}
+
+AsyncIO::~AsyncIO() {
+    try {
+        drain();
+    } catch (const std::exception&) {
+        // Destructors must not throw; the requests are abandoned either way
+    }
+}
+
+AsyncIO::Ticket AsyncIO::read(int fd, void* buffer, size_t length, uint64_t offset) {
+    return enqueue({0, fd, false, buffer, length, offset});
+}
+
+AsyncIO::Ticket AsyncIO::write(int fd, const void* buffer, size_t length, uint64_t offset) {
+    return enqueue({0, fd, true, const_cast<void*>(buffer), length, offset});
+}
+
+AsyncIO::Ticket AsyncIO::enqueue(Request request) {
+    if (request.length > UINT32_MAX) {
+        throw std::runtime_error("Asynchronous I/O requests are limited to 4 GiB");
+    }
+    if (inFlight + queued.size() >= queueDepth) {
+        // Let half the queue drain, so the requests that follow still go out in batches
+        submit();
+        while (inFlight > queueDepth / 2) {
+            reap(true);
+        }
+    }
+    request.ticket = nextTicket++;
+    queued.push_back(request);
+    return request.ticket;
+}
+
+void AsyncIO::submit() {
+    if (queued.empty()) return;
+    submitCount++;
+    if (ring) {
+        for (const Request& request : queued) {
+            ring->push(request);
+        }
+        const unsigned count = static_cast<unsigned>(queued.size());
+        inFlight += queued.size();
+        queued.clear();
+        ring->enter(count, false);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        pool->pending.insert(pool->pending.end(), queued.begin(), queued.end());
+    }
+    inFlight += queued.size();
+    queued.clear();
+    pool->work.notify_all();
+}
+
+void AsyncIO::reap(bool block) {
+    if (inFlight == 0) return;
+    if (ring) {
+        unsigned head = *ring->cqHead;
+        unsigned tail = loadAcquire(ring->cqTail);
+        if (head == tail && block) {
+            ring->enter(0, true);
+            tail = loadAcquire(ring->cqTail);
+        }
+        for (; head != tail; ++head) {
+            const io_uring_cqe& cqe = ring->cqes[head & ring->cqMask];
+            results[cqe.user_data] = cqe.res;
+            inFlight--;
+        }
+        storeRelease(ring->cqHead, head);
+        return;
+    }
+    std::unique_lock<std::mutex> lock(pool->mutex);
+    if (block) {
+        pool->done.wait(lock, [this] { return !pool->completed.empty(); });
+    }
+    for (const auto& entry : pool->completed) {
+        results[entry.first] = entry.second;
+    }
+    inFlight -= pool->completed.size();
+    pool->completed.clear();
+}
+
+size_t AsyncIO::wait(Ticket ticket) {
+    if (ticket == 0 || ticket >= nextTicket) {
+        throw std::runtime_error("Unknown I/O request " + std::to_string(ticket));
+    }
+    submit();
+    auto it = results.find(ticket);
+    while (it == results.end()) {
+        if (inFlight == 0) {
+            throw std::runtime_error("I/O request " + std::to_string(ticket) + " was already waited for");
+        }
+        reap(true);
+        it = results.find(ticket);
+    }
+    const int64_t result = it->second;
+    results.erase(it);
+    if (result < 0) {
+        throw std::runtime_error(std::strerror(static_cast<int>(-result)));
+    }
+    return static_cast<size_t>(result);
+}
+
+void AsyncIO::drain() {
+    submit();
+    while (inFlight > 0) {
+        reap(true);
+    }
+    results.clear();
+}
+
+} // namespace parallaxdb
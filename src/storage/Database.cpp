@@ -3,6 +3,10 @@
 
 namespace parallaxdb {
 
+Database::~Database() {
+    stopCompaction();
+}
+
 void Database::createTable(const std::string& tableName, const Schema& schema) {
     if (tableExists(tableName)) {
         throw std::runtime_error("Table '" + tableName + "' already exists");
@@ -10,17 +14,65 @@ void Database::createTable(const std::string& tableName, const Schema& schema) {
     
     Schema newSchema = schema;
     newSchema.tableName = tableName;
-    tables[tableName] = std::make_unique<Table>(tableName, newSchema);
+    auto table = std::make_unique<Table>(tableName, newSchema);
+    std::lock_guard<std::mutex> lock(catalogMutex);
+    tables[tableName] = std::move(table);
 }
 
 void Database::dropTable(const std::string& tableName) {
     if (!tableExists(tableName)) {
         throw std::runtime_error("Table '" + tableName + "' does not exist");
     }
+    for (const auto& entry : views) {
+        if (entry.second->getDefinition().baseTable == tableName) {
+            throw std::runtime_error("Table '" + tableName + "' is used by materialized view '" +
+                                     entry.first + "'");
+        }
+    }
     
+    std::lock_guard<std::mutex> lock(catalogMutex);
+    views.erase(tableName);
     tables.erase(tableName);
 }
 
+void Database::createMaterializedView(const std::string& viewName, ViewDefinition definition) {
+    if (tableExists(viewName)) {
+        throw std::runtime_error("Table '" + viewName + "' already exists");
+    }
+    Table* base = getTable(definition.baseTable);
+    if (!base) {
+        throw std::runtime_error("Table '" + definition.baseTable + "' does not exist");
+    }
+    if (definition.columns.empty()) {
+        for (const auto& column : base->getColumns()) {
+            definition.columns.push_back({column.name, column.name, AggregateFunction::NONE});
+        }
+    }
+    
+    Schema schema = MaterializedView::outputSchema(viewName, definition, *base);
+    auto table = std::make_unique<Table>(viewName, schema);
+    auto view = std::make_unique<MaterializedView>(std::move(definition), *base, *table);
+    std::lock_guard<std::mutex> lock(catalogMutex);
+    tables[viewName] = std::move(table);
+    views[viewName] = std::move(view);
+}
+
+const MaterializedView* Database::getMaterializedView(const std::string& name) const {
+    auto it = views.find(name);
+    return (it != views.end()) ? it->second.get() : nullptr;
+}
+
+Table& Database::writableTable(const std::string& tableName) {
+    Table* table = getTable(tableName);
+    if (!table) {
+        throw std::runtime_error("Table '" + tableName + "' does not exist");
+    }
+    if (isMaterializedView(tableName)) {
+        throw std::runtime_error("'" + tableName + "' is a materialized view and cannot be modified");
+    }
+    return *table;
+}
+
 bool Database::tableExists(const std::string& tableName) const {
     return tables.find(tableName) != tables.end();
 }
@@ -46,21 +98,98 @@ const Schema* Database::getSchema(const std::string& tableName) const {
 }
 
 void Database::insertInto(const std::string& tableName, const Row& row) {
+    writableTable(tableName).insertRow(row);
+}
+
+void Database::insertInto(const std::string& tableName, const std::vector<Value>& values) {
+    writableTable(tableName).insertRow(values);
+}
+
+void Database::insertRowsInto(const std::string& tableName, const std::vector<Row>& rows) {
+    writableTable(tableName).insertRows(rows);
+}
+
+size_t Database::deleteFrom(const std::string& tableName, const std::function<bool(const CompactValue*)>& match) {
+    size_t deleted = writableTable(tableName).deleteWhere(match);
+    if (deleted > 0) requestCompaction();
+    return deleted;
+}
+
+void Database::createIndex(const std::string& tableName, const std::string& indexName, const std::string& column) {
+    // Views may be indexed too: their refreshes go through the same table writes
     Table* table = getTable(tableName);
     if (!table) {
         throw std::runtime_error("Table '" + tableName + "' does not exist");
     }
-    
-    table->insertRow(row);
+    table->createTrigramIndex(indexName, column);
 }
 
-void Database::insertInto(const std::string& tableName, const std::vector<Value>& values) {
+size_t Database::dropPartition(const std::string& tableName, size_t partition) {
+    Table& table = writableTable(tableName);
+    if (!table.isPartitioned()) {
+        throw std::runtime_error("Table '" + tableName + "' is not partitioned");
+    }
+    return table.dropPartition(partition);
+}
+
+size_t Database::updateTable(const std::string& tableName, const std::function<bool(const CompactValue*)>& match,
+                             const std::vector<std::pair<size_t, Value>>& assignments) {
+    size_t updated = writableTable(tableName).updateWhere(match, assignments);
+    if (updated > 0) requestCompaction();
+    return updated;
+}
+
+void Database::startCompaction(std::chrono::milliseconds interval) {
+    if (compactionThread.joinable()) return;
+    compactionStop = false;
+    compactionThread = std::thread([this, interval] {
+        std::unique_lock<std::mutex> lock(catalogMutex);
+        while (!compactionStop) {
+            compactionWake.wait_for(lock, interval, [this] { return compactionStop || compactionPending; });
+            if (compactionStop) break;
+            compactionPending = false;
+            for (auto& entry : tables) {
+                entry.second->compact();
+            }
+        }
+    });
+}
+
+void Database::stopCompaction() {
+    if (!compactionThread.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(catalogMutex);
+        compactionStop = true;
+    }
+    compactionWake.notify_one();
+    compactionThread.join();
+}
+
+size_t Database::compactAll() {
+    std::lock_guard<std::mutex> lock(catalogMutex);
+    size_t reclaimed = 0;
+    for (auto& entry : tables) {
+        reclaimed += entry.second->compact();
+    }
+    return reclaimed;
+}
+
+void Database::requestCompaction() {
+    startCompaction();
+    {
+        std::lock_guard<std::mutex> lock(catalogMutex);
+        compactionPending = true;
+    }
+    compactionWake.notify_one();
+}
+
+void Database::analyzeTable(const std::string& tableName) {
     Table* table = getTable(tableName);
     if (!table) {
         throw std::runtime_error("Table '" + tableName + "' does not exist");
     }
     
-    table->insertRow(values);
+    table->analyze();
 }
 
 std::vector<std::string> Database::getTableNames() const {
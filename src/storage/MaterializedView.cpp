@@ -0,0 +1,193 @@
+#include "../../include/storage/MaterializedView.hpp"
+#include <algorithm>
+
+namespace parallaxdb {
+
+Schema MaterializedView::outputSchema(const std::string& name, const ViewDefinition& definition, const Table& base) {
+    Schema schema(name);
+    for (const auto& groupColumn : definition.groupBy) {
+        if (base.getColumnIndex(groupColumn) < 0) {
+            throw std::runtime_error("Unknown GROUP BY column '" + groupColumn + "' in table " + base.getName());
+        }
+    }
+    for (const auto& column : definition.columns) {
+        for (const auto& other : schema.columns) {
+            if (other.name == column.name) {
+                throw std::runtime_error("Duplicate column '" + column.name + "' in view " + name);
+            }
+        }
+        if (column.function == AggregateFunction::COUNT && column.source.empty()) {
+            schema.columns.push_back({column.name, DataType::INT});
+            continue;
+        }
+        const Column* source = base.getColumn(column.source);
+        if (!source) {
+            throw std::runtime_error("Unknown column '" + column.source + "' in table " + base.getName());
+        }
+        if (column.function == AggregateFunction::NONE && definition.isAggregate() &&
+            std::find(definition.groupBy.begin(), definition.groupBy.end(), column.source) ==
+                definition.groupBy.end()) {
+            throw std::runtime_error("Column '" + column.source + "' must appear in GROUP BY or be aggregated");
+        }
+        schema.columns.push_back({column.name, aggregateType(column, source->type)});
+    }
+    if (schema.columns.empty()) {
+        throw std::runtime_error("View " + name + " has no columns");
+    }
+    return schema;
+}
+
+MaterializedView::MaterializedView(ViewDefinition def, Table& base, Table& target)
+    : definition(std::move(def)), base(base), target(target) {
+    for (const auto& name : definition.groupBy) {
+        groupColumns.push_back(base.getColumnIndex(name));
+    }
+    for (const auto& column : definition.columns) {
+        sources.push_back(column.source.empty() ? -1 : base.getColumnIndex(column.source));
+        int slot = -1;
+        if (column.function == AggregateFunction::NONE) {
+            auto it = std::find(definition.groupBy.begin(), definition.groupBy.end(), column.source);
+            if (it != definition.groupBy.end()) slot = static_cast<int>(it - definition.groupBy.begin());
+        }
+        keySlots.push_back(slot);
+    }
+    if (definition.where) {
+        std::vector<std::string> columns;
+        for (const auto& column : base.getColumns()) {
+            columns.push_back(base.getName() + "." + column.name);
+        }
+        definition.where->bind(columns);
+    }
+    refresh();
+    base.addObserver(this);
+}
+
+MaterializedView::~MaterializedView() {
+    base.removeObserver(this);
+}
+
+void MaterializedView::onAppend(const Table&, const CompactValue* rows, size_t count) {
+    const size_t width = base.getColumns().size();
+    for (size_t r = 0; r < count; ++r) {
+        accumulate(rows + r * width);
+    }
+    flush();
+}
+
+void MaterializedView::onModify(const Table&) {
+    refresh();
+}
+
+void MaterializedView::refresh() {
+    target.truncate();
+    groups.clear();
+    groupIndex.clear();
+    touched.clear();
+    isTouched.clear();
+    pending.clear();
+    flushedGroups = 0;
+
+    // A global aggregate has its single row even over an empty table
+    if (definition.isAggregate() && definition.groupBy.empty()) {
+        groups.push_back({{}, initialStates()});
+        isTouched.push_back(0);
+        groupIndex.emplace("", 0);
+    }
+
+    {
+        Table::Pin pin(base);
+        const size_t width = base.getColumns().size();
+        for (size_t p = 0; p < base.getPartitionCount(); ++p) {
+            const Table::Partition& partition = base.getPartition(p);
+            for (size_t b = 0; b < partition.getBlockCount(); ++b) {
+                const Table::Block& block = partition.getBlock(b);
+                for (size_t r = 0; r < block.getRowCount(); ++r) {
+                    if (!block.isDeleted(r)) accumulate(block.getRowCells(r, width));
+                }
+            }
+        }
+    }
+    flush();
+}
+
+void MaterializedView::accumulate(const CompactValue* row) {
+    if (definition.where && !definition.where->evaluate(row)) return;
+
+    if (!definition.isAggregate()) {
+        Row& out = pending.emplace_back();
+        for (int source : sources) {
+            out.values.push_back(row[source].toValue());
+        }
+        return;
+    }
+
+    keyScratch.clear();
+    for (int column : groupColumns) {
+        appendGroupKey(keyScratch, row[column]);
+    }
+    auto [it, inserted] = groupIndex.try_emplace(keyScratch, groups.size());
+    if (inserted) {
+        Group group;
+        for (int column : groupColumns) {
+            group.key.push_back(row[column].toValue());
+        }
+        group.states = initialStates();
+        groups.push_back(std::move(group));
+        isTouched.push_back(0);
+    }
+    const size_t index = it->second;
+    Group& group = groups[index];
+    if (index < flushedGroups && !isTouched[index]) {
+        isTouched[index] = 1;
+        touched.push_back(index);
+    }
+
+    for (size_t i = 0; i < definition.columns.size(); ++i) {
+        if (definition.columns[i].function == AggregateFunction::NONE) continue;
+        if (sources[i] < 0) {
+            group.states[i].addRow();  // COUNT(*)
+        } else {
+            group.states[i].add(row[sources[i]]);
+        }
+    }
+}
+
+void MaterializedView::flush() {
+    // Groups that already have a row are rewritten in place; new ones append
+    for (size_t index : touched) {
+        target.replaceRow(index, groupRow(groups[index]));
+        isTouched[index] = 0;
+    }
+    touched.clear();
+    for (size_t index = flushedGroups; index < groups.size(); ++index) {
+        pending.push_back(groupRow(groups[index]));
+    }
+    flushedGroups = groups.size();
+    if (!pending.empty()) {
+        target.insertRows(pending);
+        pending.clear();
+    }
+}
+
+std::vector<AggregateState> MaterializedView::initialStates() const {
+    std::vector<AggregateState> states;
+    states.reserve(definition.columns.size());
+    for (const auto& column : definition.columns) {
+        states.emplace_back(column.function, column.parameter);
+    }
+    return states;
+}
+
+Row MaterializedView::groupRow(const Group& group) const {
+    Row row;
+    for (size_t i = 0; i < definition.columns.size(); ++i) {
+        if (definition.columns[i].function == AggregateFunction::NONE) {
+            row.values.push_back(group.key[keySlots[i]]);
+        } else {
+            row.values.push_back(group.states[i].result());
+        }
+    }
+    return row;
+}
+
+} // namespace parallaxdb
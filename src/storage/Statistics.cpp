@@ -0,0 +1,406 @@
+#include "../../include/storage/Statistics.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <random>
+
+namespace parallaxdb {
+
+uint64_t mix64(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+bool toNumeric(const Value& value, double& out) {
+    if (std::holds_alternative<int>(value)) {
+        out = static_cast<double>(std::get<int>(value));
+        return true;
+    }
+    if (std::holds_alternative<double>(value)) {
+        out = std::get<double>(value);
+        return true;
+    }
+    return false;
+}
+
+uint64_t hashValue(const Value& value) {
+    double numeric;
+    if (toNumeric(value, numeric)) {
+        if (numeric == 0.0) numeric = 0.0; // fold -0.0
+        uint64_t bits;
+        std::memcpy(&bits, &numeric, sizeof(bits));
+        return mix64(bits);
+    }
+    if (std::holds_alternative<std::string>(value)) {
+        return mix64(std::hash<std::string>{}(std::get<std::string>(value)));
+    }
+    return 0x9e3779b97f4a7c15ULL; // NULL
+}
+
+uint64_t hashValue(const CompactValue& value) {
+    if (value.isNumeric()) {
+        double numeric = value.asNumber();
+        if (numeric == 0.0) numeric = 0.0;
+        uint64_t bits;
+        std::memcpy(&bits, &numeric, sizeof(bits));
+        return mix64(bits);
+    }
+    if (value.isString()) {
+        // std::hash of a string_view equals that of the equivalent std::string
+        return mix64(std::hash<std::string_view>{}(value.asString()));
+    }
+    return 0x9e3779b97f4a7c15ULL;
+}
+
+int compareValues(const Value& a, const Value& b) {
+    double x, y;
+    if (toNumeric(a, x) && toNumeric(b, y)) {
+        return (x < y) ? -1 : (x > y ? 1 : 0);
+    }
+    if (std::holds_alternative<std::string>(a) && std::holds_alternative<std::string>(b)) {
+        return std::get<std::string>(a).compare(std::get<std::string>(b));
+    }
+    if (a.index() != b.index()) {
+        return a.index() < b.index() ? -1 : 1;
+    }
+    return 0;
+}
+
+// HyperLogLog
+
+HyperLogLog::HyperLogLog(uint8_t precision)
+    : precision(precision), registers(size_t(1) << precision, 0) {}
+
+void HyperLogLog::add(uint64_t hash) {
+    size_t index = hash >> (64 - precision);
+    uint64_t rest = hash << precision;
+    uint8_t rank = rest == 0 ? static_cast<uint8_t>(64 - precision + 1)
+                             : static_cast<uint8_t>(__builtin_clzll(rest) + 1);
+    if (rank > registers[index]) {
+        registers[index] = rank;
+    }
+}
+
+void HyperLogLog::merge(const HyperLogLog& other) {
+    if (other.precision != precision) {
+        throw std::runtime_error("Cannot merge HyperLogLog sketches of different precision");
+    }
+    for (size_t i = 0; i < registers.size(); ++i) {
+        registers[i] = std::max(registers[i], other.registers[i]);
+    }
+}
+
+double HyperLogLog::estimate() const {
+    const double m = static_cast<double>(registers.size());
+    double sum = 0.0;
+    size_t zeros = 0;
+    for (uint8_t r : registers) {
+        sum += std::ldexp(1.0, -static_cast<int>(r));
+        if (r == 0) zeros++;
+    }
+    const double alpha = 0.7213 / (1.0 + 1.079 / m);
+    double estimate = alpha * m * m / sum;
+    // Small-range correction: fall back to linear counting
+    if (estimate <= 2.5 * m && zeros > 0) {
+        estimate = m * std::log(m / static_cast<double>(zeros));
+    }
+    return estimate;
+}
+
+void HyperLogLog::clear() {
+    std::fill(registers.begin(), registers.end(), 0);
+}
+
+// QuantileSketch
+
+QuantileSketch::QuantileSketch(size_t k) : k(std::max<size_t>(k, 8)), levels(1), rng(0x2545f4914f6cdd1dULL) {}
+
+size_t QuantileSketch::capacity(size_t level) const {
+    // Lower levels shrink geometrically as the sketch grows taller
+    const size_t depth = levels.size() - 1 - level;
+    return std::max<size_t>(2, static_cast<size_t>(k * std::pow(2.0 / 3.0, static_cast<double>(depth))));
+}
+
+size_t QuantileSketch::retained() const {
+    size_t items = 0;
+    for (const auto& level : levels) {
+        items += level.size();
+    }
+    return items;
+}
+
+void QuantileSketch::add(double value) {
+    if (std::isnan(value)) return;
+    if (n == 0) {
+        minValue = maxValue = value;
+    } else {
+        minValue = std::min(minValue, value);
+        maxValue = std::max(maxValue, value);
+    }
+    n++;
+    levels[0].push_back(value);
+    if (levels[0].size() >= capacity(0)) compress();
+}
+
+void QuantileSketch::merge(const QuantileSketch& other) {
+    if (other.k != k) {
+        throw std::runtime_error("Cannot merge quantile sketches of different k");
+    }
+    if (other.n == 0) return;
+    if (n == 0) {
+        minValue = other.minValue;
+        maxValue = other.maxValue;
+    } else {
+        minValue = std::min(minValue, other.minValue);
+        maxValue = std::max(maxValue, other.maxValue);
+    }
+    n += other.n;
+    if (levels.size() < other.levels.size()) levels.resize(other.levels.size());
+    for (size_t h = 0; h < other.levels.size(); ++h) {
+        levels[h].insert(levels[h].end(), other.levels[h].begin(), other.levels[h].end());
+    }
+    compress();
+}
+
+void QuantileSketch::compress() {
+    for (size_t h = 0; h < levels.size(); ++h) {
+        if (levels[h].size() < capacity(h)) continue;
+        if (h + 1 == levels.size()) levels.emplace_back();
+        std::vector<double>& level = levels[h];
+        std::sort(level.begin(), level.end());
+        // An odd item out stays behind at its weight
+        double leftover = 0.0;
+        bool odd = level.size() % 2 == 1;
+        if (odd) {
+            leftover = level.back();
+            level.pop_back();
+        }
+        rng ^= rng << 13;
+        rng ^= rng >> 7;
+        rng ^= rng << 17;
+        for (size_t i = rng & 1; i < level.size(); i += 2) {
+            levels[h + 1].push_back(level[i]);
+        }
+        level.clear();
+        if (odd) level.push_back(leftover);
+    }
+}
+
+double QuantileSketch::quantile(double q) const {
+    if (n == 0) return std::nan("");
+    if (q <= 0.0) return minValue;
+    if (q >= 1.0) return maxValue;
+    std::vector<std::pair<double, uint64_t>> weighted;
+    weighted.reserve(retained());
+    for (size_t h = 0; h < levels.size(); ++h) {
+        for (double value : levels[h]) {
+            weighted.emplace_back(value, uint64_t(1) << h);
+        }
+    }
+    std::sort(weighted.begin(), weighted.end());
+    uint64_t total = 0;
+    for (const auto& item : weighted) {
+        total += item.second;
+    }
+    const double target = q * static_cast<double>(total);
+    uint64_t seen = 0;
+    for (const auto& [value, weight] : weighted) {
+        seen += weight;
+        if (static_cast<double>(seen) >= target) return value;
+    }
+    return maxValue;
+}
+
+// ColumnStatistics
+
+void ColumnStatistics::add(const Value& value) {
+    rowCount++;
+    if (std::holds_alternative<std::nullptr_t>(value)) {
+        nullCount++;
+        return;
+    }
+    distinct.addValue(value);
+    if (!minValue || compareValues(value, *minValue) < 0) minValue = value;
+    if (!maxValue || compareValues(value, *maxValue) > 0) maxValue = value;
+}
+
+void ColumnStatistics::clear() {
+    rowCount = 0;
+    nullCount = 0;
+    distinct.clear();
+    minValue.reset();
+    maxValue.reset();
+    histogramBounds.clear();
+    mostCommonValues.clear();
+}
+
+double ColumnStatistics::nullFraction() const {
+    return rowCount == 0 ? 0.0 : static_cast<double>(nullCount) / rowCount;
+}
+
+double ColumnStatistics::distinctCount() const {
+    if (rowCount == nullCount) return 0.0;
+    // The sketch can overshoot slightly on tiny inputs; never exceed the non-null count
+    return std::min(distinct.estimate(), static_cast<double>(rowCount - nullCount));
+}
+
+double ColumnStatistics::estimateEquality(const Value& value) const {
+    for (const auto& mcv : mostCommonValues) {
+        if (compareValues(mcv.first, value) == 0) {
+            return mcv.second;
+        }
+    }
+    if (minValue && compareValues(value, *minValue) < 0) return 0.0;
+    if (maxValue && compareValues(value, *maxValue) > 0) return 0.0;
+
+    double mcvFraction = 0.0;
+    for (const auto& mcv : mostCommonValues) mcvFraction += mcv.second;
+    double remainingDistinct = distinctCount() - static_cast<double>(mostCommonValues.size());
+    double remainingFraction = std::max(0.0, 1.0 - nullFraction() - mcvFraction);
+    return remainingFraction / std::max(1.0, remainingDistinct);
+}
+
+double ColumnStatistics::estimateFractionBelow(const Value& value) const {
+    // Returns the fraction of non-null values strictly below `value`
+    if (histogramBounds.size() >= 2) {
+        if (compareValues(value, histogramBounds.front()) <= 0) return 0.0;
+        if (compareValues(value, histogramBounds.back()) > 0) return 1.0;
+        auto it = std::upper_bound(histogramBounds.begin(), histogramBounds.end(), value, ValueLess{});
+        size_t bucket = static_cast<size_t>(it - histogramBounds.begin()) - 1;
+        size_t buckets = histogramBounds.size() - 1;
+        if (bucket >= buckets) return 1.0;
+        double within = 0.5;
+        double lo, hi, v;
+        if (toNumeric(histogramBounds[bucket], lo) && toNumeric(histogramBounds[bucket + 1], hi) &&
+            toNumeric(value, v) && hi > lo) {
+            within = (v - lo) / (hi - lo);
+        }
+        return (static_cast<double>(bucket) + within) / static_cast<double>(buckets);
+    }
+    double lo, hi, v;
+    if (minValue && maxValue && toNumeric(*minValue, lo) && toNumeric(*maxValue, hi) && toNumeric(value, v)) {
+        if (v <= lo) return 0.0;
+        if (v > hi) return 1.0;
+        return hi > lo ? (v - lo) / (hi - lo) : 0.5;
+    }
+    return 1.0 / 3.0;
+}
+
+double ColumnStatistics::estimateSelectivity(const std::string& op, const Value& value) const {
+    if (rowCount == 0) return 0.0;
+    if (std::holds_alternative<std::nullptr_t>(value)) return 0.0;
+
+    const double nonNull = 1.0 - nullFraction();
+    double eq = std::min(estimateEquality(value), nonNull);
+    double result;
+    if (op == "=") {
+        result = eq;
+    } else if (op == "!=") {
+        result = nonNull - eq;
+    } else {
+        double below = estimateFractionBelow(value) * nonNull;
+        if (op == "<") result = below;
+        else if (op == "<=") result = below + eq;
+        else if (op == ">") result = nonNull - below - eq;
+        else if (op == ">=") result = nonNull - below;
+        else result = 1.0 / 3.0;
+    }
+    return std::clamp(result, 0.0, 1.0);
+}
+
+// TableStatistics
+
+void TableStatistics::recordInsert(const Row& row) {
+    rowCount++;
+    modificationsSinceAnalyze++;
+    size_t n = std::min(row.values.size(), columns.size());
+    for (size_t i = 0; i < n; ++i) {
+        columns[i].add(row.values[i]);
+    }
+}
+
+void TableStatistics::recordDelete(size_t rows) {
+    rowCount -= std::min(rowCount, rows);
+    modificationsSinceAnalyze += rows;
+}
+
+void TableStatistics::reset(size_t columnCount) {
+    columns.assign(columnCount, ColumnStatistics());
+    rowCount = 0;
+    modificationsSinceAnalyze = 0;
+    analyzed = false;
+}
+
+void TableStatistics::analyze(size_t rows, const std::function<Value(size_t, size_t)>& valueAt) {
+    for (auto& column : columns) column.clear();
+    rowCount = rows;
+    for (size_t r = 0; r < rows; ++r) {
+        for (size_t i = 0; i < columns.size(); ++i) {
+            columns[i].add(valueAt(r, i));
+        }
+    }
+
+    // Reservoir sample of row indices; deterministic so plans are reproducible
+    std::vector<size_t> sample;
+    sample.reserve(std::min(rows, kSampleSize));
+    std::mt19937_64 rng(0x5eed);
+    for (size_t i = 0; i < rows; ++i) {
+        if (sample.size() < kSampleSize) {
+            sample.push_back(i);
+        } else {
+            size_t j = std::uniform_int_distribution<size_t>(0, i)(rng);
+            if (j < kSampleSize) sample[j] = i;
+        }
+    }
+
+    for (size_t c = 0; c < columns.size(); ++c) {
+        std::vector<Value> values;
+        values.reserve(sample.size());
+        for (size_t idx : sample) {
+            Value value = valueAt(idx, c);
+            if (!std::holds_alternative<std::nullptr_t>(value)) {
+                values.push_back(std::move(value));
+            }
+        }
+        std::sort(values.begin(), values.end(), ValueLess{});
+
+        // Most common values: runs in the sorted sample that repeat
+        std::vector<std::pair<Value, size_t>> runs;
+        for (size_t i = 0; i < values.size();) {
+            size_t j = i + 1;
+            while (j < values.size() && compareValues(values[i], values[j]) == 0) j++;
+            if (j - i > 1) runs.emplace_back(values[i], j - i);
+            i = j;
+        }
+        std::stable_sort(runs.begin(), runs.end(),
+                         [](const auto& a, const auto& b) { return a.second > b.second; });
+        if (runs.size() > kMostCommonValues) runs.resize(kMostCommonValues);
+
+        ColumnStatistics& stats = columns[c];
+        stats.mostCommonValues.clear();
+        for (const auto& run : runs) {
+            stats.mostCommonValues.emplace_back(run.first, static_cast<double>(run.second) / sample.size());
+        }
+
+        // Equi-depth histogram bounds
+        stats.histogramBounds.clear();
+        if (!values.empty()) {
+            size_t buckets = std::min(kHistogramBuckets, values.size());
+            for (size_t b = 0; b <= buckets; ++b) {
+                size_t idx = std::min(values.size() - 1, b * (values.size() - 1) / buckets);
+                stats.histogramBounds.push_back(values[idx]);
+            }
+        }
+    }
+
+    modificationsSinceAnalyze = 0;
+    analyzed = true;
+}
+
+} // namespace parallaxdb
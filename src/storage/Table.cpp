@@ -0,0 +1,715 @@
+#include "../../include/storage/Table.hpp"
+#include "../../include/util/Numa.hpp"
+#include <sstream>
+#include <thread>
+
+namespace parallaxdb {
+
+namespace {
+
+// Orders partition keys: numbers by value, strings bytewise; NULL sorts first
+int compareKeys(const CompactValue& a, const CompactValue& b) {
+    if (a.isNumeric() && b.isNumeric()) {
+        double x = a.asNumber(), y = b.asNumber();
+        return (x < y) ? -1 : (x > y ? 1 : 0);
+    }
+    if (a.isString() && b.isString()) {
+        return CompactValue::compareStrings(a, b);
+    }
+    int x = static_cast<int>(a.kind()), y = static_cast<int>(b.kind());
+    return (x < y) ? -1 : (x > y ? 1 : 0);
+}
+
+std::string keyText(const Value& value) {
+    if (std::holds_alternative<std::string>(value)) return "'" + std::get<std::string>(value) + "'";
+    std::ostringstream os;
+    os << value;
+    return os.str();
+}
+
+} // namespace
+
+Table::Table(const std::string& name, const Schema& schema)
+    : name(name), schema(schema), validation(std::make_unique<ValidationProgram>(schema)),
+      statistics(schema.columns.size()) {
+    initPartitions();
+}
+
+Table::Table(const std::string& name, const std::vector<Column>& columns)
+    : name(name), schema(name), statistics(columns.size()) {
+    schema.columns = columns;
+    validation = std::make_unique<ValidationProgram>(schema);
+    initPartitions();
+}
+
+void Table::initPartitions() {
+    const PartitionSpec& spec = schema.partitioning;
+    partitionBounds.clear();
+    partitionColumn = -1;
+    if (spec.method != PartitionSpec::NONE) {
+        partitionColumn = getColumnIndex(spec.column);
+        if (partitionColumn < 0) {
+            throw std::runtime_error("Unknown partition column '" + spec.column + "' in table " + name);
+        }
+        DataType type = schema.columns[partitionColumn].type;
+        if (spec.method == PartitionSpec::HASH && spec.partitionCount == 0) {
+            throw std::runtime_error("HASH partitioning needs at least one partition");
+        }
+        for (const auto& bound : spec.bounds) {
+            CompactValue cell = CompactValue::borrow(bound);
+            if (cell.isNull() || !DataValidator::validateValue(cell, type == DataType::INT ? DataType::DOUBLE : type)) {
+                throw std::runtime_error("Partition bound " + keyText(bound) + " does not match the type of column '" +
+                                         spec.column + "'");
+            }
+            if (!partitionBounds.empty() && compareKeys(partitionBounds.back(), cell) >= 0) {
+                throw std::runtime_error("Partition bounds must be strictly ascending");
+            }
+            partitionBounds.push_back(cell);
+        }
+    }
+    partitions = std::vector<Partition>(spec.count());
+}
+
+size_t Table::getHomeNode(size_t index) const {
+    return index % NumaTopology::current()->getNodeCount();
+}
+
+size_t Table::partitionFor(const CompactValue& key) const {
+    switch (schema.partitioning.method) {
+        case PartitionSpec::RANGE: {
+            // NULL keys compare below every bound and land in the first partition
+            auto it = std::upper_bound(partitionBounds.begin(), partitionBounds.end(), key,
+                                       [](const CompactValue& k, const CompactValue& bound) {
+                                           return compareKeys(k, bound) < 0;
+                                       });
+            return static_cast<size_t>(it - partitionBounds.begin());
+        }
+        case PartitionSpec::HASH:
+            return hashValue(key) % partitions.size();
+        case PartitionSpec::NONE:
+            break;
+    }
+    return 0;
+}
+
+bool Table::partitionMayMatch(size_t index, CompareOp op, const CompactValue& value) const {
+    if (value.isNull()) return false;  // Comparisons with NULL are never true
+    switch (schema.partitioning.method) {
+        case PartitionSpec::RANGE: {
+            // Partition `index` holds keys in [lo, hi); either end may be open
+            const CompactValue* lo = index > 0 ? &partitionBounds[index - 1] : nullptr;
+            const CompactValue* hi = index < partitionBounds.size() ? &partitionBounds[index] : nullptr;
+            switch (op) {
+                case CompareOp::EQ:
+                    return (!lo || compareKeys(*lo, value) <= 0) && (!hi || compareKeys(value, *hi) < 0);
+                case CompareOp::LT:
+                    return !lo || compareKeys(*lo, value) < 0;
+                case CompareOp::LE:
+                    return !lo || compareKeys(*lo, value) <= 0;
+                case CompareOp::GT:
+                case CompareOp::GE:
+                    return !hi || compareKeys(value, *hi) < 0;
+                case CompareOp::NE:
+                    return true;
+            }
+            return true;
+        }
+        case PartitionSpec::HASH:
+            return op != CompareOp::EQ || partitionFor(value) == index;
+        case PartitionSpec::NONE:
+            break;
+    }
+    return true;
+}
+
+std::string Table::describePartition(size_t index) const {
+    const PartitionSpec& spec = schema.partitioning;
+    if (spec.method == PartitionSpec::RANGE) {
+        std::string lo = index > 0 ? keyText(spec.bounds[index - 1]) : "-inf";
+        std::string hi = index < spec.bounds.size() ? keyText(spec.bounds[index]) : "+inf";
+        return "[" + lo + ", " + hi + ")";
+    }
+    if (spec.method == PartitionSpec::HASH) {
+        return "hash % " + std::to_string(partitions.size()) + " = " + std::to_string(index);
+    }
+    return "all";
+}
+
+size_t Table::dropPartition(size_t index) {
+    if (index >= partitions.size()) {
+        throw std::runtime_error("Table " + name + " has no partition " + std::to_string(index));
+    }
+    std::unique_lock<std::mutex> lock(storageMutex);
+    if (pins > 0) {
+        throw std::runtime_error("Cannot drop a partition of " + name + " while it is being scanned");
+    }
+    Partition& partition = partitions[index];
+    const size_t removed = partition.liveRows;
+    storedRows -= partition.storedRows;
+    liveRows -= partition.liveRows;
+    partition = Partition();
+    partition.trigrams.resize(trigramIndexes.size());
+    statistics.recordDelete(removed);
+    lock.unlock();
+    if (removed > 0) notifyModify();
+    return removed;
+}
+
+void Table::insertRow(const Row& row) {
+    encoded.clear();
+    for (const auto& value : row.values) {
+        encoded.push_back(CompactValue::borrow(value));
+    }
+    if (!validation->validateRow(encoded.data(), encoded.size())) {
+        throw std::runtime_error("Row validation failed for table: " + name);
+    }
+    {
+        std::lock_guard<std::mutex> lock(storageMutex);
+        appendEncoded(encoded.data(), 1);
+        statistics.recordInsert(row);
+    }
+    notifyAppend(encoded.data(), 1);
+}
+
+void Table::insertRows(const std::vector<Row>& rows) {
+    const size_t width = schema.columns.size();
+    encoded.clear();
+    encoded.reserve(rows.size() * width);
+    for (size_t r = 0; r < rows.size(); ++r) {
+        if (rows[r].values.size() != width) {
+            throw std::runtime_error("Row " + std::to_string(r) + " has " +
+                                     std::to_string(rows[r].values.size()) + " values, table " +
+                                     name + " has " + std::to_string(width) + " columns");
+        }
+        for (const auto& value : rows[r].values) {
+            encoded.push_back(CompactValue::borrow(value));
+        }
+    }
+
+    std::vector<ValidationFailure> failures;
+    if (!validation->validate(encoded.data(), rows.size(), failures)) {
+        const size_t shown = std::min<size_t>(failures.size(), 5);
+        std::string message = "Batch validation failed for table " + name + " (" +
+                              std::to_string(failures.size()) + " violations)";
+        for (size_t i = 0; i < shown; ++i) {
+            message += "; " + failures[i].toString(schema);
+        }
+        if (shown < failures.size()) message += "; ...";
+        throw ValidationError(message, std::move(failures));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(storageMutex);
+        appendEncoded(encoded.data(), rows.size());
+        for (const auto& row : rows) {
+            statistics.recordInsert(row);
+        }
+    }
+    notifyAppend(encoded.data(), rows.size());
+}
+
+void Table::replaceRow(size_t index, const Row& row) {
+    encoded.clear();
+    for (const auto& value : row.values) {
+        encoded.push_back(CompactValue::borrow(value));
+    }
+    if (!validation->validateRow(encoded.data(), encoded.size())) {
+        throw std::runtime_error("Row validation failed for table: " + name);
+    }
+    {
+        std::lock_guard<std::mutex> lock(storageMutex);
+        const Partition* owner = nullptr;
+        CompactValue* cells = const_cast<CompactValue*>(locateLive(index, &owner));
+        if (partitionColumn >= 0 && partitionFor(encoded[partitionColumn]) != partitionFor(cells[partitionColumn])) {
+            throw std::runtime_error("replaceRow cannot move a row between partitions of " + name);
+        }
+        StringHeap& strings = const_cast<Partition*>(owner)->strings;
+        for (size_t c = 0; c < encoded.size(); ++c) {
+            CompactValue cell = encoded[c];
+            if (cell.isString() && !cell.isInlined()) {
+                cell = CompactValue::ofString(strings.store(cell.asString()));
+            }
+            cells[c] = cell;
+        }
+        if (!trigramIndexes.empty()) rebuildIndexes(*const_cast<Partition*>(owner));
+        statistics.recordDelete(1);
+        statistics.recordInsert(row);
+    }
+    notifyModify();
+}
+
+void Table::truncate() {
+    {
+        std::lock_guard<std::mutex> lock(storageMutex);
+        if (pins > 0) {
+            throw std::runtime_error("Cannot truncate " + name + " while it is being scanned");
+        }
+        for (Partition& partition : partitions) {
+            partition = Partition();
+            partition.trigrams.resize(trigramIndexes.size());
+        }
+        slab.release();
+        statistics.recordDelete(liveRows);
+        storedRows = 0;
+        liveRows = 0;
+    }
+    notifyModify();
+}
+
+uint64_t Table::nextVersion() {
+    static std::atomic<uint64_t> counter{0};
+    return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+void Table::notifyAppend(const CompactValue* rows, size_t count) {
+    version.store(nextVersion(), std::memory_order_release);
+    for (TableObserver* observer : observers) {
+        observer->onAppend(*this, rows, count);
+    }
+}
+
+void Table::notifyModify() {
+    version.store(nextVersion(), std::memory_order_release);
+    for (TableObserver* observer : observers) {
+        observer->onModify(*this);
+    }
+}
+
+void Table::appendEncoded(const CompactValue* rows, size_t count) {
+    const size_t width = schema.columns.size();
+    // Tables this load makes large put their new blocks on huge pages
+    std::pmr::memory_resource* memory = (storedRows + count) * width * sizeof(CompactValue) >= kHugePageTableBytes
+        ? &slab : std::pmr::get_default_resource();
+    if (partitions.size() == 1) {
+        std::vector<uint32_t> all(count);
+        for (size_t r = 0; r < count; ++r) all[r] = static_cast<uint32_t>(r);
+        appendToPartition(partitions[0], rows, all.data(), count, memory);
+    } else {
+        std::vector<std::vector<uint32_t>> routed(partitions.size());
+        for (size_t r = 0; r < count; ++r) {
+            routed[partitionFor(rows[r * width + partitionColumn])].push_back(static_cast<uint32_t>(r));
+        }
+
+        // Partitions share nothing, so a large load fills them concurrently
+        size_t threads = loadParallelism > 0 ? loadParallelism : std::thread::hardware_concurrency();
+        threads = std::min(threads, partitions.size());
+        if (count >= kParallelLoadRows && threads > 1) {
+            // Each partition is filled from its home node, so its blocks are
+            // first touched (and allocated) there
+            std::shared_ptr<const NumaTopology> numa = NumaTopology::current();
+            std::vector<std::thread> workers;
+            for (size_t t = 0; t < threads; ++t) {
+                workers.emplace_back([this, t, threads, rows, &routed, &numa, memory] {
+                    for (size_t p = t; p < partitions.size(); p += threads) {
+                        if (numa->getNodeCount() > 1) numa->pinThread(getHomeNode(p));
+                        appendToPartition(partitions[p], rows, routed[p].data(), routed[p].size(), memory);
+                    }
+                });
+            }
+            for (auto& worker : workers) worker.join();
+        } else {
+            for (size_t p = 0; p < partitions.size(); ++p) {
+                appendToPartition(partitions[p], rows, routed[p].data(), routed[p].size(), memory);
+            }
+        }
+    }
+    storedRows += count;
+    liveRows += count;
+}
+
+void Table::appendToPartition(Partition& partition, const CompactValue* rows, const uint32_t* indices,
+                              size_t count, std::pmr::memory_resource* memory) {
+    const size_t width = schema.columns.size();
+    // A partition's blocks belong on its home node. Loads on a thread
+    // elsewhere bind each new block there before touching it; binding only
+    // then keeps the process's memory mappings from fragmenting.
+    std::shared_ptr<const NumaTopology> numa = NumaTopology::current();
+    const size_t home = getHomeNode(static_cast<size_t>(&partition - partitions.data()));
+    const bool bind = partitions.size() > 1 && numa->getNodeCount() > 1 && numa->currentNode() != home;
+    for (size_t i = 0; i < count; ++i) {
+        if (partition.blocks.empty() || partition.blocks.back().rows == kBlockRows) {
+            partition.blocks.emplace_back(memory);
+            std::pmr::vector<CompactValue>& cells = partition.blocks.back().cells;
+            cells.reserve(kBlockRows * width);
+            if (bind) numa->bindMemory(cells.data(), cells.capacity() * sizeof(CompactValue), home);
+        }
+        Block& block = partition.blocks.back();
+        const CompactValue* row = rows + static_cast<size_t>(indices[i]) * width;
+        for (size_t c = 0; c < width; ++c) {
+            CompactValue cell = row[c];
+            if (cell.isString() && !cell.isInlined()) {
+                cell = CompactValue::ofString(partition.strings.store(cell.asString()));
+            }
+            block.cells.push_back(cell);
+        }
+        if (!trigramIndexes.empty()) {
+            indexRow(partition, indexRowId(partition.blocks.size() - 1, block.rows),
+                     block.getRowCells(block.rows, width));
+        }
+        block.rows++;
+    }
+    partition.storedRows += count;
+    partition.liveRows += count;
+}
+
+size_t Table::deleteWhere(const std::function<bool(const CompactValue*)>& match) {
+    const size_t width = schema.columns.size();
+    std::unique_lock<std::mutex> lock(storageMutex);
+    size_t removed = 0;
+    for (Partition& partition : partitions) {
+        size_t removedHere = 0;
+        for (Block& block : partition.blocks) {
+            for (size_t r = 0; r < block.rows; ++r) {
+                if (!block.isDeleted(r) && match(block.getRowCells(r, width))) {
+                    block.markDeleted(r);
+                    removedHere++;
+                }
+            }
+        }
+        partition.liveRows -= removedHere;
+        removed += removedHere;
+    }
+    liveRows -= removed;
+    statistics.recordDelete(removed);
+    lock.unlock();
+    if (removed > 0) notifyModify();
+    return removed;
+}
+
+size_t Table::updateWhere(const std::function<bool(const CompactValue*)>& match,
+                          const std::vector<std::pair<size_t, Value>>& assignments) {
+    const size_t width = schema.columns.size();
+    for (const auto& assignment : assignments) {
+        if (assignment.first >= width) {
+            throw std::runtime_error("Column index out of range for table: " + name);
+        }
+    }
+    std::vector<CompactValue> newCells;
+    for (const auto& assignment : assignments) {
+        newCells.push_back(CompactValue::borrow(assignment.second));
+    }
+    bool inPlace = true;
+    for (size_t i = 0; i < assignments.size(); ++i) {
+        // Long strings need heap space, and a new partition key may move the row
+        if (newCells[i].isString() && !newCells[i].isInlined()) inPlace = false;
+        if (static_cast<int>(assignments[i].first) == partitionColumn) inPlace = false;
+        // Re-appended rows are indexed again; overwritten ones would keep stale postings
+        if (findTrigramIndex(static_cast<int>(assignments[i].first)) >= 0) inPlace = false;
+    }
+
+    std::unique_lock<std::mutex> lock(storageMutex);
+
+    // Collect the matching rows and build their new versions
+    struct Target {
+        Partition* partition;
+        size_t block;
+        size_t row;
+    };
+    std::vector<Target> targets;
+    encoded.clear();
+    for (Partition& partition : partitions) {
+        for (size_t b = 0; b < partition.blocks.size(); ++b) {
+            const Block& block = partition.blocks[b];
+            for (size_t r = 0; r < block.rows; ++r) {
+                const CompactValue* row = block.getRowCells(r, width);
+                if (block.isDeleted(r) || !match(row)) continue;
+                targets.push_back({&partition, b, r});
+                encoded.insert(encoded.end(), row, row + width);
+                for (size_t i = 0; i < assignments.size(); ++i) {
+                    encoded[encoded.size() - width + assignments[i].first] = newCells[i];
+                }
+            }
+        }
+    }
+    if (targets.empty()) return 0;
+
+    std::vector<ValidationFailure> failures;
+    if (!validation->validate(encoded.data(), targets.size(), failures)) {
+        std::string message = "Update violates constraints of table " + name + ": " +
+                              failures.front().toString(schema);
+        throw ValidationError(message, std::move(failures));
+    }
+
+    if (inPlace) {
+        for (size_t t = 0; t < targets.size(); ++t) {
+            Block& block = targets[t].partition->blocks[targets[t].block];
+            CompactValue* row = block.cells.data() + targets[t].row * width;
+            for (const auto& assignment : assignments) {
+                row[assignment.first] = encoded[t * width + assignment.first];
+            }
+        }
+    } else {
+        for (const auto& target : targets) {
+            target.partition->blocks[target.block].markDeleted(target.row);
+            target.partition->liveRows--;
+        }
+        liveRows -= targets.size();
+        appendEncoded(encoded.data(), targets.size());
+    }
+
+    statistics.recordDelete(targets.size());
+    for (size_t t = 0; t < targets.size(); ++t) {
+        Row row;
+        for (size_t c = 0; c < width; ++c) {
+            row.values.push_back(encoded[t * width + c].toValue());
+        }
+        statistics.recordInsert(row);
+    }
+    lock.unlock();
+    notifyModify();
+    return targets.size();
+}
+
+size_t Table::compact(double threshold) {
+    std::lock_guard<std::mutex> lock(storageMutex);
+    if (pins > 0) return 0;
+
+    const size_t before = storedRows;
+    for (Partition& partition : partitions) {
+        std::vector<Block>& blocks = partition.blocks;
+        bool moved = false;
+        for (size_t b = 0; b < blocks.size();) {
+            Block& block = blocks[b];
+            if (block.rows == 0 || block.deletedCount < threshold * block.rows) {
+                ++b;
+                continue;
+            }
+            moved = true;
+            compactBlock(partition, b);
+            // Fold the survivors into the previous block if they fit, so a
+            // mostly-deleted table does not degrade into tiny batches
+            if (b > 0 && blocks[b - 1].rows + blocks[b].rows <= kBlockRows && blocks[b - 1].deletedCount == 0) {
+                Block& previous = blocks[b - 1];
+                previous.cells.insert(previous.cells.end(), blocks[b].cells.begin(), blocks[b].cells.end());
+                previous.rows += blocks[b].rows;
+                blocks[b].rows = 0;
+            }
+            if (blocks[b].rows == 0) {
+                blocks.erase(blocks.begin() + b);
+            } else {
+                ++b;
+            }
+        }
+        // Index row IDs are positions, which compaction has just changed
+        if (moved && !trigramIndexes.empty()) rebuildIndexes(partition);
+    }
+    return before - storedRows;
+}
+
+void Table::compactBlock(Partition& partition, size_t index) {
+    const size_t width = schema.columns.size();
+    Block& block = partition.blocks[index];
+    std::pmr::vector<CompactValue> kept(block.cells.get_allocator());
+    kept.reserve((block.rows - block.deletedCount) * width);
+    for (size_t r = 0; r < block.rows; ++r) {
+        if (!block.isDeleted(r)) {
+            const CompactValue* row = block.getRowCells(r, width);
+            kept.insert(kept.end(), row, row + width);
+        }
+    }
+    storedRows -= block.deletedCount;
+    partition.storedRows -= block.deletedCount;
+    block.rows -= block.deletedCount;
+    block.cells = std::move(kept);
+    block.deleted.clear();
+    block.deletedCount = 0;
+}
+
+void Table::createTrigramIndex(const std::string& indexName, const std::string& column) {
+    const int columnIndex = getColumnIndex(column);
+    if (columnIndex < 0) {
+        throw std::runtime_error("Unknown column '" + column + "' in table " + name);
+    }
+    if (schema.columns[columnIndex].type != DataType::STRING) {
+        throw std::runtime_error("Trigram indexes need a STRING column; '" + column + "' is not");
+    }
+    for (const auto& index : trigramIndexes) {
+        if (index.name == indexName) {
+            throw std::runtime_error("Index '" + indexName + "' already exists on table " + name);
+        }
+        if (index.columnIndex == columnIndex) {
+            throw std::runtime_error("Column '" + column + "' already has trigram index '" + index.name + "'");
+        }
+    }
+    std::lock_guard<std::mutex> lock(storageMutex);
+    trigramIndexes.push_back({indexName, column, columnIndex});
+    for (Partition& partition : partitions) {
+        partition.trigrams.resize(trigramIndexes.size());
+        rebuildIndexes(partition);
+    }
+}
+
+int Table::findTrigramIndex(int column) const {
+    for (size_t i = 0; i < trigramIndexes.size(); ++i) {
+        if (trigramIndexes[i].columnIndex == column) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+size_t Table::getIndexBytes() const {
+    std::lock_guard<std::mutex> lock(storageMutex);
+    size_t bytes = 0;
+    for (const Partition& partition : partitions) {
+        for (const TrigramIndex& index : partition.trigrams) {
+            bytes += index.getBytes();
+        }
+    }
+    return bytes;
+}
+
+void Table::indexRow(Partition& partition, uint32_t rowId, const CompactValue* row) {
+    for (size_t i = 0; i < trigramIndexes.size(); ++i) {
+        const CompactValue& cell = row[trigramIndexes[i].columnIndex];
+        if (cell.isString()) partition.trigrams[i].add(rowId, cell.asString());
+    }
+}
+
+void Table::rebuildIndexes(Partition& partition) {
+    const size_t width = schema.columns.size();
+    for (TrigramIndex& index : partition.trigrams) {
+        index.clear();
+    }
+    for (size_t b = 0; b < partition.blocks.size(); ++b) {
+        const Block& block = partition.blocks[b];
+        for (size_t r = 0; r < block.rows; ++r) {
+            if (!block.isDeleted(r)) indexRow(partition, indexRowId(b, r), block.getRowCells(r, width));
+        }
+    }
+}
+
+size_t Table::getBlockCount() const {
+    std::lock_guard<std::mutex> lock(storageMutex);
+    size_t count = 0;
+    for (const Partition& partition : partitions) {
+        count += partition.blocks.size();
+    }
+    return count;
+}
+
+const CompactValue* Table::locateLive(size_t index, const Partition** owner) const {
+    const size_t width = schema.columns.size();
+    for (const Partition& partition : partitions) {
+        if (index >= partition.liveRows) {
+            index -= partition.liveRows;
+            continue;
+        }
+        if (owner) *owner = &partition;
+        for (const Block& block : partition.blocks) {
+            if (index >= block.getLiveCount()) {
+                index -= block.getLiveCount();
+                continue;
+            }
+            if (block.deletedCount == 0) return block.getRowCells(index, width);
+            for (size_t r = 0; r < block.rows; ++r) {
+                if (block.isDeleted(r)) continue;
+                if (index-- == 0) return block.getRowCells(r, width);
+            }
+        }
+    }
+    throw std::out_of_range("Row index out of range for table: " + name);
+}
+
+const CompactValue* Table::getRowCells(size_t index) const {
+    return locateLive(index);
+}
+
+Row Table::getRow(size_t index) const {
+    std::lock_guard<std::mutex> lock(storageMutex);
+    const CompactValue* rowCells = locateLive(index);
+    Row row;
+    for (size_t i = 0; i < schema.columns.size(); ++i) {
+        row.values.push_back(rowCells[i].toValue());
+    }
+    return row;
+}
+
+size_t Table::getStorageBytes() const {
+    std::lock_guard<std::mutex> lock(storageMutex);
+    size_t bytes = 0;
+    for (const Partition& partition : partitions) {
+        bytes += partition.strings.getBytesReserved();
+        for (const Block& block : partition.blocks) {
+            bytes += block.cells.capacity() * sizeof(CompactValue) + block.deleted.capacity() * sizeof(uint64_t);
+        }
+    }
+    return bytes;
+}
+
+void Table::setSchema(const Schema& newSchema) {
+    const PartitionSpec& oldSpec = schema.partitioning;
+    const PartitionSpec& newSpec = newSchema.partitioning;
+    if (newSpec.method != oldSpec.method || newSpec.column != oldSpec.column ||
+        newSpec.bounds != oldSpec.bounds || newSpec.count() != oldSpec.count()) {
+        throw std::runtime_error("Cannot change the partitioning of table " + name);
+    }
+    auto program = std::make_unique<ValidationProgram>(newSchema);
+    std::lock_guard<std::mutex> lock(storageMutex);
+    // Re-lay the cells for the new width; missing columns become NULL
+    const size_t oldWidth = schema.columns.size();
+    const size_t newWidth = newSchema.columns.size();
+    for (Partition& partition : partitions) {
+        for (Block& block : partition.blocks) {
+            std::pmr::vector<CompactValue> relaid(block.rows * newWidth, CompactValue(), block.cells.get_allocator());
+            for (size_t r = 0; r < block.rows; ++r) {
+                for (size_t c = 0; c < std::min(oldWidth, newWidth); ++c) {
+                    relaid[r * newWidth + c] = block.cells[r * oldWidth + c];
+                }
+            }
+            block.cells = std::move(relaid);
+        }
+    }
+    schema = newSchema;
+    validation = std::move(program);
+    version.store(nextVersion(), std::memory_order_release);
+    partitionColumn = getColumnIndex(schema.partitioning.column);
+    partitionBounds.clear();
+    for (const auto& bound : schema.partitioning.bounds) {
+        partitionBounds.push_back(CompactValue::borrow(bound));
+    }
+    // Indexes follow their columns by name and go away with them
+    std::vector<TrigramIndexInfo> kept;
+    for (auto& index : trigramIndexes) {
+        index.columnIndex = getColumnIndex(index.column);
+        if (index.columnIndex >= 0 && schema.columns[index.columnIndex].type == DataType::STRING) {
+            kept.push_back(index);
+        }
+    }
+    trigramIndexes = std::move(kept);
+    for (Partition& partition : partitions) {
+        partition.trigrams.assign(trigramIndexes.size(), TrigramIndex());
+        rebuildIndexes(partition);
+    }
+    statistics.reset(schema.columns.size());
+    for (const Partition& partition : partitions) {
+        for (const Block& block : partition.blocks) {
+            for (size_t r = 0; r < block.rows; ++r) {
+                if (block.isDeleted(r)) continue;
+                Row row;
+                const CompactValue* rowCells = block.getRowCells(r, newWidth);
+                for (size_t c = 0; c < newWidth; ++c) {
+                    row.values.push_back(rowCells[c].toValue());
+                }
+                statistics.recordInsert(row);
+            }
+        }
+    }
+}
+
+void Table::analyze() {
+    Pin pin(*this);
+    const size_t width = schema.columns.size();
+    std::vector<const CompactValue*> live;
+    live.reserve(liveRows);
+    for (const Partition& partition : partitions) {
+        for (const Block& block : partition.blocks) {
+            for (size_t r = 0; r < block.rows; ++r) {
+                if (!block.isDeleted(r)) live.push_back(block.getRowCells(r, width));
+            }
+        }
+    }
+    statistics.analyze(live.size(), [&live](size_t row, size_t column) {
+        return live[row][column].toValue();
+    });
+}
+
+} // namespace parallaxdb
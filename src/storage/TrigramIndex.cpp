@@ -0,0 +1,123 @@
+#include "../../include/storage/TrigramIndex.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace parallaxdb {
+
+namespace {
+
+void appendVarint(std::vector<uint8_t>& bytes, uint32_t value) {
+    while (value >= 0x80) {
+        bytes.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    bytes.push_back(static_cast<uint8_t>(value));
+}
+
+uint32_t readVarint(const uint8_t*& p) {
+    uint32_t value = 0;
+    for (int shift = 0;; shift += 7) {
+        const uint8_t byte = *p++;
+        value |= static_cast<uint32_t>(byte & 0x7f) << shift;
+        if (byte < 0x80) return value;
+    }
+}
+
+} // namespace
+
+void TrigramIndex::add(uint32_t rowId, std::string_view text) {
+    for (size_t i = 0; i + kGramLength <= text.size(); ++i) {
+        PostingList& list = lists[gramAt(text, i)];
+        if (list.count > 0 && list.last == rowId) continue;  // Repeated within the row
+        appendVarint(list.bytes, list.count > 0 ? rowId - list.last : rowId);
+        list.last = rowId;
+        list.count++;
+    }
+}
+
+void TrigramIndex::clear() {
+    lists.clear();
+}
+
+size_t TrigramIndex::getBytes() const {
+    size_t bytes = 0;
+    for (const auto& entry : lists) {
+        bytes += entry.second.bytes.size();
+    }
+    return bytes;
+}
+
+bool TrigramIndex::usable(const std::vector<std::string>& literals) {
+    return std::any_of(literals.begin(), literals.end(),
+                       [](const std::string& literal) { return literal.size() >= kGramLength; });
+}
+
+std::vector<const TrigramIndex::PostingList*> TrigramIndex::listsFor(const std::vector<std::string>& literals) const {
+    std::vector<uint32_t> grams;
+    for (const auto& literal : literals) {
+        for (size_t i = 0; i + kGramLength <= literal.size(); ++i) {
+            grams.push_back(gramAt(literal, i));
+        }
+    }
+    std::sort(grams.begin(), grams.end());
+    grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+
+    std::vector<const PostingList*> result;
+    for (uint32_t gram : grams) {
+        auto it = lists.find(gram);
+        if (it == lists.end()) return {nullptr};
+        result.push_back(&it->second);
+    }
+    std::sort(result.begin(), result.end(),
+              [](const PostingList* a, const PostingList* b) { return a->count < b->count; });
+    return result;
+}
+
+size_t TrigramIndex::estimate(const std::vector<std::string>& literals) const {
+    std::vector<const PostingList*> found = listsFor(literals);
+    if (found.empty()) {
+        throw std::runtime_error("Trigram lookup needs a literal of at least 3 bytes");
+    }
+    return found.front() ? found.front()->count : 0;
+}
+
+void TrigramIndex::lookup(const std::vector<std::string>& literals, std::vector<uint32_t>& out) const {
+    out.clear();
+    std::vector<const PostingList*> found = listsFor(literals);
+    if (found.empty()) {
+        throw std::runtime_error("Trigram lookup needs a literal of at least 3 bytes");
+    }
+    if (!found.front()) return;
+
+    // Decode the shortest list, then narrow it by merging against the others
+    // straight from their encoded bytes
+    const PostingList& shortest = *found.front();
+    out.reserve(shortest.count);
+    const uint8_t* p = shortest.bytes.data();
+    uint32_t id = 0;
+    for (uint32_t i = 0; i < shortest.count; ++i) {
+        id += readVarint(p);
+        out.push_back(id);
+    }
+    for (size_t l = 1; l < found.size() && !out.empty(); ++l) {
+        const PostingList& list = *found[l];
+        const uint8_t* q = list.bytes.data();
+        uint32_t remaining = list.count;
+        uint32_t next = 0;
+        auto advance = [&] {
+            if (remaining == 0) return false;
+            next += readVarint(q);
+            remaining--;
+            return true;
+        };
+        bool more = advance();
+        size_t kept = 0;
+        for (size_t i = 0; i < out.size() && more; ++i) {
+            while (more && next < out[i]) more = advance();
+            if (more && next == out[i]) out[kept++] = out[i];
+        }
+        out.resize(kept);
+    }
+}
+
+} // namespace parallaxdb
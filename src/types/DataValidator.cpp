@@ -1,41 +1,57 @@
 #include "../../include/types/Common.hpp"
+#include "../../include/types/CompactValue.hpp"
 #include <stdexcept>
 #include <algorithm>
 
 namespace parallaxdb {
 
 bool DataValidator::validateValue(const Value& value, DataType type) {
+    return validateValue(CompactValue::borrow(value), type);
+}
+
+bool DataValidator::validateRow(const Row& row, const Schema& schema) {
+    std::vector<CompactValue> cells;
+    cells.reserve(row.values.size());
+    for (const auto& value : row.values) {
+        cells.push_back(CompactValue::borrow(value));
+    }
+    return validateRow(cells.data(), cells.size(), schema);
+}
+
+bool DataValidator::validateValue(const CompactValue& value, DataType type) {
+    // NULL fits any type; NOT NULL is enforced per column in validateRow()
+    if (value.isNull()) {
+        return true;
+    }
     switch (type) {
         case DataType::INT:
-            return std::holds_alternative<int>(value);
+            return value.kind() == CompactValue::Kind::INT;
         case DataType::DOUBLE:
-            return std::holds_alternative<double>(value) || std::holds_alternative<int>(value);
+            return value.isNumeric();
         case DataType::STRING:
-            return std::holds_alternative<std::string>(value);
+            return value.isString();
         case DataType::BOOLEAN:
-            return std::holds_alternative<int>(value) && 
-                   (std::get<int>(value) == 0 || std::get<int>(value) == 1);
+            return value.kind() == CompactValue::Kind::INT &&
+                   (value.asInt() == 0 || value.asInt() == 1);
         default:
             return false;
     }
 }
 
-bool DataValidator::validateRow(const Row& row, const Schema& schema) {
-    if (row.values.size() != schema.columns.size()) {
+bool DataValidator::validateRow(const CompactValue* cells, size_t count, const Schema& schema) {
+    if (count != schema.columns.size()) {
         return false;
     }
     
-    for (size_t i = 0; i < row.values.size(); ++i) {
-        if (!validateValue(row.values[i], schema.columns[i].type)) {
+    for (size_t i = 0; i < count; ++i) {
+        if (!validateValue(cells[i], schema.columns[i].type)) {
             return false;
         }
         
         // Check NOT NULL constraint
         for (const auto& constraint : schema.columns[i].constraints) {
-            if (constraint.type == Constraint::NOT_NULL) {
-                if (std::holds_alternative<std::nullptr_t>(row.values[i])) {
-                    return false;
-                }
+            if (constraint.type == Constraint::NOT_NULL && cells[i].isNull()) {
+                return false;
             }
         }
     }
@@ -0,0 +1,155 @@
+#include "../../include/types/ValidationProgram.hpp"
+#include "../../include/parser/Expression.hpp"
+#include "../../include/parser/ExpressionParser.hpp"
+#include "../../include/parser/Tokenizer.hpp"
+#include <algorithm>
+
+namespace parallaxdb {
+
+std::string ValidationFailure::toString(const Schema& schema) const {
+    const Column& col = schema.columns[column];
+    std::string where = "row " + std::to_string(row) + ", column '" + col.name + "'";
+    switch (reason) {
+        case TYPE_MISMATCH:
+            return where + ": expected " + DataValidator::getTypeName(col.type);
+        case NOT_NULL:
+            return where + ": NULL in NOT NULL column";
+        case BOOLEAN_RANGE:
+            return where + ": BOOLEAN must be 0 or 1";
+        case CHECK:
+            return "row " + std::to_string(row) + ": violates CHECK (" + constraint + ")";
+    }
+    return where;
+}
+
+ValidationProgram::ValidationProgram(const Schema& schema) {
+    std::vector<std::string> names;
+    for (const auto& column : schema.columns) {
+        names.push_back(column.name);
+    }
+
+    for (size_t c = 0; c < schema.columns.size(); ++c) {
+        const Column& column = schema.columns[c];
+        ColumnStep step{0, false, column.type == DataType::BOOLEAN};
+        switch (column.type) {
+            case DataType::INT:
+            case DataType::BOOLEAN:
+                step.allowedKinds = kindBit(CompactValue::Kind::INT);
+                break;
+            case DataType::DOUBLE:
+                step.allowedKinds = kindBit(CompactValue::Kind::INT) | kindBit(CompactValue::Kind::DOUBLE);
+                break;
+            case DataType::STRING:
+                step.allowedKinds = kindBit(CompactValue::Kind::STRING);
+                break;
+        }
+
+        for (const auto& constraint : column.constraints) {
+            if (constraint.type == Constraint::NOT_NULL) {
+                step.notNull = true;
+            } else if (constraint.type == Constraint::CHECK && constraint.checkExpression) {
+                CheckStep check;
+                check.column = c;
+                check.text = *constraint.checkExpression;
+
+                Tokenizer tokenizer(check.text);
+                auto tokens = tokenizer.tokenize();
+                size_t pos = 0;
+                check.expr = ExpressionParser::parseWhereExpression(tokens, pos);
+                if (pos < tokens.size() && tokens[pos].type != TokenType::END_OF_INPUT) {
+                    throw std::runtime_error("Unexpected token in CHECK (" + check.text + ") [pos=" +
+                                             std::to_string(tokens[pos].position) + "]");
+                }
+                check.expr->bind(names);
+
+                std::vector<std::string> referenced;
+                check.expr->collectColumns(referenced);
+                for (const auto& name : referenced) {
+                    check.inputs.push_back(static_cast<size_t>(findColumn(names, name)));
+                }
+                checks.push_back(std::move(check));
+            }
+        }
+        if (!step.notNull) {
+            step.allowedKinds |= kindBit(CompactValue::Kind::NULL_VALUE);
+        }
+        columns.push_back(step);
+    }
+}
+
+ValidationProgram::~ValidationProgram() = default;
+
+bool ValidationProgram::checkPasses(const CheckStep& check, const CompactValue* row) const {
+    // A CHECK that evaluates to unknown (a NULL input) is satisfied
+    for (size_t input : check.inputs) {
+        if (row[input].isNull()) return true;
+    }
+    return check.expr->evaluate(row);
+}
+
+bool ValidationProgram::validate(const CompactValue* cells, size_t rows,
+                                 std::vector<ValidationFailure>& failures) const {
+    const size_t w = columns.size();
+    const size_t firstFailure = failures.size();
+    std::vector<uint8_t> rowOk(rows, 1);
+
+    for (size_t c = 0; c < w; ++c) {
+        const ColumnStep& step = columns[c];
+        const CompactValue* cell = cells + c;
+        for (size_t r = 0; r < rows; ++r, cell += w) {
+            const CompactValue::Kind kind = cell->kind();
+            bool rangeOk = !step.boolean || kind != CompactValue::Kind::INT ||
+                           static_cast<unsigned>(cell->asInt()) <= 1;
+            if ((step.allowedKinds & kindBit(kind)) && rangeOk) continue;
+
+            ValidationFailure::Reason reason = ValidationFailure::BOOLEAN_RANGE;
+            if (kind == CompactValue::Kind::NULL_VALUE) reason = ValidationFailure::NOT_NULL;
+            else if (!(step.allowedKinds & kindBit(kind))) reason = ValidationFailure::TYPE_MISMATCH;
+            failures.push_back({r, c, reason, ""});
+            rowOk[r] = 0;
+        }
+    }
+
+    // CHECK expressions only see rows whose cells are well-typed
+    for (const auto& check : checks) {
+        const CompactValue* row = cells;
+        for (size_t r = 0; r < rows; ++r, row += w) {
+            if (rowOk[r] && !checkPasses(check, row)) {
+                failures.push_back({r, check.column, ValidationFailure::CHECK, check.text});
+            }
+        }
+    }
+
+    if (failures.size() == firstFailure) return true;
+    std::stable_sort(failures.begin() + firstFailure, failures.end(),
+                     [](const ValidationFailure& a, const ValidationFailure& b) {
+                         return a.row != b.row ? a.row < b.row : a.column < b.column;
+                     });
+    return false;
+}
+
+bool ValidationProgram::validateRow(const CompactValue* cells, size_t count) const {
+    if (count != columns.size()) return false;
+    for (size_t c = 0; c < count; ++c) {
+        const ColumnStep& step = columns[c];
+        const CompactValue::Kind kind = cells[c].kind();
+        if (!(step.allowedKinds & kindBit(kind))) return false;
+        if (step.boolean && kind == CompactValue::Kind::INT && static_cast<unsigned>(cells[c].asInt()) > 1) {
+            return false;
+        }
+    }
+    for (const auto& check : checks) {
+        if (!checkPasses(check, cells)) return false;
+    }
+    return true;
+}
+
+std::vector<size_t> ValidationError::getRows() const {
+    std::vector<size_t> rows;
+    for (const auto& failure : failures) {
+        if (rows.empty() || rows.back() != failure.row) rows.push_back(failure.row);
+    }
+    return rows;
+}
+
+} // namespace parallaxdb
@@ -0,0 +1,194 @@
+#include "../../include/util/HugePages.hpp"
+#include "../../include/util/MemoryTracker.hpp"
+#include <atomic>
+#include <fstream>
+#include <new>
+#include <string>
+#include <sys/mman.h>
+
+namespace parallaxdb {
+
+namespace {
+
+enum class Backing { EXPLICIT, TRANSPARENT, REGULAR_MAPPING, HEAP };
+
+struct Registry {
+    std::mutex mutex;
+    std::unordered_map<void*, Backing> live;   // Allocations of at least kMinBytes
+    HugePageStats stats;
+};
+
+Registry& registry() {
+    static Registry* instance = new Registry();   // Outlives static destructors that free
+    return *instance;
+}
+
+std::atomic<HugePagePolicy> policy{HugePagePolicy::TRANSPARENT};
+
+size_t roundToPages(size_t bytes) {
+    return (bytes + HugePageResource::kPageBytes - 1) & ~(HugePageResource::kPageBytes - 1);
+}
+
+// A 2MB-aligned anonymous mapping of `length` bytes, or nullptr
+void* mapAligned(size_t length) {
+    const size_t slack = HugePageResource::kPageBytes;
+    void* raw = mmap(nullptr, length + slack, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) return nullptr;
+    const uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+    const uintptr_t aligned = (start + slack - 1) & ~(slack - 1);
+    if (aligned > start) munmap(raw, aligned - start);
+    const uintptr_t end = start + length + slack;
+    if (end > aligned + length) munmap(reinterpret_cast<void*>(aligned + length), end - aligned - length);
+    return reinterpret_cast<void*>(aligned);
+}
+
+uint64_t& statFor(HugePageStats& stats, Backing backing) {
+    switch (backing) {
+        case Backing::EXPLICIT: return stats.explicitBytes;
+        case Backing::TRANSPARENT: return stats.transparentBytes;
+        default: return stats.regularBytes;
+    }
+}
+
+} // namespace
+
+HugePageResource* HugePageResource::get() {
+    static HugePageResource instance;
+    return &instance;
+}
+
+void HugePageResource::setPolicy(HugePagePolicy newPolicy) {
+    policy.store(newPolicy);
+}
+
+HugePagePolicy HugePageResource::getPolicy() {
+    return policy.load();
+}
+
+HugePageStats HugePageResource::getStats() {
+    std::lock_guard<std::mutex> lock(registry().mutex);
+    return registry().stats;
+}
+
+uint64_t HugePageResource::getResidentTransparentBytes() {
+    std::ifstream file("/proc/self/smaps_rollup");
+    std::string key;
+    uint64_t kilobytes;
+    while (file >> key >> kilobytes) {
+        if (key == "AnonHugePages:") return kilobytes * 1024;
+        file.ignore(256, '\n');
+    }
+    return 0;
+}
+
+void* HugePageResource::do_allocate(size_t bytes, size_t alignment) {
+    if (bytes < kMinBytes) {
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    const HugePagePolicy wanted = policy.load();
+    const size_t length = roundToPages(bytes);
+    void* data = nullptr;
+    Backing backing = Backing::HEAP;
+    bool fellBack = false;
+    if (wanted == HugePagePolicy::EXPLICIT) {
+        data = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (data == MAP_FAILED) {
+            data = nullptr;
+            fellBack = true;   // Pool empty or absent
+        } else {
+            backing = Backing::EXPLICIT;
+        }
+    }
+    if (!data && wanted != HugePagePolicy::OFF) {
+        data = mapAligned(length);
+        if (!data) throw std::bad_alloc();
+        if (madvise(data, length, MADV_HUGEPAGE) == 0) {
+            backing = Backing::TRANSPARENT;
+        } else {
+            backing = Backing::REGULAR_MAPPING;   // THP disabled or unsupported
+            fellBack = true;
+        }
+    }
+    if (!data) {
+        data = std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    } else {
+        MemoryTracker::recordMapped(static_cast<int64_t>(length));
+    }
+
+    std::lock_guard<std::mutex> lock(registry().mutex);
+    registry().live.emplace(data, backing);
+    statFor(registry().stats, backing) += backing == Backing::HEAP ? bytes : length;
+    registry().stats.fallbacks += fellBack;
+    return data;
+}
+
+void HugePageResource::do_deallocate(void* data, size_t bytes, size_t alignment) {
+    if (bytes < kMinBytes) {
+        std::pmr::new_delete_resource()->deallocate(data, bytes, alignment);
+        return;
+    }
+    Backing backing;
+    {
+        std::lock_guard<std::mutex> lock(registry().mutex);
+        auto it = registry().live.find(data);
+        backing = it->second;
+        registry().live.erase(it);
+        statFor(registry().stats, backing) -= backing == Backing::HEAP ? bytes : roundToPages(bytes);
+    }
+    if (backing == Backing::HEAP) {
+        std::pmr::new_delete_resource()->deallocate(data, bytes, alignment);
+    } else {
+        munmap(data, roundToPages(bytes));
+        MemoryTracker::recordMapped(-static_cast<int64_t>(roundToPages(bytes)));
+    }
+}
+
+void HugePageSlab::release() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (void* chunk : chunks) {
+        HugePageResource::get()->deallocate(chunk, kChunkBytes, HugePageResource::kPageBytes);
+    }
+    chunks.clear();
+    reusable.clear();
+    used = kChunkBytes;
+}
+
+size_t HugePageSlab::getMappedBytes() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return chunks.size() * kChunkBytes;
+}
+
+void* HugePageSlab::do_allocate(size_t bytes, size_t alignment) {
+    // Big buffers would strand too much of a chunk
+    if (bytes > kChunkBytes / 4 || alignment > 64) {
+        return HugePageResource::get()->allocate(bytes, alignment);
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<void*>& list = reusable[bytes];
+    if (!list.empty()) {
+        void* data = list.back();
+        list.pop_back();
+        return data;
+    }
+    // Carve on cache-line boundaries; the tail of a chunk too short for the
+    // request is abandoned
+    used = (used + 63) & ~size_t(63);
+    if (used + bytes > kChunkBytes) {
+        chunks.push_back(HugePageResource::get()->allocate(kChunkBytes, HugePageResource::kPageBytes));
+        used = 0;
+    }
+    void* data = static_cast<char*>(chunks.back()) + used;
+    used += bytes;
+    return data;
+}
+
+void HugePageSlab::do_deallocate(void* data, size_t bytes, size_t alignment) {
+    if (bytes > kChunkBytes / 4 || alignment > 64) {
+        HugePageResource::get()->deallocate(data, bytes, alignment);
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    reusable[bytes].push_back(data);
+}
+
+} // namespace parallaxdb
@@ -0,0 +1,67 @@
+#include "../../include/util/MemoryTracker.hpp"
+#include <cstdlib>
+#include <new>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+namespace parallaxdb {
+
+namespace {
+
+thread_local uint64_t bytesAllocated = 0;
+thread_local int64_t currentBytes = 0;
+thread_local int64_t peakBytes = 0;
+
+void* trackedAlloc(size_t size) {
+    void* ptr = std::malloc(size == 0 ? 1 : size);
+    if (!ptr) return nullptr;
+#if defined(__GLIBC__)
+    size = malloc_usable_size(ptr);
+#endif
+    bytesAllocated += size;
+    currentBytes += static_cast<int64_t>(size);
+    if (currentBytes > peakBytes) peakBytes = currentBytes;
+    return ptr;
+}
+
+void trackedFree(void* ptr) {
+    if (!ptr) return;
+#if defined(__GLIBC__)
+    // Without the usable size only allocations are tracked
+    currentBytes -= static_cast<int64_t>(malloc_usable_size(ptr));
+#endif
+    std::free(ptr);
+}
+
+void* allocOrThrow(size_t size) {
+    void* ptr = trackedAlloc(size);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+} // namespace
+
+uint64_t MemoryTracker::getBytesAllocated() { return bytesAllocated; }
+int64_t MemoryTracker::getCurrentBytes() { return currentBytes; }
+int64_t MemoryTracker::getPeakBytes() { return peakBytes; }
+void MemoryTracker::setPeakBytes(int64_t peak) { peakBytes = peak; }
+
+void MemoryTracker::recordMapped(int64_t bytes) {
+    if (bytes > 0) bytesAllocated += static_cast<uint64_t>(bytes);
+    currentBytes += bytes;
+    if (currentBytes > peakBytes) peakBytes = currentBytes;
+}
+
+} // namespace parallaxdb
+
+void* operator new(size_t size) { return parallaxdb::allocOrThrow(size); }
+void* operator new[](size_t size) { return parallaxdb::allocOrThrow(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return parallaxdb::trackedAlloc(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return parallaxdb::trackedAlloc(size); }
+void operator delete(void* ptr) noexcept { parallaxdb::trackedFree(ptr); }
+void operator delete[](void* ptr) noexcept { parallaxdb::trackedFree(ptr); }
+void operator delete(void* ptr, size_t) noexcept { parallaxdb::trackedFree(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { parallaxdb::trackedFree(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { parallaxdb::trackedFree(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { parallaxdb::trackedFree(ptr); }
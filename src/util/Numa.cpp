@@ -0,0 +1,148 @@
+#include "../../include/util/Numa.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <fstream>
+#include <sched.h>
+#include <sstream>
+#include <stdexcept>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace parallaxdb {
+
+namespace {
+
+// From <linux/mempolicy.h>, spelled out so the engine needs neither libnuma
+// nor its headers
+constexpr int kMpolPreferred = 1;
+
+std::shared_ptr<const NumaTopology>& installed() {
+    static std::shared_ptr<const NumaTopology> topology;
+    return topology;
+}
+
+std::vector<int> allowedCpus() {
+    std::vector<int> cpus;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+        }
+    }
+    if (cpus.empty()) cpus.push_back(0);
+    return cpus;
+}
+
+} // namespace
+
+std::vector<int> NumaTopology::parseCpuList(const std::string& list) {
+    std::vector<int> cpus;
+    std::stringstream stream(list);
+    std::string range;
+    while (std::getline(stream, range, ',')) {
+        range.erase(std::remove_if(range.begin(), range.end(), [](char c) { return std::isspace(static_cast<unsigned char>(c)); }),
+                    range.end());
+        if (range.empty()) continue;
+        try {
+            const size_t dash = range.find('-');
+            const int first = std::stoi(range.substr(0, dash));
+            const int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+            if (first < 0 || last < first) throw std::invalid_argument(range);
+            for (int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+        } catch (const std::logic_error&) {
+            throw std::runtime_error("Malformed CPU list: '" + list + "'");
+        }
+    }
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    return cpus;
+}
+
+NumaTopology NumaTopology::flat() {
+    NumaTopology topology;
+    topology.nodes.push_back(allowedCpus());
+    topology.ids.push_back(0);
+    return topology;
+}
+
+NumaTopology NumaTopology::detect(const std::string& sysfsRoot) {
+    // Node numbers may have gaps after hot-unplug; probe a generous range and
+    // keep the nodes that have CPUs, in order
+    NumaTopology topology;
+    for (int node = 0; node < 1024; ++node) {
+        std::ifstream file(sysfsRoot + "/node" + std::to_string(node) + "/cpulist");
+        if (!file) continue;
+        std::string list;
+        std::getline(file, list);
+        std::vector<int> cpus = parseCpuList(list);
+        if (cpus.empty()) continue;   // Memory-only node
+        topology.nodes.push_back(std::move(cpus));
+        topology.ids.push_back(node);
+    }
+    if (topology.nodes.empty()) return flat();
+    return topology;
+}
+
+std::shared_ptr<const NumaTopology> NumaTopology::current() {
+    std::shared_ptr<const NumaTopology> topology = std::atomic_load(&installed());
+    if (topology) return topology;
+    std::shared_ptr<const NumaTopology> detected = std::make_shared<NumaTopology>(detect());
+    // Lose gracefully to a concurrent install()
+    std::atomic_compare_exchange_strong(&installed(), &topology, detected);
+    return topology ? topology : detected;
+}
+
+void NumaTopology::install(NumaTopology topology) {
+    std::atomic_store(&installed(), std::shared_ptr<const NumaTopology>(
+        std::make_shared<NumaTopology>(std::move(topology))));
+}
+
+size_t NumaTopology::nodeOfCpu(int cpu) const {
+    for (size_t node = 0; node < nodes.size(); ++node) {
+        if (std::binary_search(nodes[node].begin(), nodes[node].end(), cpu)) return node;
+    }
+    return 0;
+}
+
+size_t NumaTopology::currentNode() const {
+    const int cpu = sched_getcpu();
+    return cpu < 0 ? 0 : nodeOfCpu(cpu);
+}
+
+bool NumaTopology::pinThread(size_t node) const {
+    if (node >= nodes.size()) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : nodes[node]) {
+        if (cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+    }
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+void NumaTopology::unpinThread() {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) CPU_SET(cpu, &set);
+    sched_setaffinity(0, sizeof(set), &set);   // The kernel trims it to the CPUs that exist
+}
+
+bool NumaTopology::bindMemory(void* data, size_t bytes, size_t node) const {
+#ifdef SYS_mbind
+    if (node >= ids.size()) return false;
+    const uintptr_t page = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    const uintptr_t begin = (reinterpret_cast<uintptr_t>(data) + page - 1) & ~(page - 1);
+    const uintptr_t end = (reinterpret_cast<uintptr_t>(data) + bytes) & ~(page - 1);
+    if (begin >= end) return false;   // No whole page to place
+    constexpr size_t kMaskBits = 8 * sizeof(unsigned long);
+    if (static_cast<size_t>(ids[node]) >= kMaskBits) return false;
+    unsigned long mask = 1UL << ids[node];
+    return syscall(SYS_mbind, begin, end - begin, kMpolPreferred, &mask, kMaskBits + 1, 0) == 0;
+#else
+    (void)data; (void)bytes; (void)node;
+    return false;
+#endif
+}
+
+} // namespace parallaxdb
@@ -2,7 +2,27 @@
 #include <cassert>
 #include "../include/storage/Database.hpp"
 #include "../include/parser/SQLProcessor.hpp"
+#include "../include/executor/QueryExecutor.hpp"
+#include "../include/planner/SelectivityEstimator.hpp"
+#include "../include/planner/WindowNode.hpp"
+#include "../include/planner/DistinctNode.hpp"
+#include "../include/jit/FilterJit.hpp"
+#include "../include/storage/TrigramIndex.hpp"
+#include "../include/storage/AsyncIO.hpp"
+#include "../include/storage/Statistics.hpp"
+#include "../include/util/HugePages.hpp"
+#include "../include/util/Numa.hpp"
 #include "../include/types/Common.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <thread>
+#include <tuple>
+#include <unistd.h>
 
 using namespace parallaxdb;
 
@@ -25,7 +45,7 @@ void test_basic_table_operations() {
     
     const Table* users = db.getTable("users");
     assert(users != nullptr);
-    assert(users->getRows().size() == 2);
+    assert(users->getRowCount() == 2);
     std::cout << "✓ Basic table operations passed" << std::endl;
 }
 
@@ -56,11 +76,1866 @@ void test_query_execution() {
     std::cout << "✓ Query execution tests passed" << std::endl;
 }
 
+void test_table_statistics() {
+    std::cout << "Testing table statistics..." << std::endl;
+    
+    Database db;
+    
+    Schema eventsSchema("events");
+    eventsSchema.columns = {
+        {"id", DataType::INT},
+        {"kind", DataType::STRING},
+        {"score", DataType::DOUBLE}
+    };
+    
+    db.createTable("events", eventsSchema);
+    for (int i = 0; i < 2000; ++i) {
+        std::string kind = (i % 2 == 0) ? "click" : ("view" + std::to_string(i % 40));
+        db.insertInto("events", {i, kind, static_cast<double>(i % 100)});
+    }
+    
+    // Incremental statistics are available before ANALYZE
+    const Table* events = db.getTable("events");
+    const TableStatistics& stats = events->getStatistics();
+    assert(stats.getRowCount() == 2000);
+    assert(!stats.isAnalyzed());
+    double idDistinct = stats.getColumn(0).distinctCount();
+    assert(idDistinct > 1900 && idDistinct <= 2000);
+    
+    SQLProcessor::processStatement("ANALYZE events", db);
+    assert(stats.isAnalyzed());
+    assert(stats.getModificationsSinceAnalyze() == 0);
+    
+    // Most common value and equi-depth histogram
+    const ColumnStatistics& kind = stats.getColumn(1);
+    assert(!kind.mostCommonValues.empty());
+    assert(std::get<std::string>(kind.mostCommonValues[0].first) == "click");
+    double clickSel = kind.estimateSelectivity("=", std::string("click"));
+    assert(clickSel > 0.45 && clickSel < 0.55);
+    
+    const ColumnStatistics& id = stats.getColumn(0);
+    assert(id.histogramBounds.size() == TableStatistics::kHistogramBuckets + 1);
+    double rangeSel = id.estimateSelectivity("<", 500);
+    assert(rangeSel > 0.2 && rangeSel < 0.3);
+    assert(id.estimateSelectivity(">", 5000) == 0.0);
+    
+    // Predicate selectivity for the optimizer
+    ComparisonExpr lowScore("score", "<", 10.0);
+    ComparisonExpr isClick("kind", "=", std::string("click"));
+    double conj = SelectivityEstimator::estimate(lowScore, *events) * SelectivityEstimator::estimate(isClick, *events);
+    assert(conj > 0.03 && conj < 0.07);
+    
+    // Null fraction
+    TableStatistics nullable(1);
+    for (int i = 0; i < 10; ++i) {
+        nullable.recordInsert(Row{{i < 3 ? Value(nullptr) : Value(i)}});
+    }
+    assert(nullable.getColumn(0).nullFraction() == 0.3);
+    
+    std::cout << "✓ Table statistics tests passed" << std::endl;
+}
+
+void test_cost_based_optimizer() {
+    std::cout << "Testing cost-based optimizer..." << std::endl;
+    
+    Database db;
+    
+    Schema customersSchema("customers");
+    customersSchema.columns = {
+        {"id", DataType::INT},
+        {"region", DataType::STRING}
+    };
+    Schema ordersSchema("orders");
+    ordersSchema.columns = {
+        {"id", DataType::INT},
+        {"customer_id", DataType::INT},
+        {"amount", DataType::INT}
+    };
+    Schema regionsSchema("regions");
+    regionsSchema.columns = {
+        {"name", DataType::STRING},
+        {"manager", DataType::STRING}
+    };
+    db.createTable("customers", customersSchema);
+    db.createTable("orders", ordersSchema);
+    db.createTable("regions", regionsSchema);
+    
+    for (int i = 0; i < 100; ++i) {
+        db.insertInto("customers", {i, i % 4 == 0 ? "north" : "south"});
+    }
+    for (int i = 0; i < 1000; ++i) {
+        db.insertInto("orders", {i, i % 100, i % 50});
+    }
+    db.insertInto("regions", {"north", "Ann"});
+    db.insertInto("regions", {"south", "Sam"});
+    SQLProcessor::processStatement("ANALYZE", db);
+    
+    // Join with pushed-down predicates and a projection
+    auto plan = SQLParser::parse(
+        "SELECT o.id, c.region FROM orders o JOIN customers c ON o.customer_id = c.id "
+        "WHERE c.region = 'north' AND o.amount < 10", db);
+    assert(plan != nullptr);
+    auto rows = QueryExecutor::execute(*plan);
+    // customers 0,4,...,96 are north; order i has customer i % 100 and amount i % 50
+    size_t expected = 0;
+    for (int i = 0; i < 1000; ++i) {
+        if ((i % 100) % 4 == 0 && i % 50 < 10) expected++;
+    }
+    assert(rows.size() == expected);
+    for (const auto& row : rows) {
+        assert(row.values.size() == 2);
+        assert(std::get<std::string>(row.values[1]) == "north");
+    }
+    
+    // Predicates are pushed into their scans, which output only the columns
+    // needed above them, and the join builds on the smaller input
+    std::string explained = explainPlan(*plan);
+    assert(explained.find("HashJoin [o.customer_id = c.id]") != std::string::npos);
+    assert(explained.find("TableScan orders AS o [id, customer_id] WHERE [o.amount < 10]") != std::string::npos);
+    assert(explained.find("TableScan customers AS c [id, region] WHERE [c.region = 'north']") != std::string::npos);
+    
+    // Three-way join: the selective regions table is joined before orders
+    auto plan3 = SQLParser::parse(
+        "SELECT o.id, r.manager FROM orders o JOIN customers c ON o.customer_id = c.id "
+        "JOIN regions r ON c.region = r.name WHERE r.manager = 'Ann'", db);
+    assert(plan3 != nullptr);
+    auto rows3 = QueryExecutor::execute(*plan3);
+    assert(rows3.size() == 250);
+    std::string explained3 = explainPlan(*plan3);
+    size_t outerJoin = explained3.find("HashJoin [o.customer_id = c.id]");
+    size_t innerJoin = explained3.find("HashJoin [c.region = r.name]");
+    assert(outerJoin != std::string::npos && innerJoin != std::string::npos);
+    assert(outerJoin < innerJoin);
+    
+    // SELECT * over a join keeps the written column order
+    auto planStar = SQLParser::parse("SELECT * FROM customers JOIN regions ON region = name", db);
+    assert(planStar != nullptr);
+    assert(planStar->getOutputColumns().size() == 4);
+    assert(planStar->getOutputColumns()[0] == "customers.id");
+    assert(planStar->getOutputColumns()[3] == "regions.manager");
+    assert(QueryExecutor::execute(*planStar).size() == 100);
+    
+    // Unknown tables and ambiguous columns are rejected
+    assert(SQLParser::parse("SELECT * FROM missing", db) == nullptr);
+    assert(SQLParser::parse("SELECT id FROM orders JOIN customers ON customer_id = id", db) == nullptr);
+    
+    SQLProcessor::processStatement("EXPLAIN SELECT id FROM orders WHERE amount > 40", db);
+    
+    std::cout << "✓ Cost-based optimizer tests passed" << std::endl;
+}
+
+void test_adaptive_filter() {
+    std::cout << "Testing adaptive predicate reordering..." << std::endl;
+    
+    Database db;
+    
+    Schema metricsSchema("metrics");
+    metricsSchema.columns = {
+        {"host", DataType::STRING},
+        {"value", DataType::INT}
+    };
+    db.createTable("metrics", metricsSchema);
+    for (int i = 0; i < 20000; ++i) {
+        db.insertInto("metrics", {"host" + std::to_string(i % 8), i % 1000});
+    }
+    
+    // The unselective predicate is written first. Compiled code would skip
+    // the adaptive order, so this scan stays interpreted.
+    FilterJit::instance().setEnabled(false);
+    auto plan = SQLParser::parse("SELECT * FROM metrics WHERE host != 'none' AND value = 7", db);
+    assert(plan != nullptr);
+    TableScanNode* scan = dynamic_cast<TableScanNode*>(plan.get());
+    assert(scan != nullptr);
+    assert(scan->getConjunctOrder()[0] == 0);
+    
+    auto rows = QueryExecutor::execute(*plan);
+    assert(rows.size() == 20);
+    assert(scan->getConjunctOrder()[0] == 1);
+    assert(scan->getDetails() == "metrics [host, value] WHERE [value = 7 AND host != 'none']");
+    FilterJit::instance().setEnabled(true);
+    
+    // A standalone filter over a join output adapts the same way
+    auto child = std::make_unique<TableScanNode>(*db.getTable("metrics"));
+    FilterNode filter(std::move(child), std::make_unique<LogicalExpr>("AND",
+        std::make_unique<ComparisonExpr>("value", ">=", 0),
+        std::make_unique<ComparisonExpr>("host", "=", std::string("host3"))));
+    assert(QueryExecutor::execute(filter).size() == 2500);
+    assert(filter.getConjunctOrder()[0] == 1);
+    
+    std::cout << "✓ Adaptive predicate reordering tests passed" << std::endl;
+}
+
+void test_late_materialization() {
+    std::cout << "Testing late materialization..." << std::endl;
+    
+    Database db;
+    
+    Schema wideSchema("wide");
+    for (int c = 0; c < 60; ++c) {
+        wideSchema.columns.push_back({"c" + std::to_string(c), DataType::INT});
+    }
+    db.createTable("wide", wideSchema);
+    for (int i = 0; i < 3000; ++i) {
+        std::vector<Value> values;
+        for (int c = 0; c < 60; ++c) values.push_back(i * 100 + c);
+        db.insertInto("wide", values);
+    }
+    
+    // Only the projected columns are materialized; the predicate column is not
+    auto plan = SQLParser::parse("SELECT c1, c59 FROM wide WHERE c30 < 1030", db);
+    assert(plan != nullptr);
+    assert(dynamic_cast<TableScanNode*>(plan.get()) != nullptr);
+    assert(plan->getOutputColumns().size() == 2);
+    auto rows = QueryExecutor::execute(*plan);
+    assert(rows.size() == 10);
+    for (size_t i = 0; i < rows.size(); ++i) {
+        assert(rows[i].values.size() == 2);
+        assert(std::get<int>(rows[i].values[0]) == static_cast<int>(i) * 100 + 1);
+        assert(std::get<int>(rows[i].values[1]) == static_cast<int>(i) * 100 + 59);
+    }
+    
+    std::cout << "✓ Late materialization tests passed" << std::endl;
+}
+
+void test_query_arena() {
+    std::cout << "Testing per-query arena..." << std::endl;
+    
+    Database db;
+    Schema schema("items");
+    schema.columns = {{"id", DataType::INT}, {"name", DataType::STRING}};
+    db.createTable("items", schema);
+    for (int i = 0; i < 5000; ++i) {
+        db.insertInto("items", {i, std::string("item") + std::to_string(i)});
+    }
+    
+    // Plan and expression nodes come from the arena while a scope is active
+    QueryArena arena;
+    {
+        ArenaScope scope(arena);
+        auto plan = SQLParser::parse("SELECT name FROM items WHERE id >= 10 AND id < 2010", db);
+        assert(plan != nullptr);
+        assert(arena.getBytesAllocated() > 0);
+        assert(QueryArena::current() == &arena);
+        assert(QueryExecutor::execute(*plan).size() == 2000);
+    }
+    assert(arena.getBytesAllocated() == 0);
+    assert(QueryArena::current() == nullptr);
+    
+    // Outside a scope the same nodes fall back to the heap
+    auto heapPlan = SQLParser::parse("SELECT id FROM items WHERE id < 3", db);
+    assert(QueryExecutor::execute(*heapPlan).size() == 3);
+    assert(arena.getBytesAllocated() == 0);
+    
+    // Cleared batches hand their row buffers back out
+    RowBatch batch;
+    batch.appendRow().values = {1, 2, 3};
+    const Value* buffer = batch.rows[0].values.data();
+    batch.clear();
+    Row& reused = batch.appendRow();
+    assert(reused.values.empty());
+    assert(reused.values.capacity() >= 3);
+    assert(reused.values.data() == buffer);
+    
+    std::cout << "✓ Per-query arena tests passed" << std::endl;
+}
+
+void test_compact_values() {
+    std::cout << "Testing compact value storage..." << std::endl;
+    
+    static_assert(sizeof(CompactValue) == 16);
+    
+    // Short strings are inlined, long ones point at their buffer
+    std::string longText = "a string well past the inline limit";
+    CompactValue shortCell = CompactValue::ofString("hello");
+    CompactValue exactCell = CompactValue::ofString("twelve bytes");
+    CompactValue longCell = CompactValue::ofString(longText);
+    assert(shortCell.isInlined() && exactCell.isInlined() && !longCell.isInlined());
+    assert(shortCell.asString() == "hello");
+    assert(exactCell.asString() == "twelve bytes");
+    assert(longCell.asString().data() == longText.data());
+    assert(std::get<std::string>(longCell.toValue()) == longText);
+    assert(CompactValue::ofInt(-7).asInt() == -7);
+    assert(CompactValue::ofDouble(2.5).asDouble() == 2.5);
+    assert(CompactValue().isNull());
+    
+    // Comparisons follow the Value semantics
+    std::string otherLong = "a string well past the inline limiT";
+    CompactValue otherCell = CompactValue::ofString(otherLong);
+    assert(!applyComparison(longCell, CompareOp::EQ, otherCell));
+    assert(applyComparison(otherCell, CompareOp::LT, longCell));
+    assert(applyComparison(shortCell, CompareOp::EQ, CompactValue::ofString("hello")));
+    assert(applyComparison(shortCell, CompareOp::LT, CompactValue::ofString("hello!")));
+    assert(applyComparison(CompactValue::ofString("b"), CompareOp::GT, CompactValue::ofString("abcdef")));
+    assert(applyComparison(CompactValue::ofInt(3), CompareOp::LT, CompactValue::ofDouble(3.5)));
+    assert(applyComparison(CompactValue::ofInt(3), CompareOp::NE, shortCell));
+    assert(!applyComparison(CompactValue(), CompareOp::EQ, CompactValue()));
+    
+    // Tables store cells and intern long strings in their heap
+    Database db;
+    Schema schema("docs");
+    schema.columns = {{"id", DataType::INT}, {"title", DataType::STRING}, {"score", DataType::DOUBLE}};
+    db.createTable("docs", schema);
+    for (int i = 0; i < 3000; ++i) {
+        std::string title = (i % 2 == 0) ? "doc" + std::to_string(i) : "a much longer document title " + std::to_string(i);
+        db.insertInto("docs", {i, title, i * 0.5});
+    }
+    const Table* docs = db.getTable("docs");
+    assert(docs->getRowCount() == 3000);
+    assert(docs->getStorageBytes() < 3000 * 3 * sizeof(Value));
+    Row row = docs->getRow(7);
+    assert(std::get<int>(row.values[0]) == 7);
+    assert(std::get<std::string>(row.values[1]) == "a much longer document title 7");
+    assert(std::get<double>(row.values[2]) == 3.5);
+    
+    auto plan = SQLParser::parse(
+        "SELECT id FROM docs WHERE title = 'a much longer document title 1001' AND score > 1", db);
+    auto rows = QueryExecutor::execute(*plan);
+    assert(rows.size() == 1 && std::get<int>(rows[0].values[0]) == 1001);
+    plan = SQLParser::parse("SELECT title FROM docs WHERE title >= 'doc' AND id < 10", db);
+    assert(QueryExecutor::execute(*plan).size() == 5);
+    
+    std::cout << "✓ Compact value storage tests passed" << std::endl;
+}
+
+void test_explain_analyze() {
+    std::cout << "Testing EXPLAIN ANALYZE..." << std::endl;
+    
+    Database db;
+    Schema orders("orders");
+    orders.columns = {{"id", DataType::INT}, {"customer_id", DataType::INT}, {"amount", DataType::INT}};
+    db.createTable("orders", orders);
+    Schema customers("customers");
+    customers.columns = {{"id", DataType::INT}, {"name", DataType::STRING}};
+    db.createTable("customers", customers);
+    for (int i = 0; i < 100; ++i) {
+        db.insertInto("customers", {i, std::string("customer") + std::to_string(i)});
+    }
+    for (int i = 0; i < 5000; ++i) {
+        db.insertInto("orders", {i, i % 100, i % 50});
+    }
+    
+    auto plan = SQLParser::parse(
+        "SELECT o.id, c.name FROM orders o JOIN customers c ON o.customer_id = c.id WHERE o.amount < 5", db);
+    std::string text = QueryExecutor::explainAnalyze(*plan);
+    assert(text.find("Execution time:") != std::string::npos);
+    assert(text.find("(500 rows)") != std::string::npos);
+    assert(text.find("[actual rows=500 ") != std::string::npos);
+    assert(text.find("TableScan orders AS o") != std::string::npos);
+    
+    // Row counts flow between operators: the scan reads every row
+    const QueryPlanNode* node = plan.get();
+    while (!node->getChildren().empty()) {
+        if (node->getName() == "HashJoin") break;
+        node = node->getChildren()[0];
+    }
+    assert(node->getName() == "HashJoin");
+    assert(node->getProfile().rowsOut == 500);
+    uint64_t scanned = 0;
+    for (const QueryPlanNode* child : node->getChildren()) {
+        scanned += child->getProfile().rowsIn;
+        assert(child->getProfile().batches > 0);
+        assert(child->getProfile().wallNanos > 0);
+    }
+    assert(scanned == 5100);
+    assert(node->getProfile().bytesAllocated > 0);
+    assert(node->getProfile().peakBytes > 0);
+    
+    auto jsonPlan = SQLParser::parse("SELECT id FROM orders WHERE amount = 3", db);
+    std::string json = QueryExecutor::explainAnalyze(*jsonPlan, ExplainFormat::JSON);
+    assert(json.find("{\"plan\": {\"operator\": \"TableScan\"") == 0);
+    assert(json.find("\"rows_out\": 100") != std::string::npos);
+    assert(json.find("\"rows_in\": 5000") != std::string::npos);
+    assert(json.find("\"rows\": 100") != std::string::npos);
+    
+    SQLProcessor::processStatement("EXPLAIN ANALYZE SELECT id FROM orders WHERE amount = 3", db);
+    SQLProcessor::processStatement("EXPLAIN ANALYZE FORMAT JSON SELECT id FROM orders WHERE amount = 3", db);
+    
+    // Unprofiled plans keep the plain EXPLAIN output
+    auto plain = SQLParser::parse("SELECT id FROM orders", db);
+    assert(explainPlan(*plain).find("actual") == std::string::npos);
+    
+    std::cout << "✓ EXPLAIN ANALYZE tests passed" << std::endl;
+}
+
+// Parses and runs a query in the thread's arena and returns its rows
+std::vector<Row> runQuery(Database& db, const std::string& query) {
+    ArenaScope scope(QueryArena::forThread());
+    auto plan = SQLParser::parse(query, db);
+    assert(plan);
+    return QueryExecutor::execute(*plan);
+}
+
+// The EXPLAIN text of a query, or "" if it does not parse
+std::string explainQuery(Database& db, const std::string& query) {
+    ArenaScope scope(QueryArena::forThread());
+    auto plan = SQLParser::parse(query, db);
+    return plan ? explainPlan(*plan) : std::string();
+}
+
+// Runs a plan into a sink of the given format and returns the bytes written
+std::string renderResult(const QueryPlanNode& plan, ResultFormat format) {
+    FILE* file = std::tmpfile();
+    assert(file != nullptr);
+    int fd = fileno(file);
+    {
+        auto sink = makeResultSink(format, fd);
+        QueryExecutor::execute(plan, *sink);
+    }
+    std::string out;
+    lseek(fd, 0, SEEK_SET);
+    char buf[65536];
+    ssize_t n;
+    while ((n = read(fd, buf, sizeof(buf))) > 0) out.append(buf, n);
+    std::fclose(file);
+    return out;
+}
+
+void test_result_sinks() {
+    std::cout << "Testing result sinks..." << std::endl;
+    
+    Database db;
+    Schema schema("notes");
+    schema.columns = {{"id", DataType::INT}, {"body", DataType::STRING}, {"score", DataType::DOUBLE}};
+    db.createTable("notes", schema);
+    db.insertInto("notes", {1, std::string("plain"), 0.1});
+    db.insertInto("notes", {2, std::string("has, comma and \"quote\""), 2.0});
+    db.insertInto("notes", {3, std::string("line\nbreak"), -1.5});
+    
+    auto plan = SQLParser::parse("SELECT id, body, score FROM notes", db);
+    
+    std::string table = renderResult(*plan, ResultFormat::TABLE);
+    assert(table.find("id | body") == 0);
+    assert(table.find("---+-") != std::string::npos);
+    assert(table.find("1  | plain") != std::string::npos);
+    assert(table.find("(3 rows)") != std::string::npos);
+    
+    std::string csv = renderResult(*plan, ResultFormat::CSV);
+    assert(csv == "id,body,score\r\n"
+                  "1,plain,0.1\r\n"
+                  "2,\"has, comma and \"\"quote\"\"\",2\r\n"
+                  "3,\"line\nbreak\",-1.5\r\n");
+    
+    std::string ndjson = renderResult(*plan, ResultFormat::NDJSON);
+    assert(ndjson.find("{\"id\":1,\"body\":\"plain\",\"score\":0.1}\n") == 0);
+    assert(ndjson.find("\"body\":\"line\\nbreak\"") != std::string::npos);
+    
+    // Binary output round-trips, including NULL and mixed-type columns
+    RowBatch batch;
+    batch.rows = {{{1, std::string("a"), nullptr}}, {{nullptr, std::string("bb"), 2.5}},
+                  {{3, nullptr, std::string("x")}}};
+    FILE* file = std::tmpfile();
+    BinaryColumnarSink sink(fileno(file));
+    sink.begin({"a", "b", "c"});
+    sink.consume(batch);
+    sink.consume(batch);
+    sink.finish();
+    std::string bytes(sink.getBytesWritten(), '\0');
+    lseek(fileno(file), 0, SEEK_SET);
+    assert(read(fileno(file), bytes.data(), bytes.size()) == static_cast<ssize_t>(bytes.size()));
+    std::fclose(file);
+    std::vector<std::string> columns;
+    auto decoded = decodeBinaryColumnar(bytes, &columns);
+    assert(columns == std::vector<std::string>({"a", "b", "c"}));
+    assert(decoded.size() == 6);
+    for (size_t i = 0; i < decoded.size(); ++i) {
+        assert(decoded[i].values == batch.rows[i % 3].values);
+    }
+    
+    // Large results are written in a few big chunks
+    Schema wide("numbers");
+    wide.columns = {{"n", DataType::INT}};
+    db.createTable("numbers", wide);
+    for (int i = 0; i < 200000; ++i) db.insertInto("numbers", {i});
+    auto numbers = SQLParser::parse("SELECT n FROM numbers", db);
+    std::string numbersCsv = renderResult(*numbers, ResultFormat::CSV);
+    assert(numbersCsv.size() > BufferedSink::kFlushBytes);
+    assert(numbersCsv.find("\r\n199999\r\n") != std::string::npos);
+    assert(decodeBinaryColumnar(renderResult(*numbers, ResultFormat::BINARY)).size() == 200000);
+    
+    std::cout << "✓ Result sink tests passed" << std::endl;
+}
+
+void test_arrow_interop() {
+    std::cout << "Testing Arrow C Data Interface..." << std::endl;
+    
+    Database db;
+    Schema schema("readings");
+    schema.columns = {{"id", DataType::INT}, {"sensor", DataType::STRING}, {"value", DataType::DOUBLE}};
+    db.createTable("readings", schema);
+    for (int i = 0; i < 10; ++i) {
+        db.insertInto("readings", {i, i == 3 ? Value(nullptr) : Value("sensor-" + std::to_string(i % 3)),
+                                   i % 2 == 0 ? Value(i * 1.5) : Value(i)});
+    }
+    
+    auto plan = SQLParser::parse("SELECT id, sensor, value FROM readings WHERE id >= 2", db);
+    ArrowSchema arrowSchema;
+    ArrowArray arrowArray;
+    assert(QueryExecutor::exportArrow(*plan, &arrowSchema, &arrowArray) == 8);
+    assert(std::string(arrowSchema.format) == "+s");
+    assert(arrowSchema.n_children == 3 && arrowArray.n_children == 3);
+    assert(std::string(arrowSchema.children[0]->format) == "i");
+    assert(std::string(arrowSchema.children[1]->format) == "u");
+    assert(std::string(arrowSchema.children[2]->format) == "g");
+    assert(std::string(arrowSchema.children[1]->name) == "sensor");
+    
+    // Consumers read the exported buffers in place
+    const ArrowArray* ids = arrowArray.children[0];
+    assert(ids->length == 8 && ids->null_count == 0);
+    assert(static_cast<const int32_t*>(ids->buffers[1])[0] == 2);
+    const ArrowArray* sensors = arrowArray.children[1];
+    assert(sensors->null_count == 1);
+    const auto* validity = static_cast<const uint8_t*>(sensors->buffers[0]);
+    assert(((validity[0] >> 1) & 1) == 0); // id 3 is NULL
+    const auto* offsets = static_cast<const int32_t*>(sensors->buffers[1]);
+    const char* chars = static_cast<const char*>(sensors->buffers[2]);
+    assert(std::string(chars + offsets[0], offsets[1] - offsets[0]) == "sensor-2");
+    const ArrowArray* values = arrowArray.children[2];
+    assert(static_cast<const double*>(values->buffers[1])[1] == 3.0); // INT promoted to float64
+    
+    // Importing takes ownership and releases both structs
+    assert(importArrowTable(db, "copy", &arrowSchema, &arrowArray) == 8);
+    assert(arrowSchema.release == nullptr && arrowArray.release == nullptr);
+    const Table* copy = db.getTable("copy");
+    assert(copy->getColumns()[2].type == DataType::DOUBLE);
+    Row row = copy->getRow(1);
+    assert(std::get<int>(row.values[0]) == 3);
+    assert(std::holds_alternative<std::nullptr_t>(row.values[1]));
+    assert(std::get<double>(row.values[2]) == 3.0);
+    
+    // Producer-built arrays with an offset, int64 and bool columns
+    int64_t bigints[] = {10, 20, 30, 40};
+    uint8_t flags[] = {0b0101};
+    const void* bigintBuffers[] = {nullptr, bigints};
+    const void* flagBuffers[] = {nullptr, flags};
+    ArrowArray bigintArray{4, 0, 0, 2, 0, bigintBuffers, nullptr, nullptr, nullptr, nullptr};
+    ArrowArray flagArray{4, 0, 0, 2, 0, flagBuffers, nullptr, nullptr, nullptr, nullptr};
+    bigintArray.release = [](ArrowArray* a) { a->release = nullptr; };
+    flagArray.release = bigintArray.release;
+    ArrowSchema bigintSchema{"l", "n", nullptr, 0, 0, nullptr, nullptr, nullptr, nullptr};
+    ArrowSchema flagSchema{"b", "flag", nullptr, 0, 0, nullptr, nullptr, nullptr, nullptr};
+    bigintSchema.release = [](ArrowSchema* s) { s->release = nullptr; };
+    flagSchema.release = bigintSchema.release;
+    ArrowArray* childArrays[] = {&bigintArray, &flagArray};
+    ArrowSchema* childSchemas[] = {&bigintSchema, &flagSchema};
+    const void* structBuffers[] = {nullptr};
+    ArrowArray parentArray{3, 0, 1, 1, 2, structBuffers, childArrays, nullptr, nullptr, nullptr};
+    ArrowSchema parentSchema{"+s", "", nullptr, 0, 2, childSchemas, nullptr, nullptr, nullptr};
+    parentArray.release = [](ArrowArray* a) {
+        for (int64_t i = 0; i < a->n_children; ++i) a->children[i]->release(a->children[i]);
+        a->release = nullptr;
+    };
+    parentSchema.release = [](ArrowSchema* s) {
+        for (int64_t i = 0; i < s->n_children; ++i) s->children[i]->release(s->children[i]);
+        s->release = nullptr;
+    };
+    assert(importArrowTable(db, "imported", &parentSchema, &parentArray) == 3);
+    assert(parentArray.release == nullptr && bigintArray.release == nullptr);
+    const Table* imported = db.getTable("imported");
+    assert(imported->getColumns()[1].type == DataType::BOOLEAN);
+    assert(std::get<int>(imported->getRow(0).values[0]) == 20);
+    assert(std::get<int>(imported->getRow(0).values[1]) == 0);
+    assert(std::get<int>(imported->getRow(1).values[1]) == 1);
+    
+    std::cout << "✓ Arrow C Data Interface tests passed" << std::endl;
+}
+
+void test_runtime_bloom_filter() {
+    std::cout << "Testing runtime Bloom filter pushdown..." << std::endl;
+    
+    RuntimeBloomFilter bloom;
+    bloom.reset(1000);
+    for (uint64_t i = 0; i < 1000; ++i) bloom.insert(hashValue(Value(static_cast<int>(i))));
+    size_t falsePositives = 0;
+    for (uint64_t i = 0; i < 1000; ++i) assert(bloom.mayContain(hashValue(Value(static_cast<int>(i)))));
+    for (uint64_t i = 1000; i < 101000; ++i) falsePositives += bloom.mayContain(hashValue(Value(static_cast<int>(i))));
+    assert(falsePositives < 2000);
+    
+    Database db;
+    Schema stores("stores");
+    stores.columns = {{"id", DataType::INT}, {"region", DataType::STRING}};
+    db.createTable("stores", stores);
+    Schema sales("sales");
+    sales.columns = {{"id", DataType::INT}, {"store_id", DataType::INT}, {"amount", DataType::INT}};
+    db.createTable("sales", sales);
+    for (int i = 0; i < 100; ++i) {
+        db.insertInto("stores", {i, std::string(i % 20 == 0 ? "north" : "south")});
+    }
+    for (int i = 0; i < 20000; ++i) {
+        db.insertInto("sales", {i, i % 100, i % 7});
+    }
+    db.analyzeTable("stores");
+    db.analyzeTable("sales");
+    
+    // The fact scan only passes rows whose store survives the dimension filter
+    auto plan = SQLParser::parse(
+        "SELECT s.id, t.region FROM sales s JOIN stores t ON s.store_id = t.id WHERE t.region = 'north'", db);
+    std::string explained = explainPlan(*plan);
+    assert(explained.find("TableScan sales AS s [id, store_id] BLOOM [s.store_id]") != std::string::npos);
+    
+    plan->enableProfiling();
+    auto rows = QueryExecutor::execute(*plan);
+    assert(rows.size() == 1000);
+    for (const auto& row : rows) {
+        assert(std::get<int>(row.values[0]) % 20 == 0);
+    }
+    const QueryPlanNode* node = plan.get();
+    while (node->getName() != "TableScan" || node->getDetails().find("sales") == std::string::npos) {
+        const QueryPlanNode* next = nullptr;
+        for (const QueryPlanNode* child : node->getChildren()) {
+            if (explainPlan(*child).find("sales") != std::string::npos) next = child;
+        }
+        node = next;
+    }
+    assert(node->getProfile().rowsIn == 20000);
+    assert(node->getProfile().rowsOut < 1200);
+    
+    // A filter that prunes nothing switches itself off; results are unchanged
+    auto unselective = SQLParser::parse("SELECT s.id FROM sales s JOIN stores t ON s.store_id = t.id", db);
+    assert(QueryExecutor::execute(*unselective).size() == 20000);
+    
+    // NULL probe keys are dropped at the scan, as the join would drop them
+    db.insertInto("sales", {20000, nullptr, 1});
+    auto withNull = SQLParser::parse(
+        "SELECT s.id FROM sales s JOIN stores t ON s.store_id = t.id WHERE t.region = 'north'", db);
+    assert(QueryExecutor::execute(*withNull).size() == 1000);
+    
+    std::cout << "✓ Runtime Bloom filter tests passed" << std::endl;
+}
+
+void test_batch_validation() {
+    std::cout << "Testing batch validation..." << std::endl;
+    
+    Database db;
+    SQLProcessor::processStatement(
+        "CREATE TABLE accounts (id INT NOT NULL, owner STRING, active BOOLEAN, "
+        "balance DOUBLE CHECK (balance >= 0 AND balance < 1000000))", db);
+    Table* accounts = db.getTable("accounts");
+    assert(accounts != nullptr);
+    assert(accounts->getValidationProgram().hasChecks());
+    
+    std::vector<Row> rows;
+    for (int i = 0; i < 100; ++i) {
+        rows.push_back(Row{{i, std::string("owner") + std::to_string(i), i % 2, i * 10.5}});
+    }
+    db.insertRowsInto("accounts", rows);
+    assert(accounts->getRowCount() == 100);
+    
+    // Every violation is reported with its row; nothing from the batch is stored
+    rows[3].values[0] = nullptr;                 // NOT NULL
+    rows[17].values[1] = 42;                     // type
+    rows[42].values[2] = 7;                      // BOOLEAN range
+    rows[58].values[3] = -1.0;                   // CHECK
+    rows[59].values[2] = 2;                      // BOOLEAN range, CHECK not evaluated
+    rows[59].values[3] = -5.0;
+    rows[90].values[3] = nullptr;                // CHECK on NULL is satisfied
+    bool rejected = false;
+    try {
+        db.insertRowsInto("accounts", rows);
+    } catch (const ValidationError& e) {
+        rejected = true;
+        assert((e.getRows() == std::vector<size_t>{3, 17, 42, 58, 59}));
+        const auto& failures = e.getFailures();
+        assert(failures.size() == 5);
+        assert(failures[0].reason == ValidationFailure::NOT_NULL && failures[0].column == 0);
+        assert(failures[1].reason == ValidationFailure::TYPE_MISMATCH && failures[1].column == 1);
+        assert(failures[2].reason == ValidationFailure::BOOLEAN_RANGE && failures[2].column == 2);
+        assert(failures[3].reason == ValidationFailure::CHECK && failures[3].column == 3);
+        assert(failures[4].row == 59 && failures[4].reason == ValidationFailure::BOOLEAN_RANGE);
+    }
+    assert(rejected);
+    assert(accounts->getRowCount() == 100);
+    
+    // Once its type is fixed, row 59 is checked and fails CHECK too
+    rows[3].values[0] = 3;
+    rows[17].values[1] = std::string("x");
+    rows[42].values[2] = 1;
+    rows[59].values[2] = 0;
+    rejected = false;
+    try {
+        db.insertRowsInto("accounts", rows);
+    } catch (const ValidationError& e) {
+        rejected = true;
+        assert((e.getRows() == std::vector<size_t>{58, 59}));
+        assert(e.getFailures()[1].reason == ValidationFailure::CHECK);
+        assert(std::string(e.what()).find("CHECK (balance >= 0 AND balance < 1000000)") != std::string::npos);
+    }
+    assert(rejected);
+    rows[58].values[3] = 0.0;
+    rows[59].values[3] = 0.0;
+    db.insertRowsInto("accounts", rows);
+    assert(accounts->getRowCount() == 200);
+    
+    // Single-row inserts go through the same compiled program
+    bool threw = false;
+    try {
+        db.insertInto("accounts", {1, std::string("a"), 1, 2000000.0});
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+    
+    std::cout << "Batch validation tests passed!" << std::endl;
+}
+
+void test_update_delete() {
+    std::cout << "Testing UPDATE, DELETE and compaction..." << std::endl;
+    
+    Database db;
+    Schema events("events");
+    events.columns = {{"id", DataType::INT}, {"kind", DataType::STRING}, {"score", DataType::DOUBLE}};
+    db.createTable("events", events);
+    std::vector<Row> rows;
+    for (int i = 0; i < 5000; ++i) {
+        rows.push_back(Row{{i, std::string(i % 2 ? "click" : "view"), i * 0.5}});
+    }
+    db.insertRowsInto("events", rows);
+    Table* table = db.getTable("events");
+    assert(table->getBlockCount() == 5);
+    
+    // Hold a scan open so the compactor cannot move rows under it
+    auto open = SQLParser::parse("SELECT id FROM events", db);
+    open->open();
+    
+    SQLProcessor::processStatement("DELETE FROM events WHERE id < 3000", db);
+    assert(table->getRowCount() == 2000);
+    assert(table->getStoredRowCount() == 5000);
+    assert(table->getStatistics().getRowCount() == 2000);
+    assert(runQuery(db, "SELECT id FROM events").size() == 2000);
+    assert(runQuery(db, "SELECT id FROM events WHERE kind = 'click'").size() == 1000);
+    assert(table->getRow(0).values[0] == Value(3000));
+    
+    // In-place update of a fixed-width column
+    SQLProcessor::processStatement("UPDATE events SET score = 0 WHERE id >= 4000", db);
+    assert(runQuery(db, "SELECT id FROM events WHERE score = 0").size() == 1000);
+    assert(table->getStoredRowCount() == 5000);
+    
+    // A long string does not fit in its cell: the row moves to the end
+    SQLProcessor::processStatement("UPDATE events SET kind = 'a much longer event kind' WHERE id = 3001", db);
+    assert(runQuery(db, "SELECT id FROM events WHERE kind = 'a much longer event kind'").size() == 1);
+    assert(table->getRowCount() == 2000);
+    assert(table->getStoredRowCount() == 5001);
+    
+    // Constraint violations reject the whole update
+    SQLProcessor::processStatement("UPDATE events SET score = 'high' WHERE id > 4990", db);
+    assert(runQuery(db, "SELECT id FROM events WHERE score = 0").size() == 1000);
+    
+    // The pinned table is left alone; once the scan is gone compaction runs
+    assert(table->compact() == 0);
+    open.reset();
+    for (int i = 0; i < 200 && table->getStoredRowCount() != 2000; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    db.compactAll();
+    assert(table->getStoredRowCount() == 2000);
+    assert(table->getBlockCount() == 3);
+    assert(runQuery(db, "SELECT id FROM events").size() == 2000);
+    assert(runQuery(db, "SELECT id FROM events WHERE score = 0").size() == 1000);
+    assert(runQuery(db, "SELECT id FROM events WHERE kind = 'a much longer event kind'").size() == 1);
+    
+    SQLProcessor::processStatement("DELETE FROM events", db);
+    assert(runQuery(db, "SELECT id FROM events").size() == 0);
+    db.stopCompaction();
+    
+    std::cout << "UPDATE, DELETE and compaction tests passed!" << std::endl;
+}
+
+void test_partitioning() {
+    std::cout << "Testing table partitioning..." << std::endl;
+    
+    Database db;
+    SQLProcessor::processStatement(
+        "CREATE TABLE sales (id INT, region STRING, amount DOUBLE) PARTITION BY RANGE (id) VALUES (100, 200, 300)", db);
+    Table* sales = db.getTable("sales");
+    assert(sales && sales->isPartitioned() && sales->getPartitionCount() == 4);
+    assert(sales->describePartition(0) == "[-inf, 100)");
+    assert(sales->describePartition(2) == "[200, 300)");
+    
+    std::vector<Row> rows;
+    for (int i = 0; i < 400; ++i) {
+        rows.push_back(Row{{i, std::string(i % 2 ? "east" : "west"), i * 1.0}});
+    }
+    db.insertRowsInto("sales", rows);
+    for (size_t p = 0; p < 4; ++p) {
+        assert(sales->getPartition(p).getRowCount() == 100);
+    }
+    assert(sales->partitionFor(CompactValue::ofInt(250)) == 2);
+    assert(sales->partitionFor(CompactValue()) == 0);
+    
+    // Comparisons on the key prune; AND intersects and OR unions
+    assert(explainQuery(db, "SELECT id FROM sales WHERE id = 150").find("PARTITIONS [1] of 4") != std::string::npos);
+    assert(explainQuery(db, "SELECT id FROM sales WHERE id >= 200 AND id < 250").find("PARTITIONS [2] of 4") != std::string::npos);
+    assert(explainQuery(db, "SELECT id FROM sales WHERE id < 50 OR id >= 350").find("PARTITIONS [0, 3] of 4") != std::string::npos);
+    assert(explainQuery(db, "SELECT id FROM sales WHERE region = 'east'").find("PARTITIONS [0, 1, 2, 3] of 4") != std::string::npos);
+    assert(runQuery(db, "SELECT id FROM sales WHERE id = 150").size() == 1);
+    assert(runQuery(db, "SELECT id FROM sales WHERE id >= 200 AND id < 250").size() == 50);
+    assert(runQuery(db, "SELECT id FROM sales WHERE id < 50 OR id >= 350").size() == 100);
+    assert(runQuery(db, "SELECT id FROM sales WHERE id >= 100 AND region = 'east'").size() == 150);
+    
+    // Moving a row's key moves it to its new partition
+    SQLProcessor::processStatement("UPDATE sales SET id = 399 WHERE id = 0", db);
+    assert(sales->getPartition(0).getRowCount() == 99);
+    assert(sales->getPartition(3).getRowCount() == 101);
+    assert(runQuery(db, "SELECT id FROM sales WHERE id = 399").size() == 2);
+    
+    SQLProcessor::processStatement("ALTER TABLE sales DROP PARTITION 1", db);
+    assert(sales->getRowCount() == 300);
+    assert(sales->getStatistics().getRowCount() == 300);
+    assert(runQuery(db, "SELECT id FROM sales WHERE id >= 100 AND id < 200").size() == 0);
+    assert(runQuery(db, "SELECT id FROM sales").size() == 300);
+    
+    // Bounds must ascend and match the key column's type
+    Schema bad("bad");
+    bad.columns = {{"id", DataType::INT}};
+    bad.partitioning.method = PartitionSpec::RANGE;
+    bad.partitioning.column = "id";
+    bad.partitioning.bounds = {Value(10), Value(5)};
+    bool threw = false;
+    try { db.createTable("bad", bad); } catch (const std::runtime_error&) { threw = true; }
+    assert(threw);
+    
+    // Hash partitions: equality prunes to one; a large load and scan run in parallel
+    SQLProcessor::processStatement(
+        "CREATE TABLE visits (user STRING, page INT) PARTITION BY HASH (page) PARTITIONS 8", db);
+    Table* visits = db.getTable("visits");
+    assert(visits->getPartitionCount() == 8);
+    visits->setLoadParallelism(4);
+    std::vector<Row> load;
+    for (int i = 0; i < 200000; ++i) {
+        load.push_back(Row{{std::string("user") + std::to_string(i % 1000), i % 500}});
+    }
+    db.insertRowsInto("visits", load);
+    size_t stored = 0;
+    for (size_t p = 0; p < 8; ++p) {
+        stored += visits->getPartition(p).getRowCount();
+    }
+    assert(stored == 200000);
+    size_t home = visits->partitionFor(CompactValue::ofInt(42));
+    assert(explainQuery(db, "SELECT user FROM visits WHERE page = 42").find(
+               "PARTITIONS [" + std::to_string(home) + "] of 8") != std::string::npos);
+    assert(runQuery(db, "SELECT user FROM visits WHERE page = 42").size() == 400);
+    {
+        ArenaScope scope(QueryArena::forThread());
+        auto plan = SQLParser::parse("SELECT page FROM visits WHERE page < 100", db);
+        QueryPlanNode* node = plan.get();
+        while (!dynamic_cast<TableScanNode*>(node)) node = const_cast<QueryPlanNode*>(node->getChildren()[0]);
+        auto* scan = static_cast<TableScanNode*>(node);
+        scan->setParallelism(4);
+        auto results = QueryExecutor::execute(*plan);
+        assert(results.size() == 40000);
+        assert(scan->isParallel());
+        // Batches arrive in partition order
+        size_t previous = 0;
+        for (const auto& row : results) {
+            size_t p = visits->partitionFor(CompactValue::borrow(row.values[0]));
+            assert(p >= previous);
+            previous = p;
+        }
+        // Abandoning a parallel scan part-way stops its workers
+        RowBatch batch;
+        scan->open();
+        assert(scan->next(batch) && scan->isParallel());
+    }
+    db.stopCompaction();
+    
+    std::cout << "Table partitioning tests passed!" << std::endl;
+}
+
+void test_materialized_views() {
+    std::cout << "Testing materialized views..." << std::endl;
+    
+    Database db;
+    Schema orders("orders");
+    orders.columns = {{"id", DataType::INT}, {"region", DataType::STRING}, {"amount", DataType::DOUBLE}};
+    db.createTable("orders", orders);
+    db.insertInto("orders", {1, "north", 10.0});
+    db.insertInto("orders", {2, "south", 20.0});
+    
+    SQLProcessor::processStatement(
+        "CREATE MATERIALIZED VIEW totals AS SELECT region, COUNT(*), SUM(amount) AS revenue, "
+        "MAX(amount), AVG(amount) FROM orders WHERE amount > 0 GROUP BY region", db);
+    SQLProcessor::processStatement("CREATE MATERIALIZED VIEW big AS SELECT id, amount FROM orders WHERE amount >= 100", db);
+    SQLProcessor::processStatement("CREATE MATERIALIZED VIEW overall AS SELECT COUNT(*), MIN(region) FROM orders", db);
+    assert(db.isMaterializedView("totals") && db.isMaterializedView("big"));
+    
+    Table* totals = db.getTable("totals");
+    const auto& columns = totals->getColumns();
+    assert(columns.size() == 5 && columns[1].name == "count" && columns[2].name == "revenue" &&
+           columns[3].name == "max_amount" && columns[4].type == DataType::DOUBLE);
+    assert(totals->getRowCount() == 2);
+    
+    // Single-row and bulk appends update only the groups they touch
+    db.insertInto("orders", {3, "north", 30.0});
+    std::vector<Row> batch;
+    for (int i = 0; i < 1000; ++i) {
+        batch.push_back(Row{{100 + i, std::string(i % 2 ? "east" : "north"), i * 1.0}});
+    }
+    db.insertRowsInto("orders", batch);
+    assert(totals->getRowCount() == 3);
+    auto north = runQuery(db, "SELECT count, revenue, max_amount, avg_amount FROM totals WHERE region = 'north'");
+    assert(north.size() == 1);
+    // 10 + 30 plus the even i in 1..998 (amount 0 is filtered out)
+    assert(north[0].values[0] == Value(2 + 499));
+    assert(std::get<double>(north[0].values[1]) == 40.0 + 249500.0 - 0.0);
+    assert(north[0].values[2] == Value(998.0));
+    assert(std::abs(std::get<double>(north[0].values[3]) - (40.0 + 249500.0) / 501) < 1e-9);
+    assert(runQuery(db, "SELECT id FROM big").size() == 900);
+    auto overall = runQuery(db, "SELECT count, min_region FROM overall");
+    assert(overall.size() == 1 && overall[0].values[0] == Value(1003) &&
+           overall[0].values[1] == Value(std::string("east")));
+    
+    // The maintained view matches a recomputation
+    MaterializedView* view = const_cast<MaterializedView*>(db.getMaterializedView("totals"));
+    auto before = runQuery(db, "SELECT region, count, revenue FROM totals");
+    view->refresh();
+    auto after = runQuery(db, "SELECT region, count, revenue FROM totals");
+    assert(before.size() == after.size());
+    for (size_t i = 0; i < before.size(); ++i) {
+        assert(before[i].values == after[i].values);
+    }
+    
+    // Deletes recompute the view
+    SQLProcessor::processStatement("DELETE FROM orders WHERE region = 'east'", db);
+    assert(totals->getRowCount() == 2);
+    assert(runQuery(db, "SELECT id FROM big").size() == 450);
+    
+    // Views are read-only, and their base tables cannot be dropped under them
+    bool threw = false;
+    try { db.insertInto("totals", {std::string("west"), 1, 1.0, 1.0, 1.0}); } catch (const std::runtime_error&) { threw = true; }
+    assert(threw);
+    threw = false;
+    try { db.dropTable("orders"); } catch (const std::runtime_error&) { threw = true; }
+    assert(threw);
+    db.dropTable("totals");
+    db.dropTable("big");
+    db.dropTable("overall");
+    assert(!db.isMaterializedView("totals"));
+    db.insertInto("orders", {5000, "west", 1.0});
+    db.dropTable("orders");
+    db.stopCompaction();
+    
+    std::cout << "Materialized view tests passed!" << std::endl;
+}
+
+void test_result_cache() {
+    std::cout << "Testing the query result cache..." << std::endl;
+    
+    struct CollectSink : ResultSink {
+        std::vector<std::string> columns;
+        std::vector<Row> rows;
+        void begin(const std::vector<std::string>& names) override { columns = names; rows.clear(); }
+        void consume(const RowBatch& batch) override { rows.insert(rows.end(), batch.rows.begin(), batch.rows.end()); }
+        void finish() override {}
+    };
+    
+    // Fingerprints ignore case and spacing and pull the literals out
+    QueryFingerprint a = fingerprintQuery("select id from t where x = 5 and name = 'bob'");
+    QueryFingerprint b = fingerprintQuery("SELECT id  FROM t WHERE x=7 AND name = 'al';");
+    assert(a.cacheable && a.shape == b.shape && a.key() != b.key());
+    assert(a.literals.size() == 2 && a.literals[0] == Value(5) && a.literals[1] == Value(std::string("bob")));
+    assert(fingerprintQuery("SELECT id FROM t WHERE x < 0.0000001").key() !=
+           fingerprintQuery("SELECT id FROM t WHERE x < 0.0000002").key());
+    QueryFingerprint wide = fingerprintQuery("SELECT id FROM t WHERE id < 99999999999");
+    assert(wide.cacheable && wide.literals[0] == Value(99999999999.0));
+    assert(fingerprintQuery("SELECT id FROM t WHERE x < 2.5").literals[0] == Value(2.5));
+
+    Database db;
+    Schema items("items");
+    items.columns = {{"id", DataType::INT}, {"price", DataType::DOUBLE}};
+    db.createTable("items", items);
+    std::vector<Row> rows;
+    for (int i = 0; i < 3000; ++i) {
+        rows.push_back(Row{{i, i * 0.5}});
+    }
+    db.insertRowsInto("items", rows);
+    
+    ResultCache& cache = SQLProcessor::getResultCache();
+    cache.clear();
+    auto run = [&db](const std::string& query) {
+        ArenaScope scope(QueryArena::forThread());
+        CollectSink sink;
+        SQLProcessor::executeSelect(query, db, sink);
+        return sink.rows;
+    };
+    auto before = cache.getStats();
+    auto first = run("SELECT id, price FROM items WHERE price < 100");
+    auto second = run("select id, price from items where price<100");
+    assert(first.size() == 200 && second.size() == 200);
+    for (size_t i = 0; i < first.size(); ++i) {
+        assert(first[i].values == second[i].values);
+    }
+    auto stats = cache.getStats();
+    assert(stats.misses == before.misses + 1 && stats.hits == before.hits + 1 && stats.entries == 1);
+    
+    // Another literal is another entry
+    assert(run("SELECT id, price FROM items WHERE price < 10").size() == 20);
+    assert(cache.getStats().entries == 2);
+    assert(run("SELECT id, price FROM items WHERE id < 99999999999").size() == 3000);
+    assert(run("SELECT id, price FROM items WHERE id < 2.5").size() == 3);   // Not truncated to 2
+    
+    // Any write to a table a result read invalidates it
+    uint64_t version = db.getTable("items")->getVersion();
+    db.insertInto("items", {5000, 1.0});
+    assert(db.getTable("items")->getVersion() != version);
+    assert(run("SELECT id, price FROM items WHERE price < 100").size() == 201);
+    assert(cache.getStats().invalidations == stats.invalidations + 1);
+    SQLProcessor::processStatement("DELETE FROM items WHERE id = 5000", db);
+    assert(run("SELECT id, price FROM items WHERE price < 100").size() == 200);
+    
+    // Dropping and re-creating a table never revives old results
+    db.dropTable("items");
+    db.createTable("items", items);
+    assert(run("SELECT id, price FROM items WHERE price < 100").empty());
+    
+    // Eviction prefers cheap results: equal sizes, so the lower cost goes
+    ResultCache small(4000);
+    auto entryOf = [](double cost) {
+        ResultCache::Entry entry;
+        entry.rows.push_back(Row{{1}});
+        entry.bytes = 900;
+        entry.costNanos = cost;
+        return entry;
+    };
+    small.insert("expensive", entryOf(1e6));
+    small.insert("cheap", entryOf(10));
+    small.insert("middle", entryOf(1e4));
+    small.insert("another", entryOf(1e4));
+    assert(small.getStats().evictions == 0);
+    small.insert("last", entryOf(1e4));
+    assert(small.getStats().evictions == 1);
+    assert(small.lookup("cheap", db) == nullptr);
+    assert(small.lookup("expensive", db) != nullptr);
+    assert(small.getStats().bytes <= 4000);
+    small.insert("huge", [] { ResultCache::Entry e; e.bytes = 2000; return e; }());
+    assert(small.lookup("huge", db) == nullptr);  // Over a quarter of the capacity
+    
+    cache.clear();
+    db.stopCompaction();
+    
+    std::cout << "Result cache tests passed!" << std::endl;
+}
+
+void test_approximate_queries() {
+    std::cout << "Testing sampling and approximate aggregates..." << std::endl;
+    
+    // Sketches merge: four partial sketches agree with one over everything
+    HyperLogLog whole;
+    std::vector<HyperLogLog> parts(4);
+    QuantileSketch wholeQuantiles;
+    std::vector<QuantileSketch> quantileParts(4);
+    for (int i = 0; i < 100000; ++i) {
+        whole.addValue(i % 20000);
+        parts[i % 4].addValue(i % 20000);
+        wholeQuantiles.add(i);
+        quantileParts[i % 4].add(i);
+    }
+    for (size_t p = 1; p < 4; ++p) {
+        parts[0].merge(parts[p]);
+        quantileParts[0].merge(quantileParts[p]);
+    }
+    assert(parts[0].estimate() == whole.estimate());
+    assert(std::abs(whole.estimate() - 20000) < 20000 * 0.05);
+    assert(quantileParts[0].count() == 100000 && quantileParts[0].retained() < 2000);
+    for (double q : {0.1, 0.5, 0.99}) {
+        assert(std::abs(wholeQuantiles.quantile(q) - q * 100000) < 100000 * 0.03);
+        assert(std::abs(quantileParts[0].quantile(q) - q * 100000) < 100000 * 0.03);
+    }
+    assert(quantileParts[0].quantile(0.0) == 0 && quantileParts[0].quantile(1.0) == 99999);
+    AggregateState left(AggregateFunction::MAX), right(AggregateFunction::MAX);
+    left.add(CompactValue::ofInt(3));
+    right.add(CompactValue::ofInt(7));
+    left.merge(right);
+    assert(left.result() == Value(7));
+    
+    Database db;
+    Schema events("events");
+    events.columns = {{"id", DataType::INT}, {"user", DataType::STRING}, {"latency", DataType::DOUBLE}};
+    db.createTable("events", events);
+    std::vector<Row> rows;
+    for (int i = 0; i < 200000; ++i) {
+        rows.push_back(Row{{i, "u" + std::to_string(i % 5000), static_cast<double>(i % 1000)}});
+    }
+    db.insertRowsInto("events", rows);
+    
+    auto result = runQuery(db, "SELECT COUNT(*), APPROX_COUNT_DISTINCT(user), APPROX_QUANTILE(latency, 0.5) AS median, "
+                               "MAX(latency) FROM events WHERE id >= 0");
+    assert(result.size() == 1);
+    assert(result[0].values[0] == Value(200000));
+    assert(std::abs(std::get<int>(result[0].values[1]) - 5000) < 5000 * 0.05);
+    assert(std::abs(std::get<double>(result[0].values[2]) - 500) < 1000 * 0.03);
+    assert(result[0].values[3] == Value(999.0));
+    
+    // SYSTEM reads whole blocks, BERNOULLI single rows; both about 10% here
+    auto sampledCount = [&db](const std::string& sample) {
+        return std::get<int>(runQuery(db, "SELECT COUNT(*) FROM events TABLESAMPLE " + sample)[0].values[0]);
+    };
+    int system = sampledCount("SYSTEM (10)");
+    assert(system >= 10 * static_cast<int>(Table::kBlockRows) && system <= 40 * static_cast<int>(Table::kBlockRows));
+    int bernoulli = sampledCount("BERNOULLI (10)");
+    assert(bernoulli > 18000 && bernoulli < 22000);
+    assert(sampledCount("BERNOULLI (10) REPEATABLE (7)") == sampledCount("BERNOULLI (10) REPEATABLE (7)"));
+    assert(sampledCount("BERNOULLI (10) REPEATABLE (7)") != bernoulli);
+    assert(sampledCount("SYSTEM (0)") == 0 && sampledCount("BERNOULLI (100)") == 200000);
+    auto sampled = runQuery(db, "SELECT APPROX_COUNT_DISTINCT(user) FROM events e TABLESAMPLE SYSTEM (25) WHERE e.latency < 500");
+    assert(std::abs(std::get<int>(sampled[0].values[0]) - 2500) < 2500 * 0.1);
+    std::string plan = explainQuery(db, "SELECT APPROX_QUANTILE(latency, 0.9) FROM events TABLESAMPLE SYSTEM (5)");
+    assert(plan.find("Aggregate [APPROX_QUANTILE(latency, 0.9)]") != std::string::npos);
+    assert(plan.find("SAMPLE SYSTEM (5%)") != std::string::npos);
+    
+    // GROUP BY, with an empty input still giving the global aggregate a row
+    auto groups = runQuery(db, "SELECT user, COUNT(*), AVG(latency) FROM events WHERE id < 10 GROUP BY user");
+    assert(groups.size() == 10 && groups[3].values[0] == Value(std::string("u3")) && groups[3].values[1] == Value(1));
+    auto empty = runQuery(db, "SELECT COUNT(*), APPROX_QUANTILE(latency, 0.5) FROM events WHERE id < 0");
+    assert(empty.size() == 1 && empty[0].values[0] == Value(0) &&
+           std::holds_alternative<std::nullptr_t>(empty[0].values[1]));
+    assert(explainQuery(db, "SELECT SUM(user) FROM events").empty());
+    assert(explainQuery(db, "SELECT user, COUNT(*) FROM events").empty());
+    assert(explainQuery(db, "SELECT COUNT(*) FROM events TABLESAMPLE SYSTEM (150)").empty());
+    
+    // Views keep sketches up to date as rows arrive
+    SQLProcessor::processStatement(
+        "CREATE MATERIALIZED VIEW reach AS SELECT APPROX_COUNT_DISTINCT(user) AS users FROM events", db);
+    db.insertInto("events", {200000, "newcomer", 1.0});
+    auto reach = runQuery(db, "SELECT users FROM reach");
+    assert(std::abs(std::get<int>(reach[0].values[0]) - 5001) < 5001 * 0.05);
+    db.dropTable("reach");
+    db.stopCompaction();
+    
+    std::cout << "Sampling and approximate aggregate tests passed!" << std::endl;
+}
+
+void test_window_functions() {
+    std::cout << "Testing window functions..." << std::endl;
+    
+    Database db;
+    Schema ticks("ticks");
+    ticks.columns = {{"id", DataType::INT}, {"sym", DataType::STRING}, {"price", DataType::DOUBLE}};
+    db.createTable("ticks", ticks);
+    // a: 10, 20, 20, 40 at ids 1..4; b: 5, 7 at ids 5, 6
+    db.insertInto("ticks", {1, "a", 10.0});
+    db.insertInto("ticks", {5, "b", 5.0});
+    db.insertInto("ticks", {2, "a", 20.0});
+    db.insertInto("ticks", {3, "a", 20.0});
+    db.insertInto("ticks", {6, "b", 7.0});
+    db.insertInto("ticks", {4, "a", 40.0});
+    
+    auto parses = [&db](const std::string& sql) {
+        ArenaScope scope(QueryArena::forThread());
+        return SQLParser::parse(sql, db) != nullptr;
+    };
+    
+    auto rows = runQuery(db, "SELECT id, ROW_NUMBER() OVER (PARTITION BY sym ORDER BY id) AS n, "
+                             "RANK() OVER (PARTITION BY sym ORDER BY price), DENSE_RANK() OVER (PARTITION BY sym ORDER BY price), "
+                             "LAG(price) OVER (PARTITION BY sym ORDER BY id), LEAD(price, 2, 0) OVER (PARTITION BY sym ORDER BY id), "
+                             "SUM(price) OVER (PARTITION BY sym ORDER BY id) AS running FROM ticks");
+    // Rows come out partitioned and sorted by the first window
+    assert(rows.size() == 6);
+    std::vector<int> ids;
+    for (const auto& row : rows) ids.push_back(std::get<int>(row.values[0]));
+    assert((ids == std::vector<int>{1, 2, 3, 4, 5, 6}));
+    assert(rows[3].values[1] == Value(4) && rows[5].values[1] == Value(2));
+    assert(rows[2].values[2] == Value(2) && rows[3].values[2] == Value(4));   // 20 and 20 tie
+    assert(rows[3].values[3] == Value(3));
+    assert(std::holds_alternative<std::nullptr_t>(rows[0].values[4]) && rows[1].values[4] == Value(10.0));
+    assert(rows[0].values[5] == Value(20.0) && rows[2].values[5] == Value(0) && rows[4].values[5] == Value(0));
+    assert(rows[3].values[6] == Value(90.0) && rows[5].values[6] == Value(12.0));
+    
+    auto framed = runQuery(db, "SELECT id, AVG(price) OVER (ORDER BY id ROWS BETWEEN 2 PRECEDING AND CURRENT ROW), "
+                               "MAX(price) OVER (ORDER BY id ROWS BETWEEN 1 PRECEDING AND 1 FOLLOWING), "
+                               "COUNT(*) OVER (), MIN(sym) OVER (ORDER BY price DESC ROWS BETWEEN CURRENT ROW AND UNBOUNDED FOLLOWING) "
+                               "FROM ticks WHERE id > 1");
+    assert(framed.size() == 5);
+    assert(framed[0].values[0] == Value(2) && framed[0].values[1] == Value(20.0));
+    assert(framed[3].values[1] == Value((20.0 + 40.0 + 5.0) / 3));
+    assert(framed[3].values[2] == Value(40.0) && framed[4].values[2] == Value(7.0));
+    assert(framed[0].values[3] == Value(5));
+    
+    // Against brute force, over partitions sorted on worker threads
+    Schema series("series");
+    series.columns = {{"t", DataType::INT}, {"host", DataType::INT}, {"load", DataType::DOUBLE}};
+    db.createTable("series", series);
+    std::vector<Row> points;
+    for (int i = 0; i < 100000; ++i) {
+        points.push_back(Row{{100000 - i, i % 16, static_cast<double>((i * 37) % 101)}});
+    }
+    db.insertRowsInto("series", points);
+    {
+        ArenaScope scope(QueryArena::forThread());
+        auto plan = SQLParser::parse("SELECT host, t, SUM(load) OVER (PARTITION BY host ORDER BY t "
+                                     "ROWS BETWEEN 100 PRECEDING AND 50 FOLLOWING) AS s FROM series", db);
+        assert(explainPlan(*plan).find("Window [SUM(load) OVER (PARTITION BY host ORDER BY t "
+                                       "ROWS BETWEEN 100 PRECEDING AND 50 FOLLOWING) AS s]") != std::string::npos);
+        QueryPlanNode* node = plan.get();
+        while (!dynamic_cast<WindowNode*>(node)) node = const_cast<QueryPlanNode*>(node->getChildren()[0]);
+        static_cast<WindowNode*>(node)->setParallelism(4);
+        auto result = QueryExecutor::execute(*plan);
+        assert(result.size() == 100000 && static_cast<WindowNode*>(node)->isParallel());
+        std::vector<std::vector<double>> byHost(16);
+        for (int i = 99999; i >= 0; --i) byHost[i % 16].push_back((i * 37) % 101);   // Ascending t
+        size_t next = 0;
+        for (int host = 0; host < 16; ++host) {
+            const auto& loads = byHost[host];
+            for (size_t i = 0; i < loads.size(); ++i, ++next) {
+                if (i % 97 != 0) continue;
+                double expected = 0.0;
+                for (size_t j = i >= 100 ? i - 100 : 0; j <= std::min(loads.size() - 1, i + 50); ++j) {
+                    expected += loads[j];
+                }
+                assert(result[next].values[0] == Value(host));
+                assert(std::abs(std::get<double>(result[next].values[2]) - expected) < 1e-6);
+            }
+        }
+    }
+    
+    // Offsets far past the partition behave like UNBOUNDED instead of overflowing
+    auto far = runQuery(db, "SELECT id, SUM(price) OVER (ORDER BY id ROWS BETWEEN CURRENT ROW AND 9223372036854775806 FOLLOWING) AS rest, "
+                            "SUM(price) OVER (ORDER BY id ROWS BETWEEN 9223372036854775806 PRECEDING AND CURRENT ROW) AS upto, "
+                            "LEAD(price, 9223372036854775806, 0) OVER (ORDER BY id) FROM ticks");
+    assert(far.size() == 6);
+    assert(far[0].values[1] == Value(102.0) && far[3].values[1] == Value(52.0) && far[5].values[1] == Value(7.0));
+    assert(far[0].values[2] == Value(10.0) && far[5].values[2] == Value(102.0));
+    assert(far[0].values[3] == Value(0) && far[5].values[3] == Value(0));
+    assert(!parses("SELECT SUM(price) OVER (ORDER BY id ROWS BETWEEN CURRENT ROW AND 99999999999999999999 FOLLOWING) FROM ticks"));
+    assert(!parses("SELECT LAG(price, 99999999999999999999) OVER (ORDER BY id) FROM ticks"));
+    
+    assert(!parses("SELECT SUM(sym) OVER () FROM ticks"));
+    assert(!parses("SELECT SUM(price) OVER (ORDER BY id ROWS BETWEEN 1 FOLLOWING AND CURRENT ROW) FROM ticks"));
+    assert(!parses("SELECT COUNT(*), ROW_NUMBER() OVER () FROM ticks"));
+    db.stopCompaction();
+    
+    std::cout << "Window function tests passed!" << std::endl;
+}
+
+void test_distinct_and_in() {
+    std::cout << "Testing DISTINCT, IN lists and semi-joins..." << std::endl;
+    
+    Database db;
+    Schema events("events");
+    events.columns = {{"id", DataType::INT}, {"user", DataType::STRING}, {"kind", DataType::STRING}};
+    db.createTable("events", events);
+    std::vector<Row> rows;
+    const char* kinds[] = {"view", "click", "buy"};
+    for (int i = 0; i < 3000; ++i) {
+        rows.push_back(Row{{i, "u" + std::to_string(i % 100), std::string(kinds[i % 7 % 3])}});
+    }
+    db.insertRowsInto("events", rows);
+    Schema vips("vips");
+    vips.columns = {{"name", DataType::STRING}, {"tier", DataType::INT}};
+    db.createTable("vips", vips);
+    for (int u = 0; u < 100; u += 10) {
+        db.insertInto("vips", {"u" + std::to_string(u), u % 20 == 0 ? 2 : 1});
+        db.insertInto("vips", {"u" + std::to_string(u), 3});   // Duplicate keys match once
+    }
+    
+    // DISTINCT keeps first occurrences in input order
+    auto distinctKinds = runQuery(db, "SELECT DISTINCT kind FROM events");
+    assert(distinctKinds.size() == 3);
+    assert(distinctKinds[0].values[0] == Value("view") && distinctKinds[1].values[0] == Value("click"));
+    assert(runQuery(db, "SELECT DISTINCT user, kind FROM events").size() == 300);
+    assert(runQuery(db, "SELECT DISTINCT * FROM events").size() == 3000);
+    assert(runQuery(db, "SELECT DISTINCT kind, COUNT(*) FROM events GROUP BY kind").size() == 3);
+    assert(explainQuery(db, "SELECT DISTINCT kind FROM events").find("Distinct [events.kind]") != std::string::npos);
+    
+    // IN lists, short and long, against the equivalent ORs
+    assert(runQuery(db, "SELECT id FROM events WHERE id IN (5, 7.0, 'x', 9000)").size() == 2);
+    std::string longList = "SELECT id FROM events WHERE id IN (";
+    std::set<int> wanted;
+    for (int v = 0; v < 500; ++v) {
+        int id = (v * 7919) % 4000;
+        wanted.insert(id);
+        longList += (v > 0 ? ", " : "") + std::to_string(id);
+    }
+    auto inList = runQuery(db, longList + ") AND kind IN ('view', 'buy')");
+    size_t expected = 0;
+    for (const auto& row : rows) {
+        int id = std::get<int>(row.values[0]);
+        expected += wanted.count(id) && row.values[2] != Value("click");
+    }
+    assert(inList.size() == expected && expected > 0);
+    for (const auto& row : inList) {
+        assert(wanted.count(std::get<int>(row.values[0])));
+    }
+    {
+        InListExpr doubles("x", {Value(1.5), Value(2), Value("2"), Value(nullptr), Value(3), Value(4), Value(5),
+                                 Value(6), Value(7), Value(8)});
+        doubles.bind({"x"});
+        assert(!doubles.hashes.empty());
+        assert(doubles.contains(CompactValue::ofInt(2)) && doubles.contains(CompactValue::borrow(Value(2.0))));
+        assert(doubles.contains(CompactValue::borrow(Value("2"))) && doubles.contains(CompactValue::borrow(Value(1.5))));
+        assert(!doubles.contains(CompactValue::ofInt(9)) && !doubles.contains(CompactValue()));
+    }
+    
+    // IN (SELECT ...) runs as a hash semi-join and does not duplicate rows
+    auto semi = runQuery(db, "SELECT id, user FROM events WHERE user IN (SELECT name FROM vips WHERE tier > 1) AND id < 1000");
+    assert(semi.size() == 10 * 10);
+    for (const auto& row : semi) {
+        int user = std::stoi(std::get<std::string>(row.values[1]).substr(1));
+        assert(user % 10 == 0 && std::get<int>(row.values[0]) < 1000);
+    }
+    assert(runQuery(db, "SELECT id FROM events WHERE user IN (SELECT name FROM vips WHERE tier = 2)").size() == 5 * 30);
+    std::string semiPlan = explainQuery(db, "SELECT id FROM events WHERE user IN (SELECT DISTINCT name FROM vips) AND id < 1000");
+    assert(semiPlan.find("HashSemiJoin [user = name]") != std::string::npos);
+    assert(semiPlan.find("Distinct") != std::string::npos);
+    assert(explainQuery(db, "SELECT id FROM events WHERE user IN (SELECT name, tier FROM vips)").empty());
+    assert(explainQuery(db, "SELECT id FROM events WHERE id = 1 OR user IN (SELECT name FROM vips)").empty());
+    
+    // Partition pruning unions the listed keys' partitions
+    SQLProcessor::processStatement(
+        "CREATE TABLE sales (id INT, amount DOUBLE) PARTITION BY RANGE (id) VALUES (100, 200, 300)", db);
+    assert(explainQuery(db, "SELECT id FROM sales WHERE id IN (5, 250)").find("PARTITIONS [0, 2] of 4") != std::string::npos);
+    
+    // Large inputs are probed on worker threads; the output is unchanged
+    Schema clicks("clicks");
+    clicks.columns = {{"session", DataType::INT}, {"page", DataType::STRING}};
+    db.createTable("clicks", clicks);
+    std::vector<Row> load;
+    for (int i = 0; i < 200000; ++i) {
+        load.push_back(Row{{(i * 31) % 5003, "p" + std::to_string(i % 3)}});
+    }
+    db.insertRowsInto("clicks", load);
+    std::vector<Row> serial, parallel;
+    for (size_t threads : {1, 4}) {
+        ArenaScope scope(QueryArena::forThread());
+        auto plan = SQLParser::parse("SELECT DISTINCT session, page FROM clicks", db);
+        auto* distinct = dynamic_cast<DistinctNode*>(plan.get());
+        assert(distinct);
+        distinct->setParallelism(threads);
+        (threads == 1 ? serial : parallel) = QueryExecutor::execute(*plan);
+        assert(distinct->isParallel() == (threads > 1));
+        assert(distinct->getDistinctCount() == 5003 * 3);
+    }
+    assert(serial.size() == 5003 * 3 && parallel.size() == serial.size());
+    for (size_t i = 0; i < serial.size(); ++i) {
+        assert(serial[i].values == parallel[i].values);
+    }
+    db.stopCompaction();
+    
+    std::cout << "DISTINCT and IN tests passed!" << std::endl;
+}
+
+// Reference LIKE semantics by plain recursion
+bool naiveLike(const std::string& text, size_t t, const std::string& pattern, size_t p) {
+    if (p == pattern.size()) return t == text.size();
+    if (pattern[p] == '%') {
+        for (size_t k = t; k <= text.size(); ++k) {
+            if (naiveLike(text, k, pattern, p + 1)) return true;
+        }
+        return false;
+    }
+    if (t == text.size()) return false;
+    if (pattern[p] == '\\' && p + 1 < pattern.size()) {
+        return text[t] == pattern[p + 1] && naiveLike(text, t + 1, pattern, p + 2);
+    }
+    return (pattern[p] == '_' || pattern[p] == text[t]) && naiveLike(text, t + 1, pattern, p + 1);
+}
+
+void test_pattern_predicates() {
+    std::cout << "Testing LIKE and substring predicates..." << std::endl;
+    
+    using Strategy = PatternMatcher::Strategy;
+    assert(PatternMatcher::like("abc").getStrategy() == Strategy::EXACT);
+    assert(PatternMatcher::like("abc%").getStrategy() == Strategy::PREFIX);
+    assert(PatternMatcher::like("%abc").getStrategy() == Strategy::SUFFIX);
+    assert(PatternMatcher::like("%%abc%").getStrategy() == Strategy::CONTAINS);
+    assert(PatternMatcher::like("a%b%c").getStrategy() == Strategy::SEGMENTS);
+    assert(PatternMatcher::like("a_c%").getStrategy() == Strategy::NFA);
+    assert(PatternMatcher::like("a\\_c%").getStrategy() == Strategy::PREFIX);
+    assert(PatternMatcher::like("a\\_c%").matches(std::string_view("a_cd")));
+    assert(!PatternMatcher::like("a\\_c%").matches(std::string_view("abcd")));
+    assert(PatternMatcher::like("%").matches(std::string_view("")) && PatternMatcher::like("").matches(std::string_view("")));
+    assert(!PatternMatcher::like("").matches(std::string_view("a")));
+    assert(PatternMatcher::like("%Error%", true).matches(std::string_view("disk eRRoR")));
+    assert(PatternMatcher::like("_rr%", true).matches(std::string_view("ERROR")));
+    assert(PatternMatcher::startsWith("GET ").matches(std::string_view("GET /index")));
+    assert(PatternMatcher::contains("").matches(std::string_view("")));
+    
+    // Every strategy agrees with the reference on random strings over a small alphabet
+    uint64_t seed = 42;
+    auto random = [&seed](size_t bound) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        return static_cast<size_t>((seed >> 33) % bound);
+    };
+    const char alphabet[] = "abAB%_";
+    for (int trial = 0; trial < 3000; ++trial) {
+        std::string pattern, text;
+        for (size_t i = random(7); i > 0; --i) pattern += alphabet[random(6)];
+        for (size_t i = random(20); i > 0; --i) text += alphabet[random(4)];
+        PatternMatcher matcher = PatternMatcher::like(pattern);
+        bool expected = naiveLike(text, 0, pattern, 0);
+        assert(matcher.matches(std::string_view(text)) == expected);
+        assert(matcher.matches(CompactValue::ofString(text)) == expected);
+        std::string lowerText = text, lowerPattern = pattern;
+        std::transform(lowerText.begin(), lowerText.end(), lowerText.begin(), ::tolower);
+        std::transform(lowerPattern.begin(), lowerPattern.end(), lowerPattern.begin(), ::tolower);
+        assert(PatternMatcher::like(pattern, true).matches(std::string_view(text)) ==
+               naiveLike(lowerText, 0, lowerPattern, 0));
+    }
+    
+    Database db;
+    Schema logs("logs");
+    logs.columns = {{"id", DataType::INT}, {"level", DataType::STRING}, {"message", DataType::STRING}};
+    db.createTable("logs", logs);
+    const char* levels[] = {"INFO", "WARN", "ERROR", "error"};
+    const char* messages[] = {"GET /api/users took 12ms", "disk /dev/sda1 is 91% full", "connection reset by peer",
+                              "GET /health", "timeout after 30s contacting db-7"};
+    std::vector<Row> rows;
+    for (int i = 0; i < 5000; ++i) {
+        rows.push_back(Row{{i, std::string(levels[i % 4]), messages[i % 5] + std::string(i % 3 ? "" : " (retry)")}});
+    }
+    rows.push_back(Row{{5000, nullptr, nullptr}});
+    db.insertRowsInto("logs", rows);
+    
+    auto count = [&db](const std::string& where) { return runQuery(db, "SELECT id FROM logs WHERE " + where).size(); };
+    auto expect = [&rows](auto predicate) {
+        size_t n = 0;
+        for (const auto& row : rows) {
+            if (!std::holds_alternative<std::string>(row.values[2]) || !std::holds_alternative<std::string>(row.values[1])) continue;
+            n += predicate(std::get<std::string>(row.values[1]), std::get<std::string>(row.values[2]));
+        }
+        return n;
+    };
+    using S = const std::string&;
+    assert(count("message LIKE 'GET %'") == expect([](S, S m) { return m.rfind("GET ", 0) == 0; }));
+    assert(count("STARTS_WITH(message, 'GET /api')") == expect([](S, S m) { return m.rfind("GET /api", 0) == 0; }));
+    assert(count("CONTAINS(message, 'retry')") == expect([](S, S m) { return m.find("retry") != std::string::npos; }));
+    assert(count("message LIKE '%(retry)'") == expect([](S, S m) { return m.size() > 7 && m.substr(m.size() - 7) == "(retry)"; }));
+    assert(count("message LIKE '%/dev/sd_1%'") == 1000);
+    assert(count("message LIKE 'disk%91\\% full%'") == 1000);
+    assert(count("level ILIKE 'error' AND message LIKE '%db-_'") == expect([](S l, S m) {
+        return (l == "ERROR" || l == "error") && m == "timeout after 30s contacting db-7"; }));
+    assert(count("level NOT ILIKE 'err%'") == 2500);   // NULL matches neither way
+    assert(count("message NOT LIKE '%GET%' OR CONTAINS(level, 'WA')") ==
+           expect([](S l, S m) { return m.find("GET") == std::string::npos || l == "WARN"; }));
+    
+    ArenaScope scope(QueryArena::forThread());
+    assert(!SQLParser::parse("SELECT id FROM logs WHERE LENGTH(message, 'x')", db));
+    assert(!SQLParser::parse("SELECT id FROM logs WHERE message NOT = 'x'", db));
+    std::string explained = explainPlan(*SQLParser::parse("SELECT id FROM logs WHERE message ILIKE '%Full' AND STARTS_WITH(level, 'W')", db));
+    assert(explained.find("message ILIKE '%Full'") != std::string::npos);
+    assert(explained.find("STARTS_WITH(level, 'W')") != std::string::npos);
+    db.stopCompaction();
+    
+    std::cout << "Pattern predicate tests passed!" << std::endl;
+}
+
+void test_trigram_index() {
+    std::cout << "Testing trigram indexes..." << std::endl;
+    
+    // Candidates are exactly the rows holding every trigram of the literals
+    uint64_t state = 7;
+    auto random = [&state](uint64_t n) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return (state >> 33) % n;
+    };
+    const char alphabet[] = "abcd";
+    std::vector<std::string> texts;
+    TrigramIndex index;
+    for (uint32_t r = 0; r < 2000; ++r) {
+        std::string text;
+        for (size_t i = random(12); i > 0; --i) text += alphabet[random(4)];
+        texts.push_back(text);
+        index.add(r * 3, text);   // IDs need only ascend
+    }
+    auto hasGrams = [](const std::string& text, const std::string& literal) {
+        for (size_t i = 0; i + 3 <= literal.size(); ++i) {
+            if (text.find(literal.substr(i, 3)) == std::string::npos) return false;
+        }
+        return true;
+    };
+    std::vector<uint32_t> found;
+    for (int trial = 0; trial < 200; ++trial) {
+        std::vector<std::string> literals(1 + random(2));
+        for (auto& literal : literals) {
+            for (size_t i = 3 + random(3); i > 0; --i) literal += alphabet[random(4)];
+        }
+        std::vector<uint32_t> expected;
+        for (uint32_t r = 0; r < texts.size(); ++r) {
+            bool all = true;
+            for (const auto& literal : literals) all = all && hasGrams(texts[r], literal);
+            if (all) expected.push_back(r * 3);
+        }
+        index.lookup(literals, found);
+        assert(found == expected);
+        assert(index.estimate(literals) >= found.size());
+    }
+    assert(!TrigramIndex::usable({"ab", ""}) && TrigramIndex::usable({"ab", "abc"}));
+    assert(index.getTrigramCount() == 64);
+    
+    Database db;
+    SQLProcessor::processStatement(
+        "CREATE TABLE logs (id INT, host STRING, message STRING) PARTITION BY HASH (id) PARTITIONS 4", db);
+    Table* logs = db.getTable("logs");
+    auto load = [&db](int from, int to) {
+        std::vector<Row> rows;
+        for (int i = from; i < to; ++i) {
+            std::string message = "request " + std::to_string(i) + " served by worker-" + std::to_string(i % 50);
+            if (i % 1000 == 7) message = "kernel panic at " + std::to_string(i);
+            rows.push_back(Row{{i, "host-" + std::to_string(i % 8), message}});
+        }
+        db.insertRowsInto("logs", rows);
+    };
+    load(0, 10000);
+    SQLProcessor::processStatement("CREATE INDEX logs_message ON logs USING TRIGRAM (message)", db);
+    assert(logs->getTrigramIndexes().size() == 1 && logs->getIndexBytes() > 0);
+    load(10000, 20000);   // Inserts extend the posting lists
+    
+    auto count = [&db](const std::string& where) { return runQuery(db, "SELECT id FROM logs WHERE " + where).size(); };
+    auto usesIndex = [&db](const std::string& where) {
+        return explainQuery(db, "SELECT id FROM logs WHERE " + where).find("TRIGRAM INDEX logs_message") != std::string::npos;
+    };
+    assert(count("message LIKE '%panic%'") == 20);
+    assert(usesIndex("message LIKE '%panic%'"));
+    assert(count("CONTAINS(message, 'panic at 1')") == 11);
+    assert(count("message = 'request 12345 served by worker-45'") == 1);
+    assert(usesIndex("message = 'request 12345 served by worker-45'"));
+    // Trigrams only narrow the rows; the predicate still decides
+    assert(count("message LIKE '%worker-1_'") == 20000 / 50 * 10);
+    assert(count("message LIKE '%er-4%' AND message LIKE '%request 1234%'") == 10);
+    assert(count("message LIKE '%panic at 1%' AND host = 'host-3'") == 0);
+    // Unselective literals, short literals and case folding keep the scan
+    assert(!usesIndex("message LIKE 'request%'"));
+    assert(!usesIndex("message LIKE '%pa%'"));
+    assert(!usesIndex("message ILIKE '%PANIC%'"));
+    assert(!usesIndex("message NOT LIKE '%panic%'"));
+    assert(count("message ILIKE '%PANIC%'") == 20);
+    {
+        ArenaScope scope(QueryArena::forThread());
+        auto plan = SQLParser::parse("SELECT id FROM logs WHERE CONTAINS(message, 'panic')", db);
+        const auto* scan = dynamic_cast<const TableScanNode*>(plan.get());
+        assert(scan && scan->usesIndex());
+        auto result = QueryExecutor::execute(*plan);
+        assert(result.size() == 20);
+        assert(scan->getProfile().rowsIn == 20);
+    }
+    
+    // Updates, deletes and compaction move rows; the index follows them
+    SQLProcessor::processStatement("UPDATE logs SET message = 'oom killer' WHERE id = 7", db);
+    assert(count("message LIKE '%killer%'") == 1 && usesIndex("message LIKE '%killer%'"));
+    assert(count("message LIKE '%panic%'") == 19);
+    SQLProcessor::processStatement("DELETE FROM logs WHERE id < 15000", db);
+    db.compactAll();
+    assert(logs->getStoredRowCount() < 20000);
+    assert(count("message LIKE '%panic%'") == 5);
+    assert(count("message = 'request 17345 served by worker-45'") == 1);
+    load(20000, 21000);
+    assert(count("message LIKE '%panic%'") == 6);
+    SQLProcessor::processStatement("ALTER TABLE logs DROP PARTITION 0", db);
+    assert(count("message LIKE '%panic%'") ==
+           count("message ILIKE '%panic%'"));
+    
+    // Only STRING columns, one index per column, unique names
+    bool threw = false;
+    try { logs->createTrigramIndex("by_id", "id"); } catch (const std::runtime_error&) { threw = true; }
+    assert(threw);
+    threw = false;
+    try { db.createIndex("logs", "again", "message"); } catch (const std::runtime_error&) { threw = true; }
+    assert(threw);
+    threw = false;
+    try { DDLParser::parseCreateIndex("CREATE INDEX i ON logs USING BTREE (host)"); } catch (const std::runtime_error&) { threw = true; }
+    assert(threw);
+    assert(SQLProcessor::getStatementType("create index i on logs using trigram (host)") == StatementType::CREATE_INDEX);
+    db.stopCompaction();
+    
+    std::cout << "Trigram index tests passed!" << std::endl;
+}
+
+void test_async_io() {
+    std::cout << "Testing asynchronous I/O..." << std::endl;
+    
+    constexpr size_t kPage = 4096;
+    constexpr size_t kPages = 64;
+    std::string expected;
+    for (size_t p = 0; p < kPages; ++p) {
+        expected += std::string(kPage, static_cast<char>('a' + p % 26));
+    }
+    for (auto backend : {AsyncIO::Backend::IO_URING, AsyncIO::Backend::THREAD_POOL}) {
+        FILE* file = std::tmpfile();
+        const int fd = fileno(file);
+        {
+            // Pages are written out of order; a full queue submits as one batch
+            AsyncIO io(8, backend);
+            assert(backend == AsyncIO::Backend::IO_URING || io.getBackend() == AsyncIO::Backend::THREAD_POOL);
+            std::vector<AsyncIO::Ticket> tickets;
+            for (size_t i = 0; i < kPages; ++i) {
+                const size_t p = (i * 37) % kPages;
+                tickets.push_back(io.write(fd, expected.data() + p * kPage, kPage, p * kPage));
+            }
+            for (auto ticket : tickets) {
+                assert(io.wait(ticket) == kPage);
+            }
+            assert(io.getSubmitCount() <= kPages / 4 + 1);
+            
+            std::string page(kPage, '\0');
+            AsyncIO::Ticket read = io.read(fd, page.data(), kPage, 5 * kPage);
+            assert(io.wait(read) == kPage && page == expected.substr(5 * kPage, kPage));
+            bool threw = false;
+            try { io.wait(read); } catch (const std::runtime_error&) { threw = true; }
+            assert(threw);
+            threw = false;
+            AsyncIO::Ticket bad = io.read(-1, page.data(), kPage, 0);
+            try { io.wait(bad); } catch (const std::runtime_error&) { threw = true; }
+            assert(threw);
+        }
+        
+        std::fclose(file);
+    }
+    
+    std::cout << "Asynchronous I/O tests passed!" << std::endl;
+}
+
+void test_numa_placement() {
+    std::cout << "Testing NUMA placement..." << std::endl;
+    
+    assert((NumaTopology::parseCpuList("0-3, 8,10-11\n") == std::vector<int>{0, 1, 2, 3, 8, 10, 11}));
+    bool threw = false;
+    try { NumaTopology::parseCpuList("4-2"); } catch (const std::runtime_error&) { threw = true; }
+    assert(threw);
+    
+    // A fake sysfs with two CPU nodes, numbered with a gap, and a memory-only node
+    std::string root = "/tmp/parallaxdb_numa_" + std::to_string(getpid());
+    for (const char* node : {"node0", "node1", "node3"}) {
+        std::filesystem::create_directories(root + "/" + node);
+    }
+    std::ofstream(root + "/node0/cpulist") << "0,2-3\n";
+    std::ofstream(root + "/node1/cpulist") << "\n";
+    std::ofstream(root + "/node3/cpulist") << "1,4-5\n";
+    NumaTopology topology = NumaTopology::detect(root);
+    std::filesystem::remove_all(root);
+    assert(topology.getNodeCount() == 2);
+    assert((topology.getCpus(1) == std::vector<int>{1, 4, 5}));
+    assert(topology.nodeOfCpu(4) == 1 && topology.nodeOfCpu(2) == 0 && topology.nodeOfCpu(99) == 0);
+    assert(NumaTopology::detect(root).getNodeCount() == 1);   // Gone: one flat node
+    
+    Database db;
+    SQLProcessor::processStatement(
+        "CREATE TABLE events (kind STRING, value INT) PARTITION BY HASH (value) PARTITIONS 4", db);
+    Table* events = db.getTable("events");
+    events->setLoadParallelism(2);
+    std::vector<Row> load;
+    for (int i = 0; i < 100000; ++i) {
+        load.push_back(Row{{std::string("kind") + std::to_string(i % 7), i}});
+    }
+    auto scanEvents = [&db](size_t threads) {
+        ArenaScope scope(QueryArena::forThread());
+        auto plan = SQLParser::parse("SELECT value FROM events WHERE value < 50000", db);
+        QueryPlanNode* node = plan.get();
+        while (!dynamic_cast<TableScanNode*>(node)) node = const_cast<QueryPlanNode*>(node->getChildren()[0]);
+        static_cast<TableScanNode*>(node)->setParallelism(threads);
+        plan->enableProfiling();
+        auto results = QueryExecutor::execute(*plan);
+        assert(results.size() == 50000 && static_cast<TableScanNode*>(node)->isParallel());
+        return std::make_pair(node->getProfile(), explainPlan(*plan));
+    };
+    
+    // Partitions alternate between the nodes; placement is best effort, so
+    // the load and scan succeed even where the fake CPUs do not exist
+    NumaTopology::install(topology);
+    db.insertRowsInto("events", load);
+    assert(events->getHomeNode(0) == 0 && events->getHomeNode(1) == 1 && events->getHomeNode(2) == 0);
+    auto [split, text] = scanEvents(2);
+    assert(split.localMorsels + split.remoteMorsels == 4);
+    assert(split.localMorsels >= 1);   // Whoever claims second finds a partition of its own node
+    assert(text.find("numa local=") != std::string::npos);
+    
+    // On one node every partition is local
+    NumaTopology::install(NumaTopology::flat());
+    assert(events->getHomeNode(1) == 0);
+    OperatorProfile flat = scanEvents(3).first;
+    assert(flat.localMorsels == 4 && flat.remoteMorsels == 0);
+    
+    NumaTopology::install(NumaTopology::detect());
+    
+    std::cout << "NUMA placement tests passed!" << std::endl;
+}
+
+void test_huge_pages() {
+    std::cout << "Testing huge-page allocation..." << std::endl;
+    
+    HugePageResource* resource = HugePageResource::get();
+    auto mapped = [] {
+        HugePageStats stats = HugePageResource::getStats();
+        return stats.explicitBytes + stats.transparentBytes + stats.regularBytes;
+    };
+    constexpr size_t kBytes = 3 << 20;
+    
+    // Each policy maps whole 2MB pages and reports what it got; explicit
+    // pages fall back when the hugetlb pool is empty
+    for (auto policy : {HugePagePolicy::TRANSPARENT, HugePagePolicy::EXPLICIT}) {
+        HugePageResource::setPolicy(policy);
+        const HugePageStats before = HugePageResource::getStats();
+        const uint64_t mappedBefore = mapped();
+        void* data = resource->allocate(kBytes, 64);
+        assert(reinterpret_cast<uintptr_t>(data) % HugePageResource::kPageBytes == 0);
+        std::fill_n(static_cast<char*>(data), kBytes, 'x');
+        const HugePageStats during = HugePageResource::getStats();
+        assert(mapped() - mappedBefore == 2 * HugePageResource::kPageBytes);
+        if (policy == HugePagePolicy::EXPLICIT) {
+            assert(during.explicitBytes > before.explicitBytes || during.fallbacks > before.fallbacks);
+        }
+        resource->deallocate(data, kBytes, 64);
+        assert(mapped() == mappedBefore);
+    }
+    HugePageResource::setPolicy(HugePagePolicy::OFF);
+    uint64_t regular = HugePageResource::getStats().regularBytes;
+    void* data = resource->allocate(kBytes, 64);
+    assert(HugePageResource::getStats().regularBytes == regular + kBytes);
+    resource->deallocate(data, kBytes, 64);
+    HugePageResource::setPolicy(HugePagePolicy::TRANSPARENT);
+    const uint64_t mappedBefore = mapped();
+    resource->deallocate(resource->allocate(4096, 64), 4096, 64);   // Small: global heap
+    assert(mapped() == mappedBefore);
+    
+    // A slab carves buffers from shared chunks and reuses freed ones
+    {
+        HugePageSlab slab;
+        std::vector<void*> buffers;
+        for (int i = 0; i < 100; ++i) buffers.push_back(slab.allocate(64 * 1024, 32));
+        assert(slab.getMappedBytes() == HugePageSlab::kChunkBytes);
+        slab.deallocate(buffers[7], 64 * 1024, 32);
+        assert(slab.allocate(64 * 1024, 32) == buffers[7]);
+        for (int i = 0; i < 200; ++i) buffers.push_back(slab.allocate(48 * 1024, 32));
+        assert(slab.getMappedBytes() == 2 * HugePageSlab::kChunkBytes);
+    }
+    assert(mapped() == mappedBefore);
+    
+    // A table switches to its slab once its cells pass kHugePageTableBytes
+    Database db;
+    SQLProcessor::processStatement("CREATE TABLE wide (a INT, b INT, c DOUBLE, d STRING)", db);
+    std::vector<Row> load;
+    for (int i = 0; i < 200000; ++i) {
+        load.push_back(Row{{i, i % 100, i * 0.5, std::string("v") + std::to_string(i % 10)}});
+    }
+    db.insertRowsInto("wide", load);
+    assert(mapped() >= mappedBefore + HugePageSlab::kChunkBytes);
+    assert(runQuery(db, "SELECT a FROM wide WHERE b = 42").size() == 2000);
+    SQLProcessor::processStatement("DELETE FROM wide WHERE a < 150000", db);
+    db.getTable("wide")->compact();
+    assert(runQuery(db, "SELECT a FROM wide WHERE b = 42").size() == 500);
+    db.getTable("wide")->truncate();
+    assert(mapped() == mappedBefore);
+    
+    std::cout << "Huge-page allocation tests passed!" << std::endl;
+}
+
+void test_tiered_execution() {
+    std::cout << "Testing tiered predicate compilation..." << std::endl;
+    
+    Database db;
+    SQLProcessor::processStatement("CREATE TABLE ticks (id INT, price DOUBLE, venue STRING, qty INT)", db);
+    std::vector<Row> load;
+    for (int i = 0; i < 20000; ++i) {
+        Value price = i % 7 == 0 ? Value(nullptr) : Value((i % 500) + 0.5);
+        Value venue = i % 11 == 0 ? Value("venue-with-a-long-name-" + std::to_string(i % 3))
+                                  : Value("v" + std::to_string(i % 5));
+        load.push_back(Row{{i, price, venue, i % 13 == 0 ? Value(nullptr) : Value(i % 60)}});
+    }
+    db.insertRowsInto("ticks", load);
+    
+    // Runs a query and returns its sorted ids, and whether the scan ran compiled
+    auto run = [&db](const std::string& query) {
+        ArenaScope scope(QueryArena::forThread());
+        auto plan = SQLParser::parse(query, db);
+        QueryPlanNode* node = plan.get();
+        while (!dynamic_cast<TableScanNode*>(node)) node = const_cast<QueryPlanNode*>(node->getChildren()[0]);
+        plan->enableProfiling();
+        std::vector<int> ids;
+        for (const auto& row : QueryExecutor::execute(*plan)) ids.push_back(std::get<int>(row.values[0]));
+        std::sort(ids.begin(), ids.end());
+        auto* scan = static_cast<TableScanNode*>(node);
+        return std::make_tuple(ids, scan->isCompiled(), scan->getProfile().jitCompileNanos);
+    };
+    
+    // Compiled code agrees with the interpreter across types, NULLs and
+    // strings, whether a scan switches part-way or starts compiled
+    FilterJit& jit = FilterJit::instance();
+    const std::vector<std::pair<std::string, bool>> queries = {
+        {"SELECT id FROM ticks WHERE price < 250 AND venue = 'v3'", true},
+        {"SELECT id FROM ticks WHERE qty >= 40.5 OR venue != 'v1'", true},
+        {"SELECT id FROM ticks WHERE (id > 100 AND id <= 900) OR price = 7.5", true},
+        {"SELECT id FROM ticks WHERE (price >= 499 OR qty = 'v2') AND qty != 'x'", true},
+        {"SELECT id FROM ticks WHERE venue = 'venue-with-a-long-name-1'", false},
+        {"SELECT id FROM ticks WHERE venue LIKE 'v%' AND id < 50", false},
+    };
+    for (const auto& [query, compiles] : queries) {
+        jit.setEnabled(false);
+        auto [expected, interpreted, noJit] = run(query);
+        assert(!expected.empty() && !interpreted && noJit == 0);
+        jit.setEnabled(true);
+        auto [first, firstCompiled, firstNanos] = run(query);
+        assert(first == expected);
+        assert(firstCompiled == (firstNanos > 0));   // Switched part-way: paid for the compile
+        jit.waitIdle();
+        auto [second, secondCompiled, secondNanos] = run(query);
+        assert(second == expected && secondCompiled == compiles && secondNanos == 0);
+    }
+    
+    // DOUBLE literals against DOUBLE and INT columns, where truncating them
+    // would change the answer
+    std::vector<int> halves;
+    for (int i = 0; i < 20000; ++i) {
+        if (i % 7 != 0 && i % 500 == 7 && i % 13 != 0 && i % 60 > 39) halves.push_back(i);
+    }
+    const std::string halvesQuery = "SELECT id FROM ticks WHERE price = 7.5 AND qty > 39.5";
+    jit.setEnabled(false);
+    assert(std::get<0>(run(halvesQuery)) == halves);
+    jit.setEnabled(true);
+    run(halvesQuery);
+    jit.waitIdle();
+    auto [compiledHalves, halvesCompiled, halvesNanos] = run(halvesQuery);
+    assert(!halves.empty() && compiledHalves == halves && halvesCompiled);
+    
+    // Same shape, other literals: starts compiled
+    const size_t compiledBefore = jit.getCompiledCount();
+    auto [cheap, cheapCompiled, cheapNanos] = run("SELECT id FROM ticks WHERE price < 20 AND venue = 'v0'");
+    assert(cheapCompiled && cheapNanos == 0 && jit.getCompiledCount() == compiledBefore);
+    jit.setEnabled(false);
+    assert(std::get<0>(run("SELECT id FROM ticks WHERE price < 20 AND venue = 'v0'")) == cheap);
+    jit.setEnabled(true);
+    
+    // Small scans compile only once their shape repeats
+    SQLProcessor::processStatement("CREATE TABLE tiny (k INT, v DOUBLE)", db);
+    for (int i = 0; i < 10; ++i) db.insertInto("tiny", {i, i * 1.5});
+    const std::string point = "SELECT k FROM tiny WHERE k = 3 AND v >= 4.5";
+    assert(std::get<0>(run(point)) == std::vector<int>{3});
+    jit.waitIdle();
+    assert(jit.getCompiledCount() == compiledBefore);
+    run(point);
+    jit.waitIdle();
+    assert(jit.getCompiledCount() == compiledBefore + 1);
+    auto [hot, hotCompiled, hotNanos] = run("SELECT k FROM tiny WHERE k = 4 AND v >= 100.5");
+    assert(hot.empty() && hotCompiled);
+    
+    std::cout << "Tiered predicate compilation tests passed!" << std::endl;
+}
+
 int main() {
     std::cout << "Running ParallaxDB tests..." << std::endl;
     
     test_basic_table_operations();
     test_query_execution();
+    test_table_statistics();
+    test_cost_based_optimizer();
+    test_adaptive_filter();
+    test_late_materialization();
+    test_query_arena();
+    test_compact_values();
+    test_explain_analyze();
+    test_result_sinks();
+    test_arrow_interop();
+    test_runtime_bloom_filter();
+    test_batch_validation();
+    test_update_delete();
+    test_partitioning();
+    test_materialized_views();
+    test_result_cache();
+    test_approximate_queries();
+    test_window_functions();
+    test_distinct_and_in();
+    test_pattern_predicates();
+    test_trigram_index();
+    test_async_io();
+    test_numa_placement();
+    test_huge_pages();
+    test_tiered_execution();
     
     std::cout << "All tests passed!" << std::endl;
     return 0;
@@ -78,6 +78,16 @@ void test_tokenizer() {
     assert(tokens4[10].type == TokenType::LESS_EQUAL);
     assert(tokens4[10].value == "<=");
     
+    // Test qualified identifiers and join keywords
+    Tokenizer tokenizer5("SELECT u.id FROM users u JOIN orders o ON u.id = o.user_id");
+    auto tokens5 = tokenizer5.tokenize();
+    assert(tokens5.size() == 13);
+    assert(tokens5[1].type == TokenType::IDENTIFIER);
+    assert(tokens5[1].value == "u.id");
+    assert(tokens5[5].type == TokenType::JOIN);
+    assert(tokens5[8].type == TokenType::ON);
+    assert(tokens5[11].value == "o.user_id");
+    
     std::cout << "✓ Tokenizer tests passed" << std::endl;
 }
 
@@ -85,14 +95,14 @@ void test_parser_basic() {
     std::cout << "Testing basic parser..." << std::endl;
     
     Table users("users", {
-        {"id", Column::INT},
-        {"name", Column::STRING},
-        {"age", Column::INT}
+        {"id", DataType::INT},
+        {"name", DataType::STRING},
+        {"age", DataType::INT}
     });
     
-    users.insertRow({{1, "Alice", 30}});
-    users.insertRow({{2, "Bob", 25}});
-    users.insertRow({{3, "Charlie", 35}});
+    users.insertRow({1, "Alice", 30});
+    users.insertRow({2, "Bob", 25});
+    users.insertRow({3, "Charlie", 35});
     
     // Test SELECT *
     auto plan1 = SQLParser::parse("SELECT * FROM users", users);
@@ -117,15 +127,15 @@ void test_parser_advanced() {
     std::cout << "Testing advanced parser features..." << std::endl;
     
     Table users("users", {
-        {"id", Column::INT},
-        {"name", Column::STRING},
-        {"age", Column::INT}
+        {"id", DataType::INT},
+        {"name", DataType::STRING},
+        {"age", DataType::INT}
     });
     
-    users.insertRow({{1, "Alice", 30}});
-    users.insertRow({{2, "Bob", 25}});
-    users.insertRow({{3, "Charlie", 35}});
-    users.insertRow({{4, "Diana", 40}});
+    users.insertRow({1, "Alice", 30});
+    users.insertRow({2, "Bob", 25});
+    users.insertRow({3, "Charlie", 35});
+    users.insertRow({4, "Diana", 40});
     
     // Test AND condition
     auto plan1 = SQLParser::parse("SELECT * FROM users WHERE age > 30 AND age < 40", users);
@@ -164,12 +174,12 @@ void test_error_handling() {
     std::cout << "Testing error handling..." << std::endl;
     
     Table users("users", {
-        {"id", Column::INT},
-        {"name", Column::STRING},
-        {"age", Column::INT}
+        {"id", DataType::INT},
+        {"name", DataType::STRING},
+        {"age", DataType::INT}
     });
     
-    users.insertRow({{1, "Alice", 30}});
+    users.insertRow({1, "Alice", 30});
     
     // Test malformed query (should return nullptr)
     auto plan1 = SQLParser::parse("INVALID QUERY", users);
@@ -179,6 +189,14 @@ void test_error_handling() {
     auto plan2 = SQLParser::parse("SELECT * users", users);
     assert(plan2 == nullptr);
     
+    // Test JOIN without ON
+    auto plan4 = SQLParser::parse("SELECT * FROM users JOIN users", users);
+    assert(plan4 == nullptr);
+    
+    // Test unknown column
+    auto plan5 = SQLParser::parse("SELECT salary FROM users", users);
+    assert(plan5 == nullptr);
+    
     // Test missing WHERE value
     auto plan3 = SQLParser::parse("SELECT * FROM users WHERE age >", users);
     assert(plan3 == nullptr);